@@ -53,6 +53,12 @@ extern DRIVER_BOARD *driverboard;
 #include "alpaca_server.h"
 extern ALPACA_SERVER *alpacasrvr;
 
+#include "tc_fit.h"
+extern TC_FIT *tcfit;
+
+#include "page_arena.h"
+extern PAGE_ARENA pagearena;
+
 
 //---------------------------------------------------
 // EXTERNS
@@ -403,6 +409,12 @@ bool ALPACA_SERVER::start() {
   // HANDLE URL NOT FOUND 404
   _alpacaserver->onNotFound(alpacaget_notfound);
 
+  // record time to first request
+  _alpacaserver->addHook([](const String &, const String &, WiFiClient *, ESP8266WebServer::ContentTypeFunction) {
+    mark_firstrequest();
+    return ESP8266WebServer::CLIENT_REQUEST_CAN_CONTINUE;
+  });
+
   // START ALPACA SERVER
   _alpacaserver->begin();
   _loaded = STATE_LOADED;
@@ -440,6 +452,19 @@ void ALPACA_SERVER::stop(void) {
 }
 
 
+//---------------------------------------------------
+// RESTART ALPACA DISCOVERY
+// Called after a WiFi reconnect, rebinds the discovery
+// UDP port so clients can find the focuser again
+//---------------------------------------------------
+void ALPACA_SERVER::restart_discovery(void) {
+  if ((_loaded == STATE_LOADED) && (_discoverystatus == STATUS_RUNNING)) {
+    _ALPACADISCOVERYUdp.stop();
+    _ALPACADISCOVERYUdp.begin(ALPACADISCOVERYPORT);
+  }
+}
+
+
 //---------------------------------------------------
 // CHECK ALPACA SERVER 
 //   For New Clients
@@ -484,10 +509,17 @@ void ALPACA_SERVER::sendmyheader() {
 }
 
 //---------------------------------------------------
-// SEND RESPONSE BODY TO CLIENT
+// SEND RESPONSE HEADER AND BODY TO CLIENT
+// A page that did not fit in the page arena is cut
+// short, it is not sent
 //---------------------------------------------------
-void ALPACA_SERVER::sendmycontent(String pg) {
-  _alpacaserver->client().print(pg);
+void ALPACA_SERVER::sendmycontent(PAGE_ARENA &pg) {
+  if (pg.overflow()) {
+    _alpacaserver->send(HTML_SERVERERROR, PLAINTEXTPAGETYPE, T_PAGETOOBIG);
+    return;
+  }
+  sendmyheader();
+  _alpacaserver->client().write((const uint8_t *)pg.c_str(), pg.length());
 }
 
 //---------------------------------------------------
@@ -755,8 +787,7 @@ String ALPACA_SERVER::addclientinfo(String str) {
 // content-type: text/html
 //---------------------------------------------------
 void ALPACA_SERVER::get_home() {
-  String AlpacaPg;
-  AlpacaPg.reserve(2624);  // 2568
+  PAGE_ARENA &AlpacaPg = pagearena;
 
   AlpacaMsgPrint(T_ALPACASERVER);
   AlpacaMsgPrint(T_GET);
@@ -774,7 +805,7 @@ void ALPACA_SERVER::get_home() {
     AlpacaPg = ALPACA_NOTFOUNDSTR;
     AlpacaMsgPrintln(T_NOTFOUND);
   } else {
-    AlpacaPg = file.readString();
+    AlpacaPg.load(file);
     file.close();
 
     AlpacaPg.replace("%TXC%", TextColor);
@@ -823,8 +854,7 @@ void ALPACA_SERVER::get_home() {
   AlpacaMsgPrint("/alpacahome.html ");
   AlpacaMsgPrintln(String(AlpacaPg.length()));
 
-  //_alpacaserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AlpacaPg);
-  sendmyheader();
+  //_alpacaserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AlpacaPg.c_str(), AlpacaPg.length());
   sendmycontent(AlpacaPg);
 }
 
@@ -835,11 +865,9 @@ void ALPACA_SERVER::get_home() {
 // url: /setup/v1/focuser/0/setup
 //---------------------------------------------------
 void ALPACA_SERVER::get_focusersetup() {
-  String AlpacaPg;
+  PAGE_ARENA &AlpacaPg = pagearena;
   String tmp;
 
-  AlpacaPg.reserve(3264);  // 3208
-
   AlpacaMsgPrintln(TALPACA_GETSETUP);
 
   if (_loaded == STATE_NOTLOADED) {
@@ -979,7 +1007,7 @@ Get_Handler:
   if (!file) {
     AlpacaPg = ALPACA_NOTFOUNDSTR;
   } else {
-    AlpacaPg = file.readString();
+    AlpacaPg.load(file);
     file.close();
 
     AlpacaPg.replace("%TXC%", TextColor);
@@ -1097,8 +1125,7 @@ Get_Handler:
   _ALPACA_ServerTransactionID++;
   AlpacaMsgPrint("/setup/v1/focuser/0/setup ");
   AlpacaMsgPrintln(String(AlpacaPg.length()));
-  //_alpacaserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AlpacaPg);
-  sendmyheader();
+  //_alpacaserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AlpacaPg.c_str(), AlpacaPg.length());
   sendmycontent(AlpacaPg);
 }
 
@@ -1355,14 +1382,52 @@ void ALPACA_SERVER::send_apianswer(String smn, String smv) {
 // { "ClientTransactionID": 1, "ServerTransactionID": 1,
 //   "ErrorNumber": 0, "ErrorMessage": "string",
 //   "Value": "string" }
+// Actions
+//   tcfit           "slope,confidence,count"
+//                   Parameters "clear" clears the fit
+//   tcfitautoapply  Parameters "true" or "false" sets,
+//                   empty gets, Value "true" or "false"
 //---------------------------------------------------
 void ALPACA_SERVER::put_action() {
   // curl -X PUT "http:192.168.2.253:4040/api/v1/focuser/0/action" -H "accept: application/json" -H "Content-Type: application/x-www-form-urlencoded" -d "ClientID=1&ClientTransactionID=1&Action=string&Parameters=string"
 
   String jsonretstr;
+  String action;
+  String parameters;
 
   AlpacaMsgPrintln("AS::put_action");
 
+  for (int i = 0; i < _alpacaserver->args(); i++) {
+    String str = _alpacaserver->argName(i);
+    str.toLowerCase();
+    if (str.equals("action")) {
+      action = _alpacaserver->arg(i);
+      action.toLowerCase();
+    } else if (str.equals("parameters")) {
+      parameters = _alpacaserver->arg(i);
+      parameters.toLowerCase();
+    }
+  }
+
+  if (action.equals("tcfit")) {
+    char buff[TCFIT_SUMMARYLEN];
+    if (parameters.equals("clear")) {
+      tcfit->clear();
+    }
+    tcfit->get_summary(buff, sizeof(buff));
+    send_apianswer("action", String(buff));
+    return;
+  }
+  if (action.equals("tcfitautoapply")) {
+    if (parameters.equals("true")) {
+      ControllerData->set_tcfit_autoapply(STATE_ENABLED);
+    } else if (parameters.equals("false")) {
+      ControllerData->set_tcfit_autoapply(STATE_DISABLED);
+    }
+    send_apianswer("action", String((ControllerData->get_tcfit_autoapply() == STATE_ENABLED) ? "true" : "false"));
+    return;
+  }
+
   _ALPACA_ServerTransactionID++;
   _ALPACA_ErrorNumber = 1036;
   _ALPACA_ErrorMessage = "Action not implemented";
@@ -1761,7 +1826,7 @@ void ALPACA_SERVER::get_supportedactions() {
   // add transaction ID's
   jsonretstr = "{ " + addclientinfo(jsonretstr);
   // add supported actions
-  jsonretstr += ", \"Value\": [ \"absolute\", \"ismoving\", \"maxstep\", \"maxincrement\", \"position\", \"stepsize\", \"tempcomp\", \"tempcompavailable\", \"temperature\", \"move\", \"halt\" ] }";
+  jsonretstr += ", \"Value\": [ \"absolute\", \"ismoving\", \"maxstep\", \"maxincrement\", \"position\", \"stepsize\", \"tempcomp\", \"tempcompavailable\", \"temperature\", \"move\", \"halt\", \"tcfit\", \"tcfitautoapply\" ] }";
   AlpacaMsgPrint("supportedactions: ");
   AlpacaMsgPrintln(jsonretstr);
   send_reply(HTML_WEBPAGE, JSONAPPTYPE, jsonretstr);
@@ -19,6 +19,7 @@
 
 // Required for ALPACA DISCOVERY PROTOCOL
 #include <WiFiUdp.h>
+#include "page_arena.h"
 
 
 //---------------------------------------------------
@@ -31,6 +32,7 @@ public:
   bool start(void);
   void stop(void);
   void loop(void);
+  void restart_discovery(void);
 
   void get_home(void);
   void get_focusersetup(void);
@@ -84,7 +86,7 @@ private:
   String addclientinfo(String);
   void check_Alpaca_Discovery(void);
   void getURLParameters(void);
-  void sendmycontent(String);
+  void sendmycontent(PAGE_ARENA &);
   void sendmyheader(void);
   void send_reply(int, String, String);
   void send_setup(void);
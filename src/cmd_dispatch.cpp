@@ -0,0 +1,1145 @@
+// -------------------------------------------------------
+// myFP2ESP8266 COMMAND DISPATCHER
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// Copyright Holger M, 2019-2021. All Rights Reserved.
+// cmd_dispatch.cpp
+// Shared by TCPIP_SERVER and LOCAL_SERIAL
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <avr/pgmspace.h>
+#include "config.h"
+#include <FS.h>
+#include <LittleFS.h>
+#include "cmd_dispatch.h"
+
+
+// -------------------------------------------------------
+// DEBUGGING
+// WARNING: DO NOT ENABLE DEBUGGING INFORMATION
+// APPS USING LOCALSERIAL WILL DISCONNECT IF YOU DO THIS
+// -------------------------------------------------------
+// Remove comment to enable dispatcher messages to be
+// written to Serial port
+//#define CMD_MsgPrint 1
+
+#ifdef CMD_MsgPrint
+#define CmdMsgPrint(...) Serial.print(__VA_ARGS__)
+#define CmdMsgPrintln(...) Serial.println(__VA_ARGS__)
+#else
+#define CmdMsgPrint(...)
+#define CmdMsgPrintln(...)
+#endif
+
+
+// -------------------------------------------------------
+// EXTERN CLASSES
+// -------------------------------------------------------
+// ControllerData
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+// Driver board
+#include "driver_board.h"
+extern DRIVER_BOARD *driverboard;
+
+// MANAGEMENT server
+#include "management_server.h"
+extern MANAGEMENT_SERVER *mngsrvr;
+
+#include "tc_fit.h"
+extern TC_FIT *tcfit;
+
+#include "heap_stats.h"
+extern HEAP_STATS *heapstats;
+
+
+// -------------------------------------------------------
+// EXTERN METHODS
+// -------------------------------------------------------
+extern void display_off(void);
+extern void display_on(void);
+extern bool start_alpacaserver(void);
+extern void stop_alpacaserver(void);
+extern bool start_webserver(void);
+extern void stop_webserver(void);
+
+
+// -------------------------------------------------------
+// EXTERNS SETTINGS
+// -------------------------------------------------------
+extern int _display_type;
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// bytes read from a file per reply chunk
+#define CMD_FILECHUNK 128
+
+
+// -------------------------------------------------------
+// REPLY SINK
+// -------------------------------------------------------
+// Transports without binary framing never set _binary
+void REPLY_SINK::send_binary(const uint8_t *data, size_t len) {
+  (void)data;
+  (void)len;
+}
+
+// Send token and value bytes as a binary reply
+void REPLY_SINK::reply_binary(const char token, const void *data, size_t len) {
+  uint8_t buff[BUFFER64LEN];
+  len = (len > (sizeof(buff) - 1)) ? (sizeof(buff) - 1) : len;
+  buff[0] = (uint8_t)token;
+  memcpy(&buff[1], data, len);
+  send_binary(buff, len + 1);
+}
+
+// Build a bool reply to a client
+void REPLY_SINK::build_reply(const char token, bool state) {
+  if (_binary == true) {
+    uint8_t val = (state == false) ? 0 : 1;
+    reply_binary(token, &val, sizeof(val));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%c%i%c", token, (state == false) ? 0 : 1, CMD_EOC);
+  send_reply(buff);
+}
+
+// Build a char array reply to a client
+void REPLY_SINK::build_reply(const char token, const char *str) {
+  if (_binary == true) {
+    reply_binary(token, str, strlen(str));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%c%s%c", token, str, CMD_EOC);
+  send_reply(buff);
+}
+
+// Build a unsigned char reply to a client
+void REPLY_SINK::build_reply(const char token, unsigned char data_val) {
+  if (_binary == true) {
+    reply_binary(token, &data_val, sizeof(data_val));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%c%u%c", token, data_val, CMD_EOC);
+  send_reply(buff);
+}
+
+// Build a float reply to a client
+void REPLY_SINK::build_reply(const char token, float data_val, int decimalplaces) {
+  if (_binary == true) {
+    reply_binary(token, &data_val, sizeof(data_val));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  char tmp[BUFFER16LEN];
+  // same format as String(data_val, decimalplaces), Eric T, Nov 2024
+  dtostrf(data_val, (decimalplaces + 2), decimalplaces, tmp);
+  snprintf(buff, sizeof(buff), "%c%s%c", token, tmp, CMD_EOC);
+  send_reply(buff);
+}
+
+// Build a integer reply to a client
+void REPLY_SINK::build_reply(const char token, int data_val) {
+  if (_binary == true) {
+    reply_binary(token, &data_val, sizeof(data_val));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%c%i%c", token, data_val, CMD_EOC);
+  send_reply(buff);
+}
+
+// Build a long reply to a client
+void REPLY_SINK::build_reply(const char token, long data_val) {
+  if (_binary == true) {
+    reply_binary(token, &data_val, sizeof(data_val));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%c%ld%c", token, data_val, CMD_EOC);
+  send_reply(buff);
+}
+
+// Build a unsigned long reply to a client
+void REPLY_SINK::build_reply(const char token, unsigned long data_val) {
+  if (_binary == true) {
+    reply_binary(token, &data_val, sizeof(data_val));
+    return;
+  }
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%c%lu%c", token, data_val, CMD_EOC);
+  send_reply(buff);
+}
+
+
+// -------------------------------------------------------
+// SHARED HANDLERS
+// -------------------------------------------------------
+// Set command not supported on esp8266
+static void cmd_none(cmd_context &c) {
+  (void)c;
+}
+
+// Get command not supported on esp8266
+static void cmd_rtoken_zero(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, 0);
+}
+
+// Send a config file, read in chunks, no copy on the heap
+// The reply is the token followed by the file, no #
+static void cmd_send_file(cmd_context &c, const char *fname) {
+  File dfile = LittleFS.open(fname, "r");
+  if (!dfile) {
+    c.sink.build_reply(CMD_RTOKEN, 0);
+    return;
+  }
+  char buff[CMD_FILECHUNK + 1];
+  buff[0] = CMD_RTOKEN;
+  buff[1] = 0x00;
+  c.sink.send_reply(buff);
+  while (dfile.available()) {
+    size_t len = dfile.read((uint8_t *)buff, CMD_FILECHUNK);
+    buff[len] = 0x00;
+    c.sink.send_reply(buff);
+  }
+  dfile.close();
+}
+
+
+// -------------------------------------------------------
+// COMMAND HANDLERS
+// -------------------------------------------------------
+// :00 Get focuser position
+static void cmd_getposition(cmd_context &c) {
+  c.sink.build_reply('P', driverboard->getposition());
+}
+
+// :01 ismoving
+static void cmd_ismoving(cmd_context &c) {
+  c.sink.build_reply('I', isMoving);
+}
+
+// :02 Get controller status
+static void cmd_status(cmd_context &c) {
+  c.sink.build_reply('E', "OK");
+}
+
+// :03 Get firmware version, also used by INDI
+static void cmd_getversion(cmd_context &c) {
+  c.sink.build_reply('F', major_version);
+}
+
+// :04 Get board name and major version
+static void cmd_getbrdversion(cmd_context &c) {
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%.19s%c%c%s", ControllerData->get_brdname(), '\r', '\n', major_version);
+  c.sink.build_reply('F', buff);
+}
+
+// :05xxxxxx Set new target position to xxxxxx (and
+// focuser initiates immediate move to xxxxxx)
+static void cmd_settarget(cmd_context &c) {
+  RangeCheck(&c.lval, 0L, ControllerData->get_maxstep());
+  ftargetPosition = c.lval;
+  isMoving = true;
+}
+
+// :06 Get temperature
+static void cmd_gettemp(cmd_context &c) {
+  c.sink.build_reply('Z', temp, 3);
+}
+
+// :07 Set maxStep, must be above the focuser position
+static void cmd_setmaxstep(cmd_context &c) {
+  RangeCheck(&c.lval, driverboard->getposition() + 1, (long)FOCUSERUPPERLIMIT);
+  ControllerData->set_maxstep(c.lval);
+}
+
+// :08 Get maxStep
+static void cmd_getmaxstep(cmd_context &c) {
+  c.sink.build_reply('M', ControllerData->get_maxstep());
+}
+
+// :10 Get maxIncrement
+static void cmd_getmaxincrement(cmd_context &c) {
+  c.sink.build_reply('Y', ControllerData->get_maxstep());
+}
+
+// :11 Get coil power
+static void cmd_getcoilpower(cmd_context &c) {
+  c.sink.build_reply('O', ControllerData->get_coilpower_enable());
+}
+
+// :12 Set coil power enable
+static void cmd_setcoilpower(cmd_context &c) {
+  if (c.lval == 0) {
+    ControllerData->set_coilpower_enable(STATE_DISABLED);
+    driverboard->releasemotor();
+  } else {
+    ControllerData->set_coilpower_enable(STATE_ENABLED);
+    driverboard->enablemotor();
+  }
+}
+
+// :13 Get reverse direction setting, 00 off, 01 on
+static void cmd_getreverse(cmd_context &c) {
+  c.sink.build_reply('R', ControllerData->get_reverse_enable());
+}
+
+// :14 Set reverse direction
+static void cmd_setreverse(cmd_context &c) {
+  (c.lval == 0) ? ControllerData->set_reverse_enable(STATE_DISABLED) : ControllerData->set_reverse_enable(STATE_ENABLED);
+}
+
+// :15 Set motor speed
+static void cmd_setmotorspeed(cmd_context &c) {
+  ControllerData->set_motorspeed((byte)c.lval);
+}
+
+// :16 Set display to celsius
+static void cmd_setcelsius(cmd_context &c) {
+  (void)c;
+  ControllerData->set_tempmode(CELSIUS);
+}
+
+// :17 Set display to fahrenheit
+static void cmd_setfahrenheit(cmd_context &c) {
+  (void)c;
+  ControllerData->set_tempmode(FAHRENHEIT);
+}
+
+// :19 Set the step size value - double type, eg 2.1
+static void cmd_setstepsize(cmd_context &c) {
+  RangeCheck(&c.fval, MINIMUMSTEPSIZE, MAXIMUMSTEPSIZE);
+  ControllerData->set_stepsize(c.fval);
+}
+
+// :20 Set temp probe resolution, 9-12 bits
+static void cmd_settempresolution(cmd_context &c) {
+  ControllerData->set_tempresolution((byte)c.lval);
+}
+
+// :21 Get temp probe resolution
+static void cmd_gettempresolution(cmd_context &c) {
+  c.sink.build_reply('Q', ControllerData->get_tempresolution());
+}
+
+// :22 Set temperature coefficient steps value to xxx
+static void cmd_settempcoefficient(cmd_context &c) {
+  ControllerData->set_tempcoefficient((int)c.lval);
+}
+
+// :23 Set enable tempcomp
+static void cmd_settempcomp(cmd_context &c) {
+  if (tempcomp_available == STATE_ENABLED) {
+    (c.lval == 1) ? tempcomp_state = STATE_ENABLED : tempcomp_state = STATE_DISABLED;
+  } else {
+    tempcomp_state = STATE_DISABLED;
+    tempcomp_available = STATE_DISABLED;
+  }
+}
+
+// :24 Get status of temperature compensation
+static void cmd_gettempcomp(cmd_context &c) {
+  c.sink.build_reply('1', tempcomp_state);
+}
+
+// :25 Get temperature compensation available
+static void cmd_gettempcompavailable(cmd_context &c) {
+  c.sink.build_reply('A', tempcomp_available);
+}
+
+// :26 Get temperature coefficient steps/degree
+static void cmd_gettempcoefficient(cmd_context &c) {
+  c.sink.build_reply('B', ControllerData->get_tempcoefficient());
+}
+
+// :27 stop a move - like a Halt
+static void cmd_halt(cmd_context &c) {
+  (void)c;
+  halt_alert = true;
+}
+
+// :28 home the motor to position 0
+static void cmd_home(cmd_context &c) {
+  (void)c;
+  ftargetPosition = 0;
+  isMoving = true;
+}
+
+// :29 Get stepmode
+static void cmd_getstepmode(cmd_context &c) {
+  c.sink.build_reply('S', ControllerData->get_brdstepmode());
+}
+
+// :30 Set step mode
+// DRIVER_BOARD->setstepmode(xx); // sets physical pins
+// ControllerData->set_brdstepmode(xx);  // saves stepmode
+static void cmd_setstepmode(cmd_context &c) {
+  int ival = (int)c.lval;
+  int brdnum = ControllerData->get_brdnumber();
+  if (brdnum == PRO2EULN2003 || brdnum == PRO2EL298N || brdnum == PRO2EL293DMINI || brdnum == PRO2EL9110S) {
+    RangeCheck(&ival, 1, 2);
+  } else if (brdnum == WEMOSDRV8825 || brdnum == PRO2EDRV8825) {
+    // stepmode is set by jumpers
+    ival = (int)ControllerData->get_brdfixedstepmode();
+  } else if (brdnum == PRO2EL293DNEMA || brdnum == PRO2EL293D28BYJ48) {
+    ival = STEP1;
+  }
+  ControllerData->set_brdstepmode(ival);
+  driverboard->setstepmode(ival);
+}
+
+// :31 Set focuser position
+static void cmd_setposition(cmd_context &c) {
+  RangeCheck(&c.lval, 0L, ControllerData->get_maxstep());
+  ftargetPosition = c.lval;
+  driverboard->setposition(c.lval);
+  ControllerData->set_fposition(c.lval);
+}
+
+// :32 Get if stepsize is enabled, esp8266 always enabled
+static void cmd_getstepsizeenable(cmd_context &c) {
+  c.sink.build_reply('U', 1);
+}
+
+// :33 Get stepsize
+static void cmd_getstepsize(cmd_context &c) {
+  c.sink.build_reply('T', ControllerData->get_stepsize(), 2);
+}
+
+// :34 Get the time that a display page is shown for
+// serial apps expect milliseconds, network apps seconds
+static void cmd_getpagetime(cmd_context &c) {
+  if (c.transport == CMD_SERIAL) {
+    c.sink.build_reply('X', (long)(DISPLAYPAGETIME * 1000));
+  } else {
+    c.sink.build_reply('X', DISPLAYPAGETIME);
+  }
+}
+
+// :36 Disable (0) or Enable (1) Display
+static void cmd_setdisplayenable(cmd_context &c) {
+  if (c.lval == 1) {
+    ControllerData->set_display_enable(STATE_ENABLED);
+  } else {
+    ControllerData->set_display_enable(STATE_DISABLED);
+  }
+  if (display_found == true) {
+    (ControllerData->get_display_enable() == true) ? display_on() : display_off();
+  }
+}
+
+// :37 Get display enable status
+static void cmd_getdisplayenable(cmd_context &c) {
+  c.sink.build_reply('D', ControllerData->get_display_enable());
+}
+
+// :38 Get temperature mode 1=Celsius, 0=Fahrenheit
+static void cmd_gettempmode(cmd_context &c) {
+  c.sink.build_reply('b', ControllerData->get_tempmode());
+}
+
+// :39 Get the new motor position (target) XXXXXX
+static void cmd_gettarget(cmd_context &c) {
+  c.sink.build_reply('N', ftargetPosition);
+}
+
+// :40 reboot controller with 2s delay
+static void cmd_reboot(cmd_context &c) {
+  (void)c;
+  software_Reboot(2000);
+}
+
+// :42 reset focuser defaults
+static void cmd_setdefaults(cmd_context &c) {
+  (void)c;
+  ControllerData->SetFocuserDefaults();
+  ftargetPosition = ControllerData->get_fposition();
+  driverboard->setposition(ftargetPosition);
+  ControllerData->set_fposition(ftargetPosition);
+}
+
+// :43 Get motorspeed
+static void cmd_getmotorspeed(cmd_context &c) {
+  c.sink.build_reply('C', ControllerData->get_motorspeed());
+}
+
+// :44 Get Powerdown enable state
+static void cmd_getpowerdownenable(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_powerdown_enable());
+}
+
+// :45 Set PowerDown enable state
+static void cmd_setpowerdownenable(cmd_context &c) {
+  (c.lval == 0) ? ControllerData->set_powerdown_enable(false) : ControllerData->set_powerdown_enable(true);
+}
+
+// :48 save settings to file
+static void cmd_savesettings(cmd_context &c) {
+  (void)c;
+  // need to save position setting
+  ControllerData->set_fposition(driverboard->getposition());
+  // save the focuser settings immediately
+  ControllerData->SaveNow(driverboard->getposition(), driverboard->getdirection());
+}
+
+// :49 aXXXXX
+static void cmd_getcode(cmd_context &c) {
+  c.sink.build_reply('a', "b552efd");
+}
+
+// :50 Get if Home Position Switch enabled
+static void cmd_gethpswenable(cmd_context &c) {
+  c.sink.build_reply('l', 0);
+}
+
+// :51 Get Wifi Controller IP Address
+static void cmd_getipaddress(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ipStr);
+}
+
+// :52 Get PowerDown state
+static void cmd_getpowerdown(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, c.pdstatus);
+}
+
+// :54 Controller SSID
+static void cmd_getssid(cmd_context &c) {
+  if (c.transport == CMD_SERIAL) {
+    c.sink.build_reply('g', "SERIAL");
+  } else {
+    c.sink.build_reply(CMD_RTOKEN, mySSID);
+  }
+}
+
+// :55 Get motorspeed delay for current speed setting
+static void cmd_getmsdelay(cmd_context &c) {
+  c.sink.build_reply('0', ControllerData->get_brdmsdelay());
+}
+
+// :56 Set motorspeed delay
+static void cmd_setmsdelay(cmd_context &c) {
+  ControllerData->set_brdmsdelay((unsigned long)c.lval);
+}
+
+// :59 Get powerdown time
+static void cmd_getpowerdowntime(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_powerdown_time());
+}
+
+// :60 Set powerdown time interval in seconds (30-120)
+static void cmd_setpowerdowntime(cmd_context &c) {
+  ControllerData->set_powerdown_time((int)c.lval);
+}
+
+// :61 Set update of position on display when moving
+static void cmd_setupdateonmove(cmd_context &c) {
+  (c.lval == 0) ? ControllerData->set_display_updateonmove(STATE_DISABLED) : ControllerData->set_display_updateonmove(STATE_ENABLED);
+}
+
+// :62 Get update of position on display when moving
+static void cmd_getupdateonmove(cmd_context &c) {
+  c.sink.build_reply('L', ControllerData->get_display_updateonmove());
+}
+
+// :63 Get status of home position switch
+static void cmd_gethpsw(cmd_context &c) {
+  c.sink.build_reply('H', 0);
+}
+
+// :64 move a specified number of steps
+static void cmd_moverelative(cmd_context &c) {
+  long lval = c.lval + driverboard->getposition();
+  RangeCheck(&lval, 0L, ControllerData->get_maxstep());
+  ftargetPosition = lval;
+  isMoving = true;
+}
+
+// :66 Get jogging state enabled/disabled
+static void cmd_getjogging(cmd_context &c) {
+  c.sink.build_reply('K', 0);
+}
+
+// :68 Get jogging direction, 0=IN, 1=OUT
+static void cmd_getjoggingdir(cmd_context &c) {
+  c.sink.build_reply('V', 0);
+}
+
+// :69 Get push button steps
+static void cmd_getpbsteps(cmd_context &c) {
+  c.sink.build_reply('?', 1);
+}
+
+// :71 Set delayaftermove time value in milliseconds
+static void cmd_setdam(cmd_context &c) {
+  ControllerData->set_delayaftermove_time((byte)c.lval);
+}
+
+// :72 Get delayaftermove time value in milliseconds
+static void cmd_getdam(cmd_context &c) {
+  c.sink.build_reply('3', ControllerData->get_delayaftermove_time());
+}
+
+// :74 Get backlash in enabled status, if steps in > 0
+static void cmd_getblinenable(cmd_context &c) {
+  c.sink.build_reply('4', (ControllerData->get_backlashsteps_in() > 0) ? 1 : 0);
+}
+
+// :76 Get backlash OUT enabled status, if steps out > 0
+static void cmd_getbloutenable(cmd_context &c) {
+  c.sink.build_reply('4', (ControllerData->get_backlashsteps_out() > 0) ? 1 : 0);
+}
+
+// :77 Set backlash in steps [0-255]
+static void cmd_setblin(cmd_context &c) {
+  ControllerData->set_backlashsteps_in((byte)c.lval);
+}
+
+// :78 Get backlash steps IN
+static void cmd_getblin(cmd_context &c) {
+  c.sink.build_reply('6', ControllerData->get_backlashsteps_in());
+}
+
+// :79 Set backlash OUT steps [0-255]
+static void cmd_setblout(cmd_context &c) {
+  ControllerData->set_backlashsteps_out((byte)c.lval);
+}
+
+// :80 Get backlash steps OUT
+static void cmd_getblout(cmd_context &c) {
+  c.sink.build_reply('7', ControllerData->get_backlashsteps_out());
+}
+
+// :81 Get STALL_VALUE (for TMC2209 stepper modules)
+static void cmd_getstall(cmd_context &c) {
+  c.sink.build_reply('8', 0);
+}
+
+// :83 Get if there is a temperature probe
+static void cmd_gettempprobe(cmd_context &c) {
+  c.sink.build_reply('c', tempprobe_found);
+}
+
+// :85 Get delay after move enable state
+// esp8266 - enabled if dam-time is non 0
+static void cmd_getdamenable(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, (ControllerData->get_delayaftermove_time() > 0) ? 1 : 0);
+}
+
+// :87 Get tc direction
+static void cmd_gettcdirection(cmd_context &c) {
+  c.sink.build_reply((c.transport == CMD_SERIAL) ? 'c' : 'k', ControllerData->get_tcdirection());
+}
+
+// :88 Set tc direction
+static void cmd_settcdirection(cmd_context &c) {
+  (c.lval == 0) ? ControllerData->set_tcdirection(STATE_DISABLED) : ControllerData->set_tcdirection(STATE_ENABLED);
+}
+
+// :89 Get stepper power
+static void cmd_getstepperpower(cmd_context &c) {
+  c.sink.build_reply('9', 1);
+}
+
+// :92 Set display page display option (6 pgs)
+static void cmd_setpageoption(cmd_context &c) {
+  char pgopt[BUFFER8LEN];
+  const char *args = c.args;
+  // If empty (no args) - fill with default display string
+  if (args[0] == 0x00) {
+    args = "111111";
+  }
+  // if display option length less than 6 then pad with
+  // leading 0's, do not allow display strings that exceed
+  // length of buffer (0-5, 6 digits)
+  int len = strnlen(args, 6);
+  memset(pgopt, '0', 6 - len);
+  memcpy(pgopt + (6 - len), args, len);
+  pgopt[6] = 0x00;
+  ControllerData->set_display_pageoption(pgopt);
+}
+
+// :93 Get display page option, string of 01's, 6 digits
+static void cmd_getpageoption(cmd_context &c) {
+  c.sink.build_reply('l', ControllerData->get_display_pageoption());
+}
+
+// :94 Get TMC Interpolation state (network)
+// Set DelayedDisplayUpdate (serial)
+static void cmd_94(cmd_context &c) {
+  if (c.transport != CMD_SERIAL) {
+    c.sink.build_reply('n', 0);
+  }
+}
+
+// :95 Set TMC Interpolation state (network)
+// Get DelayedDisplayUpdate (serial)
+static void cmd_95(cmd_context &c) {
+  if (c.transport == CMD_SERIAL) {
+    c.sink.build_reply('n', 0);
+  }
+}
+
+// :96 Get firmware Major version, Minor Version
+static void cmd_getversions(cmd_context &c) {
+  char buff[BUFFER32LEN];
+  snprintf(buff, sizeof(buff), "%s,%s", major_version, minor_version);
+  c.sink.build_reply('F', buff);
+}
+
+// :97 Get Display Type, NONE=0, 1=TEXT, 2=LILYGO, 3=GRAPHIC
+static void cmd_getdisplaytype(cmd_context &c) {
+  c.sink.build_reply('n', _display_type);
+}
+
+// :98 Get network strength dbm
+static void cmd_getrssi(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, getrssi());
+}
+
+// :A4 Get temp probe enabled state
+static void cmd_gettempprobeenable(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_tempprobe_enable());
+}
+
+// :A5 Set temp probe enabled state
+static void cmd_settempprobeenable(cmd_context &c) {
+  (c.lval == 0) ? ControllerData->set_tempprobe_enable(STATE_DISABLED) : ControllerData->set_tempprobe_enable(STATE_ENABLED);
+}
+
+// :A6 Get ALPACA Server enabled state
+static void cmd_getalpacaenable(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_alpacasrvr_enable());
+}
+
+// :A7 Set ALPACA Server enabled state
+static void cmd_setalpacaenable(cmd_context &c) {
+  if (c.lval == 0) {
+    ControllerData->set_alpacasrvr_enable(STATE_DISABLED);
+    if (alpacasrvr_status) {
+      // stop and disable
+      stop_alpacaserver();
+    }
+    alpacasrvr_status = STATUS_STOPPED;
+  } else {
+    ControllerData->set_alpacasrvr_enable(STATE_ENABLED);
+  }
+}
+
+// :A8 Get ALPACA Server Start/Stop status
+static void cmd_getalpacastatus(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, alpacasrvr_status);
+}
+
+// :A9 Set ALPACA Server Start/Stop
+static void cmd_setalpacastatus(cmd_context &c) {
+  if (c.lval == 0) {
+    // stop the alpaca server
+    if (alpacasrvr_status == STATUS_RUNNING) {
+      stop_alpacaserver();
+    }
+    alpacasrvr_status = STATUS_STOPPED;
+  } else {
+    // start alpaca server
+    if (ControllerData->get_alpacasrvr_enable() == STATE_ENABLED) {
+      alpacasrvr_status = start_alpacaserver();
+      if (alpacasrvr_status == STATUS_STOPPED) {
+        CmdMsgPrintln("E:cmd:A9:alpaca!start");
+      }
+    }
+  }
+}
+
+// :B0 Get Web Server enabled state
+static void cmd_getwebenable(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_websrvr_enable());
+}
+
+// :B1 Set Web Server enabled state
+static void cmd_setwebenable(cmd_context &c) {
+  if (c.lval == 0) {
+    if (websrvr_status == STATUS_RUNNING) {
+      stop_webserver();
+    }
+    websrvr_status = STATUS_STOPPED;
+    ControllerData->set_websrvr_enable(STATE_DISABLED);
+  } else {
+    ControllerData->set_websrvr_enable(STATE_ENABLED);
+  }
+}
+
+// :B2 Get Web Server Start/Stop status
+static void cmd_getwebstatus(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, websrvr_status);
+}
+
+// :B3 Set Web Server Start/Stop
+static void cmd_setwebstatus(cmd_context &c) {
+  if (c.lval == 0) {
+    if (websrvr_status == STATUS_RUNNING) {
+      stop_webserver();
+    }
+    websrvr_status = STATUS_STOPPED;
+  } else {
+    // start, check enable
+    if (ControllerData->get_websrvr_enable() == STATE_ENABLED) {
+      // enabled, then start
+      websrvr_status = start_webserver();
+      if (websrvr_status == STATUS_STOPPED) {
+        CmdMsgPrintln("E:cmd:B3:wsrvr!start");
+      }
+    }
+  }
+}
+
+// :B4 Get Management Server enabled state
+static void cmd_getmngenable(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_mngsrvr_enable());
+}
+
+// :B5 Set Management Server enabled state
+static void cmd_setmngenable(cmd_context &c) {
+  if (c.lval == 0) {
+    if (mngsrvr_status == STATUS_RUNNING) {
+      // stop the server first
+      mngsrvr->stop();
+      mngsrvr_status = STATUS_STOPPED;
+    }
+    ControllerData->set_mngsrvr_enable(STATE_DISABLED);
+  } else {
+    ControllerData->set_mngsrvr_enable(STATE_ENABLED);
+  }
+}
+
+// :B6 Get Management Server Start/Stop status
+static void cmd_getmngstatus(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, mngsrvr_status);
+}
+
+// :B7 Set Start/Stop Management Server
+static void cmd_setmngstatus(cmd_context &c) {
+  if (c.lval == 0) {
+    if (mngsrvr_status == STATUS_RUNNING) {
+      mngsrvr->stop();
+    }
+    mngsrvr_status = STATUS_STOPPED;
+  } else {
+    // start
+    if (ControllerData->get_mngsrvr_enable() == STATE_ENABLED) {
+      mngsrvr_status = mngsrvr->start();
+      if (mngsrvr_status == STATUS_STOPPED) {
+        CmdMsgPrintln("E:cmd:B7:mngsrvr!start");
+      }
+    }
+  }
+}
+
+// :B8 Get cntlr_config.jsn
+static void cmd_getcntlrconfig(cmd_context &c) {
+  cmd_send_file(c, "/cntlr_config.jsn");
+}
+
+// :B9 Get board_config.jsn
+static void cmd_getboardconfig(cmd_context &c) {
+  cmd_send_file(c, "/board_config.jsn");
+}
+
+// :C4 Get brightness level (0=off, 255=max)
+static void cmd_getbrightness(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, 255);
+}
+
+// :C6xxxxxx Set serial port speed, :C6 gets the speed
+// The reply is sent at the old speed, then the port
+// changes, $0# if the speed is not supported
+static void cmd_serialspeed(cmd_context &c) {
+  c.sink.build_reply(CMD_RTOKEN, serialserver_speed((unsigned long)c.lval));
+}
+
+// :C7x Set camera idle, 0=exposing 1=idle, :C7 gets it
+// Temp comp moves are held back while the camera exposes
+static void cmd_cameraidle(cmd_context &c) {
+  if (c.args[0] != 0x00) {
+    camera_idle = (c.lval != 0);
+  }
+  c.sink.build_reply(CMD_RTOKEN, camera_idle);
+}
+
+// :C8 Get temp coefficient fit, slope,confidence,count
+// :C80 clears the fit
+static void cmd_tcfit(cmd_context &c) {
+  char buff[TCFIT_SUMMARYLEN];
+
+  if ((c.args[0] != 0x00) && (c.lval == 0)) {
+    tcfit->clear();
+  }
+  tcfit->get_summary(buff, sizeof(buff));
+  c.sink.build_reply(CMD_RTOKEN, buff);
+}
+
+// :C9x Set temp coefficient fit auto apply, 0=off 1=on
+// :C9 gets it
+static void cmd_tcfitauto(cmd_context &c) {
+  if (c.args[0] != 0x00) {
+    ControllerData->set_tcfit_autoapply((c.lval == 0) ? STATE_DISABLED : STATE_ENABLED);
+  }
+  c.sink.build_reply(CMD_RTOKEN, ControllerData->get_tcfit_autoapply());
+}
+
+// :D0 Get heap statistics, free,maxblock,frag,minfree,stack
+// :D00 restarts the lowest free heap and the counters
+static void cmd_heapstats(cmd_context &c) {
+  char buff[HEAP_SUMMARYLEN];
+
+  if ((c.args[0] != 0x00) && (c.lval == 0)) {
+    heapstats->reset();
+  }
+  heapstats->get_summary(buff, sizeof(buff));
+  c.sink.build_reply(CMD_RTOKEN, buff);
+}
+
+
+// -------------------------------------------------------
+// OPCODE TABLE
+// Indexed by opcode, kept in flash. An entry gives the
+// handler, how its argument is parsed, the limits for an
+// ARG_RANGE argument, and when the command is ignored
+// -------------------------------------------------------
+#define NM  CMD_NOTMOVING
+#define NET CMD_NETWORK
+#define LCL CMD_LOCAL
+
+static constexpr cmd_entry cmd_table[CMD_COUNT] PROGMEM = {
+  { cmd_getposition,          0, ARG_NONE,  0,   0, 0 },
+  { cmd_ismoving,             1, ARG_NONE,  0,   0, 0 },
+  { cmd_status,               2, ARG_NONE,  0,   0, 0 },
+  { cmd_getversion,           3, ARG_NONE,  0,   0, 0 },
+  { cmd_getbrdversion,        4, ARG_NONE,  0,   0, 0 },
+  { cmd_settarget,            5, ARG_LONG,  NM,  0, 0 },
+  { cmd_gettemp,              6, ARG_NONE,  0,   0, 0 },
+  { cmd_setmaxstep,           7, ARG_LONG,  0,   0, 0 },
+  { cmd_getmaxstep,           8, ARG_NONE,  0,   0, 0 },
+  { cmd_rtoken_zero,          9, ARG_NONE,  0,   0, 0 },  // inoutledmode
+  { cmd_getmaxincrement,     10, ARG_NONE,  0,   0, 0 },
+  { cmd_getcoilpower,        11, ARG_NONE,  0,   0, 0 },
+  { cmd_setcoilpower,        12, ARG_LONG,  0,   0, 0 },
+  { cmd_getreverse,          13, ARG_NONE,  0,   0, 0 },
+  { cmd_setreverse,          14, ARG_LONG,  NM,  0, 0 },
+  { cmd_setmotorspeed,       15, ARG_RANGE, 0,   0, 2 },
+  { cmd_setcelsius,          16, ARG_NONE,  0,   0, 0 },
+  { cmd_setfahrenheit,       17, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                18, ARG_NONE,  0,   0, 0 },  // stepsize enable
+  { cmd_setstepsize,         19, ARG_FLOAT, 0,   0, 0 },
+  { cmd_settempresolution,   20, ARG_RANGE, 0,   9, 12 },
+  { cmd_gettempresolution,   21, ARG_NONE,  0,   0, 0 },
+  { cmd_settempcoefficient,  22, ARG_RANGE, 0,   0, 400 },
+  { cmd_settempcomp,         23, ARG_LONG,  0,   0, 0 },
+  { cmd_gettempcomp,         24, ARG_NONE,  0,   0, 0 },
+  { cmd_gettempcompavailable, 25, ARG_NONE, 0,   0, 0 },
+  { cmd_gettempcoefficient,  26, ARG_NONE,  0,   0, 0 },
+  { cmd_halt,                27, ARG_NONE,  0,   0, 0 },
+  { cmd_home,                28, ARG_NONE,  NM,  0, 0 },
+  { cmd_getstepmode,         29, ARG_NONE,  0,   0, 0 },
+  { cmd_setstepmode,         30, ARG_LONG,  0,   0, 0 },
+  { cmd_setposition,         31, ARG_LONG,  NM,  0, 0 },
+  { cmd_getstepsizeenable,   32, ARG_NONE,  0,   0, 0 },
+  { cmd_getstepsize,         33, ARG_NONE,  0,   0, 0 },
+  { cmd_getpagetime,         34, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                35, ARG_NONE,  0,   0, 0 },  // page time
+  { cmd_setdisplayenable,    36, ARG_LONG,  0,   0, 0 },
+  { cmd_getdisplayenable,    37, ARG_NONE,  0,   0, 0 },
+  { cmd_gettempmode,         38, ARG_NONE,  0,   0, 0 },
+  { cmd_gettarget,           39, ARG_NONE,  0,   0, 0 },
+  { cmd_reboot,              40, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                41, ARG_NONE,  0,   0, 0 },  // inoutledmode
+  { cmd_setdefaults,         42, ARG_NONE,  NM,  0, 0 },
+  { cmd_getmotorspeed,       43, ARG_NONE,  0,   0, 0 },
+  { cmd_getpowerdownenable,  44, ARG_NONE,  0,   0, 0 },
+  { cmd_setpowerdownenable,  45, ARG_LONG,  0,   0, 0 },
+  { cmd_rtoken_zero,         46, ARG_NONE,  0,   0, 0 },  // inout led
+  { cmd_none,                47, ARG_NONE,  0,   0, 0 },  // inout led
+  { cmd_savesettings,        48, ARG_NONE,  NM,  0, 0 },
+  { cmd_getcode,             49, ARG_NONE,  0,   0, 0 },
+  { cmd_gethpswenable,       50, ARG_NONE,  0,   0, 0 },
+  { cmd_getipaddress,        51, ARG_NONE,  0,   0, 0 },
+  { cmd_getpowerdown,        52, ARG_NONE,  0,   0, 0 },
+  { cmd_rtoken_zero,         53, ARG_NONE,  0,   0, 0 },  // display pages
+  { cmd_getssid,             54, ARG_NONE,  0,   0, 0 },
+  { cmd_getmsdelay,          55, ARG_NONE,  0,   0, 0 },
+  { cmd_setmsdelay,          56, ARG_RANGE, 0,   DEFAULT_MOTORSPEEDDELAYMIN, DEFAULT_MOTORSPEEDDELAYMAX },
+  { cmd_rtoken_zero,         57, ARG_NONE,  0,   0, 0 },  // pushbuttons
+  { cmd_none,                58, ARG_NONE,  0,   0, 0 },  // pushbuttons
+  { cmd_getpowerdowntime,    59, ARG_NONE,  0,   0, 0 },
+  { cmd_setpowerdowntime,    60, ARG_RANGE, 0,   30, 120 },
+  { cmd_setupdateonmove,     61, ARG_LONG,  0,   0, 0 },
+  { cmd_getupdateonmove,     62, ARG_NONE,  0,   0, 0 },
+  { cmd_gethpsw,             63, ARG_NONE,  0,   0, 0 },
+  { cmd_moverelative,        64, ARG_LONG,  NM,  0, 0 },
+  { cmd_none,                65, ARG_NONE,  0,   0, 0 },  // jogging
+  { cmd_getjogging,          66, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                67, ARG_NONE,  0,   0, 0 },  // jogging dir
+  { cmd_getjoggingdir,       68, ARG_NONE,  0,   0, 0 },
+  { cmd_getpbsteps,          69, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                70, ARG_NONE,  0,   0, 0 },  // pb steps
+  { cmd_setdam,              71, ARG_RANGE, 0,   0, 255 },
+  { cmd_getdam,              72, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                73, ARG_NONE,  0,   0, 0 },  // backlash in
+  { cmd_getblinenable,       74, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                75, ARG_NONE,  0,   0, 0 },  // backlash out
+  { cmd_getbloutenable,      76, ARG_NONE,  0,   0, 0 },
+  { cmd_setblin,             77, ARG_RANGE, 0,   0, 255 },
+  { cmd_getblin,             78, ARG_NONE,  0,   0, 0 },
+  { cmd_setblout,            79, ARG_RANGE, 0,   0, 255 },
+  { cmd_getblout,            80, ARG_NONE,  0,   0, 0 },
+  { cmd_getstall,            81, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                82, ARG_NONE,  0,   0, 0 },  // stall value
+  { cmd_gettempprobe,        83, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                84, ARG_NONE,  0,   0, 0 },  // myFP2N reserved
+  { cmd_getdamenable,        85, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                86, ARG_NONE,  0,   0, 0 },  // dam enable
+  { cmd_gettcdirection,      87, ARG_NONE,  0,   0, 0 },
+  { cmd_settcdirection,      88, ARG_LONG,  0,   0, 0 },
+  { cmd_getstepperpower,     89, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                90, ARG_NONE,  0,   0, 0 },  // presets
+  { cmd_rtoken_zero,         91, ARG_NONE,  0,   0, 0 },  // presets
+  { cmd_setpageoption,       92, ARG_STR,   0,   0, 0 },
+  { cmd_getpageoption,       93, ARG_NONE,  0,   0, 0 },
+  { cmd_94,                  94, ARG_NONE,  0,   0, 0 },
+  { cmd_95,                  95, ARG_NONE,  0,   0, 0 },
+  { cmd_getversions,         96, ARG_NONE,  0,   0, 0 },
+  { cmd_getdisplaytype,      97, ARG_NONE,  0,   0, 0 },
+  { cmd_getrssi,             98, ARG_NONE,  0,   0, 0 },
+  { cmd_none,                99, ARG_NONE,  0,   0, 0 },  // hpsw enable
+  // :A0 to :A9
+  { cmd_rtoken_zero,        100, ARG_NONE,  0,   0, 0 },  // joystick1
+  { cmd_none,               101, ARG_NONE,  0,   0, 0 },  // joystick1
+  { cmd_rtoken_zero,        102, ARG_NONE,  0,   0, 0 },  // joystick2
+  { cmd_none,               103, ARG_NONE,  0,   0, 0 },  // joystick2
+  { cmd_gettempprobeenable, 104, ARG_NONE,  0,   0, 0 },
+  { cmd_settempprobeenable, 105, ARG_LONG,  0,   0, 0 },
+  { cmd_getalpacaenable,    106, ARG_NONE,  0,   0, 0 },
+  { cmd_setalpacaenable,    107, ARG_LONG,  NET, 0, 0 },
+  { cmd_getalpacastatus,    108, ARG_NONE,  0,   0, 0 },
+  { cmd_setalpacastatus,    109, ARG_LONG,  NET, 0, 0 },
+  // :B0 to :B9
+  { cmd_getwebenable,       110, ARG_NONE,  0,   0, 0 },
+  { cmd_setwebenable,       111, ARG_LONG,  NET, 0, 0 },
+  { cmd_getwebstatus,       112, ARG_NONE,  0,   0, 0 },
+  { cmd_setwebstatus,       113, ARG_LONG,  NET, 0, 0 },
+  { cmd_getmngenable,       114, ARG_NONE,  0,   0, 0 },
+  { cmd_setmngenable,       115, ARG_LONG,  NET, 0, 0 },
+  { cmd_getmngstatus,       116, ARG_NONE,  0,   0, 0 },
+  { cmd_setmngstatus,       117, ARG_LONG,  NET, 0, 0 },
+  { cmd_getcntlrconfig,     118, ARG_NONE,  0,   0, 0 },
+  { cmd_getboardconfig,     119, ARG_NONE,  0,   0, 0 },
+  // :C0 to :C6
+  { cmd_rtoken_zero,        120, ARG_NONE,  NET, 0, 0 },  // OTA state
+  { cmd_none,               121, ARG_NONE,  0,   0, 0 },  // OTA state
+  { cmd_rtoken_zero,        122, ARG_NONE,  NET, 0, 0 },  // OTA status
+  { cmd_none,               123, ARG_NONE,  0,   0, 0 },  // OTA status
+  { cmd_getbrightness,      124, ARG_NONE,  NET, 0, 0 },
+  { cmd_none,               125, ARG_NONE,  0,   0, 0 },
+  { cmd_serialspeed,        126, ARG_LONG,  LCL, 0, 0 },
+  { cmd_cameraidle,         127, ARG_LONG,  0,   0, 0 },
+  { cmd_tcfit,              128, ARG_LONG,  0,   0, 0 },
+  { cmd_tcfitauto,          129, ARG_LONG,  0,   0, 0 },
+  // :D0
+  { cmd_heapstats,          130, ARG_LONG,  0,   0, 0 },
+};
+
+#undef NM
+#undef NET
+#undef LCL
+
+// the table index is the opcode
+static constexpr bool cmd_table_ordered(int i) {
+  return (i == CMD_COUNT) ? true : ((cmd_table[i].opcode == i) && cmd_table_ordered(i + 1));
+}
+static_assert(cmd_table_ordered(0), "cmd_table is not in opcode order");
+
+
+// -------------------------------------------------------
+// GET OPCODE
+// 2 chars, 00-99, A0-A9, B0-B9, C0-C9, D0
+// Returns -1 if there is no opcode
+// -------------------------------------------------------
+int cmd_opcode(const char *cmd) {
+  if (cmd[0] == 0x00) {
+    return -1;
+  }
+  if ((cmd[0] >= 'A') && (isdigit(cmd[1]) == 0)) {
+    return -1;
+  }
+  if (cmd[0] == 'A') {
+    return 100 + (cmd[1] - '0');  // only use digits A0-A9
+  } else if (cmd[0] == 'B') {
+    return 110 + (cmd[1] - '0');  // only use digits B0-B9
+  } else if (cmd[0] == 'C') {
+    return 120 + (cmd[1] - '0');  // only use digits C0-C9
+  } else if (cmd[0] == 'D') {
+    return (cmd[1] == '0') ? 130 : -1;  // only D0
+  }
+  char cmdstr[3] = { cmd[0], cmd[1], 0x00 };
+  return atoi(cmdstr);
+}
+
+
+// -------------------------------------------------------
+// DISPATCH A COMMAND
+// cmd is the command without : and #, the opcode is the
+// first 2 chars, the argument follows
+// -------------------------------------------------------
+void cmd_dispatch(REPLY_SINK &sink, byte transport, bool pdstatus, const char *cmd) {
+  int opcode = cmd_opcode(cmd);
+  if ((opcode < 0) || (opcode >= CMD_COUNT)) {
+    CmdMsgPrint("cmd err: ");
+    CmdMsgPrintln(opcode);
+    return;
+  }
+
+  cmd_entry entry;
+  memcpy_P(&entry, &cmd_table[opcode], sizeof(entry));
+
+  if (((entry.flags & CMD_NETWORK) != 0) && (transport == CMD_SERIAL)) {
+    return;
+  }
+  if (((entry.flags & CMD_LOCAL) != 0) && (transport != CMD_SERIAL)) {
+    return;
+  }
+  if (((entry.flags & CMD_NOTMOVING) != 0) && (isMoving == true)) {
+    return;
+  }
+
+  // argument follows the 2 char opcode
+  const char *args = (cmd[1] == 0x00) ? &cmd[1] : &cmd[2];
+  cmd_context c = { sink, transport, pdstatus, args, 0L, 0.0f };
+
+  switch (entry.argtype) {
+    case ARG_LONG:
+      c.lval = atol(args);
+      break;
+    case ARG_RANGE:
+      c.lval = atol(args);
+      RangeCheck(&c.lval, entry.min, entry.max);
+      break;
+    case ARG_FLOAT:
+      c.fval = (float)atof(args);
+      break;
+    default:
+      break;
+  }
+
+  entry.handler(c);
+}
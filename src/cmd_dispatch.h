@@ -0,0 +1,107 @@
+// -------------------------------------------------------
+// myFP2ESP8266 COMMAND DISPATCHER DEFINITIONS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// cmd_dispatch.h
+// Shared by TCPIP_SERVER and LOCAL_SERIAL
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _cmd_dispatch_h_
+#define _cmd_dispatch_h_
+
+#include <Arduino.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// transport that received the command
+#define CMD_TCPIP     0
+#define CMD_SERIAL    1
+
+// reply tokens
+#define CMD_EOC       '#'   // end of command or reply
+#define CMD_RTOKEN    '$'   // generic reply token
+#define CMD_STX       0x02  // start of a binary frame
+
+// argument type, parsed before the handler is called
+#define ARG_NONE      0     // no argument
+#define ARG_LONG      1     // integer, handler checks limits
+#define ARG_RANGE     2     // integer, clamped to min-max
+#define ARG_FLOAT     3     // float, handler checks limits
+#define ARG_STR       4     // handler parses the argument
+
+// command flags
+#define CMD_NOTMOVING 0x01  // ignored while focuser is moving
+#define CMD_NETWORK   0x02  // ignored when transport is serial
+#define CMD_LOCAL     0x04  // ignored when transport is network
+
+// opcodes 00-99, A0-A9 (100-109), B0-B9 (110-119),
+// C0-C9 (120-129), D0 (130)
+#define CMD_COUNT     131
+
+
+// -------------------------------------------------------
+// REPLY SINK
+// Implemented by each transport, send_reply() writes a
+// complete reply to the client
+// When _binary is set the build_reply() methods send the
+// token and the value as bytes to send_binary(): bool
+// and unsigned char as 1 byte, int, long, unsigned long
+// and float as 4 bytes little endian, char arrays as is
+// -------------------------------------------------------
+class REPLY_SINK {
+public:
+  virtual void send_reply(const char *) = 0;
+  virtual void send_binary(const uint8_t *, size_t);
+
+  void build_reply(const char, bool);
+  void build_reply(const char, const char *);
+  void build_reply(const char, unsigned char);
+  void build_reply(const char, float, int);
+  void build_reply(const char, int);
+  void build_reply(const char, long);
+  void build_reply(const char, unsigned long);
+
+protected:
+  bool _binary = false;
+
+private:
+  void reply_binary(const char, const void *, size_t);
+};
+
+
+// -------------------------------------------------------
+// COMMAND CONTEXT
+// Passed to each handler
+// -------------------------------------------------------
+typedef struct {
+  REPLY_SINK &sink;
+  byte transport;   // CMD_TCPIP or CMD_SERIAL
+  bool pdstatus;    // powerdown state
+  const char *args; // argument, after the 2 char opcode
+  long lval;        // ARG_LONG, ARG_RANGE
+  float fval;       // ARG_FLOAT
+} cmd_context;
+
+
+// -------------------------------------------------------
+// OPCODE TABLE ENTRY
+// -------------------------------------------------------
+typedef struct {
+  void (*handler)(cmd_context &);
+  byte opcode;      // must equal the table index
+  byte argtype;
+  byte flags;
+  long min;         // ARG_RANGE limits
+  long max;
+} cmd_entry;
+
+
+// -------------------------------------------------------
+// METHODS
+// -------------------------------------------------------
+int cmd_opcode(const char *);
+void cmd_dispatch(REPLY_SINK &, byte, bool, const char *);
+
+#endif
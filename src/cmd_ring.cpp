@@ -0,0 +1,145 @@
+// -------------------------------------------------------
+// myFP2ESP8266 SERIAL COMMAND RING CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// cmd_ring.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "cmd_ring.h"
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+CMD_RING::CMD_RING() {
+  _dropped = 0;
+  clear();
+}
+
+
+// -------------------------------------------------------
+// CLEAR
+// Discard all commands, including one in progress
+// -------------------------------------------------------
+void CMD_RING::clear(void) {
+  _head = 0;
+  _tail = 0;
+  _start = 0;
+  _wr = 0;
+  _used = 0;
+  _inframe = false;
+  _overflow = false;
+}
+
+
+// -------------------------------------------------------
+// PUT A RECEIVED BYTE
+// : starts a command, a partial command is discarded
+// # ends the command and publishes it
+// Bytes outside : and # are ignored
+// -------------------------------------------------------
+void CMD_RING::put(char inChar) {
+  uint16_t head = _head;
+
+  switch (inChar) {
+    case CMDRING_SOC:
+      _inframe = true;
+      _overflow = false;
+      // a command must fit before the end of the buffer,
+      // else it starts at 0 and the bytes to the end of
+      // the buffer are skipped
+      if ((CMDRING_SIZE - head) < (CMDRING_MAXCMD + 1)) {
+        _start = 0;
+        _used = CMDRING_SIZE - head;
+      } else {
+        _start = head;
+        _used = 0;
+      }
+      _wr = _start;
+      break;
+
+    case CMDRING_EOC:
+      if (_inframe == false) {
+        break;
+      }
+      _inframe = false;
+      // room for the '\0' terminator
+      if ((_overflow == true) || ((_used + 1) > ((_tail + CMDRING_SIZE - head - 1) % CMDRING_SIZE))) {
+        _dropped++;
+        break;
+      }
+      _buf[_wr] = '\0';
+      if (_start != head) {
+        _buf[head] = CMDRING_WRAP;
+      }
+      // publish only after the command bytes are written
+      _head = (_wr + 1) % CMDRING_SIZE;
+      break;
+
+    case CMDRING_WRAP:
+      break;
+
+    default:
+      if ((_inframe == false) || (_overflow == true)) {
+        break;
+      }
+      // too long, or no room before the oldest command,
+      // keep 1 byte for the '\0' terminator
+      if (((_wr - _start) >= CMDRING_MAXCMD) || ((_used + 2) > ((_tail + CMDRING_SIZE - head - 1) % CMDRING_SIZE))) {
+        _overflow = true;
+        break;
+      }
+      _buf[_wr++] = inChar;
+      _used++;
+      break;
+  }
+}
+
+
+// -------------------------------------------------------
+// IS A COMMAND AVAILABLE
+// -------------------------------------------------------
+bool CMD_RING::available(void) {
+  return (_tail != _head);
+}
+
+
+// -------------------------------------------------------
+// PEEK AT THE OLDEST COMMAND
+// Returns a '\0' terminated command without : and #,
+// valid until pop(), or nullptr if there is none
+// -------------------------------------------------------
+const char *CMD_RING::peek(void) {
+  if (_tail == _head) {
+    return nullptr;
+  }
+  if (_buf[_tail] == CMDRING_WRAP) {
+    _tail = 0;
+  }
+  return &_buf[_tail];
+}
+
+
+// -------------------------------------------------------
+// RELEASE THE OLDEST COMMAND
+// -------------------------------------------------------
+void CMD_RING::pop(void) {
+  const char *cmd = peek();
+  if (cmd == nullptr) {
+    return;
+  }
+  _tail = (_tail + strlen(cmd) + 1) % CMDRING_SIZE;
+}
+
+
+// -------------------------------------------------------
+// NUMBER OF COMMANDS DROPPED, RING FULL OR TOO LONG
+// -------------------------------------------------------
+unsigned long CMD_RING::get_dropped(void) {
+  return _dropped;
+}
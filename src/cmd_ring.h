@@ -0,0 +1,68 @@
+// -------------------------------------------------------
+// myFP2ESP8266 SERIAL COMMAND RING CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// cmd_ring.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _cmd_ring_h_
+#define _cmd_ring_h_
+
+#include <Arduino.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// ring size in bytes, holds many short :xx# commands
+#define CMDRING_SIZE    256
+// longest command accepted between : and #
+#define CMDRING_MAXCMD  63
+// start of command, end of command
+#define CMDRING_SOC     ':'
+#define CMDRING_EOC     '#'
+// marks the unused tail of the buffer when a command
+// starts again at 0, never valid in a command
+#define CMDRING_WRAP    '\xff'
+
+
+// -------------------------------------------------------
+// CLASS
+// Single producer (serialEvent), single consumer
+// (process_cmd) byte ring. Bytes between : and # are
+// written in place, then the command is terminated with
+// '\0' and published, so the consumer gets a pointer
+// into the ring and no copy or heap allocation is made.
+// A command is always contiguous: if it may not fit
+// before the end of the buffer it starts at 0.
+// Commands that do not fit, or are too long, are dropped
+// and counted.
+// -------------------------------------------------------
+class CMD_RING {
+public:
+  CMD_RING();
+
+  // producer
+  void put(char);
+
+  // consumer
+  bool available(void);
+  const char *peek(void);
+  void pop(void);
+
+  void clear(void);
+  unsigned long get_dropped(void);
+
+private:
+  char _buf[CMDRING_SIZE];
+  volatile uint16_t _head;  // end of last published command
+  volatile uint16_t _tail;  // start of oldest command
+  uint16_t _start;          // start of command in progress
+  uint16_t _wr;             // next write, command in progress
+  uint16_t _used;           // bytes used by command in progress
+  bool _inframe;            // between : and #
+  bool _overflow;           // command in progress is dropped
+  volatile unsigned long _dropped;
+};
+
+#endif
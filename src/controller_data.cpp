@@ -50,6 +50,9 @@ extern CONTROLLER_DATA *ControllerData;
 #include "driver_board.h"
 extern DRIVER_BOARD *driverboard;
 
+// millis64()
+#include "scheduler.h"
+
 
 // -------------------------------------------------------
 // EXTERNS
@@ -77,17 +80,38 @@ extern int _display_type;
 // CONTROLLERSDATA DEFINES
 // -------------------------------------------------------
 #define DEFAULT_ZERO 0
-#define DEFAULTCONFIGSIZE 2048
-#define BOARDDATASIZE 512
-#define BOARDVARDATASIZE 64
+
+
+// -------------------------------------------------------
+// JSON FILTERS
+// Board profiles may hold keys this firmware does not use
+// (ie sda, sck), the filter stops them being materialized
+// cntlr_config.jsn and cntlr_var.jsn are written by this
+// class with only the keys that are read, so are not
+// filtered
+// -------------------------------------------------------
+static void board_filter(JsonDocument &filter) {
+  filter["board"] = true;
+  filter["maxstepmode"] = true;
+  filter["stepmode"] = true;
+  filter["enpin"] = true;
+  filter["steppin"] = true;
+  filter["dirpin"] = true;
+  filter["temppin"] = true;
+  filter["brdnum"] = true;
+  filter["stepsrev"] = true;
+  filter["fixedsmode"] = true;
+  filter["brdpins"] = true;
+  filter["msdelay"] = true;
+}
 
 
 // -------------------------------------------------------
 // CONTROLLER_DATA CLASS CONSTRUCTOR
 // -------------------------------------------------------
 CONTROLLER_DATA::CONTROLLER_DATA(void) {
-  SnapShotMillis = millis();
-  BoardSnapShotMillis = millis();
+  SnapShotMillis = millis64();
+  BoardSnapShotMillis = millis64();
   ReqSaveData_var = false;    // Controller Variable Data
   ReqSaveData_per = false;    // Controller Persistant Data
   ReqSaveBoard_var = false;   // Controller Board Data
@@ -105,9 +129,12 @@ CONTROLLER_DATA::CONTROLLER_DATA(void) {
     } else {
       filesystemloaded = STATE_LOADED;
     }
+  } else {
+    filesystemloaded = STATE_LOADED;
   }
+  // tidy up any save that was interrupted by a reset
+  RecoverFiles();
   LoadConfiguration();
-  delay(10);
 };
 
 
@@ -142,22 +169,21 @@ bool CONTROLLER_DATA::LoadConfiguration() {
 
   ControllerPrint(T_CNTLRDATA);
   ControllerPrintln("LoadConfiguration"); 
+  ControllerPrint("CD-heap before load ");
+  ControllerPrintln(ESP.getFreeHeap());
 
-  if (LittleFS.exists(file_cntlr_config) == FILE_NOTFOUND) {
+  // Open file
+  File cfile = LittleFS.open(file_cntlr_config, "r");
+  if (!cfile) {
     ControllerPrintln("LoadDefaultPersistantData");
     LoadDefaultPersistantData();
   } else {
-    String cdata;
-    cdata.reserve(DEFAULTCONFIGSIZE);
-
-    // Open file
-    File cfile = LittleFS.open(file_cntlr_config, "r");
-    cdata = cfile.readString();
-    cfile.close();
-
     JsonDocument doc;
-    // Deserialize the JSON document
-    DeserializationError error = deserializeJson(doc, cdata);
+    // Deserialize the JSON document straight from the file
+    DeserializationError error = deserializeJson(doc, cfile);
+    cfile.close();
+    ControllerPrint("CD-heap cntlr_config ");
+    ControllerPrintln(ESP.getFreeHeap());
     if (error) {
       ControllerPrintln("LoadDefaultPersistantData");
       LoadDefaultPersistantData();
@@ -181,25 +207,25 @@ bool CONTROLLER_DATA::LoadConfiguration() {
       delayaftermove_time = doc["dam_time"];
 
       // DEVICENAME
-      devicename = doc["devname"].as<const char *>();
-      snprintf(DeviceName, sizeof(DeviceName), "%s%c", devicename, 0x00);
+      strlcpy(devicename, doc["devname"] | DEFAULT_DEVICENAME, sizeof(devicename));
+      strlcpy(DeviceName, devicename, sizeof(DeviceName));
 
       // DISPLAY
       display_enable = doc["d_en"];
       display_updateonmove = doc["d_updmove"];
-      display_pageoption = doc["d_pgopt"].as<const char *>();
+      pad_pageoption(display_pageoption, doc["d_pgopt"] | "");
 
       // DUCKDNS
       duckdns_enable = doc["ddns_en"];
-      duckdns_domain = doc["ddns_d"].as<const char *>();
-      duckdns_token = doc["ddns_t"].as<const char *>();
+      strlcpy(duckdns_domain, doc["ddns_d"] | "", sizeof(duckdns_domain));
+      strlcpy(duckdns_token, doc["ddns_t"] | "", sizeof(duckdns_token));
 
       // MANAGEMENT SERVER
       mngsrvr_enable = doc["mngt_en"];
 
       // MDNS NAME
-      mdnsname = doc["mdnsn"].as<const char *>();
-      snprintf(MDNSName, sizeof(MDNSName), "%s%c", mdnsname, 0x00);
+      strlcpy(mdnsname, doc["mdnsn"] | DEFAULT_MDNSNAME, sizeof(mdnsname));
+      strlcpy(MDNSName, mdnsname, sizeof(MDNSName));
 
       // MOTORSPEED SLOW, MED, FAST
       motorspeed = doc["mspeed"];
@@ -233,6 +259,24 @@ bool CONTROLLER_DATA::LoadConfiguration() {
       // TEMP COMP LOAD STATE
       tempcomp_onload = doc["tc_load"];
 
+      // TEMP PROBE RESOLUTION, 9-12 BITS
+      tempresolution = doc["t_res"] | DEFAULTTEMPRESOLUTION;
+
+      // TEMP PROBE ROM IDS BY ROLE, AND TEMP COMP PROBE
+      for (int i = 0; i < TEMP_MAXPROBES; i++) {
+        strlcpy(tprobe_rom[i], doc["t_rom"][i] | "", sizeof(tprobe_rom[i]));
+      }
+      tcprobe = doc["t_tcp"] | Probe_Tube;
+
+      // TEMP COMP DEADBAND, STEPS
+      tcdeadband = doc["t_tcdb"] | DEFAULTTCDEADBAND;
+
+      // TEMP COEFFICIENT FIT AUTO APPLY
+      tcfit_autoapply = doc["tc_auto"] | STATE_DISABLED;
+
+      // HISTORY FILE
+      history_spill = doc["hist_sp"] | STATE_DISABLED;
+
       // WEB Server
       websrvr_enable = doc["ws_en"];
 
@@ -247,21 +291,21 @@ bool CONTROLLER_DATA::LoadConfiguration() {
     LoadDefaultBoardData();
   } else {
     // board_config.jsn board data
-    String bdata;
-    bdata.reserve(BOARDDATASIZE);
-
-    bdata = bfile.readString();
-    bfile.close();
+    JsonDocument filter;
+    board_filter(filter);
 
     JsonDocument doc_brd;
-    // Deserialize the JSON document
-    DeserializationError error = deserializeJson(doc_brd, bdata);
+    // Deserialize the JSON document straight from the file
+    DeserializationError error = deserializeJson(doc_brd, bfile, DeserializationOption::Filter(filter));
+    bfile.close();
+    ControllerPrint("CD-heap board_config ");
+    ControllerPrintln(ESP.getFreeHeap());
     if (error) {
       ControllerPrintln("LoadDefaultBoardData");
       LoadDefaultBoardData();
     } else {
       ControllerPrintln("LoadBoardData");
-      board = doc_brd["board"].as<const char *>();
+      strlcpy(board, doc_brd["board"] | "Unknown", sizeof(board));
       maxstepmode = doc_brd["maxstepmode"];
       stepmode = doc_brd["stepmode"];
       enablepin = doc_brd["enpin"];
@@ -287,16 +331,13 @@ bool CONTROLLER_DATA::LoadConfiguration() {
   if (!vfile) {
     LoadDefaultVariableData();
   } else {
-    String vdata;
-    vdata.reserve(BOARDVARDATASIZE);
-
-    vdata = vfile.readString();
-    vfile.close();
-
     JsonDocument doc_var;
 
-    // Deserialize the JSON document
-    DeserializationError error = deserializeJson(doc_var, vdata);
+    // Deserialize the JSON document straight from the file
+    DeserializationError error = deserializeJson(doc_var, vfile);
+    vfile.close();
+    ControllerPrint("CD-heap cntlr_var ");
+    ControllerPrintln(ESP.getFreeHeap());
     if (error) {
       LoadDefaultVariableData();
     } else {
@@ -344,8 +385,8 @@ void CONTROLLER_DATA::LoadDefaultPersistantData() {
 
   // DUCKDNS from /defines/duckdns_defines.h
   duckdns_enable = STATE_DISABLED;
-  duckdns_domain = String(duckdnsdomain);
-  duckdns_token = String(duckdnstoken);
+  strlcpy(duckdns_domain, duckdnsdomain, sizeof(duckdns_domain));
+  strlcpy(duckdns_token, duckdnstoken, sizeof(duckdns_token));
 
   mngsrvr_enable = STATE_ENABLED;
   tcpipsrvr_enable = STATE_DISABLED;
@@ -361,16 +402,16 @@ void CONTROLLER_DATA::LoadDefaultPersistantData() {
   // DELAY AFTER MOVE
   delayaftermove_time = 25;
 
-  devicename = String(DEFAULT_DEVICENAME);
-  snprintf(DeviceName, sizeof(DeviceName), "%s%c", devicename, 0x00);
+  strlcpy(devicename, DEFAULT_DEVICENAME, sizeof(devicename));
+  strlcpy(DeviceName, devicename, sizeof(DeviceName));
 
   // DISPLAY
   display_enable = STATE_DISABLED;
   display_updateonmove = STATE_ENABLED;
-  display_pageoption = "111111";  // six pages
+  strlcpy(display_pageoption, "111111", sizeof(display_pageoption));  // six pages
 
-  mdnsname = String(DEFAULT_MDNSNAME);
-  snprintf(MDNSName, sizeof(MDNSName), "%s%c", mdnsname, 0x00);
+  strlcpy(mdnsname, DEFAULT_MDNSNAME, sizeof(mdnsname));
+  strlcpy(MDNSName, mdnsname, sizeof(MDNSName));
 
   // MOTORSPEED
   motorspeed = FAST;
@@ -391,6 +432,16 @@ void CONTROLLER_DATA::LoadDefaultPersistantData() {
   tempmode = CELSIUS;
   tcdirection = TC_DIRECTION_IN;
   tempcomp_onload = STATE_DISABLED;
+  tempresolution = DEFAULTTEMPRESOLUTION;
+  for (int i = 0; i < TEMP_MAXPROBES; i++) {
+    tprobe_rom[i][0] = '\0';
+  }
+  tcprobe = Probe_Tube;
+  tcdeadband = DEFAULTTCDEADBAND;
+  tcfit_autoapply = STATE_DISABLED;
+
+  // HISTORY
+  history_spill = STATE_DISABLED;
 
   SavePersitantConfiguration();
   delay(10);
@@ -410,8 +461,13 @@ void CONTROLLER_DATA::LoadDefaultBoardData() {
 
   // cannot use boardnumber because the value has not
   // been set yet
-  // Load the board file from /boards, make up filename first
 
+  // try the board profile index first, no JSON parsing
+  if (LoadBrdConfigIndex(myboardnumber) == true) {
+    return;
+  }
+
+  // Load the board file from /boards, make up filename first
   String bfile = "/boards/" + String(myboardnumber) + ".jsn";
 
   // attempt to load the specified board config
@@ -421,7 +477,7 @@ void CONTROLLER_DATA::LoadDefaultBoardData() {
   } else {
     // a board config file could not be loaded,
     // so create a dummy one
-    board = "Unknown";
+    strlcpy(board, "Unknown", sizeof(board));
     maxstepmode = -1;
     stepmode = 1;
     enablepin = -1;
@@ -478,12 +534,11 @@ bool CONTROLLER_DATA::SaveConfiguration(long currentPosition, byte DirOfTravel)
     fposition = currentPosition;
     focuserdirection = DirOfTravel;
     ReqSaveData_var = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
   }
 
-  unsigned long x = millis();
-
-  if ((SnapShotMillis + DEFAULTSAVETIME) < x || SnapShotMillis > x) {
+  // millis64() does not rollover
+  if ((millis64() - SnapShotMillis) > DEFAULTSAVETIME) {
     if (ReqSaveData_per == true) {
       if (SavePersitantConfiguration() == true) {
         state = true;
@@ -515,7 +570,6 @@ bool CONTROLLER_DATA::SaveConfiguration(long currentPosition, byte DirOfTravel)
       }
     }
   }
-  delay(10);
   return state;
 }
 
@@ -537,11 +591,10 @@ bool CONTROLLER_DATA::SaveNow(long focuser_position, bool focuser_direction) {
 bool CONTROLLER_DATA::SaveVariableConfiguration(long focuser_position, bool focuser_direction) {
   LittleFS.begin();
 
-  // Delete existing file
-  LittleFS.remove(file_cntlr_var);
-
-  // Open file for writing
-  File vfile = LittleFS.open(file_cntlr_var, "w");
+  // Open temporary file for writing, existing file is
+  // kept till the new file is complete
+  String tmpfile = file_cntlr_var + file_tmpext;
+  File vfile = LittleFS.open(tmpfile, "w");
   if (!vfile) {
     return false;
   }
@@ -558,10 +611,12 @@ bool CONTROLLER_DATA::SaveVariableConfiguration(long focuser_position, bool focu
   // save settings to file
   if (serializeJson(doc, vfile) == 0) {
     vfile.close();
+    LittleFS.remove(tmpfile);
     return false;
   }
+  vfile.flush();
   vfile.close();
-  return true;
+  return CommitFile(file_cntlr_var);
 }
 
 
@@ -571,9 +626,6 @@ bool CONTROLLER_DATA::SaveVariableConfiguration(long focuser_position, bool focu
 bool CONTROLLER_DATA::SavePersitantConfiguration() {
   LittleFS.begin();
 
-  // remove existing file
-  LittleFS.remove(file_cntlr_config);
-
   JsonDocument doc;
 
   doc["maxstep"] = maxstep;
@@ -633,24 +685,37 @@ bool CONTROLLER_DATA::SavePersitantConfiguration() {
   doc["t_coe"] = tempcoefficient;
   doc["t_mod"] = tempmode;
   doc["t_tcdir"] = tcdirection;
+  doc["t_res"] = tempresolution;
+  JsonArray roms = doc["t_rom"].to<JsonArray>();
+  for (int i = 0; i < TEMP_MAXPROBES; i++) {
+    roms.add(tprobe_rom[i]);
+  }
+  doc["t_tcp"] = tcprobe;
+  doc["t_tcdb"] = tcdeadband;
+  doc["tc_auto"] = tcfit_autoapply;
+  doc["hist_sp"] = history_spill;
   doc["tc_load"] = tempcomp_onload;
 
   // WEB Server
   doc["ws_en"] = websrvr_enable;
 
-  // Open file for writing
-  File cfile = LittleFS.open(file_cntlr_config, "w");
+  // Open temporary file for writing, existing file is
+  // kept till the new file is complete
+  String tmpfile = file_cntlr_config + file_tmpext;
+  File cfile = LittleFS.open(tmpfile, "w");
   if (!cfile) {
     return false;
   }
 
   if (serializeJson(doc, cfile) == 0) {
     cfile.close();
+    LittleFS.remove(tmpfile);
     return false;
   }
 
+  cfile.flush();
   cfile.close();
-  return true;
+  return CommitFile(file_cntlr_config);
 }
 
 
@@ -658,10 +723,10 @@ bool CONTROLLER_DATA::SavePersitantConfiguration() {
 // SAVE BOARD DATA TO FILE BOARD_CONFIG.JSN
 // -------------------------------------------------------
 bool CONTROLLER_DATA::SaveBoardConfiguration() {
-  LittleFS.remove(file_board_config);
-
-  // Open file for writing
-  File bfile = LittleFS.open(file_board_config, "w");
+  // Open temporary file for writing, existing file is
+  // kept till the new file is complete
+  String tmpfile = file_board_config + file_tmpext;
+  File bfile = LittleFS.open(tmpfile, "w");
   if (!bfile) {
     return false;
   } else {
@@ -685,16 +750,62 @@ bool CONTROLLER_DATA::SaveBoardConfiguration() {
 
     if (serializeJson(doc_brd, bfile) == 0) {
       bfile.close();
-      delay(10);
+      LittleFS.remove(tmpfile);
       return false;
     }
+    bfile.flush();
     bfile.close();
   }
-  delay(10);
+  return CommitFile(file_board_config);
+}
+
+
+// -------------------------------------------------------
+// COMMIT A SAVED FILE
+// Rename the completed .tmp file over the original.
+// LittleFS rename replaces an existing file atomically,
+// so after a reset either the old or the new file exists,
+// never a truncated one
+// -------------------------------------------------------
+bool CONTROLLER_DATA::CommitFile(const String &fname) {
+  String tmpfile = fname + file_tmpext;
+  if (LittleFS.rename(tmpfile, fname) == false) {
+    ControllerPrint("CD-rename err ");
+    ControllerPrintln(fname);
+    LittleFS.remove(tmpfile);
+    return false;
+  }
   return true;
 }
 
 
+// -------------------------------------------------------
+// RECOVER FILES AT BOOT
+// A .tmp file left behind means a reset happened during
+// a save. If the original exists it is still complete, so
+// the .tmp is discarded. If there is no original, the .tmp
+// is used; LoadConfiguration() falls back to defaults if
+// it cannot be deserialized.
+// -------------------------------------------------------
+void CONTROLLER_DATA::RecoverFiles(void) {
+  const String *files[3] = { &file_cntlr_config, &file_cntlr_var, &file_board_config };
+
+  for (int i = 0; i < 3; i++) {
+    String tmpfile = *files[i] + file_tmpext;
+    if (LittleFS.exists(tmpfile) == FILE_NOTFOUND) {
+      continue;
+    }
+    ControllerPrint("CD-recover ");
+    ControllerPrintln(tmpfile);
+    if (LittleFS.exists(*files[i]) == FILE_FOUND) {
+      LittleFS.remove(tmpfile);
+    } else {
+      LittleFS.rename(tmpfile, *files[i]);
+    }
+  }
+}
+
+
 // -------------------------------------------------------
 // LOAD BOARD DATA CONFIGURATION
 // -------------------------------------------------------
@@ -703,24 +814,22 @@ bool CONTROLLER_DATA::LoadBrdConfigStart(String brdfile) {
   if (!bfile) {
     return false;
   } else {
-    // read file and deserialize
-    String fdata;
-    fdata.reserve(BOARDDATASIZE);
-    fdata = bfile.readString();
-    bfile.close();
+    // deserialize straight from the file, board keys only
+    JsonDocument filter;
+    board_filter(filter);
 
     JsonDocument doc_brd;
 
-    DeserializationError jerror = deserializeJson(doc_brd, fdata);
+    DeserializationError jerror = deserializeJson(doc_brd, bfile, DeserializationOption::Filter(filter));
+    bfile.close();
     if (jerror) {
-      delay(10);
       return false;
     }
 
     // save the brd_data just read from board
     // config file (brdfile) into board_config.jsn
     // Set the board values from doc_brd
-    board = doc_brd["board"].as<const char *>();
+    strlcpy(board, doc_brd["board"] | "Unknown", sizeof(board));
     maxstepmode = doc_brd["maxstepmode"];
     stepmode = doc_brd["stepmode"];
     enablepin = doc_brd["enpin"];
@@ -728,38 +837,7 @@ bool CONTROLLER_DATA::LoadBrdConfigStart(String brdfile) {
     dirpin = doc_brd["dirpin"];
     temppin = doc_brd["temppin"];
     boardnumber = doc_brd["brdnum"];
-
-    // brdstepsperrev comes from STEPSPERREVOLUTION
-    // and will be different so must override the
-    // default setting in the board files
-    switch (myboardnumber) {
-      case PRO2EULN2003:
-      case PRO2EL298N:
-      case PRO2EL293DMINI:
-      case PRO2EL9110S:
-      case PRO2EL293DNEMA:
-      case PRO2EL293D28BYJ48:
-        stepsperrev = mystepsperrev;
-        // override STEPSPERREVOLUTION from controller_config.h
-        break;
-      default:
-        stepsperrev = doc_brd["stepsrev"];
-        break;
-    }
-    // myfixedstepmode comes from FIXEDSTEPMODE
-    // and will be different so must override
-    // the default setting in the board files
-    switch (myboardnumber) {
-      case WEMOSDRV8825H:
-      case WEMOSDRV8825:
-      case PRO2EDRV8825:
-        fixedstepmode = myfixedstepmode;
-        // override FIXEDSTEPMODE from controller_config.h
-        break;
-      default:
-        fixedstepmode = doc_brd["fixedsmode"];
-        break;
-    }
+    SetBoardStepDefaults(doc_brd["stepsrev"], doc_brd["fixedsmode"]);
     for (int i = 0; i < 4; i++) {
       boardpins[i] = doc_brd["brdpins"][i];
     }
@@ -772,6 +850,110 @@ bool CONTROLLER_DATA::LoadBrdConfigStart(String brdfile) {
 }
 
 
+// -------------------------------------------------------
+// LOAD BOARD CONFIG FROM BOARD PROFILE INDEX
+// Reads one fixed size record from /boards/boards.idx,
+// found by board number via the slot table, so no JSON
+// is parsed. Returns false if the index is missing or
+// has no record for the board; caller then falls back
+// to /boards/<n>.jsn
+// -------------------------------------------------------
+bool CONTROLLER_DATA::LoadBrdConfigIndex(int brdnum) {
+  if ((brdnum < 0) || (brdnum >= BOARDINDEXSLOTS)) {
+    return false;
+  }
+
+  File ifile = LittleFS.open(file_board_index, "r");
+  if (!ifile) {
+    return false;
+  }
+
+  uint8_t hdr[BOARDINDEXHDRLEN];
+  uint8_t slot = 0;
+  BOARD_RECORD rec;
+
+  // check header, magic and record length must match
+  if ((ifile.read(hdr, BOARDINDEXHDRLEN) != BOARDINDEXHDRLEN)
+      || (memcmp(hdr, "BIDX", 4) != 0)
+      || ((hdr[4] | (hdr[5] << 8)) != sizeof(BOARD_RECORD))) {
+    ifile.close();
+    ControllerPrintln("CD-board index invalid");
+    return false;
+  }
+  int count = hdr[6] | (hdr[7] << 8);
+
+  ifile.seek(BOARDINDEXHDRLEN + brdnum);
+  if ((ifile.read(&slot, 1) != 1) || (slot == 0) || (slot > count)) {
+    ifile.close();
+    return false;
+  }
+
+  ifile.seek(BOARDINDEXHDRLEN + BOARDINDEXSLOTS + ((slot - 1) * sizeof(BOARD_RECORD)));
+  if (ifile.read((uint8_t *)&rec, sizeof(BOARD_RECORD)) != sizeof(BOARD_RECORD)) {
+    ifile.close();
+    return false;
+  }
+  ifile.close();
+
+  rec.name[BOARDNAMELEN - 1] = 0x00;
+  strlcpy(board, rec.name, sizeof(board));
+  maxstepmode = rec.maxstepmode;
+  stepmode = rec.stepmode;
+  enablepin = rec.enpin;
+  steppin = rec.steppin;
+  dirpin = rec.dirpin;
+  temppin = rec.temppin;
+  boardnumber = rec.brdnum;
+  SetBoardStepDefaults(rec.stepsrev, rec.fixedsmode);
+  for (int i = 0; i < 4; i++) {
+    boardpins[i] = rec.brdpins[i];
+  }
+  msdelay = rec.msdelay;
+  SaveBoardConfiguration();
+  return true;
+}
+
+
+// -------------------------------------------------------
+// SET BOARD STEPS PER REV AND FIXED STEP MODE
+// Values from a board profile, overridden by the compile
+// time settings for boards that use them
+// -------------------------------------------------------
+void CONTROLLER_DATA::SetBoardStepDefaults(int stepsrev, int fixedsmode) {
+  // brdstepsperrev comes from STEPSPERREVOLUTION
+  // and will be different so must override the
+  // default setting in the board files
+  switch (myboardnumber) {
+    case PRO2EULN2003:
+    case PRO2EL298N:
+    case PRO2EL293DMINI:
+    case PRO2EL9110S:
+    case PRO2EL293DNEMA:
+    case PRO2EL293D28BYJ48:
+      stepsperrev = mystepsperrev;
+      // override STEPSPERREVOLUTION from controller_config.h
+      break;
+    default:
+      stepsperrev = stepsrev;
+      break;
+  }
+  // myfixedstepmode comes from FIXEDSTEPMODE
+  // and will be different so must override
+  // the default setting in the board files
+  switch (myboardnumber) {
+    case WEMOSDRV8825H:
+    case WEMOSDRV8825:
+    case PRO2EDRV8825:
+      fixedstepmode = myfixedstepmode;
+      // override FIXEDSTEPMODE from controller_config.h
+      break;
+    default:
+      fixedstepmode = fixedsmode;
+      break;
+  }
+}
+
+
 // -------------------------------------------------------
 // CREATE BOARD CONFIGURATION FROM JSON STRING
 // legacy orphaned code
@@ -788,7 +970,7 @@ bool CONTROLLER_DATA::CreateBoardConfigfromjson(String jsonstr) {
     LoadDefaultBoardData();
     return false;
   } else {
-    board = doc_brd["board"].as<const char *>();
+    strlcpy(board, doc_brd["board"] | "Unknown", sizeof(board));
     maxstepmode = doc_brd["maxstepmode"];
     stepmode = doc_brd["stepmode"];
     enablepin = doc_brd["enpin"];
@@ -915,15 +1097,15 @@ void CONTROLLER_DATA::set_delayaftermove_time(byte newtime) {
 }
 
 // DEVICENAME
-String CONTROLLER_DATA::get_devicename(void) {
+const char *CONTROLLER_DATA::get_devicename(void) {
   return devicename;
 }
 
-void CONTROLLER_DATA::set_devicename(String newstr) {
-  String sav = newstr.substring(0, 10);  // 11 chars
-  StartDelayedUpdate(devicename, sav);
+void CONTROLLER_DATA::set_devicename(const char *newstr) {
+  // truncated to 11 chars
+  StartDelayedUpdate(devicename, newstr, sizeof(devicename));
   // update cached var
-  snprintf(DeviceName, sizeof(DeviceName), "%s%c", sav, 0x00);
+  strlcpy(DeviceName, devicename, sizeof(DeviceName));
 }
 
 // DISPLAY
@@ -944,24 +1126,27 @@ void CONTROLLER_DATA::set_display_updateonmove(bool newstate) {
   StartDelayedUpdate(display_updateonmove, newstate);
 }
 
-String CONTROLLER_DATA::get_display_pageoption(void) {
-  String tmp = display_pageoption;
-  while (tmp.length() < 6) {
-    tmp = tmp + "0";
-  }
-  tmp = tmp + "";
-  display_pageoption = tmp;
+// always 6 chars, padded with 0 when loaded or set
+const char *CONTROLLER_DATA::get_display_pageoption(void) {
   return display_pageoption;
 }
 
-void CONTROLLER_DATA::set_display_pageoption(String newoption) {
-  String tmp = newoption;
-  while (tmp.length() < 6) {
-    tmp = tmp + "0";
+void CONTROLLER_DATA::set_display_pageoption(const char *newoption) {
+  char tmp[BUFFER8LEN];
+  pad_pageoption(tmp, newoption);
+  StartDelayedUpdate(display_pageoption, tmp, sizeof(display_pageoption));
+}
+
+// copy page option, 6 chars (pages 1-6), pad with 0
+void CONTROLLER_DATA::pad_pageoption(char *dest, const char *src) {
+  int i = 0;
+  for (; (i < 6) && (src[i] != 0x00); i++) {
+    dest[i] = src[i];
+  }
+  for (; i < 6; i++) {
+    dest[i] = '0';
   }
-  tmp = tmp + "";
-  display_pageoption = tmp;
-  StartDelayedUpdate(display_pageoption, newoption);
+  dest[6] = 0x00;
 }
 
 // DUCKDNS
@@ -973,32 +1158,32 @@ void CONTROLLER_DATA::set_duckdns_enable(bool newstate) {
   StartDelayedUpdate(duckdns_enable, newstate);
 }
 
-String CONTROLLER_DATA::get_duckdns_domain(void) {
+const char *CONTROLLER_DATA::get_duckdns_domain(void) {
   return duckdns_domain;
 }
 
-void CONTROLLER_DATA::set_duckdns_domain(String newdomain) {
-  StartDelayedUpdate(duckdns_domain, newdomain);
+void CONTROLLER_DATA::set_duckdns_domain(const char *newdomain) {
+  StartDelayedUpdate(duckdns_domain, newdomain, sizeof(duckdns_domain));
 }
 
-String CONTROLLER_DATA::get_duckdns_token(void) {
+const char *CONTROLLER_DATA::get_duckdns_token(void) {
   return duckdns_token;
 }
 
-void CONTROLLER_DATA::set_duckdns_token(String newtoken) {
-  StartDelayedUpdate(duckdns_token, newtoken);
+void CONTROLLER_DATA::set_duckdns_token(const char *newtoken) {
+  StartDelayedUpdate(duckdns_token, newtoken, sizeof(duckdns_token));
 }
 
 // MDNS Name
-String CONTROLLER_DATA::get_mdnsname(void) {
+const char *CONTROLLER_DATA::get_mdnsname(void) {
   return mdnsname;
 }
 
-void CONTROLLER_DATA::set_mdnsname(String newstr) {
-  String sav = newstr.substring(0, 10);
-  StartDelayedUpdate(mdnsname, sav);
+void CONTROLLER_DATA::set_mdnsname(const char *newstr) {
+  // truncated to 11 chars
+  StartDelayedUpdate(mdnsname, newstr, sizeof(mdnsname));
   // update cached var
-  snprintf(MDNSName, sizeof(MDNSName), "%s%c", sav, 0x00);
+  strlcpy(MDNSName, mdnsname, sizeof(MDNSName));
 }
 
 // MANAGEMENT SERVER
@@ -1120,6 +1305,60 @@ void CONTROLLER_DATA::set_tempcomp_onload(bool newstate) {
   StartDelayedUpdate(tcdirection, newstate);
 }
 
+byte CONTROLLER_DATA::get_tempresolution(void) {
+  return tempresolution;
+}
+
+void CONTROLLER_DATA::set_tempresolution(byte newval) {
+  StartDelayedUpdate(tempresolution, newval);
+}
+
+const char *CONTROLLER_DATA::get_tprobe_rom(byte role) {
+  return (role < TEMP_MAXPROBES) ? tprobe_rom[role] : "";
+}
+
+void CONTROLLER_DATA::set_tprobe_rom(byte role, const char *newrom) {
+  if (role < TEMP_MAXPROBES) {
+    StartDelayedUpdate(tprobe_rom[role], newrom, sizeof(tprobe_rom[role]));
+  }
+}
+
+byte CONTROLLER_DATA::get_tcprobe(void) {
+  return tcprobe;
+}
+
+void CONTROLLER_DATA::set_tcprobe(byte newrole) {
+  if (newrole < TEMP_MAXPROBES) {
+    StartDelayedUpdate(tcprobe, newrole);
+  }
+}
+
+int CONTROLLER_DATA::get_tcdeadband(void) {
+  return tcdeadband;
+}
+
+void CONTROLLER_DATA::set_tcdeadband(int newval) {
+  RangeCheck(&newval, 0, MAXTCDEADBAND);
+  StartDelayedUpdate(tcdeadband, newval);
+}
+
+bool CONTROLLER_DATA::get_tcfit_autoapply(void) {
+  return tcfit_autoapply;
+}
+
+void CONTROLLER_DATA::set_tcfit_autoapply(bool newstate) {
+  StartDelayedUpdate(tcfit_autoapply, newstate);
+}
+
+// HISTORY
+bool CONTROLLER_DATA::get_history_spill(void) {
+  return history_spill;
+}
+
+void CONTROLLER_DATA::set_history_spill(bool newstate) {
+  StartDelayedUpdate(history_spill, newstate);
+}
+
 // WEB SERVER
 bool CONTROLLER_DATA::get_websrvr_enable(void) {
   return websrvr_enable;
@@ -1133,7 +1372,7 @@ void CONTROLLER_DATA::set_websrvr_enable(bool newstate) {
 // -------------------------------------------------------
 // Board Data get and set methods
 // -------------------------------------------------------
-String CONTROLLER_DATA::get_brdname() {
+const char *CONTROLLER_DATA::get_brdname() {
   return board;
 }
 
@@ -1182,8 +1421,8 @@ unsigned long CONTROLLER_DATA::get_brdmsdelay() {
 }
 
 // set
-void CONTROLLER_DATA::set_brdname(String newstr) {
-  StartBoardDelayedUpdate(board, newstr);
+void CONTROLLER_DATA::set_brdname(const char *newstr) {
+  StartBoardDelayedUpdate(board, newstr, sizeof(board));
 }
 
 void CONTROLLER_DATA::set_brdmaxstepmode(int newval) {
@@ -1239,7 +1478,7 @@ void CONTROLLER_DATA::set_brdmsdelay(unsigned long newval) {
 void CONTROLLER_DATA::StartDelayedUpdate(bool &org_data, bool new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1247,7 +1486,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(bool &org_data, bool new_data) {
 void CONTROLLER_DATA::StartDelayedUpdate(byte &org_data, byte new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1255,7 +1494,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(byte &org_data, byte new_data) {
 void CONTROLLER_DATA::StartDelayedUpdate(int &org_data, int new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1263,7 +1502,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(int &org_data, int new_data) {
 void CONTROLLER_DATA::StartDelayedUpdate(unsigned int &org_data, unsigned int new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1271,7 +1510,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(unsigned int &org_data, unsigned int ne
 void CONTROLLER_DATA::StartDelayedUpdate(long &org_data, long new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1279,7 +1518,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(long &org_data, long new_data) {
 void CONTROLLER_DATA::StartDelayedUpdate(unsigned long &org_data, unsigned long new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1287,16 +1526,17 @@ void CONTROLLER_DATA::StartDelayedUpdate(unsigned long &org_data, unsigned long
 void CONTROLLER_DATA::StartDelayedUpdate(float &org_data, float new_data) {
   if (org_data != new_data) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
+    SnapShotMillis = millis64();
     org_data = new_data;
   }
 }
 
-void CONTROLLER_DATA::StartDelayedUpdate(String &org_data, String new_data) {
-  if (org_data != new_data) {
+// new_data is truncated to fit org_data[len]
+void CONTROLLER_DATA::StartDelayedUpdate(char *org_data, const char *new_data, size_t len) {
+  if (strncmp(org_data, new_data, len - 1) != 0) {
     ReqSaveData_per = true;
-    SnapShotMillis = millis();
-    org_data = new_data;
+    SnapShotMillis = millis64();
+    strlcpy(org_data, new_data, len);
   }
 }
 
@@ -1308,7 +1548,7 @@ void CONTROLLER_DATA::StartDelayedUpdate(String &org_data, String new_data) {
 void CONTROLLER_DATA::StartBoardDelayedUpdate(int &org_data, int new_data) {
   if (org_data != new_data) {
     ReqSaveBoard_var = true;
-    BoardSnapShotMillis = millis();
+    BoardSnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1316,7 +1556,7 @@ void CONTROLLER_DATA::StartBoardDelayedUpdate(int &org_data, int new_data) {
 void CONTROLLER_DATA::StartBoardDelayedUpdate(unsigned long &org_data, unsigned long new_data) {
   if (org_data != new_data) {
     ReqSaveBoard_var = true;
-    BoardSnapShotMillis = millis();
+    BoardSnapShotMillis = millis64();
     org_data = new_data;
   }
 }
@@ -1324,15 +1564,16 @@ void CONTROLLER_DATA::StartBoardDelayedUpdate(unsigned long &org_data, unsigned
 void CONTROLLER_DATA::StartBoardDelayedUpdate(byte &org_data, byte new_data) {
   if (org_data != new_data) {
     ReqSaveBoard_var = true;
-    BoardSnapShotMillis = millis();
+    BoardSnapShotMillis = millis64();
     org_data = new_data;
   }
 }
 
-void CONTROLLER_DATA::StartBoardDelayedUpdate(String &org_data, String new_data) {
-  if (org_data != new_data) {
+// new_data is truncated to fit org_data[len]
+void CONTROLLER_DATA::StartBoardDelayedUpdate(char *org_data, const char *new_data, size_t len) {
+  if (strncmp(org_data, new_data, len - 1) != 0) {
     ReqSaveBoard_var = true;
-    BoardSnapShotMillis = millis();
-    org_data = new_data;
+    BoardSnapShotMillis = millis64();
+    strlcpy(org_data, new_data, len);
   }
 }
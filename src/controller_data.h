@@ -10,6 +10,34 @@
 #include "config.h"
 
 
+// -------------------------------------------------------
+// BOARD PROFILE INDEX /boards/boards.idx
+// Generated from /boards/*.jsn by tools/mkboardindex.py
+// header  char magic[4] "BIDX", uint16 reclen, uint16 count
+// slots   uint8 slot[BOARDINDEXSLOTS] by board number,
+//         0 = none, else record number + 1
+// records BOARD_RECORD[count]
+// -------------------------------------------------------
+#define BOARDINDEXHDRLEN  8
+#define BOARDINDEXSLOTS   256
+#define BOARDNAMELEN      24
+
+typedef struct __attribute__((packed)) {
+  char name[BOARDNAMELEN];
+  int16_t brdnum;
+  int16_t maxstepmode;
+  int16_t stepmode;
+  int16_t enpin;
+  int16_t steppin;
+  int16_t dirpin;
+  int16_t temppin;
+  int16_t stepsrev;
+  int16_t fixedsmode;
+  int16_t brdpins[4];
+  uint16_t msdelay;
+} BOARD_RECORD;
+
+
 // -------------------------------------------------------
 // CONTROLLER_DATA CLASS
 // -------------------------------------------------------
@@ -21,6 +49,8 @@ public:
   // attempt to load a board config file [DRVBRD] 
   // immediately after a firmware reprogram
   bool LoadBrdConfigStart(String);
+  // load a board config from the board profile index
+  bool LoadBrdConfigIndex(int);
   void LoadDefaultBoardData(void);
 
   bool SaveConfiguration(long, byte);
@@ -75,26 +105,26 @@ public:
   void set_delayaftermove_time(byte);
 
   // Device Name
-  String get_devicename(void);
-  void set_devicename(String);
+  const char *get_devicename(void);
+  void set_devicename(const char *);
 
   // DISPLAY
   bool get_display_enable(void);
   void set_display_enable(bool);
   bool get_display_updateonmove(void);
   void set_display_updateonmove(bool);
-  String get_display_pageoption(void);
-  void set_display_pageoption(String);
+  const char *get_display_pageoption(void);
+  void set_display_pageoption(const char *);
 
   // DUCKDNS
-  String get_duckdns_domain(void);
-  String get_duckdns_token(void);
-  void set_duckdns_domain(String);
-  void set_duckdns_token(String);
+  const char *get_duckdns_domain(void);
+  const char *get_duckdns_token(void);
+  void set_duckdns_domain(const char *);
+  void set_duckdns_token(const char *);
 
   // MDNS Name
-  String get_mdnsname(void);
-  void set_mdnsname(String);
+  const char *get_mdnsname(void);
+  void set_mdnsname(const char *);
 
   // MOTORSPEED
   byte get_motorspeed(void);
@@ -126,9 +156,23 @@ public:
   void set_tcdirection(bool);
   bool get_tempcomp_onload(void);
   void set_tempcomp_onload(bool);
+  byte get_tempresolution(void);
+  void set_tempresolution(byte);
+  const char *get_tprobe_rom(byte);  // rom id saved for a role
+  void set_tprobe_rom(byte, const char *);
+  byte get_tcprobe(void);            // role used for temp comp
+  void set_tcprobe(byte);
+  int get_tcdeadband(void);          // steps
+  void set_tcdeadband(int);
+  bool get_tcfit_autoapply(void);    // apply fitted coefficient
+  void set_tcfit_autoapply(bool);
+
+  // HISTORY
+  bool get_history_spill(void);      // append to history file
+  void set_history_spill(bool);
 
   // BOARD CONFIGURATIONS
-  String get_brdname(void);
+  const char *get_brdname(void);
   int get_brdmaxstepmode(void);
   int get_brdstepmode(void);
   int get_brdenablepin(void);
@@ -144,7 +188,7 @@ public:
   int get_stepsperrev(void);
 
   // set boardconfig
-  void set_brdname(String);
+  void set_brdname(const char *);
   void set_brdmaxstepmode(int);
   void set_brdstepmode(int);
   void set_brdenablepin(int);
@@ -164,6 +208,11 @@ private:
   void LoadDefaultVariableData(void);
   void LoadBoardConfiguration(void);
   void SetDefaultBoardData(void);
+  void SetBoardStepDefaults(int, int);
+
+  // atomic writes, save to .tmp then rename over original
+  bool CommitFile(const String &);
+  void RecoverFiles(void);
 
   void StartDelayedUpdate(bool &, bool);
   void StartDelayedUpdate(byte &, byte);
@@ -172,13 +221,15 @@ private:
   void StartDelayedUpdate(long &, long);
   void StartDelayedUpdate(unsigned long &, unsigned long);
   void StartDelayedUpdate(float &, float);
-  void StartDelayedUpdate(String &, String);
+  void StartDelayedUpdate(char *, const char *, size_t);
 
   void StartBoardDelayedUpdate(byte &, byte);
   void StartBoardDelayedUpdate(int &, int);
   void StartBoardDelayedUpdate(unsigned long &, unsigned long);
   void StartBoardDelayedUpdate(float &, float);
-  void StartBoardDelayedUpdate(String &, String);
+  void StartBoardDelayedUpdate(char *, const char *, size_t);
+
+  void pad_pageoption(char *, const char *);
 
   bool ReqSaveData_var;   // Flag request save variable data
   bool ReqSaveData_per;   // Flag request save persitant data
@@ -190,13 +241,17 @@ private:
   const String file_cntlr_var = "/cntlr_var.jsn";        
   // board JSON configuration
   const String file_board_config = "/board_config.jsn";  
+  // board profile index
+  const String file_board_index = "/boards/boards.idx";
+  // extension of temporary file used when saving
+  const String file_tmpext = ".tmp";
 
   long fposition;          // last focuser position
   long maxstep;            // max steps
   byte focuserdirection;   // last focuser move direction
 
-  unsigned long SnapShotMillis;
-  unsigned long BoardSnapShotMillis;
+  uint64_t SnapShotMillis;       // millis64() of last change
+  uint64_t BoardSnapShotMillis;
 
   // Loaded at boot time, if enabled is 1 then an 
   // attempt will be made to "start" and "run"
@@ -211,20 +266,20 @@ private:
   
   byte delayaftermove_time; // milliseconds to wait after a move 
 
-  String devicename;
+  char devicename[BUFFER12LEN];
 
   // DISPLAY
   bool display_enable;
   bool display_updateonmove;  // update position when moving
-  String display_pageoption;  // which pages to show/hide
+  char display_pageoption[BUFFER8LEN];  // which pages to show/hide
   
   // DUCKDNS
   bool duckdns_enable;
-  String duckdns_domain;
-  String duckdns_token;
+  char duckdns_domain[BUFFER48LEN];
+  char duckdns_token[BUFFER48LEN];
 
   // MDNSNAME
-  String mdnsname;
+  char mdnsname[BUFFER12LEN];
 
   // MOTORSPEED
   byte motorspeed;  // slow, medium or fast
@@ -255,11 +310,18 @@ private:
 
   byte tcdirection;  // direction to move when tempcomp is ON
   byte tempcomp_onload;  // set tempcomp on bootup
+  byte tempresolution;   // DS18B20 resolution in bits, 9-12
+  char tprobe_rom[TEMP_MAXPROBES][TEMP_ROMHEXLEN];  // by role, "" = unassigned
+  byte tcprobe;          // role of the temp comp probe
+  int tcdeadband;        // temp comp moves at least this many steps
+  bool tcfit_autoapply;  // apply the fitted temp coefficient
+
+  bool history_spill;    // append 10 minute history to a file
 
   bool websrvr_enable;
 
   // DATASET BOARD CONFIGURATION
-  String board;
+  char board[BUFFER32LEN];
   int maxstepmode;
   int stepmode;
   int enablepin;
@@ -17,6 +17,7 @@
 const char TEXTPAGETYPE[10] = "text/html";
 const char PLAINTEXTPAGETYPE[11] = "text/plain";
 const char JSONTEXTPAGETYPE[10] = "text/json";
+const char BINARYPAGETYPE[25] = "application/octet-stream";
 const char JSONAPPTYPE[17] = "application/json";
 
 const char T_GET[5]  = "GET ";
@@ -26,12 +27,16 @@ const char T_PUT[5]  = "PUT ";
 const char H_FILENOTFOUNDSTR[196] = "<html><head><title>myFP2ESP8266</title></head><body><p>myFP2ESP8266</p><p>File not found</p><p><form action=\"/\" method=\"GET\"><input type=\"submit\" value=\"HOMEPAGE\"></form></p></body></html>";
 const char H_FSNOTLOADEDSTR[211] = "<html><head><title>myFP2ESP8266</title></head><body><p>myFP2ESP8266</p><p>err: File-system not started.</p><p><form action=\"/\" method=\"GET\"><input type=\"submit\" value=\"HOMEPAGE\"></form></p></body></html>";
 const char T_FILESYSTEMERROR[28] = "ERROR FileSystem not loaded";
+const char T_PAGETOOBIG[19] = "ERROR page too big";
 
 const char T_ACCESSPOINT[13] = "ACCESSPOINT ";
 const char T_STATION[9] = "STATION ";
 const char T_LOCALSERIAL[13] = "LOCALSERIAL ";
 const char T_CELSIUS[8] = "Celsius";
 const char T_FAHRENHEIT[11] = "Fahrenheit";
+const char T_TUBE[5] = "Tube";
+const char T_AMBIENT[8] = "Ambient";
+const char T_MIRROR[7] = "Mirror";
 //const char T_SERIAL[7] = "Serial";
 const char T_SSID[6] = "SSID ";
 const char T_DEVICENAME[12] = "DeviceName ";
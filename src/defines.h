@@ -78,6 +78,12 @@ extern void RangeCheck(float *, float, float);
 extern void get_systemuptime();
 extern void software_Reboot(int);
 extern long getrssi(void);
+extern void mark_firstrequest(void);
+extern void wifi_gettimes(char *, int);
+extern void boot_gettimes(char *, int);
+extern unsigned long wifi_reconnects(void);
+extern unsigned long wifi_downtime(void);
+extern unsigned long serialserver_speed(unsigned long);
 
 
 // FOCUSER SETTINGS
@@ -90,6 +96,8 @@ extern bool isMoving;
 extern float temp;
 extern bool tempcomp_state;
 extern bool tempcomp_available;
+extern bool camera_idle;
+extern long tempcomp_target;
 
 // CONTROLLER SETTINGS
 // States
@@ -127,6 +135,7 @@ extern char mySSID[BUFFER64LEN];
 extern char myAPSSID[BUFFER64LEN];
 extern char ipStr[BUFFER16LEN];
 extern char systemuptime[BUFFER12LEN];
+extern unsigned long looprate;
 extern bool filesystemloaded;
 extern int  myboardnumber;
 extern bool focuserDirection;
@@ -222,6 +231,9 @@ extern int  mystepsperrev;
 // DISPLAY (use I2Cscanner to find the correct address)
 // -------------------------------------------------------
 #define OLED_ADDR  0x3C // some displays maybe at 0x3D or 0x3F
+// I2C clock used by the graphics display, 400kHz fast mode,
+// 1000000L for fast mode plus if the panel supports it
+#define OLED_I2CCLOCK  400000L
 #define DISPLAYPAGETIME 4 // default page time
 // number of steps before updating position when moving if oledupdateonmove is 1
 #define DISPLAYUPDATEONMOVE 15    
@@ -316,6 +328,10 @@ extern int  mystepsperrev;
 // -------------------------------------------------------
 // 9600, 14400, 19200, 28800, 38400, 57600, 115200
 #define SERIALPORTSPEED  115200
+// speeds a client may switch to with :C6xxxxxx#, the
+// controller returns to SERIALPORTSPEED after a reboot
+// 115200, 230400, 460800, 921600
+#define SERIALPORTSPEEDMAX  921600
 
 // number of commands in queue
 #define MAXCOMMAND  10
@@ -326,12 +342,28 @@ extern int  mystepsperrev;
 // -------------------------------------------------------
 #define DEFAULTTEMPREFRESHTIME  3000 // in ms  
 #define DEFAULTTEMPRESOLUTION  10
+// start a probe conversion this often, in ms
+#define TEMPCONVERTTIME  1000
+// probes on the one wire bus, one per role
+#define TEMP_MAXPROBES  3
+// probe rom id as hex, 8 bytes + nul
+#define TEMP_ROMHEXLEN  17
+enum Probe_Roles { Probe_Tube,
+                   Probe_Ambient,
+                   Probe_Mirror };
+// temp comp, ema weight of a new reading, and the
+// default deadband in steps
+#define TEMP_EMAALPHA  0.2f
+#define DEFAULTTCDEADBAND  2
+#define MAXTCDEADBAND  100
 #define DEFAULTLASTTEMP  20.0f
 #define DEFAULTEMPPIN  10
 // Set the default DS18B20 resolution to 0.25 of a degree 9=0.5, 10=0.25, 11=0.125, 12=0.0625
 
 #define REBOOTDELAY  2000  // in ms, delay before reboot occurs
 #define DEFAULTSAVETIME  120000L // in ms, 120 seconds
+#define BOOTPHASES  12     // boot phase times kept
+#define BOOTTIMESLEN  320  // boot times text, phases and wifi
 
 
 // -------------------------------------------------------
@@ -340,6 +372,7 @@ extern int  mystepsperrev;
 extern const char TEXTPAGETYPE[10];
 extern const char PLAINTEXTPAGETYPE[11];
 extern const char JSONTEXTPAGETYPE[10];
+extern const char BINARYPAGETYPE[25];
 extern const char JSONAPPTYPE[17];
 
 extern const char T_GET[5];
@@ -349,12 +382,16 @@ extern const char T_PUT[5];
 extern const char H_FILENOTFOUNDSTR[196];
 extern const char H_FSNOTLOADEDSTR[211];
 extern const char T_FILESYSTEMERROR[28];
+extern const char T_PAGETOOBIG[19];
 
 extern const char T_ACCESSPOINT[13];
 extern const char T_STATION[9];
 extern const char T_LOCALSERIAL[13];
 extern const char T_CELSIUS[8];
 extern const char T_FAHRENHEIT[11];
+extern const char T_TUBE[5];
+extern const char T_AMBIENT[8];
+extern const char T_MIRROR[7];
 //extern const char T_SERIAL[7];
 extern const char T_SSID[6];
 extern const char T_DEVICENAME[12]; 
@@ -40,3 +40,16 @@ IPAddress station_gateway(192, 168, 2, 1);
 IPAddress station_subnet(255, 255, 255, 0);  
 IPAddress station_dns1(192, 168, 2, 1);
 IPAddress station_dns2(192, 168, 2, 1);
+
+
+//---------------------------------------------------
+// FAST CONNECT
+//---------------------------------------------------
+// The AP (BSSID) and channel of the last connection 
+// are saved, and the next boot connects to that AP 
+// without a scan. Set to true to also reuse the last 
+// DHCP lease as a static address, which skips DHCP. 
+// Only use this if your router always gives the 
+// controller the same address. Not used with STATICIP
+
+bool station_reuselease = false;
@@ -119,16 +119,15 @@ bool GRAPHIC_DISPLAY::start() {
   DisplayGraphicPrintln(T_FOUND);
 
   // For SH1106
-  _display = new SH1106Wire(_addr, 4, 5, GEOMETRY_128_64, I2C_ONE, 700000);
+  _display = new SH1106Wire(_addr, I2CDATAPIN, I2CCLKPIN, GEOMETRY_128_64, I2C_ONE, OLED_I2CCLOCK);
   // or
   // For SSD1306
-  //_display = new SSD1306Wire(_addr, 4, 5);
+  //_display = new SSD1306Wire(_addr, I2CDATAPIN, I2CCLKPIN, GEOMETRY_128_64, I2C_ONE, OLED_I2CCLOCK);
 
   _display->init();
 
   display_found = FOUND;
   _loaded = STATE_LOADED;
-  delay(1000);
   _display->flipScreenVertically();
   _display->setFont(ArialMT_Plain_10);
   _display->clear();
@@ -144,9 +143,8 @@ bool GRAPHIC_DISPLAY::start() {
   // draw wifi logo
   //display_draw_xbm(nwifi, 34, 14);
   display_draw_xbm(nwifi);
+  // boot screen is sent in one go, later updates use run()
   _display->display();
-  
-  delay(10);
   return true;
 }
 
@@ -158,6 +156,7 @@ void GRAPHIC_DISPLAY::stop(void) {
   DisplayGraphicPrintln(TUC_STOP); 
   delete _display;
   _loaded = STATE_NOTLOADED;
+  _flushpending = false;
 }
 
 // --------------------------------------------------------
@@ -167,7 +166,6 @@ void GRAPHIC_DISPLAY::clear(void) {
   if (_loaded == STATE_LOADED) {
     DisplayGraphicPrintln("Display clear");
     _display->clear();
-    delay(10);
   }
 }
 
@@ -179,7 +177,6 @@ void GRAPHIC_DISPLAY::off(void) {
     DisplayGraphicPrint(T_DISPLAYGRAPHIC);
     DisplayGraphicPrintln(T_OFF);
     _display->displayOff();
-    delay(10);
   }
 }
 
@@ -192,7 +189,6 @@ void GRAPHIC_DISPLAY::on(void) {
     DisplayGraphicPrintln(T_ON);
     _display->displayOn();
   }
-  delay(10);
 }
 
 
@@ -205,7 +201,6 @@ void GRAPHIC_DISPLAY::update_page(long position) {
     DisplayGraphicPrintln(T_UPDATE);
     draw_main_update(position);
   }
-  delay(10);
 }
 
 
@@ -224,9 +219,8 @@ void GRAPHIC_DISPLAY::update_position(long position) {
     DisplayGraphicPrintln("Display update position");
     snprintf(buff, sizeof(buff), "%ld", position);
     _display->drawString(x, y, buff);
-    _display->display();
+    flush_start();
   }
-  delay(10);
 }
 
 // --------------------------------------------------------
@@ -269,9 +263,83 @@ void GRAPHIC_DISPLAY::draw_main_update(long position) {
   snprintf(buffer, sizeof(buffer), "%c", _heartbeat[++_count_hb % 4]);
   _display->drawString(8, 14, buffer);
 
-  _display->display();
+  flush_start();
+}
+
+
+// --------------------------------------------------------
+// FLUSH FRAMEBUFFER
+// display() sends the whole 1KB framebuffer in one
+// blocking call. Instead, run() is called every pass of
+// loop() and sends only the bytes that differ from
+// buffer_back (what the panel holds), a chunk at a time,
+// and returns once OLED_FLUSHTIME us have been used. The
+// rest is sent on the following passes.
+// Page and column addressing is for the SH1106. For a
+// SSD1306 (horizontal addressing mode) use display().
+// --------------------------------------------------------
+void GRAPHIC_DISPLAY::flush_start(void) {
+  // restart from page 0, pages already sent are skipped
+  // as they match buffer_back
+  _flushpage = 0;
+  _flushcol = 0;
+  _flushpending = true;
+}
+
+void GRAPHIC_DISPLAY::run(void) {
+  if ((_loaded != STATE_LOADED) || (_flushpending == false)) {
+    return;
+  }
+
+  uint8_t *buf = _display->buffer;
+  uint8_t *back = _display->buffer_back;
+  unsigned long start = micros();
 
-  delay(10);
+  while (_flushpage < OLED_PAGES) {
+    uint16_t row = _flushpage * SCREEN_WIDTH;
+
+    // find next changed column in this page
+    uint8_t x = _flushcol;
+    while ((x < SCREEN_WIDTH) && (buf[row + x] == back[row + x])) {
+      x++;
+    }
+    if (x == SCREEN_WIDTH) {
+      _flushpage++;
+      _flushcol = 0;
+      continue;
+    }
+
+    // send up to OLED_FLUSHCHUNK bytes, ending on a changed byte
+    uint8_t end = ((x + OLED_FLUSHCHUNK) < SCREEN_WIDTH) ? (x + OLED_FLUSHCHUNK) : SCREEN_WIDTH;
+    while ((end > (x + 1)) && (buf[row + end - 1] == back[row + end - 1])) {
+      end--;
+    }
+    send_data(_flushpage, x, &buf[row + x], end - x);
+    memcpy(&back[row + x], &buf[row + x], end - x);
+    _flushcol = end;
+
+    if ((micros() - start) >= OLED_FLUSHTIME) {
+      return;
+    }
+  }
+  _flushpending = false;
+}
+
+// write len bytes at page, column
+void GRAPHIC_DISPLAY::send_data(uint8_t page, uint8_t col, const uint8_t *data, uint8_t len) {
+  col += OLED_COLOFFSET;
+  // command stream: page, column low, column high
+  Wire.beginTransmission(_addr);
+  Wire.write(0x00);
+  Wire.write(0xB0 + page);
+  Wire.write(col & 0x0F);
+  Wire.write(0x10 | (col >> 4));
+  Wire.endTransmission();
+  // data stream
+  Wire.beginTransmission(_addr);
+  Wire.write(0x40);
+  Wire.write(data, len);
+  Wire.endTransmission();
 }
 
 
@@ -313,7 +381,6 @@ void GRAPHIC_DISPLAY::display_draw_xbm(logo_num num) {
         break;
     }
     _display->display();
-    delay(10);
   }
 }
 
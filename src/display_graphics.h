@@ -39,6 +39,11 @@
 #define HEARTBEAT2 0x2F //  /
 #define HEARTBEAT3 0x2D //  - 
 #define HEARTBEAT4 0x5C //  \
+// framebuffer flush, see run()
+#define OLED_PAGES       8      // 8 pixel rows per page
+#define OLED_COLOFFSET   2      // SH1106 ram is 132 columns wide
+#define OLED_FLUSHCHUNK  16     // bytes per I2C data write
+#define OLED_FLUSHTIME   1000   // max us spent flushing per run()
 
 // Note: TEXT/GRAPHICS use the exact same class definition
 // but private members can be different.
@@ -59,14 +64,20 @@ class GRAPHIC_DISPLAY {
     void off(void);
 
     void display_draw_xbm(logo_num);
+    void run(void);
 
   private:
     void draw_main_update(long);
+    void flush_start(void);
+    void send_data(uint8_t, uint8_t, const uint8_t *, uint8_t);
 
     uint8_t _addr;
     bool _loaded = STATE_NOTLOADED;
     byte _count_hb = 0;
     const char _heartbeat[4] = { HEARTBEAT1, HEARTBEAT2, HEARTBEAT3, HEARTBEAT4 };
+    bool _flushpending = false;
+    uint8_t _flushpage = 0;
+    uint8_t _flushcol = 0;
     
     SH1106Wire *_display;
     // or
@@ -115,6 +115,7 @@ const char DT_MODEERROR[6]       = "ERROR";
 TEXT_DISPLAY::TEXT_DISPLAY(uint8_t addr)
   : _addr(addr) {
   _loaded = STATE_NOTLOADED;
+  invalidate();
 }
 
 
@@ -172,6 +173,8 @@ bool TEXT_DISPLAY::start() {
   _display->println(project_name);
   _display->println(major_version);
   _display->println("BOOTING");
+  // boot text is not in the shadow rows
+  invalidate();
   return true;
 }
 
@@ -193,6 +196,10 @@ void TEXT_DISPLAY::stop(void) {
 void TEXT_DISPLAY::clear(void) {
   if (_loaded == STATE_LOADED) {
     _display->clear();
+    for (uint8_t r = 0; r < TEXT_ROWS; r++) {
+      _shown[r][0] = 0x00;
+      _shownscale[r] = TEXT_BLANK;
+    }
   }
 }
 
@@ -237,19 +244,100 @@ void TEXT_DISPLAY::update_page(long position) {
 
 // -------------------------------------------------------
 // UPDATE POSITION
+// rows 1 and 2 only, called while moving
 // -------------------------------------------------------
 void TEXT_DISPLAY::update_position(long position) {
   if (_loaded == STATE_LOADED) {
-    _display->setCursor(0, 0);
-    _display->print(DT_POSITION);
-    _display->print(position);
-    _display->clearToEOL();
-    _display->println();
-
-    _display->print(DT_T);
-    _display->print(ftargetPosition);
-    _display->clearToEOL();
-    _display->println();
+    _pagescale[0] = 2;
+    _pagescale[1] = 2;
+    snprintf(_page[0], TEXT_ROWLEN, "%s%ld", DT_POSITION, position);
+    snprintf(_page[1], TEXT_ROWLEN, "%s%ld", DT_T, ftargetPosition);
+    flush(0, 1);
+  }
+}
+
+
+// -------------------------------------------------------
+// SHADOW ROWS
+// _shown is the text on screen, a page is drawn into
+// _page and flush() writes only the characters that
+// differ, so an update that changes one digit writes one
+// character cell instead of the whole screen.
+// Row r is at display pages r*2 and r*2+1, a 1X row uses
+// the first page only and the second is kept blank.
+// -------------------------------------------------------
+
+// screen contents unknown, the next flush rewrites all rows
+void TEXT_DISPLAY::invalidate(void) {
+  for (uint8_t r = 0; r < TEXT_ROWS; r++) {
+    _shown[r][0] = 0x00;
+    _shownscale[r] = TEXT_UNKNOWN;
+  }
+}
+
+// start a new page, all rows empty at 2X
+void TEXT_DISPLAY::begin_page(void) {
+  for (uint8_t r = 0; r < TEXT_ROWS; r++) {
+    _page[r][0] = 0x00;
+    _pagescale[r] = 2;
+  }
+}
+
+// write the changed characters of rows first to last
+void TEXT_DISPLAY::flush(uint8_t first, uint8_t last) {
+  for (uint8_t r = first; r <= last; r++) {
+    uint8_t scale = _pagescale[r];
+    uint8_t cols = (scale == 2) ? TEXT_COLS2X : TEXT_COLS1X;
+    char *want = _page[r];
+    char *have = _shown[r];
+
+    // clip to the row width
+    want[cols] = 0x00;
+
+    // different scale or unknown, clear both pages of the row
+    if ((_shownscale[r] != scale) && (_shownscale[r] != TEXT_BLANK)) {
+      _display->set2X();
+      _display->setCursor(0, r * 2);
+      _display->clearToEOL();
+      have[0] = 0x00;
+    }
+
+    uint8_t wlen = strlen(want);
+    uint8_t hlen = strlen(have);
+    uint8_t len = (wlen > hlen) ? wlen : hlen;
+
+    // first and last differing cells, past the end is blank
+    uint8_t start = 0;
+    while ((start < len) && (((start < wlen) ? want[start] : ' ') == ((start < hlen) ? have[start] : ' '))) {
+      start++;
+    }
+    if (start < len) {
+      uint8_t end = len - 1;
+      while ((end > start) && (((end < wlen) ? want[end] : ' ') == ((end < hlen) ? have[end] : ' '))) {
+        end--;
+      }
+
+      if (scale == 2) {
+        _display->set2X();
+      } else {
+        _display->set1X();
+      }
+      _display->setCursor(start * TEXT_CHARWIDTH * scale, r * 2);
+      if (end >= wlen) {
+        // new text is shorter, clear the old tail
+        for (uint8_t i = start; i < wlen; i++) {
+          _display->write(want[i]);
+        }
+        _display->clearToEOL();
+      } else {
+        for (uint8_t i = start; i <= end; i++) {
+          _display->write(want[i]);
+        }
+      }
+    }
+
+    strlcpy(have, want, TEXT_ROWLEN);
+    _shownscale[r] = (wlen == 0) ? TEXT_BLANK : scale;
   }
 }
 
@@ -270,10 +358,10 @@ void TEXT_DISPLAY::draw_main_update(long position) {
   static int displaybitmask = 1;
 
   // get page options
-  String mypage = ControllerData->get_display_pageoption();
+  const char *mypage = ControllerData->get_display_pageoption();
   DisplayTextPrint("display:pageoption:");
   DisplayTextPrintln(mypage);
-  for (int i = 0; i < (int)mypage.length(); i++) {
+  for (int i = 0; mypage[i] != 0x00; i++) {
     page *= 2;
     if (mypage[i] == '1') {
       page++;
@@ -299,8 +387,7 @@ void TEXT_DISPLAY::draw_main_update(long position) {
     displaybitmask = 1;
   }
 
-  _display->clear();
-  _display->set2X();
+  begin_page();
 
   // displaybitmask is now the page to display,
   // 1=pg1, 2=pg2, 4=pg3, 8=pg4 etc
@@ -339,16 +426,20 @@ void TEXT_DISPLAY::draw_main_update(long position) {
       page1(position);
       break;
   }
+
+  // write only what changed
+  flush(0, TEXT_ROWS - 1);
+
   // next page
   displaybitmask *= 2;
 }
 
-// 128x64
+// 128x64, 6 pixels per char at 1X
 // _display->set1X();
-// 16 chars per line
+// 21 chars per line
 // 8 rows
 // _display->set2X();
-// 8 chars per line
+// 10 chars per line
 // 4 rows
 
 // P 80000  = 7 chars
@@ -362,39 +453,20 @@ void TEXT_DISPLAY::draw_main_update(long position) {
 // Moving MoveDirection
 // -------------------------------------------------------
 void TEXT_DISPLAY::page1(long position) {
-  if (_loaded == STATE_LOADED) {
-    _display->home();
-
-    // Line 1 of 4: Position
-    _display->print(DT_POSITION);
-    _display->print(position);
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 2 of 4: Target Position
-    _display->print(DT_T);
-    _display->print(ftargetPosition);
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 3 of 4: maxStep
-    _display->print(DT_MAXSTEP);
-    _display->print(ControllerData->get_maxstep());
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 4 of 4: isMoving and IN | OUT
-    if (isMoving) {
-      _display->print(DT_ISMOVING);
-      if (ControllerData->get_focuserdirection()) {
-        _display->print("O");
-      } else {
-        _display->print("I");
-      }
-    } else {
-      _display->print(T_STOPPED);
-    }
-    _display->clearToEOL();
+  // Line 1 of 4: Position
+  snprintf(_page[0], TEXT_ROWLEN, "%s%ld", DT_POSITION, position);
+
+  // Line 2 of 4: Target Position
+  snprintf(_page[1], TEXT_ROWLEN, "%s%ld", DT_T, ftargetPosition);
+
+  // Line 3 of 4: maxStep
+  snprintf(_page[2], TEXT_ROWLEN, "%s%ld", DT_MAXSTEP, ControllerData->get_maxstep());
+
+  // Line 4 of 4: isMoving and IN | OUT
+  if (isMoving) {
+    snprintf(_page[3], TEXT_ROWLEN, "%s%s", DT_ISMOVING, (ControllerData->get_focuserdirection()) ? "O" : "I");
+  } else {
+    strlcpy(_page[3], T_STOPPED, TEXT_ROWLEN);
   }
 }
 
@@ -407,56 +479,35 @@ void TEXT_DISPLAY::page1(long position) {
 // StepMode
 // -------------------------------------------------------
 void TEXT_DISPLAY::page2(void) {
-  if (_loaded == STATE_LOADED) {
-    _display->home();
+  // Line 1 of 4: Temperature + c|f
+  char tstr[12];
+  float tp = temp;
+  if (ControllerData->get_tempmode() == FAHRENHEIT) {
+    tp = (tp * 1.8) + 32;
+  }
+  dtostrf(tp, 1, 2, tstr);
+  snprintf(_page[0], TEXT_ROWLEN, "%s%s%s", DT_T, tstr, (ControllerData->get_tempmode() == CELSIUS) ? "c" : "f");
 
-    // Line 1 of 4: Temperature + c|f
-    _display->print(DT_T);
-    float tp = temp;
-    if (ControllerData->get_tempmode() == FAHRENHEIT) {
-      tp = (tp * 1.8) + 32;
-    }
-    _display->print(String(tp, 2));
-    if (ControllerData->get_tempmode() == CELSIUS) {
-      _display->print("c");
-    } else {
-      _display->print("f");
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 2 of 4: TempComp State
-    _display->print(DT_TEMPCOMP);
-    if (tempcomp_state) {
-      _display->print(T_ON);
-    } else {
-      _display->print(T_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 3 of 4: MOTOR SPEED
-    int speed = ControllerData->get_motorspeed();
-    _display->print(DT_MOTORSPEED);
-    switch (speed) {
-      case 0:
-        _display->print(SPEED_SLOW);
-        break;
-      case 1:
-        _display->print(SPEED_MEDIUM);
-        break;
-      case 2:
-        _display->print(SPEED_FAST);
-        break;
-    }
-    _display->clearToEOL();
-    _display->println();
+  // Line 2 of 4: TempComp State
+  snprintf(_page[1], TEXT_ROWLEN, "%s%s", DT_TEMPCOMP, (tempcomp_state) ? T_ON : T_OFF);
 
-    // Line 4 of 4: STEP MODE
-    _display->print(DT_STEPMODE);
-    _display->print(ControllerData->get_brdstepmode());
-    _display->clearToEOL();
+  // Line 3 of 4: MOTOR SPEED
+  const char *speed = "";
+  switch (ControllerData->get_motorspeed()) {
+    case 0:
+      speed = SPEED_SLOW;
+      break;
+    case 1:
+      speed = SPEED_MEDIUM;
+      break;
+    case 2:
+      speed = SPEED_FAST;
+      break;
   }
+  snprintf(_page[2], TEXT_ROWLEN, "%s%s", DT_MOTORSPEED, speed);
+
+  // Line 4 of 4: STEP MODE
+  snprintf(_page[3], TEXT_ROWLEN, "%s%d", DT_STEPMODE, ControllerData->get_brdstepmode());
 }
 
 
@@ -468,44 +519,17 @@ void TEXT_DISPLAY::page2(void) {
 // Firmware revision
 // -------------------------------------------------------
 void TEXT_DISPLAY::page3(void) {
-  if (_loaded == STATE_LOADED) {
-    _display->home();
-
-    // Line 1 of 4: Coil power
-    _display->print(DT_COILPOWER);
-    if (ControllerData->get_coilpower_enable() == STATE_ENABLED) {
-      _display->print(T_ON);
-    } else {
-      _display->print(T_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 2 of 4: Reverse direction
-    _display->print(DT_REVERSE);
-    if (ControllerData->get_reverse_enable() == STATE_ENABLED) {
-      _display->print(T_ON);
-    } else {
-      _display->print(T_OFF);
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 3 of 4: DRVBRD
-    //_display->print(DT_DRIVERBOARD);
-    String name = ControllerData->get_brdname();
-    String bname = name.substring(0, 15);
-    _display->print(bname);
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 4 of 4: Firmware Version
-    //_display->print(DT_FIRMWAREVERSION);
-    _display->print(major_version);
-    _display->print("-");
-    _display->print(minor_version);
-    _display->clearToEOL();
-  }
+  // Line 1 of 4: Coil power
+  snprintf(_page[0], TEXT_ROWLEN, "%s%s", DT_COILPOWER, (ControllerData->get_coilpower_enable() == STATE_ENABLED) ? T_ON : T_OFF);
+
+  // Line 2 of 4: Reverse direction
+  snprintf(_page[1], TEXT_ROWLEN, "%s%s", DT_REVERSE, (ControllerData->get_reverse_enable() == STATE_ENABLED) ? T_ON : T_OFF);
+
+  // Line 3 of 4: DRVBRD
+  snprintf(_page[2], TEXT_ROWLEN, "%.15s", ControllerData->get_brdname());
+
+  // Line 4 of 4: Firmware Version
+  snprintf(_page[3], TEXT_ROWLEN, "%s-%s", major_version, minor_version);
 }
 
 
@@ -514,22 +538,11 @@ void TEXT_DISPLAY::page3(void) {
 // BACKLASH IN-OUT ENABLE, BACKLASH IN-OUT STEPS
 // -------------------------------------------------------
 void TEXT_DISPLAY::page4(void) {
-  if (_loaded == STATE_LOADED) {
-    _display->home();
-
-    // Line 1 of 2: BACKLASHIN STEPS
-    _display->print(DT_BACKLASHINSTEPS);
-    int steps = ControllerData->get_backlashsteps_in();
-    _display->print(steps);
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 2 of 2: BACKLASHOUT STEPS
-    _display->print(DT_BACKLASHOUTSTEPS);
-    steps = ControllerData->get_backlashsteps_out();
-    _display->print(steps);
-    _display->clearToEOL();
-  }
+  // Line 1 of 2: BACKLASHIN STEPS
+  snprintf(_page[0], TEXT_ROWLEN, "%s%d", DT_BACKLASHINSTEPS, ControllerData->get_backlashsteps_in());
+
+  // Line 2 of 2: BACKLASHOUT STEPS
+  snprintf(_page[1], TEXT_ROWLEN, "%s%d", DT_BACKLASHOUTSTEPS, ControllerData->get_backlashsteps_out());
 }
 
 
@@ -541,82 +554,51 @@ void TEXT_DISPLAY::page4(void) {
 // MDNS NAME
 // -------------------------------------------------------
 void TEXT_DISPLAY::page5(void) {
-  if (_loaded == STATE_LOADED) {
-    _display->home();
-
-    String ssID;
-
-    // Line 1 of 4: MODE SERIAL | ACCESSPOINT | STATION
-    //_display->print(DT_MODE);
-    if (mycontrollermode == LOCALSERIAL) {
-      _display->print(DT_MODELSERIAL);
-      ssID = "---";
-    } else if (mycontrollermode == ACCESSPOINT) {
-      _display->print(DT_MODEACCESSPOINT);
-      ssID = String(myAPSSID);
-    } else if (mycontrollermode == STATION) {
-      _display->print(T_STATION);
-      ssID = String(mySSID);
-    } else {
-      _display->print(DT_MODEERROR);
-      ssID = "---";
-    }
-    _display->clearToEOL();
-    _display->println();
-
-    //ssID = ssID.substring(0, 5);
+  const char *ssID;
+
+  // Line 1 of 4: MODE SERIAL | ACCESSPOINT | STATION
+  if (mycontrollermode == LOCALSERIAL) {
+    strlcpy(_page[0], DT_MODELSERIAL, TEXT_ROWLEN);
+    ssID = "---";
+  } else if (mycontrollermode == ACCESSPOINT) {
+    strlcpy(_page[0], DT_MODEACCESSPOINT, TEXT_ROWLEN);
+    ssID = myAPSSID;
+  } else if (mycontrollermode == STATION) {
+    strlcpy(_page[0], T_STATION, TEXT_ROWLEN);
+    ssID = mySSID;
+  } else {
+    strlcpy(_page[0], DT_MODEERROR, TEXT_ROWLEN);
+    ssID = "---";
+  }
 
-    // Line 2 of 4: SSID
-    _display->print(T_SSID);
-    _display->print(ssID.substring(0, 6));
-    _display->clearToEOL();
-    _display->println();
+  // Line 2 of 4: SSID
+  snprintf(_page[1], TEXT_ROWLEN, "%s%.6s", T_SSID, ssID);
 
-    // Line 3 of 4: DEVICENAME
-    _display->print(DeviceName);
-    _display->clearToEOL();
-    _display->println();
+  // Line 3 of 4: DEVICENAME
+  strlcpy(_page[2], DeviceName, TEXT_ROWLEN);
 
-    // Line 4 of 4: MDNS NAME
-    _display->print(MDNSName);
-    _display->clearToEOL();
-  }
+  // Line 4 of 4: MDNS NAME
+  strlcpy(_page[3], MDNSName, TEXT_ROWLEN);
 }
 
 
 // -------------------------------------------------------
 // PAGE 6
-// IP
+// IP, small
 // HEAP
 // SUT
-// ???
 // -------------------------------------------------------
 void TEXT_DISPLAY::page6(void) {
-  if (_loaded == STATE_LOADED) {
-    _display->home();
-
-    _display->set1X();
+  // Line 1 of 4: IP
+  _pagescale[0] = 1;
+  strlcpy(_page[0], ipStr, TEXT_ROWLEN);
 
-    // Line 1 of 4: IP
-    _display->print(ipStr);
-    _display->clearToEOL();
-    _display->println();
+  // Line 2 of 4: HEAP
+  snprintf(_page[1], TEXT_ROWLEN, "%lu", (unsigned long)ESP.getFreeHeap());
 
-    _display->println();
-
-    _display->set2X();
-
-    // Line 2 of 4: HEAP
-    _display->print(String(ESP.getFreeHeap()));
-    _display->clearToEOL();
-    _display->println();
-
-    // Line 3 of 4: SUT
-    get_systemuptime();
-    _display->print(systemuptime);
-    _display->clearToEOL();
-    _display->println();
-  }
+  // Line 3 of 4: SUT
+  get_systemuptime();
+  strlcpy(_page[2], systemuptime, TEXT_ROWLEN);
 }
 
 #endif  // #if (DISPLAYTYPE == TEXT_OLED12864)
@@ -23,6 +23,20 @@
 #include <mySSD1306AsciiWire.h>
 
 
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// 128x64, 4 text rows, each row is two display pages
+#define TEXT_ROWS       4
+#define TEXT_COLS2X     10
+#define TEXT_COLS1X     21
+#define TEXT_ROWLEN     22      // TEXT_COLS1X + terminator
+#define TEXT_CHARWIDTH  6       // 5x7 font plus 1 space, at 1X
+// shown row scale when not 1 or 2
+#define TEXT_BLANK      0       // row is clear
+#define TEXT_UNKNOWN    0xFF    // row contents not known
+
+
 // Note: TEXT/GRAPHICS use the exact same class
 // definition, but private members can be different.
 // -------------------------------------------------------
@@ -50,10 +64,17 @@ class TEXT_DISPLAY {
     void page4(void);
     void page5(void);
     void page6(void);
+    void invalidate(void);
+    void begin_page(void);
+    void flush(uint8_t, uint8_t);
 
     uint8_t _addr;
     bool _loaded = STATE_NOTLOADED;
     SSD1306AsciiWire *_display;  
+    char _shown[TEXT_ROWS][TEXT_ROWLEN];  // text on screen
+    uint8_t _shownscale[TEXT_ROWS];
+    char _page[TEXT_ROWS][TEXT_ROWLEN];   // text being drawn
+    uint8_t _pagescale[TEXT_ROWS];
 };
 
 #endif
@@ -97,6 +97,8 @@ extern volatile bool halt_alert;
 // -------------------------------------------------------
 // DEFINES
 // -------------------------------------------------------
+// boards require 1ms after enable before stepping can occur
+#define MOTORENABLETIME 1000UL  // in us
 
 
 // -------------------------------------------------------
@@ -267,7 +269,6 @@ void DRIVER_BOARD::start(long startposition) {
   // For all boards do the following
   // set default focuser position to same as ControllerData
   _focuserposition = startposition;
-  delay(10);
 }
 
 // -------------------------------------------------------
@@ -297,7 +298,21 @@ void DRIVER_BOARD::enablemotor(void) {
     digitalWrite(ControllerData->get_brdenablepin(), 0);
   }
   // boards require 1ms before stepping can occur
-  delay(1);
+  // do not wait here, record the time and let the caller
+  // check motorready() before stepping
+  if (_enabled == false) {
+    _enabled = true;
+    _enabletime = micros();
+  }
+}
+
+// -------------------------------------------------------
+// MOTOR READY
+// true once MOTORENABLETIME has elapsed since the motor
+// was enabled
+// -------------------------------------------------------
+bool DRIVER_BOARD::motorready(void) {
+  return (_enabled == true) && ((micros() - _enabletime) >= MOTORENABLETIME);
 }
 
 // -------------------------------------------------------
@@ -305,6 +320,7 @@ void DRIVER_BOARD::enablemotor(void) {
 // Turns off coil power current to the motor.
 // -------------------------------------------------------
 void DRIVER_BOARD::releasemotor(void) {
+  _enabled = false;
   // all DRV8825 boards
   if ( (_boardnum == WEMOSDRV8825)  || (_boardnum == PRO2EDRV8825) \
     || (_boardnum == PRO2EDRV8825S) || (_boardnum == PRO2EDRV8825DS)) {
@@ -368,7 +384,6 @@ void DRIVER_BOARD::initmove(bool mdir, long steps) {
   if (ITimer.attachInterruptInterval(msdelay, TimerHandler) == false) {
     DrvBrdMsgPrintln("err ITimer");
   }
-  delay(10);
 }
 
 // -------------------------------------------------------
@@ -475,7 +490,6 @@ void DRIVER_BOARD::movemotor(bool ddir, bool updateposition) {
 void DRIVER_BOARD::end_move(void) {
   ITimer.detachInterrupt();
   DrvBrdMsgPrintln("Move done");
-  delay(10);
 }
 
 
@@ -521,7 +535,6 @@ void DRIVER_BOARD::setstepmode(int smode) {
     ControllerData->set_brdstepmode(STEP1);
 #endif
   } while (0);
-  delay(10);
 }
 
 
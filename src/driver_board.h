@@ -43,6 +43,7 @@ public:
 
   // set
   void enablemotor(void);
+  bool motorready(void);
   void releasemotor(void);
   void setposition(long);
   void setstepmode(int);
@@ -70,6 +71,8 @@ private:
   int _dirpin;    // ControllerData->get_brddirpin()
   int _enablepin; // ControllerData->get_brdenablepin()
   int _steppin;   // ControllerData->get_brdsteppin()
+  bool _enabled = false;           // coil power is on
+  unsigned long _enabletime = 0;   // micros() when motor was enabled
   
 };
 
@@ -15,8 +15,8 @@
 
 #if defined(ENABLE_DUCKDNS)
 
-// https://github.com/ayushsharma82/EasyDDNS
-#include <EasyDDNS.h>
+#include <ESP8266WiFi.h>
+#include <lwip/dns.h>
 #include "duckdns.h"
 
 
@@ -51,11 +51,9 @@ extern CONTROLLER_DATA *ControllerData;
 
 // -------------------------------------------------------
 // CLASS CONSTRUCTOR
-// REFRESH IS HANDLED BY LIB - JUST SET THE REFRESH VALUE
 // -------------------------------------------------------
 DUCK_DNS::DUCK_DNS() {
   _loaded = STATE_NOTLOADED;
-  cntlr_ip.reserve(24);
 }
 
 
@@ -77,38 +75,13 @@ bool DUCK_DNS::start(void) {
     return false;
   }
 
-  // Set DDNS Service Name to "duckdns"
-  EasyDDNS.service("duckdns");
-
-  String domain = ControllerData->get_duckdns_domain();
-  int domainlen = domain.length() + 1;
-  String token = ControllerData->get_duckdns_token();
-  int tokenlen = token.length() + 1;
-  char ddd[domainlen];
-  char ddt[tokenlen];
-  domain.toCharArray(ddd, domainlen);
-  token.toCharArray(ddt, tokenlen);
-  // Enter ddns Domain & Token | Example - "esp.duckdns.org","1234567"
-  EasyDDNS.client(ddd, ddt);
   DuckdnsMsgPrint("domain: ");
-  DuckdnsMsgPrintln(ddd);
-  DuckdnsMsgPrint("token: ");
-  DuckdnsMsgPrintln(ddt);
-
-  // convert refreshrate to milliseconds
-  EasyDDNS.update(DUCKDNS_REFRESHRATE * 1000);
-
-  // Get Notified when your IP changes
-  EasyDDNS.onUpdate([&](const char* old_duckdns_ip, const char* new_duckdns_ip) {
-    DuckdnsMsgPrint("ddns:ipchange:");
-    DuckdnsMsgPrintln(new_duckdns_ip);
-    old_duckdns_ip = new_duckdns_ip;
-    cntlr_ip = String(new_duckdns_ip);
-    DuckdnsMsgPrint("old_duckdns_ip:");
-    DuckdnsMsgPrintln(old_duckdns_ip);
-    DuckdnsMsgPrint("new_duckdns_ip:");
-    DuckdnsMsgPrintln(new_duckdns_ip);
-  });
+  DuckdnsMsgPrintln(ControllerData->get_duckdns_domain());
+
+  _state = DDNS_Idle;
+  _retrytime = DUCKDNS_RETRYTIME;
+  // force an update to duckdns on the first check
+  _ddnsip[0] = 0x00;
   _loaded = STATE_LOADED;
   duckdns_status = STATUS_RUNNING;
   this->updatenow();
@@ -120,6 +93,8 @@ bool DUCK_DNS::start(void) {
 // STOP DUCKDNS
 // -------------------------------------------------------
 void DUCK_DNS::stop() {
+  _client.stop();
+  _state = DDNS_Idle;
   _loaded = false;
   duckdns_status = STATUS_STOPPED;
   DuckdnsMsgPrint(T_DUCKDNS);
@@ -128,29 +103,267 @@ void DUCK_DNS::stop() {
 
 
 // -------------------------------------------------------
-// GET IP ADDRESS FROM EASYDNS SERVER
+// GET IP ADDRESS LAST SENT TO DUCKDNS
 // -------------------------------------------------------
 String DUCK_DNS::get_ddns_ip() {
-  return cntlr_ip;
+  return String(_ddnsip);
 }
 
 
 // -------------------------------------------------------
 // UPDATE DUCKDNS
+// check the public ip on the next run(), does not wait
 // -------------------------------------------------------
 void DUCK_DNS::updatenow() {
   DuckdnsMsgPrint(T_DUCKDNS);
   DuckdnsMsgPrintln(T_UPDATE);
 
   if (_loaded == STATE_LOADED) {
-    EasyDDNS.update(false);      // use global ip
-    DuckdnsMsgPrint("ip:");
-    DuckdnsMsgPrintln(this->get_ddns_ip());
-  }
-  else {
+    _nexttime = millis();
+    _waittime = 0;
+  } else {
     DuckdnsMsgPrintln(T_ERROR);
   }
 }
 
-#endif
 
+// -------------------------------------------------------
+// RUN
+// Called every pass of loop(), one step per call
+// Idle     wait for next check time
+// Resolve  wait for host name lookup
+// Connect  connect to host, send request
+// Read     read the reply as it arrives, until the
+//          server closes the connection
+// -------------------------------------------------------
+void DUCK_DNS::run(void) {
+  if (_loaded != STATE_LOADED) {
+    return;
+  }
+
+  unsigned long now = millis();
+
+  switch (_state) {
+    case DDNS_Idle:
+      if ((now - _nexttime) >= _waittime) {
+        if (WiFi.status() != WL_CONNECTED) {
+          end_request(false);
+          break;
+        }
+        begin_request(DDNS_GetIP);
+      }
+      break;
+
+    case DDNS_Resolve:
+      if (_resolved) {
+        if (_hostip.isSet()) {
+          _state = DDNS_Connect;
+        } else {
+          DuckdnsMsgPrintln("ddns:dns:not found");
+          end_request(false);
+        }
+      } else if ((now - _steptime) >= DUCKDNS_DNSTIMEOUT) {
+        DuckdnsMsgPrintln("ddns:dns:timeout");
+        end_request(false);
+      }
+      break;
+
+    case DDNS_Connect:
+      _client.setTimeout(DUCKDNS_CONNECTTIMEOUT);
+      if ((_client.connect(_hostip, DUCKDNS_PORT) == 0) || (send_request() == false)) {
+        DuckdnsMsgPrintln("ddns:connect:failed");
+        end_request(false);
+        break;
+      }
+      _linelen = 0;
+      _part = Reply_Status;
+      _httpcode = 0;
+      if (_request == DDNS_GetIP) {
+        _newip[0] = 0x00;
+      }
+      _steptime = millis();
+      _state = DDNS_Read;
+      break;
+
+    case DDNS_Read:
+      {
+        // only what has already arrived, never wait
+        int avail = _client.available();
+        if (avail > 0) {
+          while (avail-- > 0) {
+            parse((char)_client.read());
+          }
+          _steptime = now;
+          break;
+        }
+        if (!_client.connected()) {
+          // complete, flush last body line
+          parse('\n');
+          _client.stop();
+          if (_request == DDNS_GetIP) {
+            IPAddress ip;
+            if ((_httpcode != 200) || (ip.fromString(_newip) == false)) {
+              DuckdnsMsgPrintln("ddns:ip:bad reply");
+              end_request(false);
+            } else if (strcmp(_newip, _ddnsip) == 0) {
+              // public ip unchanged, nothing to send
+              end_request(true);
+            } else {
+              DuckdnsMsgPrint("ddns:ipchange:");
+              DuckdnsMsgPrintln(_newip);
+              begin_request(DDNS_Update);
+            }
+          } else {
+            // duckdns replies OK or KO
+            if ((_httpcode == 200) && (_part == Reply_Done) && (strcmp(_line, "OK") == 0)) {
+              strlcpy(_ddnsip, _newip, DUCKDNS_IPLEN);
+              end_request(true);
+            } else {
+              DuckdnsMsgPrintln("ddns:update:failed");
+              end_request(false);
+            }
+          }
+        } else if ((now - _steptime) >= DUCKDNS_READTIMEOUT) {
+          DuckdnsMsgPrintln("ddns:read:timeout");
+          end_request(false);
+        }
+      }
+      break;
+  }
+}
+
+
+// -------------------------------------------------------
+// START A REQUEST, begin the host name lookup
+// -------------------------------------------------------
+void DUCK_DNS::begin_request(DDNS_Requests request) {
+  ip_addr_t addr;
+
+  _host = (request == DDNS_GetIP) ? DUCKDNS_IPHOST : DUCKDNS_UPDATEHOST;
+  _request = request;
+  _resolved = false;
+  _hostip = IPAddress();
+  _steptime = millis();
+
+  err_t err = dns_gethostbyname(_host, &addr, &DUCK_DNS::dns_found, this);
+  if (err == ERR_OK) {
+    // cached
+    _hostip = IPAddress(&addr);
+    _state = DDNS_Connect;
+  } else if (err == ERR_INPROGRESS) {
+    _state = DDNS_Resolve;
+  } else {
+    end_request(false);
+  }
+}
+
+// lwip callback, may be called from the network stack
+void DUCK_DNS::dns_found(const char *name, const ip_addr_t *addr, void *arg) {
+  DUCK_DNS *self = (DUCK_DNS *)arg;
+  if ((self->_state != DDNS_Resolve) || (strcmp(name, self->_host) != 0)) {
+    // late reply to a lookup that timed out
+    return;
+  }
+  if (addr != nullptr) {
+    self->_hostip = IPAddress(addr);
+  }
+  self->_resolved = true;
+}
+
+
+// -------------------------------------------------------
+// END A REQUEST
+// Schedule the next check, after DUCKDNS_REFRESHRATE on
+// success, or after a retry time that doubles on each
+// failure up to DUCKDNS_MAXRETRYTIME
+// -------------------------------------------------------
+void DUCK_DNS::end_request(bool ok) {
+  _client.stop();
+  _state = DDNS_Idle;
+  _nexttime = millis();
+  if (ok) {
+    _retrytime = DUCKDNS_RETRYTIME;
+    _waittime = DUCKDNS_REFRESHRATE * 1000UL;
+  } else {
+    _waittime = _retrytime;
+    _retrytime *= 2;
+    if (_retrytime > DUCKDNS_MAXRETRYTIME) {
+      _retrytime = DUCKDNS_MAXRETRYTIME;
+    }
+    DuckdnsMsgPrint("ddns:retry in ms:");
+    DuckdnsMsgPrintln(_waittime);
+  }
+}
+
+
+// -------------------------------------------------------
+// SEND REQUEST
+// HTTP/1.0 so the server closes the connection at the end
+// of the reply
+// -------------------------------------------------------
+bool DUCK_DNS::send_request(void) {
+  char buff[DUCKDNS_REQUESTLEN];
+  int len;
+
+  if (_request == DDNS_GetIP) {
+    len = snprintf(buff, sizeof(buff), "GET %s HTTP/1.0\r\nHost: %s\r\nUser-Agent: curl\r\n\r\n", DUCKDNS_IPPATH, DUCKDNS_IPHOST);
+  } else {
+    len = snprintf(buff, sizeof(buff), "GET /update?domains=%s&token=%s&ip=%s HTTP/1.0\r\nHost: %s\r\n\r\n",
+                   ControllerData->get_duckdns_domain(), ControllerData->get_duckdns_token(), _newip, DUCKDNS_UPDATEHOST);
+  }
+  if ((len <= 0) || (len >= (int)sizeof(buff))) {
+    return false;
+  }
+  return (_client.write((const uint8_t *)buff, len) == (size_t)len);
+}
+
+
+// -------------------------------------------------------
+// PARSE REPLY
+// One char at a time. The status line gives _httpcode,
+// headers are skipped, and the first body line is left in
+// _line and, for DDNS_GetIP, copied to _newip
+// -------------------------------------------------------
+void DUCK_DNS::parse(char c) {
+  if ((_part == Reply_Done) || (c == '\r')) {
+    return;
+  }
+  if (c != '\n') {
+    if (_linelen < (DUCKDNS_LINELEN - 1)) {
+      _line[_linelen++] = c;
+    }
+    return;
+  }
+
+  _line[_linelen] = 0x00;
+  switch (_part) {
+    case Reply_Status:
+      {
+        // HTTP/1.1 200 OK
+        char *p = strchr(_line, ' ');
+        _httpcode = (p != nullptr) ? atoi(p + 1) : -1;
+        _part = Reply_Headers;
+      }
+      break;
+    case Reply_Headers:
+      // blank line, end of headers
+      if (_linelen == 0) {
+        _part = Reply_Body;
+      }
+      break;
+    case Reply_Body:
+      if (_linelen != 0) {
+        if (_request == DDNS_GetIP) {
+          strlcpy(_newip, _line, DUCKDNS_IPLEN);
+        }
+        _part = Reply_Done;
+        return;
+      }
+      break;
+    case Reply_Done:
+      break;
+  }
+  _linelen = 0;
+}
+
+#endif
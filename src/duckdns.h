@@ -16,9 +16,38 @@
 // -------------------------------------------------------
 // INCLUDES
 // -------------------------------------------------------
+#include <ESP8266WiFi.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// servers, can be pointed at a local test server
+#define DUCKDNS_IPHOST        "ifconfig.me"
+#define DUCKDNS_IPPATH        "/ip"
+#define DUCKDNS_UPDATEHOST    "www.duckdns.org"
+#define DUCKDNS_PORT          80
+// per step timeouts, ms
+#define DUCKDNS_DNSTIMEOUT    5000
+#define DUCKDNS_CONNECTTIMEOUT 1000
+#define DUCKDNS_READTIMEOUT   5000
+// retry after a failure, doubles on each failure, ms
+#define DUCKDNS_RETRYTIME     10000
+#define DUCKDNS_MAXRETRYTIME  1800000
+// buffers
+#define DUCKDNS_IPLEN         16
+#define DUCKDNS_REQUESTLEN    200
+#define DUCKDNS_LINELEN       48
+
 
 // -------------------------------------------------------
 // CLASS
+// The public ip is read from DUCKDNS_IPHOST, and only if
+// it has changed is the duckdns update url requested.
+// run() is called every pass of loop() and does one short
+// step of the exchange. The host name lookup and reading
+// the reply never wait, connect waits at most
+// DUCKDNS_CONNECTTIMEOUT.
 // -------------------------------------------------------
 class DUCK_DNS {
 public:
@@ -26,14 +55,43 @@ public:
   bool start();
   void stop(void);
   void updatenow(void);
+  void run(void);
   String get_ddns_ip(void);
 
 private:
+  enum DDNS_States { DDNS_Idle, DDNS_Resolve, DDNS_Connect, DDNS_Read };
+  enum DDNS_Requests { DDNS_GetIP, DDNS_Update };
+  enum DDNS_Reply { Reply_Status, Reply_Headers, Reply_Body, Reply_Done };
+
+  void begin_request(DDNS_Requests);
+  void end_request(bool);
+  bool send_request(void);
+  void parse(char);
+  static void dns_found(const char *, const ip_addr_t *, void *);
+
   bool _loaded = STATE_NOTLOADED;
-  const char new_duckdns_ip[48] = "                                               ";
-  const char old_duckdns_ip[48] = "                                               ";
-  String cntlr_ip;
+  WiFiClient _client;
+  DDNS_States _state = DDNS_Idle;
+  DDNS_Requests _request = DDNS_GetIP;
+  const char *_host = DUCKDNS_IPHOST;
+  unsigned long _steptime = 0;        // millis() when step started
+  unsigned long _nexttime = 0;        // millis() of next check
+  unsigned long _waittime = 0;        // ms from _nexttime
+  unsigned long _retrytime = DUCKDNS_RETRYTIME;
+
+  // host lookup, set by dns_found()
+  volatile bool _resolved = false;
+  IPAddress _hostip;
+
+  // reply, status line, headers then body
+  char _line[DUCKDNS_LINELEN];
+  uint8_t _linelen = 0;
+  DDNS_Reply _part = Reply_Status;
+  int _httpcode = 0;
+
+  char _newip[DUCKDNS_IPLEN] = "";    // ip read from DUCKDNS_IPHOST
+  char _ddnsip[DUCKDNS_IPLEN] = "";   // ip last sent to duckdns
 };
 
-#endif 
+#endif
 #endif
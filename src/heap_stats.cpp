@@ -0,0 +1,154 @@
+// -------------------------------------------------------
+// myFP2ESP8266 HEAP STATISTICS CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// heap_stats.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "heap_stats.h"
+
+
+// -------------------------------------------------------
+// ALLOCATION COUNTERS
+// With -Wl,--wrap=malloc -Wl,--wrap=realloc every call
+// outside the heap itself comes here, so String buffers
+// and operator new, which uses malloc, are counted. Only
+// allocations are counted, free() does not know the tag.
+// -------------------------------------------------------
+#if defined(ENABLE_HEAPCOUNTERS)
+byte heap_tag = Heap_Loop;
+static uint32_t heap_allocs[Heap_TagCount];
+static uint32_t heap_bytes[Heap_TagCount];
+
+static const char *const heap_tagnames[Heap_TagCount] = {
+  "loop", "alpaca", "management", "tcpip", "web", "serial", "display"
+};
+
+extern "C" {
+void *__real_malloc(size_t);
+void *__real_realloc(void *, size_t);
+
+void *__wrap_malloc(size_t size) {
+  heap_allocs[heap_tag]++;
+  heap_bytes[heap_tag] += size;
+  return __real_malloc(size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+  heap_allocs[heap_tag]++;
+  heap_bytes[heap_tag] += size;
+  return __real_realloc(ptr, size);
+}
+}
+#endif  // #if defined(ENABLE_HEAPCOUNTERS)
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+HEAP_STATS::HEAP_STATS() {
+  _minfree = ESP.getFreeHeap();
+}
+
+
+// -------------------------------------------------------
+// RUN
+// Called every pass of loop(), the free heap is kept in
+// a counter by the heap, so this is cheap
+// -------------------------------------------------------
+void HEAP_STATS::run(void) {
+  uint32_t heap = ESP.getFreeHeap();
+  if (heap < _minfree) {
+    _minfree = heap;
+  }
+}
+
+
+// -------------------------------------------------------
+// RESET
+// Restart the lowest free heap and the counters, for a
+// new soak run
+// -------------------------------------------------------
+void HEAP_STATS::reset(void) {
+  _minfree = ESP.getFreeHeap();
+#if defined(ENABLE_HEAPCOUNTERS)
+  for (byte i = 0; i < Heap_TagCount; i++) {
+    heap_allocs[i] = 0;
+    heap_bytes[i] = 0;
+  }
+#endif
+}
+
+
+// -------------------------------------------------------
+// GETTERS
+// -------------------------------------------------------
+uint32_t HEAP_STATS::get_free(void) {
+  return ESP.getFreeHeap();
+}
+
+uint32_t HEAP_STATS::get_maxblock(void) {
+  return ESP.getMaxFreeBlockSize();
+}
+
+uint8_t HEAP_STATS::get_fragmentation(void) {
+  return ESP.getHeapFragmentation();
+}
+
+uint32_t HEAP_STATS::get_minfree(void) {
+  run();
+  return _minfree;
+}
+
+// least free loop() stack since boot, the core fills the
+// stack with a pattern and finds how much is untouched
+uint32_t HEAP_STATS::get_stackfree(void) {
+  return ESP.getFreeContStack();
+}
+
+
+// -------------------------------------------------------
+// SUMMARY
+// free,maxblock,frag,minfree,stack
+// -------------------------------------------------------
+void HEAP_STATS::get_summary(char *buff, size_t len) {
+  uint32_t heap;
+  uint32_t maxblock;
+  uint8_t frag;
+
+  // one call, so the three values are from the same time
+  ESP.getHeapStats(&heap, &maxblock, &frag);
+  snprintf(buff, len, "%lu,%lu,%u,%lu,%lu", (unsigned long)heap, (unsigned long)maxblock, frag,
+           (unsigned long)get_minfree(), (unsigned long)get_stackfree());
+}
+
+
+// -------------------------------------------------------
+// REPORT
+// The summary with names, then allocations and bytes per
+// tag if the counters are enabled
+// -------------------------------------------------------
+void HEAP_STATS::get_report(char *buff, size_t len) {
+  uint32_t heap;
+  uint32_t maxblock;
+  uint8_t frag;
+  int pos;
+
+  ESP.getHeapStats(&heap, &maxblock, &frag);
+  pos = snprintf(buff, len, "free %lu\nmaxblock %lu\nfrag %u%%\nminfree %lu\nstack %lu\n",
+                 (unsigned long)heap, (unsigned long)maxblock, frag,
+                 (unsigned long)get_minfree(), (unsigned long)get_stackfree());
+#if defined(ENABLE_HEAPCOUNTERS)
+  for (byte i = 0; (i < Heap_TagCount) && (pos < (int)len); i++) {
+    pos += snprintf(&buff[pos], len - pos, "%s %lu %lu\n", heap_tagnames[i],
+                    (unsigned long)heap_allocs[i], (unsigned long)heap_bytes[i]);
+  }
+#else
+  (void)pos;
+#endif
+}
@@ -0,0 +1,67 @@
+// -------------------------------------------------------
+// myFP2ESP8266 HEAP STATISTICS CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// heap_stats.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _heap_stats_h_
+#define _heap_stats_h_
+
+#include <Arduino.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// "free,maxblock,frag,minfree,stack"
+#define HEAP_SUMMARYLEN  48
+// summary, then a line per tag when counters are enabled
+#define HEAP_REPORTLEN   320
+
+// Allocation counters per subsystem are optional, as they
+// need malloc and realloc wrapped by the linker, see
+// build_flags in platformio.ini. loop() sets the tag
+// around each subsystem it runs.
+enum Heap_Tags { Heap_Loop,
+                 Heap_Alpaca,
+                 Heap_Management,
+                 Heap_Tcpip,
+                 Heap_Web,
+                 Heap_Serial,
+                 Heap_Display,
+                 Heap_TagCount };
+
+#if defined(ENABLE_HEAPCOUNTERS)
+extern byte heap_tag;
+#define HeapTag(t) heap_tag = (t)
+#else
+#define HeapTag(t)
+#endif
+
+
+// -------------------------------------------------------
+// CLASS
+// Heap and stack telemetry. run() is called every pass of
+// loop() to track the lowest free heap. Fragmentation is
+// as reported by the core, 0 when the free heap is one
+// block, rising towards 100 as it splits into small ones.
+// -------------------------------------------------------
+class HEAP_STATS {
+public:
+  HEAP_STATS();
+  void run(void);
+  void reset(void);
+  uint32_t get_free(void);
+  uint32_t get_maxblock(void);
+  uint8_t get_fragmentation(void);
+  uint32_t get_minfree(void);
+  uint32_t get_stackfree(void);
+  void get_summary(char *, size_t);
+  void get_report(char *, size_t);
+
+private:
+  uint32_t _minfree;
+};
+
+#endif
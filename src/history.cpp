@@ -0,0 +1,211 @@
+// -------------------------------------------------------
+// myFP2ESP8266 TEMPERATURE AND POSITION HISTORY CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// history.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "config.h"
+#include <FS.h>
+#include <LittleFS.h>
+#include "history.h"
+#include "scheduler.h"
+
+
+// -------------------------------------------------------
+// DEBUGGING
+// WARNING: DO NOT ENABLE DEBUGGING INFORMATION
+// -------------------------------------------------------
+// Remove comment to enable history messages to be
+// written to Serial port
+//#define HIST_MsgPrint 1
+
+#ifdef HIST_MsgPrint
+#define HistMsgPrint(...) Serial.print(__VA_ARGS__)
+#define HistMsgPrintln(...) Serial.println(__VA_ARGS__)
+#else
+#define HistMsgPrint(...)
+#define HistMsgPrintln(...)
+#endif
+
+
+// -------------------------------------------------------
+// EXTERNALS
+// -------------------------------------------------------
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+HISTORY::HISTORY() {
+  _tiers[0].buf = _tier0;
+  _tiers[0].len = HISTORY_TIER0LEN;
+  _tiers[0].ratio = 1;
+  _tiers[0].span = 1;
+  _tiers[1].buf = _tier1;
+  _tiers[1].len = HISTORY_TIER1LEN;
+  _tiers[1].ratio = HISTORY_TIER1RATIO;
+  _tiers[1].span = HISTORY_TIER1RATIO;
+  _tiers[2].buf = _tier2;
+  _tiers[2].len = HISTORY_TIER2LEN;
+  _tiers[2].ratio = HISTORY_TIER2RATIO;
+  _tiers[2].span = HISTORY_TIER1RATIO * HISTORY_TIER2RATIO;
+  clear();
+}
+
+
+// -------------------------------------------------------
+// CLEAR HISTORY
+// -------------------------------------------------------
+void HISTORY::clear(void) {
+  for (byte i = 0; i < HISTORY_TIERS; i++) {
+    _tiers[i].head = 0;
+    _tiers[i].count = 0;
+    _tiers[i].total = 0;
+    _tiers[i].tempsum = 0;
+    _tiers[i].n = 0;
+    _tiers[i].moving = 0;
+  }
+}
+
+
+// -------------------------------------------------------
+// TAKE A SAMPLE
+// Called every HISTORYSAMPLETIME by timer_history()
+// -------------------------------------------------------
+void HISTORY::sample(float temp, long position, long target, bool moving) {
+  HIST_SAMPLE s;
+
+  s.time = (uint32_t)(millis64() / 1000);
+  s.position = position;
+  s.target = target;
+  s.temp = (int16_t)lroundf(temp * 100.0f);
+  s.moving = moving ? 1 : 0;
+  s.reserved = 0;
+  add(0, s);
+}
+
+
+// -------------------------------------------------------
+// ADD A SAMPLE TO A TIER
+// The sample is also folded into the next tier; when that
+// has ratio samples, their mean temperature, the last
+// position and target, and whether it moved at all make
+// one sample of the next tier.
+// -------------------------------------------------------
+void HISTORY::add(byte tier, const HIST_SAMPLE &s) {
+  hist_tier &t = _tiers[tier];
+
+  t.buf[t.head] = s;
+  t.head = (t.head + 1) % t.len;
+  if (t.count < t.len) {
+    t.count++;
+  }
+  t.total++;
+
+  if (tier == (HISTORY_TIERS - 1)) {
+    if (ControllerData->get_history_spill() == STATE_ENABLED) {
+      spill(s);
+    }
+    return;
+  }
+
+  hist_tier &next = _tiers[tier + 1];
+  next.tempsum += s.temp;
+  next.moving |= s.moving;
+  next.n++;
+  if (next.n >= next.ratio) {
+    HIST_SAMPLE ds = s;
+    // mean, rounded
+    int32_t half = (next.tempsum < 0) ? -(int32_t)(next.n / 2) : (int32_t)(next.n / 2);
+    ds.temp = (int16_t)((next.tempsum + half) / (int32_t)next.n);
+    ds.moving = next.moving;
+    next.tempsum = 0;
+    next.n = 0;
+    next.moving = 0;
+    add(tier + 1, ds);
+  }
+}
+
+
+// -------------------------------------------------------
+// APPEND A SAMPLE TO THE HISTORY FILE
+// -------------------------------------------------------
+void HISTORY::spill(const HIST_SAMPLE &s) {
+  File file = LittleFS.open(HISTORYFILE, "a");
+  if (!file) {
+    HistMsgPrintln("hist: open err");
+    return;
+  }
+  size_t size = file.size();
+  file.write((const uint8_t *)&s, sizeof(HIST_SAMPLE));
+  file.close();
+
+  if ((size + sizeof(HIST_SAMPLE)) >= HISTORYFILEMAX) {
+    LittleFS.remove(HISTORYOLDFILE);
+    LittleFS.rename(HISTORYFILE, HISTORYOLDFILE);
+  }
+}
+
+
+// -------------------------------------------------------
+// NUMBER OF SAMPLES IN A TIER
+// -------------------------------------------------------
+uint16_t HISTORY::count(byte tier) {
+  return (tier < HISTORY_TIERS) ? _tiers[tier].count : 0;
+}
+
+
+// -------------------------------------------------------
+// MERGED NUMBER OF SAMPLES IN A TIER
+// The oldest samples of a tier whose periods end before
+// the period of the oldest sample in any finer tier
+// starts. Exporting these from tier 2 to tier 0 gives one
+// timeline at the best resolution, with no period sent
+// twice. Periods are counted in tier 0 samples, not by
+// time, as the whole second sample times repeat when a
+// sample is late.
+// -------------------------------------------------------
+uint16_t HISTORY::merged_count(byte tier) {
+  uint32_t start = 0xFFFFFFFF;
+
+  if (tier >= HISTORY_TIERS) {
+    return 0;
+  }
+  // start of the oldest period held by a finer tier
+  for (byte i = 0; i < tier; i++) {
+    hist_tier &f = _tiers[i];
+    if ((f.count > 0) && (((f.total - f.count) * f.span) < start)) {
+      start = (f.total - f.count) * f.span;
+    }
+  }
+
+  hist_tier &t = _tiers[tier];
+  uint32_t first = t.total - t.count;  // oldest held
+  uint16_t n = 0;
+  while ((n < t.count) && (((first + n + 1) * t.span) <= start)) {
+    n++;
+  }
+  return n;
+}
+
+
+// -------------------------------------------------------
+// GET A SAMPLE
+// index 0 is the oldest sample in the tier
+// -------------------------------------------------------
+bool HISTORY::get(byte tier, uint16_t index, HIST_SAMPLE &s) {
+  if ((tier >= HISTORY_TIERS) || (index >= _tiers[tier].count)) {
+    return false;
+  }
+  hist_tier &t = _tiers[tier];
+  s = t.buf[(t.head + t.len - t.count + index) % t.len];
+  return true;
+}
@@ -0,0 +1,91 @@
+// -------------------------------------------------------
+// myFP2ESP8266 TEMPERATURE AND POSITION HISTORY CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// history.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _history_h_
+#define _history_h_
+
+#include <Arduino.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// sample every 1s, tier 0 holds 2 minutes. each tier is
+// built from the tier below, tier 1 holds 2 hours of 1
+// minute samples, tier 2 holds 16 hours of 10 minutes
+#define HISTORY_TIERS       3
+#define HISTORY_TIER0LEN    120
+#define HISTORY_TIER1LEN    120
+#define HISTORY_TIER2LEN    96
+#define HISTORY_TIER1RATIO  60
+#define HISTORY_TIER2RATIO  10
+#define HISTORYSAMPLETIME   1000  // in ms
+
+// tier 2 samples are appended here when spill is enabled,
+// when full the file is renamed to HISTORYOLDFILE
+#define HISTORYFILE     "/history.bin"
+#define HISTORYOLDFILE  "/history.old"
+#define HISTORYFILEMAX  16384
+
+// binary export header, char magic[4] "HIST",
+// uint16 reclen, uint16 count, then the records
+#define HISTORYHDRLEN  8
+// export is sent in chunks of this size, a csv line is
+// at most HISTORYLINELEN
+#define HISTORYCHUNKLEN  512
+#define HISTORYLINELEN   64
+
+// one sample, little endian as stored in ram
+typedef struct {
+  uint32_t time;      // seconds since boot, end of period
+  int32_t position;   // at end of period
+  int32_t target;     // at end of period
+  int16_t temp;       // mean, celsius x 100
+  uint8_t moving;     // 1 if moving during the period
+  uint8_t reserved;
+} HIST_SAMPLE;
+
+static_assert(sizeof(HIST_SAMPLE) == 16, "HIST_SAMPLE must be 16 bytes");
+
+
+// -------------------------------------------------------
+// CLASS
+// -------------------------------------------------------
+class HISTORY {
+public:
+  HISTORY();
+  void sample(float, long, long, bool);
+  uint16_t count(byte);
+  uint16_t merged_count(byte);
+  bool get(byte, uint16_t, HIST_SAMPLE &);
+  void clear(void);
+
+private:
+  typedef struct {
+    HIST_SAMPLE *buf;
+    uint16_t len;       // capacity
+    uint16_t head;      // next write
+    uint16_t count;
+    uint16_t ratio;     // samples from the tier below
+    uint16_t span;      // tier 0 samples in one sample
+    uint32_t total;     // samples added since clear()
+    // sample being built from the tier below
+    int32_t tempsum;
+    uint16_t n;
+    uint8_t moving;
+  } hist_tier;
+
+  void add(byte, const HIST_SAMPLE &);
+  void spill(const HIST_SAMPLE &);
+
+  hist_tier _tiers[HISTORY_TIERS];
+  HIST_SAMPLE _tier0[HISTORY_TIER0LEN];
+  HIST_SAMPLE _tier1[HISTORY_TIER1LEN];
+  HIST_SAMPLE _tier2[HISTORY_TIER2LEN];
+};
+
+#endif
@@ -16,6 +16,8 @@
 #include "config.h"
 #include <FS.h>
 #include <LittleFS.h>
+#include <Updater.h>
+#include <flash_hal.h>
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
 #include <ArduinoJson.h>
@@ -48,6 +50,22 @@ extern CONTROLLER_DATA *ControllerData;
 #include "driver_board.h"
 extern DRIVER_BOARD *driverboard;
 
+// History
+#include "history.h"
+extern HISTORY *history;
+
+// Temp Coefficient Fit
+#include "tc_fit.h"
+extern TC_FIT *tcfit;
+
+// Heap Statistics
+#include "heap_stats.h"
+extern HEAP_STATS *heapstats;
+
+// Page arena, shared by the servers
+#include "page_arena.h"
+extern PAGE_ARENA pagearena;
+
 // Management Server defines
 #include "defines/management_defines.h"
 #include "management_server.h"
@@ -74,6 +92,7 @@ extern void stop_tcpipserver(void);
 // Temperature Probe
 extern bool start_temperature_probe(void);
 extern void stop_temperature_probe(void);
+extern float read_temperature_probe(byte, char *);
 // Web Server
 extern bool start_webserver(void);
 extern void stop_webserver(void);
@@ -247,6 +266,14 @@ void ms_postuploadfile(void) {
   mngsrvr->handler_postuploadfile();
 }
 
+void ms_postupdate(void) {
+  mngsrvr->handler_postupdate();
+}
+
+void ms_postupdatefile(void) {
+  mngsrvr->handler_postupdatefile();
+}
+
 void ms_success(void) {
   mngsrvr->handler_success();
 }
@@ -275,6 +302,14 @@ void ms_boardconfig(void) {
   mngsrvr->get_boardconfig();
 }
 
+void ms_boardlist(void) {
+  mngsrvr->get_boardlist();
+}
+
+void ms_history(void) {
+  mngsrvr->get_history();
+}
+
 // XHTML
 void ms_rssi() {
   mngsrvr->get_rssi();
@@ -296,10 +331,26 @@ void ms_getheap() {
   mngsrvr->get_heap();
 }
 
+void ms_getheapstats() {
+  mngsrvr->get_heapstats();
+}
+
+void ms_getlooprate() {
+  mngsrvr->get_looprate();
+}
+
 void ms_getsut() {
   mngsrvr->get_sut();
 }
 
+void ms_getwifitimes() {
+  mngsrvr->get_wifitimes();
+}
+
+void ms_getboottimes() {
+  mngsrvr->get_boottimes();
+}
+
 
 // -------------------------------------------------------
 // MANAGEMENT SERVER CLASS
@@ -307,7 +358,6 @@ void ms_getsut() {
 MANAGEMENT_SERVER::MANAGEMENT_SERVER() {
   _loaded = STATE_NOTLOADED;
   _navbar.reserve(NAVBARSIZE);
-  _filelist.reserve(1024);  // 922
 }
 
 
@@ -383,6 +433,8 @@ bool MANAGEMENT_SERVER::start() {
   mserver->on("/cntlr_config.jsn", ms_cntlrconfig);
   mserver->on("/cntlr_var.jsn", ms_cntlrvar);
   mserver->on("/board_config.jsn", ms_boardconfig);
+  mserver->on("/brdlist", ms_boardlist);
+  mserver->on("/history", ms_history);
 
   mserver->on("/uri", ms_geturi);
 
@@ -392,20 +444,31 @@ bool MANAGEMENT_SERVER::start() {
       ms_postuploadstart();
     },
     ms_postuploadfile);
+  mserver->on("/update", HTTP_POST, ms_postupdate, ms_postupdatefile);
 
   // XHTML
   mserver->on("/he", ms_getheap);
+  mserver->on("/hs", ms_getheapstats);
   mserver->on("/im", ms_getismoving);
+  mserver->on("/lr", ms_getlooprate);
   mserver->on("/po", ms_getposition);
   mserver->on("/rssi", HTTP_GET, ms_rssi);
   mserver->on("/su", ms_getsut);
   mserver->on("/ta", ms_gettargetposition);
+  mserver->on("/wt", ms_getwifitimes);
+  mserver->on("/bt", ms_getboottimes);
 
   // not found
   mserver->onNotFound([]() {
     msget_notfound();
   });
 
+  // record time to first request
+  mserver->addHook([](const String &, const String &, WiFiClient *, ESP8266WebServer::ContentTypeFunction) {
+    mark_firstrequest();
+    return ESP8266WebServer::CLIENT_REQUEST_CAN_CONTINUE;
+  });
+
   mserver->begin();
   _loaded = true;
   return _loaded;
@@ -469,6 +532,35 @@ void MANAGEMENT_SERVER::send_json(String str) {
   mserver->send(HTML_WEBPAGE, JSONTEXTPAGETYPE, str);
 }
 
+// -------------------------------------------------------
+// SEND PAGE TO CLIENT
+// The page built in the page arena. A page that did not
+// fit in the arena is cut short, it is not sent
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::send_page(PAGE_ARENA &pg) {
+  if (pg.overflow()) {
+    MngSrvrMsgPrintln(T_PAGETOOBIG);
+    mserver->send(HTML_SERVERERROR, PLAINTEXTPAGETYPE, T_PAGETOOBIG);
+    return;
+  }
+  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, pg.c_str(), pg.length());
+}
+
+// -------------------------------------------------------
+// SEND A JSON FILE TO CLIENT
+// streamed from the file, not read into a String
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::send_jsonfile(const char *filename) {
+  File file = LittleFS.open(filename, "r");
+  if (!file) {
+    Send_NoPage();
+    return;
+  }
+  mserver->sendHeader("Access-Control-Allow-Origin", "*");
+  mserver->streamFile(file, JSONTEXTPAGETYPE);
+  file.close();
+}
+
 // -------------------------------------------------------
 // SEND A REDIRECT PG TO CLIENT
 // -------------------------------------------------------
@@ -540,11 +632,9 @@ void MANAGEMENT_SERVER::get_reboot() {
 // HANDLER FOR /servers
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_servers(void) {
-  String AdminPg;
+  PAGE_ARENA &AdminPg = pagearena;
   String msg;
 
-  AdminPg.reserve(3840);  // 3707
-
   MngSrvrMsgPrintln(T_SERVERS);
 
   if (!check_access()) {
@@ -666,7 +756,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     AdminPg.replace("%TXC%", TextColor);
@@ -752,6 +842,10 @@ Get_Handler:
     // Webserver Port ReadOnly
     AdminPg.replace("%WPO%", String(WEBSERVERPORT));
 
+    // WiFi link, reconnects and downtime in seconds
+    AdminPg.replace("%WRC%", String(wifi_reconnects()));
+    AdminPg.replace("%WDT%", String(wifi_downtime()));
+
     AdminPg += _navbar;
 
     // footer
@@ -766,7 +860,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_SERVERS);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -774,11 +868,9 @@ Get_Handler:
 // DUCKDNS
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_duckdns(void) {
-  String AdminPg;
+  PAGE_ARENA &AdminPg = pagearena;
   String msg;
 
-  AdminPg.reserve(3392);  // 3320
-
   MngSrvrMsgPrintln(T_DUCKDNS);
 
   if (!check_access()) {
@@ -830,7 +922,7 @@ void MANAGEMENT_SERVER::get_duckdns(void) {
     if (msg != "") {
       String dom = mserver->arg("ddomain");
       if (dom != "") {
-        ControllerData->set_duckdns_domain(dom);
+        ControllerData->set_duckdns_domain(dom.c_str());
       }
       goto Get_Handler;
     }
@@ -840,7 +932,7 @@ void MANAGEMENT_SERVER::get_duckdns(void) {
     if (msg != "") {
       String dtok = mserver->arg("dtoken");
       if (dtok != "") {
-        ControllerData->set_duckdns_token(dtok);
+        ControllerData->set_duckdns_token(dtok.c_str());
       }
       goto Get_Handler;
     }
@@ -853,7 +945,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -919,7 +1011,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_DUCKDNS);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -927,11 +1019,9 @@ Get_Handler:
 // BACKLASH
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_backlash(void) {
-  String AdminPg;
+  PAGE_ARENA &AdminPg = pagearena;
   String msg;
 
-  AdminPg.reserve(3008);  // 2922
-
   MngSrvrMsgPrintln(T_BACKLASH);
 
   if (!check_access()) {
@@ -969,7 +1059,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     AdminPg.replace("%HEC%", HeaderColor);
@@ -999,7 +1089,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_BACKLASH);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -1007,11 +1097,9 @@ Get_Handler:
 // DISPLAY
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_display(void) {
-  String AdminPg;
+  PAGE_ARENA &AdminPg = pagearena;
   String msg;
 
-  AdminPg.reserve(4160);  // 4089, page varies in size
-
   MngSrvrMsgPrintln(T_DISPLAY);
 
   if (!check_access()) {
@@ -1073,7 +1161,7 @@ void MANAGEMENT_SERVER::get_display(void) {
     String pageoption = ControllerData->get_display_pageoption();
     if (pageoption == "") {
       pageoption = "000001";
-      ControllerData->set_display_pageoption(pageoption);
+      ControllerData->set_display_pageoption(pageoption.c_str());
     }
 
     // make sure there are 6 digits, pad leading 0's if necessary
@@ -1133,7 +1221,7 @@ void MANAGEMENT_SERVER::get_display(void) {
       else {
         pageoption[0] = '0';
       }
-      ControllerData->set_display_pageoption(pageoption);
+      ControllerData->set_display_pageoption(pageoption.c_str());
       goto Get_Handler;
     }
   }
@@ -1145,7 +1233,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     AdminPg.replace("%HEC%", HeaderColor);
@@ -1213,7 +1301,7 @@ Get_Handler:
     // DISPLAY page options
     // %P1% to %P6%
     // need to get page options and then set each checkbox
-    String pageoption = ControllerData->get_display_pageoption();
+    const char *pageoption = ControllerData->get_display_pageoption();
 
     // now build the page option html code
     // start with page1, which is right most bit
@@ -1277,7 +1365,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_DISPLAY);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -1285,10 +1373,9 @@ Get_Handler:
 // TEMP
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_temp(void) {
-  String AdminPg;
+  PAGE_ARENA &AdminPg = pagearena;
   String msg;
-
-  AdminPg.reserve(4160);  // 4106
+  static const char *const probe_role[TEMP_MAXPROBES] = { T_TUBE, T_AMBIENT, T_MIRROR };
 
   MngSrvrMsgPrintln(T_TEMP);
 
@@ -1364,6 +1451,61 @@ void MANAGEMENT_SERVER::get_temp(void) {
       goto Get_Handler;
     }
 
+    // Temp Comp Deadband 0-100 steps
+    msg = mserver->arg("settcdb");
+    if (msg != "") {
+      String st = mserver->arg("tcdb");
+      int db = st.toInt();
+      RangeCheck(&db, 0, MAXTCDEADBAND);
+      ControllerData->set_tcdeadband(db);
+      goto Get_Handler;
+    }
+
+    // Temp Coefficient Fit Auto Apply
+    msg = mserver->arg("tfa");
+    if (msg != "") {
+      if (msg == TLC_ON) {
+        ControllerData->set_tcfit_autoapply(STATE_ENABLED);
+      } else if (msg == TLC_OFF) {
+        ControllerData->set_tcfit_autoapply(STATE_DISABLED);
+      }
+      goto Get_Handler;
+    }
+
+    // History file, append 10 minute samples
+    msg = mserver->arg("hsp");
+    if (msg != "") {
+      if (msg == TLC_ON) {
+        ControllerData->set_history_spill(STATE_ENABLED);
+      } else if (msg == TLC_OFF) {
+        ControllerData->set_history_spill(STATE_DISABLED);
+      }
+      goto Get_Handler;
+    }
+
+    // Temp Comp Probe, by role
+    msg = mserver->arg("tcp");
+    if (msg != "") {
+      int role = msg.toInt();
+      RangeCheck(&role, Probe_Tube, Probe_Mirror);
+      ControllerData->set_tcprobe((byte)role);
+      goto Get_Handler;
+    }
+
+    // Reassign probe roles, the probes found on the bus
+    // take the roles in search order when the probe restarts
+    msg = mserver->arg("tpra");
+    if (msg != "") {
+      for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+        ControllerData->set_tprobe_rom(role, "");
+      }
+      if (tempprobe_status == STATUS_RUNNING) {
+        stop_temperature_probe();
+        tempprobe_status = start_temperature_probe();
+      }
+      goto Get_Handler;
+    }
+
     // Temp Comp On Load
     String msg = mserver->arg("tcl");
     if (msg != "") {
@@ -1383,7 +1525,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -1438,6 +1580,20 @@ Get_Handler:
 
     AdminPg.replace("%TEV%", String(tp, 2));
 
+    // Probes by role, temperature and rom id
+    for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+      char hex[TEMP_ROMHEXLEN];
+      String tag = "%TP" + String(role);
+      tp = read_temperature_probe(role, hex);
+      if (ControllerData->get_tempmode() == FAHRENHEIT) {
+        tp = (tp * 1.8) + 32;
+      }
+      AdminPg.replace(tag + "N%", probe_role[role]);
+      AdminPg.replace(tag + "T%", (hex[0] != '\0') ? String(tp, 2) : String("--"));
+      AdminPg.replace(tag + "A%", (hex[0] != '\0') ? hex : "none");
+      AdminPg.replace(tag + "S%", (ControllerData->get_tcprobe() == role) ? "selected" : "");
+    }
+
     if (ControllerData->get_tempmode() == FAHRENHEIT) {
       AdminPg.replace("%TEM%", "F");
     } else {
@@ -1459,6 +1615,37 @@ Get_Handler:
     // Temp Comp Coefficent
     AdminPg.replace("%tcnum%", String(ControllerData->get_tempcoefficient()));
 
+    // Temp Comp Deadband
+    AdminPg.replace("%tcdb%", String(ControllerData->get_tcdeadband()));
+
+    // Temp Coefficient Fit, slope,confidence,count
+    char fit[TCFIT_SUMMARYLEN];
+    tcfit->get_summary(fit, sizeof(fit));
+    AdminPg.replace("%TCF%", fit);
+    if (ControllerData->get_tcfit_autoapply() == STATE_ENABLED) {
+      AdminPg.replace("%TFS%", T_ENABLED);
+      AdminPg.replace("%TFA%", TLC_OFF);
+      AdminPg.replace("%TFAB%", TUC_DISABLE);
+    } else {
+      AdminPg.replace("%TFS%", T_DISABLED);
+      AdminPg.replace("%TFA%", TLC_ON);
+      AdminPg.replace("%TFAB%", TUC_ENABLE);
+    }
+
+    // History file
+    if (ControllerData->get_history_spill() == STATE_ENABLED) {
+      AdminPg.replace("%HSS%", T_ENABLED);
+      AdminPg.replace("%HSP%", TLC_OFF);
+      AdminPg.replace("%HSPB%", TUC_DISABLE);
+    } else {
+      AdminPg.replace("%HSS%", T_DISABLED);
+      AdminPg.replace("%HSP%", TLC_ON);
+      AdminPg.replace("%HSPB%", TUC_ENABLE);
+    }
+
+    // Camera Idle, set by the client
+    AdminPg.replace("%TCI%", (camera_idle) ? T_YES : T_NO);
+
     // Temp Comp On Load
     if (ControllerData->get_tempcomp_onload() == STATE_ENABLED) {
       AdminPg.replace("%TOL%", T_ENABLED);
@@ -1498,7 +1685,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_TEMP);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -1506,9 +1693,7 @@ Get_Handler:
 // MISC
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_misc(void) {
-  String AdminPg;
-
-  AdminPg.reserve(3904);  // 3816
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_MISC);
 
@@ -1523,14 +1708,14 @@ void MANAGEMENT_SERVER::get_misc(void) {
     // DeviceName
     msg = mserver->arg("dna");
     if (msg != "") {
-      ControllerData->set_devicename(msg);    
+      ControllerData->set_devicename(msg.c_str());    
       goto Get_Handler;
     }
 
     // MDNSName
     msg = mserver->arg("mdna");
     if (msg != "") {
-      ControllerData->set_mdnsname(msg);    
+      ControllerData->set_mdnsname(msg.c_str());    
       goto Get_Handler;
     }
 
@@ -1563,7 +1748,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -1624,7 +1809,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_MISC);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -1632,9 +1817,7 @@ Get_Handler:
 // MOTOR
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_motor(void) {
-  String AdminPg;
-
-  AdminPg.reserve(4992);  // 4948
+  PAGE_ARENA &AdminPg = pagearena;
   MngSrvrMsgPrintln(T_MOTOR);
 
   if (!check_access()) {
@@ -1777,7 +1960,7 @@ Get_Handler:
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -1908,7 +2091,7 @@ Get_Handler:
   MngSrvrMsgPrint(T_MOTOR);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -1923,8 +2106,7 @@ void MANAGEMENT_SERVER::get_wait() {
 // DELETE FILE
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_deletefile() {
-  String AdminPg;
-  AdminPg.reserve(2540);  // 2425
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_DELETE);
 
@@ -1937,7 +2119,7 @@ void MANAGEMENT_SERVER::get_deletefile() {
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -1963,54 +2145,73 @@ void MANAGEMENT_SERVER::get_deletefile() {
   MngSrvrMsgPrint(T_DELETE);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 // -------------------------------------------------------
 // LISTS ALL FILES IN FILE SYSTEM
+// { "/file": size, "dir":"/dirname", "/dirname/file": size }
+// sent chunked, so heap use does not grow with the
+// number of files
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_filelist(void) {
+  char buf[FILELISTCHUNKLEN];
+  char path[FILEPATHLEN] = "/";
+  size_t len;
+  bool first = true;
+
   MngSrvrMsgPrintln(T_LIST);
   if (!check_access()) {
     return;
   }
-  _filelist = "{ ";
-  ListAllFilesInDir("/");
-  // erase last ,
-  _filelist = _filelist.substring(0, _filelist.length() - 2);
-  _filelist += "  }";
 
-  MngSrvrMsgPrint(T_LIST);
-  MngSrvrMsgPrintln(_filelist.length());
-  // send _filelist
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, JSONTEXTPAGETYPE, _filelist);
+  mserver->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  mserver->send(HTML_WEBPAGE, JSONTEXTPAGETYPE, "");
+
+  len = strlcpy(buf, "{ ", sizeof(buf));
+  ListAllFilesInDir(path, buf, len, first);
+  len += strlcpy(&buf[len], "  }", sizeof(buf) - len);
+  mserver->sendContent(buf, len);
+  // end of chunked reply
+  mserver->sendContent("");
 }
 
 // -------------------------------------------------------
 // LISTS ALL FILES IN FILE SYSTEM DIRECTORY
+// path ends with / and is extended in place for each
+// entry, then restored. An entry is added to buf, which
+// is sent when there is no room for another entry
 // -------------------------------------------------------
-void MANAGEMENT_SERVER::ListAllFilesInDir(String dir_path) {
-  Dir dir = LittleFS.openDir(dir_path);
+void MANAGEMENT_SERVER::ListAllFilesInDir(char *path, char *buf, size_t &len, bool &first) {
+  size_t pathlen = strlen(path);
+  Dir dir = LittleFS.openDir(path);
   while (dir.next()) {
+    strlcpy(&path[pathlen], dir.fileName().c_str(), FILEPATHLEN - pathlen);
     if (dir.isFile()) {
-      //_filelist += "\"file\":";
-      //_filelist += "\"" + String(dir_path + dir.fileName()) + "\", ";
-      _filelist += "\"" + String(dir_path + dir.fileName()) + "\": ";
-      _filelist += String(dir.fileSize()) + ", ";
-
+      len += snprintf(&buf[len], FILELISTCHUNKLEN - len, "%s\"%s\": %u", (first) ? "" : ", ", path, (unsigned int)dir.fileSize());
       MngSrvrMsgPrint("File ");
-      MngSrvrMsgPrint(dir_path);
-      MngSrvrMsgPrintln(dir.fileName());
+      MngSrvrMsgPrintln(path);
+    } else {
+      len += snprintf(&buf[len], FILELISTCHUNKLEN - len, "%s\"dir\":\"%s\"", (first) ? "" : ", ", path);
+    }
+    first = false;
+    // room for one more entry
+    if ((FILELISTCHUNKLEN - len) < FILELISTLINELEN) {
+      mserver->sendContent(buf, len);
+      len = 0;
     }
     if (dir.isDirectory()) {
-      // print directory names
-      _filelist += "\"dir\":";
-      _filelist += "\"" + String(dir_path + dir.fileName()) + "\", ";
       // recursive file listing inside new directory
-      ListAllFilesInDir(dir_path + dir.fileName() + "/");
+      size_t dirlen = strlen(path);
+      if ((dirlen + 1) < FILEPATHLEN) {
+        path[dirlen] = '/';
+        path[dirlen + 1] = '\0';
+        ListAllFilesInDir(path, buf, len, first);
+      }
     }
   }
+  path[pathlen] = '\0';
 }
 
 
@@ -2018,8 +2219,7 @@ void MANAGEMENT_SERVER::ListAllFilesInDir(String dir_path) {
 // LISTS ALL LINKS TO PROJECT SITE
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_links(void) {
-  String AdminPg;
-  AdminPg.reserve(2345);  // 3382
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_LINKS);
 
@@ -2032,7 +2232,7 @@ void MANAGEMENT_SERVER::get_links(void) {
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -2058,7 +2258,7 @@ void MANAGEMENT_SERVER::get_links(void) {
   MngSrvrMsgPrint(T_LINKS);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -2066,68 +2266,159 @@ void MANAGEMENT_SERVER::get_links(void) {
 // cntlrconfig
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_cntlrconfig(void) {
-  String AdminPg;
-
-  AdminPg.reserve(2048);
-
-  File file = LittleFS.open("/cntlr_config.jsn", "r");
-  if (!file) {
-    Send_NoPage();
-    return;
-  } else {
-    // read contents into string
-    AdminPg = file.readString();
-    file.close();
-    send_json(AdminPg);
-  }
+  send_jsonfile("/cntlr_config.jsn");
 }
 
 // -------------------------------------------------------
 // cntlrvar
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_cntlrvar(void) {
+  send_jsonfile("/cntlr_var.jsn");
+}
+
+// -------------------------------------------------------
+// boardconfig
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::get_boardconfig(void) {
+  send_jsonfile("/board_config.jsn");
+}
+
+// -------------------------------------------------------
+// board profile list from /boards/boards.idx
+// [{"num":35,"name":"WEMOSDRV8825"},...]
+// one sequential read of slots then records
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::get_boardlist(void) {
   String AdminPg;
+  uint8_t hdr[BOARDINDEXHDRLEN];
+  uint8_t slots[BOARDINDEXSLOTS];
+  uint8_t recslot[BOARDINDEXSLOTS];
+  BOARD_RECORD rec;
 
-  AdminPg.reserve(64);
+  AdminPg.reserve(768);
 
-  File file = LittleFS.open("/cntlr_var.jsn", "r");
+  File file = LittleFS.open("/boards/boards.idx", "r");
   if (!file) {
     Send_NoPage();
     return;
-  } else {
-    // read contents into string
-    AdminPg = file.readString();
+  }
+  if ((file.read(hdr, BOARDINDEXHDRLEN) != BOARDINDEXHDRLEN)
+      || (memcmp(hdr, "BIDX", 4) != 0)
+      || ((hdr[4] | (hdr[5] << 8)) != sizeof(BOARD_RECORD))
+      || (file.read(slots, BOARDINDEXSLOTS) != BOARDINDEXSLOTS)) {
     file.close();
-    send_json(AdminPg);
+    Send_NoPage();
+    return;
+  }
+  int count = hdr[6] | (hdr[7] << 8);
+
+  // map record number back to board number
+  memset(recslot, 0, sizeof(recslot));
+  for (int i = 0; i < BOARDINDEXSLOTS; i++) {
+    if ((slots[i] != 0) && (slots[i] <= count)) {
+      recslot[slots[i] - 1] = i;
+    }
+  }
+
+  AdminPg = "[";
+  for (int i = 0; (i < count) && (i < BOARDINDEXSLOTS); i++) {
+    if (file.read((uint8_t *)&rec, sizeof(BOARD_RECORD)) != sizeof(BOARD_RECORD)) {
+      break;
+    }
+    rec.name[BOARDNAMELEN - 1] = 0x00;
+    if (i > 0) {
+      AdminPg += ",";
+    }
+    AdminPg += "{\"num\":" + String(recslot[i]) + ",\"name\":\"" + String(rec.name) + "\"}";
   }
+  AdminPg += "]";
+  file.close();
+  send_json(AdminPg);
 }
 
 // -------------------------------------------------------
-// boardconfig
+// temperature and position history, oldest first
+// /history?fmt=csv|bin&tier=0|1|2
+// no tier merges every tier into one timeline, so a night
+// is one request. bin is a HIST header then the records.
+// /history?src=file sends the history file as stored,
+// records with no header
 // -------------------------------------------------------
-void MANAGEMENT_SERVER::get_boardconfig(void) {
-  String AdminPg;
-
-  AdminPg.reserve(512);
+void MANAGEMENT_SERVER::get_history(void) {
+  char buf[HISTORYCHUNKLEN];
+  size_t len;
+  HIST_SAMPLE s;
+  uint16_t counts[HISTORY_TIERS];
+  uint16_t total = 0;
 
-  File file = LittleFS.open("/board_config.jsn", "r");
-  if (!file) {
-    Send_NoPage();
+  if (mserver->arg("src") == "file") {
+    File file = LittleFS.open(HISTORYFILE, "r");
+    if (!file) {
+      Send_NoPage();
+      return;
+    }
+    mserver->streamFile(file, BINARYPAGETYPE);
+    file.close();
     return;
+  }
+
+  bool csv = (mserver->arg("fmt") != "bin");
+  String st = mserver->arg("tier");
+  int tier = (st == "") ? -1 : st.toInt();
+  for (int i = 0; i < HISTORY_TIERS; i++) {
+    if (tier == -1) {
+      counts[i] = history->merged_count(i);
+    } else {
+      counts[i] = (i == tier) ? history->count(i) : 0;
+    }
+    total += counts[i];
+  }
+
+  mserver->setContentLength(CONTENT_LENGTH_UNKNOWN);
+  mserver->send(HTML_WEBPAGE, (csv) ? PLAINTEXTPAGETYPE : BINARYPAGETYPE, "");
+
+  if (csv) {
+    len = strlcpy(buf, "time,temp,position,target,moving\n", sizeof(buf));
   } else {
-    // read contents into string
-    AdminPg = file.readString();
-    file.close();
-    send_json(AdminPg);
+    memcpy(buf, "HIST", 4);
+    buf[4] = sizeof(HIST_SAMPLE) & 0xFF;
+    buf[5] = sizeof(HIST_SAMPLE) >> 8;
+    buf[6] = total & 0xFF;
+    buf[7] = total >> 8;
+    len = HISTORYHDRLEN;
+  }
+
+  // coarsest tier first
+  for (int t = HISTORY_TIERS - 1; t >= 0; t--) {
+    for (uint16_t i = 0; (i < counts[t]) && history->get(t, i, s); i++) {
+      if (csv) {
+        int centi = (s.temp < 0) ? -s.temp : s.temp;
+        len += snprintf(&buf[len], sizeof(buf) - len, "%lu,%s%d.%02d,%ld,%ld,%u\n",
+                        (unsigned long)s.time, (s.temp < 0) ? "-" : "", centi / 100, centi % 100,
+                        (long)s.position, (long)s.target, s.moving);
+      } else {
+        memcpy(&buf[len], &s, sizeof(HIST_SAMPLE));
+        len += sizeof(HIST_SAMPLE);
+      }
+      // room for one more line
+      if ((sizeof(buf) - len) < HISTORYLINELEN) {
+        mserver->sendContent(buf, len);
+        len = 0;
+      }
+    }
+  }
+  if (len > 0) {
+    mserver->sendContent(buf, len);
   }
+  // end of chunked reply
+  mserver->sendContent("");
 }
 
 // -------------------------------------------------------
 // NOT FOUND
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_notfound(void) {
-  String AdminPg;
-  AdminPg.reserve(2304);  // 2126
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_NOTFOUND);
 
@@ -2157,7 +2448,7 @@ void MANAGEMENT_SERVER::get_notfound(void) {
     return;
   } else {
     // using file "adminnotfound", read contents into string
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -2182,7 +2473,7 @@ void MANAGEMENT_SERVER::get_notfound(void) {
     MngSrvrMsgPrint(T_NOTFOUND);
     MngSrvrMsgPrintln(AdminPg.length());
     mserver->sendHeader("Cache-Control", "no-cache");
-    mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+    send_page(AdminPg);
   }
 }
 
@@ -2191,8 +2482,7 @@ void MANAGEMENT_SERVER::get_notfound(void) {
 // UPLOAD FILE
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::get_uploadfile(void) {
-  String AdminPg;
-  AdminPg.reserve(2432);  // 2244
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_UPLOAD);
 
@@ -2205,7 +2495,7 @@ void MANAGEMENT_SERVER::get_uploadfile(void) {
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -2231,7 +2521,7 @@ void MANAGEMENT_SERVER::get_uploadfile(void) {
   MngSrvrMsgPrint(T_UPLOAD);
   MngSrvrMsgPrintln(AdminPg.length());
   mserver->sendHeader("Cache-Control", "no-cache");
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 
@@ -2239,8 +2529,7 @@ void MANAGEMENT_SERVER::get_uploadfile(void) {
 // SAVE CONFIG TO FILESYSTEM
 // ------------------------------------------------------
 void MANAGEMENT_SERVER::handler_saveconfig(void) {
-  String AdminPg;
-  AdminPg.reserve(2176);  // 2152
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_CONFIGSAVED);
 
@@ -2255,7 +2544,7 @@ void MANAGEMENT_SERVER::handler_saveconfig(void) {
       Send_NoPage();
       return;
     } else {
-      AdminPg = file.readString();
+      AdminPg.load(file);
       file.close();
 
       // Web page colors
@@ -2281,7 +2570,7 @@ void MANAGEMENT_SERVER::handler_saveconfig(void) {
 
     MngSrvrMsgPrint(T_CONFIGSAVED);
     MngSrvrMsgPrintln(AdminPg.length());
-    mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+    send_page(AdminPg);
     return;
   } else {
     // config save error
@@ -2290,7 +2579,7 @@ void MANAGEMENT_SERVER::handler_saveconfig(void) {
       Send_NoPage();
       return;
     } else {
-      AdminPg = file.readString();
+      AdminPg.load(file);
       file.close();
 
       // Web page colors
@@ -2315,7 +2604,7 @@ void MANAGEMENT_SERVER::handler_saveconfig(void) {
 
       MngSrvrMsgPrint(T_CONFIGNOTSAVED);
       MngSrvrMsgPrintln(AdminPg.length());
-      mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+      send_page(AdminPg);
     }
   }
 }
@@ -2325,8 +2614,7 @@ void MANAGEMENT_SERVER::handler_saveconfig(void) {
 // IF REQUESTED OPERATION WAS SUCCESSFUL, DISPLAY SUCCESS HTML PAGE
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::handler_success(void) {
-  String AdminPg;
-  AdminPg.reserve(2304);  // 2219
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_SUCCESS);
 
@@ -2339,7 +2627,7 @@ void MANAGEMENT_SERVER::handler_success(void) {
     Send_NoPage();
     return;
   } else {
-    AdminPg = file.readString();
+    AdminPg.load(file);
     file.close();
 
     // Web page colors
@@ -2364,15 +2652,14 @@ void MANAGEMENT_SERVER::handler_success(void) {
   }
   MngSrvrMsgPrint(T_SUCCESS);
   MngSrvrMsgPrintln(AdminPg.length());
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 // -------------------------------------------------------
 // DELETE FILE (POST)
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::handler_postdeletefile() {
-  String AdminPg;
-  AdminPg.reserve(2304);  // deleteok 2222
+  PAGE_ARENA &AdminPg = pagearena;
 
   MngSrvrMsgPrintln(T_DELETEOK);
 
@@ -2393,7 +2680,7 @@ void MANAGEMENT_SERVER::handler_postdeletefile() {
       Send_NoPage();
       return;
     } else {
-      AdminPg = file.readString();
+      AdminPg.load(file);
       file.close();
 
       // Web page colors
@@ -2433,52 +2720,311 @@ void MANAGEMENT_SERVER::handler_postdeletefile() {
   }
   MngSrvrMsgPrint(T_DELETEOK);
   MngSrvrMsgPrintln(AdminPg.length());
-  mserver->send(HTML_WEBPAGE, TEXTPAGETYPE, AdminPg);
+  send_page(AdminPg);
 }
 
 // -------------------------------------------------------
 // HANDLES REQUEST TO UPLOAD FILE
+// Called once all the files in the request have been
+// saved by handler_postuploadfile(). ?fmt=text replies
+// with a line per file: name bytes KB/s result
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::handler_postuploadstart(void) {
   if (_loaded == false) {
     return;
   }
-  // inform client to send data now
-  mserver->send(HTML_WEBPAGE);
+  if (!check_access()) {
+    return;
+  }
+  if (_uploadreport.length() == 0) {
+    _uploadok = false;
+    _uploadreport = "Err: no file";
+  }
+  if (mserver->arg("fmt") == "text") {
+    mserver->send((_uploadok) ? HTML_WEBPAGE : HTML_SERVERERROR, PLAINTEXTPAGETYPE, _uploadreport);
+  } else if (_uploadok) {
+    handler_success();
+  } else {
+    mserver->send(HTML_SERVERERROR, PLAINTEXTPAGETYPE, _uploadreport);
+  }
+  _uploadreport = "";
+  _uploadok = true;
 }
 
 // -------------------------------------------------------
 // WRITES THE UPLOAD FILE
+// A request may hold several files, each is received as
+// start, write..., end. A client disconnect aborts it
 // -------------------------------------------------------
 void MANAGEMENT_SERVER::handler_postuploadfile(void) {
-  if (!check_access()) {
+  HTTPUpload &upload = mserver->upload();
+
+  switch (upload.status) {
+    case UPLOAD_FILE_START:
+      upload_start(upload.filename);
+      break;
+    case UPLOAD_FILE_WRITE:
+      upload_write(upload.buf, upload.currentSize);
+      break;
+    case UPLOAD_FILE_END:
+      upload_end();
+      break;
+    case UPLOAD_FILE_ABORTED:
+      if (_fsUploadFile) {
+        upload_close("aborted");
+      }
+      // no reply is sent for an aborted request
+      _uploadreport = "";
+      _uploadok = true;
+      break;
+  }
+}
+
+// -------------------------------------------------------
+// UPLOAD START
+// Access is checked here without a reply, the reply is
+// sent by handler_postuploadstart()
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::upload_start(String filename) {
+  if ((_loaded == STATE_NOTLOADED) || (!mserver->authenticate(admin_username, admin_password))) {
+    return;
+  }
+  if (!filename.startsWith("/")) {
+    filename = "/" + filename;
+  }
+  _uploadname = filename;
+  _uploadlen = 0;
+  _uploadsize = 0;
+  _uploadstart = millis();
+  br_sha256_init(&_uploadsha);
+
+  _uploadbuf = (uint8_t *)malloc(UPLOADBUFLEN);
+  if (_uploadbuf == nullptr) {
+    upload_close("nomem");
     return;
   }
+  _fsUploadFile = LittleFS.open(UPLOADTEMPFILE, "w");
+  if (!_fsUploadFile) {
+    upload_close("open");
+  }
+}
 
-  HTTPUpload &upload = mserver->upload();
-  if (upload.status == UPLOAD_FILE_START) {
-    String filename = upload.filename;
-    if (!filename.startsWith("/")) {
-      filename = "/" + filename;
-    }
-    _fsUploadFile = LittleFS.open(filename, "w");
-    _errormsg = "File " + filename;
-  } else if (upload.status == UPLOAD_FILE_WRITE) {
-    if (_fsUploadFile) {
-      _fsUploadFile.write(upload.buf, upload.currentSize);
-    }
-  } else if (upload.status == UPLOAD_FILE_END) {
-    if (_fsUploadFile) {
-      // If the file was successfully created
-      _fsUploadFile.close();
-      mngsrvr->handler_success();
+// -------------------------------------------------------
+// UPLOAD WRITE
+// Data is collected in _uploadbuf, so the file is written
+// in UPLOADBUFLEN blocks
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::upload_write(const uint8_t *data, size_t len) {
+  if (!_fsUploadFile) {
+    return;
+  }
+  br_sha256_update(&_uploadsha, data, len);
+  _uploadsize += len;
+  while (len > 0) {
+    size_t n = std::min(len, (size_t)(UPLOADBUFLEN - _uploadlen));
+    memcpy(&_uploadbuf[_uploadlen], data, n);
+    _uploadlen += n;
+    data += n;
+    len -= n;
+    if ((_uploadlen == UPLOADBUFLEN) && (!upload_flush())) {
       return;
-    } else {
-      mserver->send(HTML_SERVERERROR, String(HTML_WEBPAGE), "Err: upload file");
     }
   }
 }
 
+bool MANAGEMENT_SERVER::upload_flush(void) {
+  bool ok = (_fsUploadFile.write(_uploadbuf, _uploadlen) == _uploadlen);
+  _uploadlen = 0;
+  if (!ok) {
+    // filesystem full
+    upload_close("write");
+  }
+  return ok;
+}
+
+// -------------------------------------------------------
+// UPLOAD END
+// If the client sent ?<name>=<sha256 hex>, for example
+// ?/index.html=9f86...08, the file must match it. The
+// temp file then replaces the file in one rename, so a
+// failed upload leaves the old file as it was
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::upload_end(void) {
+  uint8_t hash[br_sha256_SIZE];
+  char hex[(br_sha256_SIZE * 2) + 1];
+
+  if (!_fsUploadFile) {
+    return;
+  }
+  if ((_uploadlen > 0) && (!upload_flush())) {
+    return;
+  }
+  _fsUploadFile.close();
+
+  br_sha256_out(&_uploadsha, hash);
+  for (int i = 0; i < br_sha256_SIZE; i++) {
+    snprintf(&hex[i * 2], 3, "%02x", hash[i]);
+  }
+  String expect = mserver->arg(_uploadname);
+  if ((expect.length() != 0) && (!expect.equalsIgnoreCase(hex))) {
+    upload_close("checksum");
+    return;
+  }
+
+  // rename does not create the directory
+  int slash = _uploadname.lastIndexOf('/');
+  if (slash > 0) {
+    LittleFS.mkdir(_uploadname.substring(0, slash));
+  }
+  if (!LittleFS.rename(UPLOADTEMPFILE, _uploadname)) {
+    upload_close("rename");
+    return;
+  }
+  upload_close(nullptr);
+}
+
+// -------------------------------------------------------
+// UPLOAD CLOSE
+// Adds the result for this file to the report. On error
+// the temp file is removed
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::upload_close(const char *err) {
+  char line[BUFFER64LEN];
+  unsigned long ms = millis() - _uploadstart;
+
+  if (_fsUploadFile) {
+    _fsUploadFile.close();
+  }
+  free(_uploadbuf);
+  _uploadbuf = nullptr;
+  if (err != nullptr) {
+    LittleFS.remove(UPLOADTEMPFILE);
+    _uploadok = false;
+  }
+  if (ms == 0) {
+    ms = 1;
+  }
+  snprintf(line, sizeof(line), " %u %luKB/s %s\n", (unsigned int)_uploadsize, (unsigned long)((_uploadsize * 1000UL) / (ms * 1024UL)), (err != nullptr) ? err : "ok");
+  _uploadreport += _uploadname;
+  _uploadreport += line;
+  MngSrvrMsgPrint(T_UPLOAD);
+  MngSrvrMsgPrint(_uploadname);
+  MngSrvrMsgPrint(line);
+}
+
+// -------------------------------------------------------
+// HANDLES REQUEST TO UPDATE FIRMWARE OR FILESYSTEM
+// Called once the image has been written by
+// handler_postupdatefile(). Replies with: bytes KB/s
+// result, and reboots into the new image if it was ok.
+// The result is reset for the next request, a request
+// without an image replies nofile
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::handler_postupdate(void) {
+  char reply[BUFFER64LEN];
+  unsigned long ms = millis() - _updatestart;
+  bool ok = (_updateerr == nullptr);
+
+  if (ms == 0) {
+    ms = 1;
+  }
+  snprintf(reply, sizeof(reply), "%u %luKB/s %s\n", (unsigned int)_updatesize, (unsigned long)((_updatesize * 1000UL) / (ms * 1024UL)), ok ? "ok" : _updateerr);
+  _updateerr = "nofile";
+  _updatesize = 0;
+
+  if (!check_access()) {
+    return;
+  }
+  MngSrvrMsgPrint("/update ");
+  MngSrvrMsgPrint(reply);
+  if (!ok) {
+    mserver->send(HTML_SERVERERROR, PLAINTEXTPAGETYPE, reply);
+    return;
+  }
+  mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, reply);
+  // saves the settings, for a filesystem image into the
+  // new filesystem, then reboots
+  software_Reboot(REBOOTDELAY);
+}
+
+// -------------------------------------------------------
+// WRITES THE UPDATE IMAGE
+// POST /update?md5=<hex>[&type=fs] with the image as a
+// multipart file, type=fs is a LittleFS image of data/,
+// else firmware. Refused while the focuser is moving.
+// The image is streamed into the Updater, which writes a
+// flash sector at a time and checks the MD5 at the end.
+// Firmware is written to the free flash after the sketch
+// and only copied over it on reboot, so a failed update
+// leaves the running firmware as it was. A filesystem
+// image is written in place, if it fails the filesystem
+// is formatted if needed and the settings saved again,
+// the data/ files must then be uploaded again
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::handler_postupdatefile(void) {
+  HTTPUpload &upload = mserver->upload();
+
+  switch (upload.status) {
+    case UPLOAD_FILE_START:
+      _updateerr = nullptr;
+      _updatefs = false;
+      _updatesize = 0;
+      _updatestart = millis();
+      if ((_loaded == STATE_NOTLOADED) || (!mserver->authenticate(admin_username, admin_password))) {
+        _updateerr = "access";
+      } else if (isMoving == true) {
+        _updateerr = "moving";
+      } else if (mserver->arg("md5").length() != 32) {
+        _updateerr = "md5";
+      } else if (mserver->arg("type") == "fs") {
+        _updatefs = true;
+        close_all_fs();
+        if (!Update.begin((size_t)FS_end - (size_t)FS_start, U_FS)) {
+          _updateerr = "begin";
+        }
+      } else if (!Update.begin((ESP.getFreeSketchSpace() - 0x1000) & 0xFFFFF000, U_FLASH)) {
+        _updateerr = "begin";
+      }
+      if (_updateerr == nullptr) {
+        Update.setMD5(mserver->arg("md5").c_str());
+      }
+      break;
+
+    case UPLOAD_FILE_WRITE:
+      if (_updateerr == nullptr) {
+        if (Update.write(upload.buf, upload.currentSize) != upload.currentSize) {
+          _updateerr = "write";
+        }
+        _updatesize += upload.currentSize;
+      }
+      break;
+
+    case UPLOAD_FILE_END:
+    case UPLOAD_FILE_ABORTED:
+      if ((upload.status == UPLOAD_FILE_ABORTED) && (_updateerr == nullptr)) {
+        _updateerr = "aborted";
+      }
+      if (Update.isRunning()) {
+        // end(true) commits the image if the MD5 matches,
+        // end(false) discards it
+        if ((!Update.end(_updateerr == nullptr)) && (_updateerr == nullptr)) {
+          _updateerr = "verify";
+        }
+      }
+      if (_updatefs) {
+        // mount the new image, or what is left of the old
+        if (!LittleFS.begin()) {
+          LittleFS.format();
+          LittleFS.begin();
+        }
+        if (_updateerr != nullptr) {
+          ControllerData->SaveNow(driverboard->getposition(), driverboard->getdirection());
+        }
+      }
+      break;
+  }
+}
+
 // -------------------------------------------------------
 // GET URI
 // -------------------------------------------------------
@@ -2536,6 +3082,35 @@ void MANAGEMENT_SERVER::get_heap() {
   mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, String(ESP.getFreeHeap()));
 }
 
+// -------------------------------------------------------
+// GET HEAP STATISTICS
+// free heap, largest block, fragmentation, lowest free
+// heap, least free stack, and allocations per subsystem
+// if counted. /hs?reset=1 restarts the lowest and counts,
+// it needs the admin login
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::get_heapstats() {
+  char buff[HEAP_REPORTLEN];
+
+  if (mserver->arg("reset") == "1") {
+    if (!check_access()) {
+      return;
+    }
+    heapstats->reset();
+  }
+  heapstats->get_report(buff, sizeof(buff));
+  mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, buff);
+}
+
+// -------------------------------------------------------
+// GET LOOP RATE
+// loop() iterations per second
+// xhtml
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::get_looprate() {
+  mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, String(looprate));
+}
+
 // -------------------------------------------------------
 // GET SUT
 // xhtml
@@ -2544,3 +3119,23 @@ void MANAGEMENT_SERVER::get_sut() {
   get_systemuptime();
   mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, String(systemuptime));
 }
+
+// -------------------------------------------------------
+// GET WIFI TIMES
+// wifi connect time and time to first request after boot
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::get_wifitimes() {
+  char buff[BUFFER64LEN];
+  wifi_gettimes(buff, sizeof(buff));
+  mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, buff);
+}
+
+// -------------------------------------------------------
+// GET BOOT TIMES
+// ms since boot at the end of each setup() phase
+// -------------------------------------------------------
+void MANAGEMENT_SERVER::get_boottimes() {
+  char buff[BOOTTIMESLEN];
+  boot_gettimes(buff, sizeof(buff));
+  mserver->send(HTML_WEBPAGE, PLAINTEXTPAGETYPE, buff);
+}
@@ -14,6 +14,23 @@
 #undef DEBUG_ESP_HTTP_SERVER
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
+#include <bearssl/bearssl_hash.h>
+#include "page_arena.h"
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// /list is sent in chunks of FILELISTCHUNKLEN, an entry
+// is at most FILELISTLINELEN
+#define FILELISTCHUNKLEN  512
+#define FILELISTLINELEN   96
+#define FILEPATHLEN       64
+
+// an upload is staged in UPLOADTEMPFILE, written in
+// UPLOADBUFLEN blocks, then renamed over the file
+#define UPLOADBUFLEN      4096
+#define UPLOADTEMPFILE    "/upload.tmp"
 
 
 // -------------------------------------------------------
@@ -50,6 +67,8 @@ public:
   void get_uploadfile(void);
   void handler_postuploadstart(void);
   void handler_postuploadfile(void);
+  void handler_postupdate(void);
+  void handler_postupdatefile(void);
   void handler_fileread(String);
   void handler_success(void);
   void handler_saveconfig(void);
@@ -57,6 +76,8 @@ public:
   void get_cntlrconfig(void);
   void get_cntlrvar(void);
   void get_boardconfig(void);
+  void get_boardlist(void);
+  void get_history(void);
 
   String get_uri(void);
   
@@ -66,21 +87,43 @@ public:
   void get_rssi(void);
   void get_targetposition(void);
   void get_heap(void);
+  void get_heapstats(void);
+  void get_looprate(void);
   void get_sut(void);
+  void get_wifitimes(void);
+  void get_boottimes(void);
 
 private:
   bool check_access(void);
   void Send_NoPage(void);
   void send_json(String);
+  void send_jsonfile(const char *);
+  void send_page(PAGE_ARENA &);
   void send_redirect(String);
   String get_contenttype(String);
-  void ListAllFilesInDir(String);
+  void ListAllFilesInDir(char *, char *, size_t &, bool &);
+  void upload_start(String);
+  void upload_write(const uint8_t *, size_t);
+  bool upload_flush(void);
+  void upload_end(void);
+  void upload_close(const char *);
 
   bool _loaded = STATE_NOTLOADED;
   String _navbar;   
-  String _filelist;
   String _errormsg;
   File _fsUploadFile;
+  String _uploadname;          // file being uploaded
+  String _uploadreport;        // a line per file this request
+  bool _uploadok = true;       // all files this request saved
+  uint8_t *_uploadbuf = nullptr;
+  size_t _uploadlen;           // bytes in _uploadbuf
+  size_t _uploadsize;          // bytes received
+  unsigned long _uploadstart;  // millis() at start of file
+  br_sha256_context _uploadsha;
+  const char *_updateerr = "nofile";  // nullptr while the update is ok
+  bool _updatefs = false;             // filesystem closed for an image
+  size_t _updatesize = 0;             // bytes of image received
+  unsigned long _updatestart = 0;     // millis() at start of image
   ESP8266WebServer *mserver;
 
   const char T_SERVERS[10]  = "/servers ";
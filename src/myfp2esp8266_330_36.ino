@@ -206,6 +206,13 @@ extern char duckdnstoken[BUFFER48LEN];
 DUCK_DNS *myDuckDNS;
 #endif
 
+// WIFI STATION [STATION ONLY]
+// Dependency: WiFi, LittleFS
+#if (CONTROLLERMODE == STATION)
+#include "wifi_station.h"
+WIFI_STATION *wifistation;
+#endif
+
 // MANAGEMENT SERVER
 // Dependency: WiFi
 // Dependency: Library ArduinoJSON
@@ -218,7 +225,6 @@ MANAGEMENT_SERVER *mngsrvr;
 // LOCAL SERIAL CLASS
 // Optional
 #if (CONTROLLERMODE == LOCALSERIAL)
-#include "myQueue.h"  // Steven de Salas
 #include "serial_server.h"
 LOCAL_SERIAL *serialsrvr;
 #endif
@@ -247,6 +253,35 @@ TEMP_PROBE *tempprobe;
 WEB_SERVER *websrvr;
 #endif
 
+// SCHEDULER
+// Deferred run-after-N-ms tasks, serviced from loop()
+#include "scheduler.h"
+SCHEDULER *scheduler;
+
+// HISTORY
+// Temperature and position samples, exported by the
+// Management Server
+#include "history.h"
+HISTORY *history;
+
+// TEMP COEFFICIENT FIT
+// Learns the temp coefficient from client moves
+#include "tc_fit.h"
+TC_FIT *tcfit;
+
+// HEAP STATISTICS
+// Heap and stack telemetry, Management Server /hs
+// and :D0
+#include "heap_stats.h"
+HEAP_STATS *heapstats;
+
+// PAGE ARENA
+// Page buffer for the Management, ALPACA and Web
+// servers. Not created with new, it is static so the
+// page views do not allocate from the heap
+#include "page_arena.h"
+PAGE_ARENA pagearena;
+
 // MDNS
 // Dependency: WebServer
 // Optional
@@ -293,6 +328,8 @@ bool isMoving;            // motor moving status
 float temp;               // the last temperature read
 bool tempcomp_available;  // temp compensation
 bool tempcomp_state;      // temp compensation ON or OFF
+bool camera_idle = true;  // temp comp moves only when idle
+long tempcomp_target = -1;  // last target set by temp comp
 bool connecting;          // Returns true while device is 
                           // connecting or disconnecting.
                           // Completion variable for the 
@@ -325,16 +362,22 @@ volatile bool halt_alert;              // stop a move immediately
 IPAddress ESP8266IPAddress;
 IPAddress myIP;
 char ipStr[BUFFER16LEN] = "000.000.000.000";
+unsigned long firstrequest_time = 0;  // ms from boot to first request
+
+// boot profile, the end of each setup() phase
+const char *bootphase_name[BOOTPHASES];
+unsigned long bootphase_time[BOOTPHASES];
+byte bootphase_count = 0;
 
 bool filesystemloaded;  // filesystem state
 bool bootup;            // indicates a reboot
+unsigned long looprate; // loop() iterations per second
+unsigned long loopcount;        // loop() iterations this second
+unsigned long uptime_minutes;   // minutes since boot
+bool PowerDown_Status = true;   // idle power down state
 long rssi;              // network signal strength in Station
 char systemuptime[BUFFER12LEN];  // ddd:hh:mm
 
-#if (CONTROLLERMODE == LOCALSERIAL)
-Queue<String> queue;
-#endif
-
 // Cached: are loaded into runtime char []
 char project_author[BUFFER32LEN];  // readonly
 char project_name[BUFFER32LEN];    // readonly
@@ -383,6 +426,7 @@ extern char mySSID[BUFFER64LEN];
 extern char myPASSWORD[BUFFER64LEN];
 extern char mySSID_1[BUFFER64LEN];
 extern char myPASSWORD_1[BUFFER64LEN];
+extern bool station_reuselease;
 
 // -------------------------------------------------------
 // CONTROLLER PROPERTIES END
@@ -472,6 +516,23 @@ void start_serialserver() {
 #endif
 }
 
+// -------------------------------------------------------
+// GET OR SET SERIAL SERVER PORT SPEED
+// 0 returns the current speed, else returns the new
+// speed, or 0 if the speed is not supported
+// -------------------------------------------------------
+unsigned long serialserver_speed(unsigned long speed) {
+#if (CONTROLLERMODE == LOCALSERIAL)
+  if (speed == 0) {
+    return serialsrvr->get_speed();
+  }
+  return (serialsrvr->set_speed(speed) == true) ? speed : 0;
+#else
+  (void)speed;
+  return 0;
+#endif
+}
+
 // -------------------------------------------------------
 // CHECK SERIAL SERVER
 // Optional
@@ -481,7 +542,7 @@ void check_serialserver(bool pdstatus) {
   if (serialsrvr_status == STATUS_RUNNING) {
     serialsrvr->serialEvent();
     // check for client requests
-    if (queue.count() >= 1) {
+    if (serialsrvr->cmd_available()) {
       serialsrvr->process_cmd(pdstatus);
     }
   }
@@ -606,6 +667,20 @@ void display_update_position(long position) {
 #endif
 }
 
+// -------------------------------------------------------
+// DISPLAY RUN
+// send pending display changes, called every pass of loop()
+// -------------------------------------------------------
+void display_run(void) {
+#if defined(DISPLAYTYPE)
+#if (DISPLAYTYPE == GRAPHIC_OLED12864)
+  if (display_status == STATUS_RUNNING) {
+    mydisplay->run();
+  }
+#endif
+#endif
+}
+
 // -------------------------------------------------------
 // DISPLAY OFF
 // -------------------------------------------------------
@@ -711,6 +786,19 @@ void duckdns_update() {
 #endif
 }
 
+// -------------------------------------------------------
+// DUCKDNS RUN
+// called every pass of loop(), checks the public ip every
+// DUCKDNS_REFRESHRATE
+// -------------------------------------------------------
+void duckdns_run() {
+#if defined(ENABLE_DUCKDNS)
+  if (duckdns_status) {
+    myDuckDNS->run();
+  }
+#endif
+}
+
 
 // -------------------------------------------------------
 // TEMPERATURE PROBE START
@@ -760,6 +848,20 @@ void stop_temperature_probe(void) {
   BootMsgPrint(T_STOP);
 }
 
+// -------------------------------------------------------
+// TEMP COEFFICIENT FIT UPDATE
+// add the temperature and focus position at the end of a
+// client move, apply the fit when auto apply is enabled
+// -------------------------------------------------------
+void update_tcfit(void) {
+  if (tempprobe_status == STATUS_RUNNING) {
+    tcfit->add(temp, driverboard->getposition());
+    if (ControllerData->get_tcfit_autoapply() == STATE_ENABLED) {
+      tcfit->apply();
+    }
+  }
+}
+
 // -------------------------------------------------------
 // TEMPERATURE PROBE UPDATE
 // -------------------------------------------------------
@@ -775,6 +877,34 @@ float update_temperature() {
   return lasttemp;
 }
 
+// -------------------------------------------------------
+// TEMPERATURE PROBE READ BY ROLE
+// hex is set to the probe rom id, "" if no probe has
+// this role
+// -------------------------------------------------------
+float read_temperature_probe(byte role, char *hex) {
+  hex[0] = '\0';
+#if defined(ENABLE_TEMPERATUREPROBE)
+  if (tempprobe_status == STATUS_RUNNING) {
+    tempprobe->get_rom(role, hex);
+    return tempprobe->read(role);
+  }
+#endif
+  return DEFAULTLASTTEMP;
+}
+
+// -------------------------------------------------------
+// TEMPERATURE PROBE RUN
+// advance the probe conversion, one bus step per call
+// -------------------------------------------------------
+void run_temperature_probe(void) {
+#if defined(ENABLE_TEMPERATUREPROBE)
+  if (tempprobe_status == STATUS_RUNNING) {
+    tempprobe->run();
+  }
+#endif
+}
+
 
 // -------------------------------------------------------
 // ALPACA SERVER START
@@ -948,6 +1078,134 @@ void check_webserver() {
 }
 
 
+// -------------------------------------------------------
+// WIFI RUN
+// Completes the station connection started in setup(),
+// then supervises the link, called every pass of loop().
+// The focuser keeps running while the link is down.
+// -------------------------------------------------------
+void wifi_run(void) {
+#if (CONTROLLERMODE == STATION)
+  static WIFI_STATION::WiFi_States laststate = WIFI_STATION::WiFi_Idle;
+  static bool firstconnect = true;
+
+  wifistation->run();
+  WIFI_STATION::WiFi_States state = wifistation->get_state();
+  if (state == laststate) {
+    return;
+  }
+  laststate = state;
+
+  if (state == WIFI_STATION::WiFi_Connected) {
+    // credentials in use, may be the 2nd set
+    strlcpy(mySSID, wifistation->get_ssid(), BUFFER64LEN);
+    strlcpy(myPASSWORD, wifistation->get_password(), BUFFER64LEN);
+    ESP8266IPAddress = WiFi.localIP();
+    snprintf(ipStr, sizeof(ipStr), "%i.%i.%i.%i", ESP8266IPAddress[0], ESP8266IPAddress[1], ESP8266IPAddress[2], ESP8266IPAddress[3]);
+    BootMsgPrint("IP: ");
+    BootMsgPrintln(ipStr);
+    if (firstconnect) {
+      firstconnect = false;
+      BootMsgPrint("WIFI CONNECT ms: ");
+      BootMsgPrintln(wifistation->get_connecttime());
+    } else {
+      // reconnected, servers listen on any address and
+      // keep running, announce the controller again
+      BootMsgPrint("WIFI RECONNECT: ");
+      BootMsgPrintln(wifistation->get_reconnects());
+#ifdef ENABLE_MDNS
+      MDNS.notifyAPChange();
+#endif
+#if defined(ENABLE_ALPACASERVER)
+      if (alpacasrvr_status == STATUS_RUNNING) {
+        alpacasrvr->restart_discovery();
+      }
+#endif
+    }
+  } else if (state == WIFI_STATION::WiFi_Lost) {
+    BootMsgPrintln("WIFI LINK LOST");
+  } else if (state == WIFI_STATION::WiFi_Failed) {
+    BootMsgPrintln("ERROR CONNECT WiFi. REBOOT");
+    software_Reboot(REBOOTDELAY);
+  }
+#endif
+}
+
+// -------------------------------------------------------
+// FIRST REQUEST
+// called by the servers for each request, records the
+// time from boot to the first one
+// -------------------------------------------------------
+void mark_firstrequest(void) {
+  if (firstrequest_time == 0) {
+    firstrequest_time = millis();
+  }
+}
+
+// -------------------------------------------------------
+// WIFI LINK STATISTICS
+// reconnects and total downtime in seconds since boot
+// -------------------------------------------------------
+unsigned long wifi_reconnects(void) {
+#if (CONTROLLERMODE == STATION)
+  return wifistation->get_reconnects();
+#else
+  return 0;
+#endif
+}
+
+unsigned long wifi_downtime(void) {
+#if (CONTROLLERMODE == STATION)
+  return wifistation->get_downtime() / 1000;
+#else
+  return 0;
+#endif
+}
+
+// -------------------------------------------------------
+// WIFI TIMES
+// connect time, fast connect, time to first request
+// -------------------------------------------------------
+void wifi_gettimes(char *buff, int len) {
+#if (CONTROLLERMODE == STATION)
+  snprintf(buff, len, "connect %lums %s, first request %lums", wifistation->get_connecttime(), (wifistation->get_fastconnect()) ? "fast" : "scan", firstrequest_time);
+#else
+  snprintf(buff, len, "first request %lums", firstrequest_time);
+#endif
+}
+
+// -------------------------------------------------------
+// BOOT PROFILE
+// setup() marks the end of each boot phase. Each mark
+// yields, so the SDK can carry on with the WiFi
+// association while the next phase runs
+// -------------------------------------------------------
+void boot_mark(const char *phase) {
+  if (bootphase_count < BOOTPHASES) {
+    bootphase_name[bootphase_count] = phase;
+    bootphase_time[bootphase_count] = millis();
+    bootphase_count++;
+  }
+  BootMsgPrint("BOOT ");
+  BootMsgPrint(phase);
+  BootMsgPrint(" ms: ");
+  BootMsgPrintln(millis());
+  yield();
+}
+
+// one line per phase with the ms since boot when it
+// ended, then the wifi times
+void boot_gettimes(char *buff, int len) {
+  int pos = 0;
+  buff[0] = '\0';
+  for (byte i = 0; (i < bootphase_count) && (pos < len); i++) {
+    pos += snprintf(buff + pos, len - pos, "%s %lums\n", bootphase_name[i], bootphase_time[i]);
+  }
+  if (pos < len) {
+    wifi_gettimes(buff + pos, len - pos);
+  }
+}
+
 // -------------------------------------------------------
 // GET WIFI SIGNAL STRENGTH (IN STATIONMODE)
 // -------------------------------------------------------
@@ -959,41 +1217,93 @@ long getrssi() {
 // -------------------------------------------------------
 // CALCULATE SYSTEM UPTIME
 // Outputs:  String systemuptime as days:hours:minutes
+// uptime_minutes is updated by timer_uptime()
 // -------------------------------------------------------
 void get_systemuptime() {
-  unsigned long elapsedtime = millis();
-  int systemuptime_m = int((elapsedtime / (1000 * 60)) % 60);
-  int systemuptime_h = int((elapsedtime / (1000 * 60 * 60)) % 24);
-  int systemuptime_d = int((elapsedtime / (1000 * 60 * 60 * 24)) % 365);
-  snprintf(systemuptime, 10, "%03d:%02d:%02d", systemuptime_d, systemuptime_h, systemuptime_m);
+  snprintf(systemuptime, BUFFER12LEN, "%03lu:%02lu:%02lu", uptime_minutes / 1440, (uptime_minutes / 60) % 24, uptime_minutes % 60);
 }
 
 // -------------------------------------------------------
-// TIMECHECK
+// REBOOT CONTROLLER
+// After boot the restart is deferred to the scheduler so
+// that loop() keeps running and the reply to the client
+// that requested the reboot is sent
 // -------------------------------------------------------
-byte TimeCheck(unsigned long x, unsigned long Delay) {
-  unsigned long y = x + Delay;
-  unsigned long z = millis();  // get current time
-
-  if ((x > y) && (x < z))
-    return 0;  // overflow y
-  if ((x < y) && (x > z))
-    return 1;  // overflow z
-
-  return (y < z);  // no or (z and y) overflow
+void reboot_now(void) {
+  ESP.restart();
 }
 
-// -------------------------------------------------------
-// REBOOT CONTROLLER
-// -------------------------------------------------------
 void software_Reboot(int Reboot_delay) {
   if (isMoving == true) {
     driverboard->end_move();
   }
   // save the focuser settings immediately
   ControllerData->SaveNow(driverboard->getposition(), driverboard->getdirection());
-  delay(Reboot_delay);
-  ESP.restart();
+  if ((bootup == true) || (scheduler->add(reboot_now, Reboot_delay) == false)) {
+    delay(Reboot_delay);
+    ESP.restart();
+  }
+}
+
+// -------------------------------------------------------
+// IS A REBOOT PENDING
+// -------------------------------------------------------
+bool reboot_pending(void) {
+  return scheduler->pending(reboot_now);
+}
+
+// -------------------------------------------------------
+// TIMERS
+// Periodic work, run by the scheduler from loop(). The
+// display page, temperature and power down are only
+// updated while the focuser is idle
+// -------------------------------------------------------
+void timer_looprate(void) {
+  looprate = loopcount;
+  loopcount = 0;
+}
+
+void timer_uptime(void) {
+  uptime_minutes = (unsigned long)(millis64() / 60000);
+}
+
+void timer_history(void) {
+  history->sample(temp, driverboard->getposition(), ftargetPosition, isMoving);
+}
+
+void timer_display(void) {
+  if ((isMoving == false) && (_display_screen_status == DisplayOn)) {
+    display_update_page(driverboard->getposition());
+  }
+}
+
+void timer_temperature(void) {
+  if ((isMoving == false) && (tempprobe_status == STATUS_RUNNING)) {
+    if (ControllerData->get_tempprobe_enable() == STATE_ENABLED) {
+      // read temp AND check Temperature Compensation
+      temp = update_temperature();
+    }
+  }
+}
+
+// the power down time can be changed at any time, so it
+// is read again each time the timer is restarted
+void timer_powerdown(void) {
+  if ((isMoving == false) && ControllerData->get_powerdown_enable()) {
+    BootMsgPrintln("timer_powerdown:powerdown=true:displayoff");
+    PowerDown_Status = true;
+    display_off();
+  }
+  scheduler->add(timer_powerdown, ControllerData->get_powerdown_time() * 1000UL);
+}
+
+void start_timers(void) {
+  scheduler->every(timer_looprate, 1000);
+  scheduler->every(timer_uptime, 60000);
+  scheduler->every(timer_history, HISTORYSAMPLETIME);
+  scheduler->every(timer_display, DISPLAYPAGETIME * 1000);
+  scheduler->every(timer_temperature, DEFAULTTEMPREFRESHTIME);
+  scheduler->add(timer_powerdown, ControllerData->get_powerdown_time() * 1000UL);
 }
 
 // -------------------------------------------------------
@@ -1009,8 +1319,6 @@ void software_Reboot(int Reboot_delay) {
 bool readwificonfig(char *xSSID, char *xPASSWORD, char *ySSID, char *yPASSWORD) {
 #if defined(READWIFICONFIG)
   const String filename = "/wificonfig.jsn";
-  String SSID_1, SSID_2;
-  String PASSWORD_1, PASSWORD_2;
 
   // LittleFS may have failed to start
   if (!filesystemloaded) {
@@ -1023,26 +1331,29 @@ bool readwificonfig(char *xSSID, char *xPASSWORD, char *ySSID, char *yPASSWORD)
 
   File f = LittleFS.open(filename, "r");
   if (f) {
-    String fdata = f.readString();
-    f.close();
+    // only the 4 keys used are materialized
+    JsonDocument filter;
+    filter["mySSID"] = true;
+    filter["myPASSWORD"] = true;
+    filter["mySSID_1"] = true;
+    filter["myPASSWORD_1"] = true;
 
     JsonDocument doc;
 
-    DeserializationError jerror = deserializeJson(doc, fdata);
+    // deserialize straight from the file
+    DeserializationError jerror = deserializeJson(doc, f, DeserializationOption::Filter(filter));
+    f.close();
+    BootMsgPrint("heap wificonfig ");
+    BootMsgPrintln(ESP.getFreeHeap());
     if (!jerror) {
       // Decode JSON/Extract values
-      SSID_1 = doc["mySSID"].as<const char *>();
-      PASSWORD_1 = doc["myPASSWORD"].as<const char *>();
-      SSID_2 = doc["mySSID_1"].as<const char *>();
-      PASSWORD_2 = doc["myPASSWORD_1"].as<const char *>();
-
       // get first pair
-      SSID_1.toCharArray(xSSID, SSID_1.length() + 1);
-      PASSWORD_1.toCharArray(xPASSWORD, PASSWORD_1.length() + 1);
+      strlcpy(xSSID, doc["mySSID"] | "", BUFFER64LEN);
+      strlcpy(xPASSWORD, doc["myPASSWORD"] | "", BUFFER64LEN);
 
       // get second pair
-      SSID_2.toCharArray(ySSID, SSID_2.length() + 1);
-      PASSWORD_2.toCharArray(yPASSWORD, PASSWORD_2.length() + 1);
+      strlcpy(ySSID, doc["mySSID_1"] | "", BUFFER64LEN);
+      strlcpy(yPASSWORD, doc["myPASSWORD_1"] | "", BUFFER64LEN);
       return true;
     }
   }
@@ -1063,8 +1374,8 @@ void load_vars() {
   tempcomp_state = STATE_DISABLED;
   tempcomp_available = NOT_AVAILABLE;
 
-  // controller settings
-  filesystemloaded = false;
+  // controller settings, filesystemloaded is set when
+  // CONTROLLER_DATA mounts LittleFS
   halt_alert = false;
   timerSemaphore = false;
 
@@ -1131,7 +1442,6 @@ void setup() {
   BootMsgPrintln("MODE LOCALSERIAL");
   serialsrvr = new LOCAL_SERIAL(Serial);
   serialsrvr->start(SERIALPORTSPEED);
-  delay(1000);
   serialsrvr_status = STATUS_RUNNING;
 #else
   Serial.begin(SERIALPORTSPEED);
@@ -1139,10 +1449,63 @@ void setup() {
     ;  // wait for serial port to start
   }
 #endif // #if (CONTROLLERMODE == LOCALSERIAL)
-  delay(500);
 
   BootMsgPrintln("FOCUSER START");
 
+  scheduler = new SCHEDULER();
+  history = new HISTORY();
+  tcfit = new TC_FIT();
+  heapstats = new HEAP_STATS();
+  boot_mark("serial");
+
+
+  //-------------------------------------------------
+  // STATION START
+  // A station connecting to an existing wifi network
+  // Started first, the SDK associates with the AP while
+  // the config, display and temp probe are loaded
+  //-------------------------------------------------
+#if (CONTROLLERMODE == STATION)
+  if (mycontrollermode == STATION) {
+    BootMsgPrint(T_STATION);
+    BootMsgPrintln(TUC_START);
+    // mount now for wificonfig and the WiFi cache,
+    // CONTROLLER_DATA formats the filesystem if this fails
+    filesystemloaded = LittleFS.begin();
+#if defined(READWIFICONFIG)
+    // READWIFICONFIG, Station Mode only
+    // read mySSID, myPASSWORD from file
+    // if file exists,
+    // otherwise use defaults
+    if (filesystemloaded) {
+      BootMsgPrint("READWIFICONFIG ");
+      BootMsgPrintln(TUC_START);
+      readwificonfig(mySSID, myPASSWORD, mySSID_1, myPASSWORD_1);
+    }
+#endif  //#if defined(READWIFICONFIG)
+
+    WiFi.mode(WIFI_STA);
+    // Turn off WiFi power save mode
+    WiFi.setSleep(false);
+    // WiFi reconnect if connection is lost
+    // not persistent, WIFI_STATION keeps its own cache
+    WiFi.setAutoReconnect(true);
+    // if static ip then set this up before starting
+    if (mystationipaddressmode == STATICIP) {
+      if (!WiFi.config(station_ip, station_gateway, station_subnet, station_dns1, station_dns2)) {
+        BootMsgPrintln("ERROR STATION STATIC IP");
+      }
+    }
+    // start connecting to user's wifi, the connection is
+    // completed by wifi_run() in loop() so the servers
+    // start while the station is associating. If neither
+    // set of credentials connects, the controller reboots
+    wifistation = new WIFI_STATION();
+    wifistation->start(mySSID, myPASSWORD, mySSID_1, myPASSWORD_1, (mystationipaddressmode == STATICIP), station_reuselease);
+  }
+  boot_mark("wifi start");
+#endif  // #if (CONTROLLERMODE == STATION)
+
 
   //-------------------------------------------------
   // READ FOCUSER SETTINGS FROM CONFIG FILES
@@ -1156,6 +1519,7 @@ void setup() {
   //-------------------------------------------------
   BootMsgPrintln("INIT VARS");
   load_vars();
+  boot_mark("config");
 
 
   //-------------------------------------------------
@@ -1170,97 +1534,20 @@ void setup() {
     WiFi.config(ap_ip, ap_dns, ap_gateway, ap_subnet);
     delay(500);
     WiFi.softAP(myAPSSID, myAPPASSWORD);
-
-#ifdef ENABLE_MDNS
-    if (websrvr_status == STATUS_RUNNING) {
-      // myfp28266.local
-      BootMsgPrint(T_MDNS);
-      BootMsgPrintln(TUC_START);
-      if (!MDNS.begin(ControllerData->get_mdnsname())) {
-        BootMsgPrintln(T_ERROR);
-        while (1) {
-          delay(1000);
-        }
-      }
-      BootMsgPrint(T_MDNS);
-      BootMsgPrintln(ControllerData->get_mdnsname());
-      MDNS.addService("http", "tcp", 80);
-    }
-#endif  //#ifdef ENABLE_MDNS
+    // Turn off WiFi power save mode
+    WiFi.setSleep(false);
   }
-#endif  //#if (CONTROLLERMODE == ACCESSPOINT)
-
 
-  //-------------------------------------------------
-  // STATION START
-  // A station connecting to an existing wifi network
-  //-------------------------------------------------
-#if (CONTROLLERMODE == STATION)
-  if (mycontrollermode == STATION) {
-    BootMsgPrint(T_STATION);
-    BootMsgPrintln(TUC_START);
-#if defined(READWIFICONFIG)
-    // READWIFICONFIG, Station Mode only
-    // read mySSID, myPASSWORD from file
-    // if file exists,
-    // otherwise use defaults
-    BootMsgPrint("READWIFICONFIG ");
-    BootMsgPrintln(TUC_START);
-    readwificonfig(mySSID, myPASSWORD, mySSID_1, myPASSWORD_1);
-#endif  //#if defined(READWIFICONFIG)
-
-    WiFi.mode(WIFI_STA);
-    // if static ip then set this up before starting
-    if (mystationipaddressmode == STATICIP) {
-      if (!WiFi.config(station_ip, station_gateway, station_subnet, station_dns1, station_dns2)) {
-        BootMsgPrintln("ERROR STATION STATIC IP");
-      }
-      delay(50);
-    }
-    // attempt to connect to user's wifi
-    WiFi.begin(mySSID, myPASSWORD);
-    for (int attempts = 0; WiFi.status() != WL_CONNECTED; attempts++) {
-      delay(500);
-      if (attempts > 9) {
-        delay(500);
-        break;
-      }
-    }
-
-    // check if connected after using first set of credentials
-    // if not connected try second pair of credentials
-    if (WiFi.status() != WL_CONNECTED) {
-      // try again with 2nd set of credentials then reboot
-      // after 10 failed attempts to log on
-      // copy 2nd credentials into mySSID and myPASSWORD
-      memset(mySSID, 0, 64);
-      memset(myPASSWORD, 0, 64);
-      memcpy(mySSID, mySSID_1, (sizeof(mySSID_1) / sizeof(mySSID_1[0])));
-      memcpy(myPASSWORD, myPASSWORD_1, (sizeof(myPASSWORD_1) / sizeof(myPASSWORD_1[0])));
-      // attempt to start the WiFi with 2nd set alternative credentials
-      WiFi.begin(mySSID, myPASSWORD);
-      delay(1000);
-      for (int attempts = 0; WiFi.status() != WL_CONNECTED; attempts++) {
-        delay(500);
-        if (attempts > 9) {
-          BootMsgPrintln("ERROR CONNECT WiFi. REBOOT");
-          software_Reboot(REBOOTDELAY);
-        }
-      }
-    }
-  }
-#endif  // #if (CONTROLLERMODE == STATION)
-
-
-#if ((CONTROLLERMODE == STATION) || (CONTROLLERMODE == ACCESSPOINT))
   //-------------------------------------------------
   // CONNECTION DETAILS
+  // Station ip is set by wifi_run() once connected
   //-------------------------------------------------
   ESP8266IPAddress = WiFi.localIP();
   snprintf(ipStr, sizeof(ipStr), "%i.%i.%i.%i", ESP8266IPAddress[0], ESP8266IPAddress[1], ESP8266IPAddress[2], ESP8266IPAddress[3]);
   BootMsgPrint("IP: ");
   BootMsgPrintln(ipStr);
-#endif  // #if ((CONTROLLERMODE == STATION) || (CONTROLLERMODE == ACCESSPOINT))
+  boot_mark("accesspoint");
+#endif  // #if (CONTROLLERMODE == ACCESSPOINT)
 
   BootMsgPrint(T_DEVICENAME);
   BootMsgPrintln(ControllerData->get_devicename());
@@ -1299,9 +1586,89 @@ void setup() {
   // ensure driverboard position is same as setupData
   // set focuser position in DriverBoard
   driverboard->setposition(ControllerData->get_fposition());
+  boot_mark("driverboard");
+
+
+  //-------------------------------------------------
+  // I2C
+  // Standard ESP8266 Node MCU 12E Module
+  // Data = GPIO4, Clock = GPIO5
+  // Set Clock to 100kHz
+  //-------------------------------------------------
+  Wire.begin(I2CDATAPIN, I2CCLKPIN);
+  Wire.setClock(100000L);
+
+
+  //-------------------------------------------------
+  // DISPLAY : Managed via Management Server
+  // Dependancy: Wire
+  // Optional
+  // Manage via Management Server
+  // Default state:  NotEnabled: Stopped
+  //-------------------------------------------------
+#if defined(DISPLAYTYPE)
+#if (DISPLAYTYPE == TEXT_OLED12864)
+  BootMsgPrint(T_DISPLAYTEXT);
+  BootMsgPrint(TUC_START);
+  BootMsgPrint(T_ADDRESS);
+  BootMsgPrintln(OLED_ADDR, HEX);
+  mydisplay = new TEXT_DISPLAY(OLED_ADDR);
+#endif  // #if (DISPLAYTYPE == TEXT_OLED12864)
+#if (DISPLAYTYPE == GRAPHIC_OLED12864)
+  BootMsgPrint(T_DISPLAYGRAPHIC);
+  BootMsgPrint(TUC_START);
+  BootMsgPrint(T_ADDRESS);
+  BootMsgPrintln(OLED_ADDR, HEX);
+  mydisplay = new GRAPHIC_DISPLAY(OLED_ADDR);
+#endif  // #if (DISPLAYTYPE == GRAPHIC_OLED12864)
+#if (DISPLAYTYPE == DISPLAY_NONE)
+  BootMsgPrintln(_DISPLAYNONE);
+#endif
+  if (mydisplay) {
+    if (ControllerData->get_display_enable()) {
+      display_status = display_start();
+      if (display_status == STATUS_STOPPED) {
+        BootMsgPrintln(T_ERROR);
+      }
+    }
+  } else {
+    BootMsgPrintln("DISPLAY NOT CREATED");
+  }
+  boot_mark("display");
+#endif  // #if defined(DISPLAYTYPE)
+
+
+  //-------------------------------------------------
+  // TEMPERATURE PROBE
+  // Optional
+  // Manage via Management Server
+  // Default state:  NotEnabled: Stopped
+  // The first conversion waits with delay(), which lets
+  // the SDK carry on with the WiFi association
+  //-------------------------------------------------
+#if defined(ENABLE_TEMPERATUREPROBE)
+  if (ControllerData->get_tempprobe_enable()) {
+    tempprobe = new TEMP_PROBE(ControllerData->get_brdtemppin());
+    tempprobe_status = start_temperature_probe();
+    if (tempprobe_status) {
+      tempprobe_found = FOUND;
+      BootMsgPrintln("Read temp");
+      temp = tempprobe->read();
+      BootMsgPrint("Temp = ");
+      BootMsgPrintln(temp);
+      if (ControllerData->get_tempcomp_onload() == STATE_ENABLED) {
+        // enable temp comp
+        tempcomp_state = STATE_ENABLED;
+      }
+    }
+  }
+  boot_mark("tempprobe");
+#endif  // #if defined(ENABLE_TEMPERATUREPROBE)
 
   // The following options require a network to run
-  
+  // They listen on any address, so can be started
+  // before the station has connected
+
 #if ((CONTROLLERMODE == STATION) || (CONTROLLERMODE == ACCESSPOINT))
   //-------------------------------------------------
   // ALPACA SERVER
@@ -1345,20 +1712,19 @@ void setup() {
 #ifdef ENABLE_MDNS
     if (websrvr_status == STATUS_RUNNING) {
       // myfp28266.local
+      // a failed start is reported, the focuser still runs
       BootMsgPrint(T_MDNS);
       BootMsgPrint(TUC_START);
       BootMsgPrintln(ControllerData->get_mdnsname());
-      if (!MDNS.begin(ControllerData->get_mdnsname())) {
+      if (MDNS.begin(ControllerData->get_mdnsname())) {
+        MDNS.addService("http", "tcp", 80);
+      } else {
         BootMsgPrintln(T_ERROR);
-        while (1) {
-          delay(1000);
-        }
       }
-      MDNS.addService("http", "tcp", 80);
     }
 #endif  // #ifdef ENABLE_MDNS
-#endif  // #ifdef ENABLE_WEBSERVER
   }
+#endif  // #ifdef ENABLE_WEBSERVER
 
   //-------------------------------------------------
   // MANAGEMENT SERVER
@@ -1386,117 +1752,48 @@ void setup() {
   }
 #endif  // #if defined(ENABLE_DUCKDNS)
 #endif  // #if (CONTROLLERMODE == STATION)
+  boot_mark("servers");
 #endif  // #if ((CONTROLLERMODE == STATION) || (CONTROLLERMODE == ACCESSPOINT))
 
-
-  //-------------------------------------------------
-  // I2C
-  // Standard ESP8266 Node MCU 12E Module
-  // Data = GPIO4, Clock = GPIO5
-  // Set Clock to 100kHz
-  //-------------------------------------------------
-  Wire.begin(I2CDATAPIN, I2CCLKPIN);
-  Wire.setClock(100000L);
-
-
-  //-------------------------------------------------
-  // DISPLAY : Managed via Management Server
-  // Dependancy: Wire
-  // Optional
-  // Manage via Management Server
-  // Default state:  NotEnabled: Stopped
-  //-------------------------------------------------
-#if defined(DISPLAYTYPE)
-#if (DISPLAYTYPE == TEXT_OLED12864)
-  BootMsgPrint(T_DISPLAYTEXT);
-  BootMsgPrint(TUC_START);
-  BootMsgPrint(T_ADDRESS);
-  BootMsgPrintln(OLED_ADDR, HEX);
-  mydisplay = new TEXT_DISPLAY(OLED_ADDR);
-#endif  // #if (DISPLAYTYPE == TEXT_OLED12864)
-#if (DISPLAYTYPE == GRAPHIC_OLED12864)
-  BootMsgPrint(T_DISPLAYGRAPHIC);
-  BootMsgPrint(TUC_START);
-  BootMsgPrint(T_ADDRESS);
-  BootMsgPrintln(OLED_ADDR, HEX);
-  mydisplay = new GRAPHIC_DISPLAY(OLED_ADDR);
-#endif  // #if (DISPLAYTYPE == GRAPHIC_OLED12864)
-#if (DISPLAYTYPE == DISPLAY_NONE)
-  BootMsgPrintln(_DISPLAYNONE);
-#endif
-  if (mydisplay) {
-    if (ControllerData->get_display_enable()) {
-      display_status = display_start();
-      if (display_status == STATUS_STOPPED) {
-        BootMsgPrintln(T_ERROR);
-      }
-    }
-  } else {
-    BootMsgPrintln("DISPLAY NOT CREATED");
-  }
-#endif  // #if defined(DISPLAYTYPE)
-
-
-  //-------------------------------------------------
-  // TEMPERATURE PROBE
-  // Optional
-  // Manage via Management Server
-  // Default state:  NotEnabled: Stopped
-  //-------------------------------------------------
-#if defined(ENABLE_TEMPERATUREPROBE)
-  if (ControllerData->get_tempprobe_enable()) {
-    tempprobe = new TEMP_PROBE(ControllerData->get_brdtemppin());
-    tempprobe_status = start_temperature_probe();
-    if (tempprobe_status) {
-      tempprobe_found = FOUND;
-      BootMsgPrintln("Read temp");
-      temp = tempprobe->read();
-      BootMsgPrint("Temp = ");
-      BootMsgPrintln(temp);
-      if (ControllerData->get_tempcomp_onload() == STATE_ENABLED) {
-        // enable temp comp
-        tempcomp_state = STATE_ENABLED;
-      }
-    }
-  }
-#endif  // #if defined(ENABLE_TEMPERATUREPROBE)
-
-#if ((CONTROLLERMODE == STATION) || (CONTROLLERMODE == ACCESSPOINT))
-  // Turn off WiFi power save mode
-  WiFi.setSleep(false);
-
-  // WiFi reconnect if connection is lost
-#if (CONTROLLERMODE == STATION)
-  WiFi.setAutoReconnect(true);
-  WiFi.persistent(true);
-#endif  // #if (CONTROLLERMODE == STATION)
-#endif  // #if ((CONTROLLERMODE == STATION) || (CONTROLLERMODE == ACCESSPOINT))
-
+  start_timers();
   bootup = false;
+  boot_mark("ready");
   BootMsgPrintln("READY");
 }
 
 
 void loop() {
   static Focuser_States FocuserState = State_Idle;
-  static uint32_t TimeStampDelayAfterMove = 0;
-  static uint32_t TimeStampDisplay = millis();
-  static uint32_t TimeStampEndMove = millis();
-  static uint32_t TimeStampPowerDown = millis();
-  static uint32_t TimeStampTemperature = millis();
-  static uint32_t TimeStampDuckDNS = millis();
+  static bool ClientMove = false;
+  static uint64_t TimeStampDelayAfterMove = 0;
   static unsigned long updatetimestamp = 0;
-  static bool PowerDown_Status = true;
 
   static uint32_t backlash_count = 0;
   static bool DirOfTravel = (bool)ControllerData->get_focuserdirection();
   static uint32_t steps = 0;
-  static int damcounter = 0;
   static uint8_t updatecount = 0;
 
+  // measure loop rate, see timer_looprate()
+  loopcount++;
+
+  // complete WiFi connection
+  wifi_run();
+
+  // run deferred and periodic tasks that are due
+  scheduler->run();
+
+  // track the lowest free heap
+  heapstats->run();
+
+  // send part of any pending display update
+  HeapTag(Heap_Display);
+  display_run();
+
   // handle all Server loop() checks, for new client or client requests
+  // each is tagged for the heap allocation counters
 
   if (serialsrvr_status == STATUS_RUNNING) {
+    HeapTag(Heap_Serial);
     check_serialserver(PowerDown_Status);
   }
 
@@ -1504,16 +1801,19 @@ void loop() {
 
   // check ALPACA server (4040) for web client requests
   if (alpacasrvr_status == STATUS_RUNNING) {
+    HeapTag(Heap_Alpaca);
     check_alpaca_server();
   }
 
   // check Management Server (6060) for web client requests
   if (mngsrvr_status == STATUS_RUNNING) {
+    HeapTag(Heap_Management);
     check_management_server();
   }
 
   // check TCP/IP Server (2020) for client requests
   if (tcpipsrvr_status == STATUS_RUNNING) {
+    HeapTag(Heap_Tcpip);
     if (check_tcpipsrvr(PowerDown_Status) == false) {
       // is a range of possible causes
       // but mainly no client connected;
@@ -1523,16 +1823,16 @@ void loop() {
 
   // check Web Server (80) for client requests
   if (websrvr_status == STATUS_RUNNING) {
+    HeapTag(Heap_Web);
     check_webserver();
   }
 
-  // check DuckDNS
+  // DuckDNS and mDNS are counted as loop
+  HeapTag(Heap_Loop);
+
+  // run DuckDNS, one step of a check, does not wait
   if (duckdns_status == STATUS_RUNNING) {
-    updatetimestamp = DUCKDNS_REFRESHRATE * 1000;
-    if (TimeCheck(TimeStampDuckDNS, updatetimestamp)) {
-      TimeStampDuckDNS = millis();
-      duckdns_update();
-    }
+    duckdns_run();
   }
 
 #ifdef ENABLE_MDNS
@@ -1540,6 +1840,8 @@ void loop() {
 #endif
 
 #endif  // #if ((CONTROLLERMODE == ACCESSPOINT) || (CONTROLLERMODE == STATION))
+  // the focuser state engine is counted as loop
+  HeapTag(Heap_Loop);
 
 
   //-------------------------------------------------
@@ -1553,11 +1855,12 @@ void loop() {
       //     goto next state
       // Position = Target, idle
       //     Save config files
-      //     Display refresh
-      //     Temperature refresh
+      //     Temperature probe conversion
+      // Display refresh, temperature refresh and power
+      // down are timers, see start_timers()
       //-------------------------------------------------
     case State_Idle:
-      if (driverboard->getposition() != ftargetPosition) {
+      if ((driverboard->getposition() != ftargetPosition) && (reboot_pending() == false)) {
         BootMsgPrint("State_Idle:positon != target: ");
         BootMsgPrintln(ftargetPosition);
         // prepare to move focuser
@@ -1565,6 +1868,9 @@ void loop() {
         PowerDown_Status = false;
         display_on();
         isMoving = true;
+        // a move not made by temp comp ends at a client
+        // chosen focus, used to fit the temp coefficient
+        ClientMove = (ftargetPosition != tempcomp_target);
         FocuserState = State_InitMove;
         BootMsgPrint("State_Idle:initmove to ");
         BootMsgPrintln(ftargetPosition);
@@ -1576,37 +1882,10 @@ void loop() {
           BootMsgPrintln("State_Idle:config saved");
         }
 
-        updatetimestamp = ControllerData->get_powerdown_time() * 1000;
-        if (TimeCheck(TimeStampPowerDown, updatetimestamp)) {
-          TimeStampPowerDown = millis();
-          // check powerdown enable state
-          if (ControllerData->get_powerdown_enable()) {
-            BootMsgPrintln("State_Idle:powerdown=true:displayoff");
-            PowerDown_Status = true;
-            display_off();
-          }
-        };
-
-        // update display
-        if (_display_screen_status == DisplayOn) {
-          updatetimestamp = DISPLAYPAGETIME * 1000;
-          if (TimeCheck(TimeStampDisplay, updatetimestamp)) {
-            TimeStampDisplay = millis();
-            //BootMsgPrint("State_Idle:updatedisplay:displaypagetime: ");
-            //BootMsgPrintln(updatetimestamp);
-            //BootMsgPrintln("State_Idle:updatedisplay:times up: call display_update_page");
-            display_update_page(driverboard->getposition());
-          }
-        }
-
-        // update temperature
+        // step the temperature probe conversion
         if (tempprobe_status == STATUS_RUNNING) {
           if (ControllerData->get_tempprobe_enable() == STATE_ENABLED) {
-            if (TimeCheck(TimeStampTemperature, DEFAULTTEMPREFRESHTIME)) {
-              TimeStampTemperature = millis();
-              // read temp AND check Temperature Compensation
-              temp = update_temperature();
-            }
+            run_temperature_probe();
           }
         }
       }
@@ -1684,31 +1963,30 @@ void loop() {
 
       if (backlash_count) {
         BootMsgPrintln("State_InitMove:backlash:yes");
-        BootMsgPrintln("State_InitMove > StateBacklash");
-        FocuserState = State_Backlash;
       } else {
         BootMsgPrintln("backlash:no");
-        // if target pos > current pos then
-        //    steps = target pos - current pos
-        // if target pos < current pos then
-        //    steps = current pos - target pos
-        // initmove enables coil power and starts the motor timer
-        BootMsgPrintln("State_InitMove:Enable move timer");
-        driverboard->initmove(DirOfTravel, steps);
-        BootMsgPrintln("State_InitMove > StateMoving");
-        FocuserState = State_Moving;
       }
+      // State_Backlash waits till the motor is ready, applies
+      // backlash if any, then starts the motor timer
+      BootMsgPrintln("State_InitMove > StateBacklash");
+      FocuserState = State_Backlash;
       break;
 
 
       //-------------------------------------------------
       // STATE_BACKLASH
+      // Wait till motor is ready to step after enable
       // Move motor to take up Backlash
       // Do NOT adjust focuser position
       // When Backlash is complete, start Motor Timer to
       // move the motor.
       //-------------------------------------------------
     case State_Backlash:
+      // boards require 1ms after enable before stepping,
+      // keep servicing loop() till then
+      if (driverboard->motorready() == false) {
+        break;
+      }
       BootMsgPrintln("State_Backlash");
 
       // apply backlash
@@ -1721,6 +1999,7 @@ void loop() {
       }
 
       // backlash count is 0, backlash move done, goto moving now
+      // initmove enables coil power and starts the motor timer
       BootMsgPrintln("State_Backlash:BL DONE");
       BootMsgPrintln("State_Backlash:driverboard->initmove");
       driverboard->initmove(DirOfTravel, steps);
@@ -1746,7 +2025,7 @@ void loop() {
         BootMsgPrintln("State_Moving:MOVE DONE");
         // disable interrupt timer that moves motor
         driverboard->end_move();
-        TimeStampDelayAfterMove = millis();
+        TimeStampDelayAfterMove = millis64();
         BootMsgPrintln("State_Moving > StateDelayAfterMove");
         FocuserState = State_DelayAfterMove;
       } else {
@@ -1776,7 +2055,7 @@ void loop() {
           // no longer need to keep track of steps here
           // or halt because driverboard updates position
           // on every move
-          TimeStampDelayAfterMove = millis();
+          TimeStampDelayAfterMove = millis64();
           FocuserState = State_DelayAfterMove;
         }  // if ( halt_alert )
 
@@ -1807,17 +2086,9 @@ void loop() {
       BootMsgPrintln("State_DelayAfterMove");
       if (ControllerData->get_delayaftermove_time() > 0) {
         updatetimestamp = ControllerData->get_delayaftermove_time() * 1000;
-        if (TimeCheck(TimeStampDelayAfterMove, updatetimestamp)) {
-          damcounter = 0;
-          FocuserState = State_EndMove;
-        }
-        // keep looping around till timecheck for delayaftermove succeeds
-        // BUT ensure there is a way to exit state
-        // if delayaftermove fails to timeout
-        // a loop cycle is ~1-4ms
-        damcounter++;
-        if (damcounter > 255) {
-          damcounter = 0;
+        // keep looping around till delayaftermove has passed
+        // millis64() does not rollover so the state always exits
+        if ((millis64() - TimeStampDelayAfterMove) >= updatetimestamp) {
           FocuserState = State_EndMove;
         }
       } else {
@@ -1835,9 +2106,12 @@ void loop() {
       //-------------------------------------------------
     case State_EndMove:
       isMoving = false;
-      TimeStampEndMove = millis();
-      TimeStampDisplay = millis();
-      TimeStampPowerDown = millis();
+      if (ClientMove) {
+        update_tcfit();
+      }
+      // restart the display page and power down timers
+      scheduler->every(timer_display, DISPLAYPAGETIME * 1000);
+      scheduler->add(timer_powerdown, ControllerData->get_powerdown_time() * 1000UL);
       // end of move, check and disable coil power if required
       if (ControllerData->get_coilpower_enable() == STATE_DISABLED) {
         BootMsgPrintln("lp:CoilPower off");
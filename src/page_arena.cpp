@@ -0,0 +1,158 @@
+// -------------------------------------------------------
+// myFP2ESP8266 PAGE ARENA CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// page_arena.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "page_arena.h"
+
+
+// -------------------------------------------------------
+// DEBUGGING
+// -------------------------------------------------------
+// Remove comment to enable arena messages to be
+// written to Serial port
+//#define ARENA_MsgPrint 1
+
+#ifdef ARENA_MsgPrint
+#define ArenaMsgPrint(...) Serial.print(__VA_ARGS__)
+#define ArenaMsgPrintln(...) Serial.println(__VA_ARGS__)
+#else
+#define ArenaMsgPrint(...)
+#define ArenaMsgPrintln(...)
+#endif
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+PAGE_ARENA::PAGE_ARENA() {
+  clear();
+}
+
+
+// -------------------------------------------------------
+// CLEAR
+// -------------------------------------------------------
+void PAGE_ARENA::clear(void) {
+  _buf[0] = '\0';
+  _len = 0;
+  _overflow = false;
+}
+
+
+// -------------------------------------------------------
+// LOAD
+// The page is read from the file straight into the
+// buffer, in place of file.readString()
+// -------------------------------------------------------
+bool PAGE_ARENA::load(File &file) {
+  clear();
+  _len = file.read((uint8_t *)_buf, PAGEARENALEN);
+  _buf[_len] = '\0';
+  if (file.available() > 0) {
+    ArenaMsgPrint("arena: too big ");
+    ArenaMsgPrintln(file.name());
+    _overflow = true;
+  }
+  return !_overflow;
+}
+
+
+// -------------------------------------------------------
+// ASSIGN AND APPEND
+// -------------------------------------------------------
+PAGE_ARENA &PAGE_ARENA::operator=(const char *str) {
+  clear();
+  append(str, strlen(str));
+  return *this;
+}
+
+PAGE_ARENA &PAGE_ARENA::operator+=(const char *str) {
+  append(str, strlen(str));
+  return *this;
+}
+
+PAGE_ARENA &PAGE_ARENA::operator+=(const String &str) {
+  append(str.c_str(), str.length());
+  return *this;
+}
+
+void PAGE_ARENA::append(const char *str, size_t len) {
+  if ((_len + len) > PAGEARENALEN) {
+    ArenaMsgPrintln("arena: append overflow");
+    _overflow = true;
+    len = PAGEARENALEN - _len;
+  }
+  memcpy(&_buf[_len], str, len);
+  _len += len;
+  _buf[_len] = '\0';
+}
+
+
+// -------------------------------------------------------
+// REPLACE
+// Replaces every find with with, in place, as
+// String::replace(). If a replacement does not fit, it
+// and those after it in the page are left undone
+// -------------------------------------------------------
+void PAGE_ARENA::replace(const char *find, const char *with) {
+  replace(find, strlen(find), with, strlen(with));
+}
+
+void PAGE_ARENA::replace(const char *find, const String &with) {
+  replace(find, strlen(find), with.c_str(), with.length());
+}
+
+void PAGE_ARENA::replace(const String &find, const char *with) {
+  replace(find.c_str(), find.length(), with, strlen(with));
+}
+
+void PAGE_ARENA::replace(const String &find, const String &with) {
+  replace(find.c_str(), find.length(), with.c_str(), with.length());
+}
+
+void PAGE_ARENA::replace(const char *find, size_t findlen, const char *with, size_t withlen) {
+  char *p = _buf;
+
+  if (findlen == 0) {
+    return;
+  }
+  while ((p = strstr(p, find)) != nullptr) {
+    if (withlen != findlen) {
+      if ((_len - findlen + withlen) > PAGEARENALEN) {
+        ArenaMsgPrint("arena: replace overflow ");
+        ArenaMsgPrintln(find);
+        _overflow = true;
+        return;
+      }
+      // move the rest of the page, with its terminator
+      memmove(p + withlen, p + findlen, _len - (p - _buf) - findlen + 1);
+      _len = _len - findlen + withlen;
+    }
+    memcpy(p, with, withlen);
+    p += withlen;
+  }
+}
+
+
+// -------------------------------------------------------
+// GETTERS
+// -------------------------------------------------------
+const char *PAGE_ARENA::c_str(void) {
+  return _buf;
+}
+
+size_t PAGE_ARENA::length(void) {
+  return _len;
+}
+
+bool PAGE_ARENA::overflow(void) {
+  return _overflow;
+}
@@ -0,0 +1,58 @@
+// -------------------------------------------------------
+// myFP2ESP8266 PAGE ARENA CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// page_arena.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _page_arena_h_
+#define _page_arena_h_
+
+#include <Arduino.h>
+#include <FS.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// largest page after all replacements, the management
+// server temp page with navbar is 5715
+#define PAGEARENALEN  6144
+
+
+// -------------------------------------------------------
+// CLASS
+// One statically allocated buffer that the HTTP page
+// handlers build their page in, in place of a String per
+// page view. The management, ALPACA and web servers run
+// one after another from loop(), so a single buffer is
+// shared by all of them. The methods used by the page
+// handlers match String, a page that does not fit is cut
+// short and overflow() is set.
+// -------------------------------------------------------
+class PAGE_ARENA {
+public:
+  PAGE_ARENA();
+  void clear(void);
+  bool load(File &);
+  PAGE_ARENA &operator=(const char *);
+  PAGE_ARENA &operator+=(const char *);
+  PAGE_ARENA &operator+=(const String &);
+  void replace(const char *, const char *);
+  void replace(const char *, const String &);
+  void replace(const String &, const char *);
+  void replace(const String &, const String &);
+  const char *c_str(void);
+  size_t length(void);
+  bool overflow(void);
+
+private:
+  void append(const char *, size_t);
+  void replace(const char *, size_t, const char *, size_t);
+
+  char _buf[PAGEARENALEN + 1];  // + 1 for the terminator
+  size_t _len;
+  bool _overflow;
+};
+
+#endif
@@ -0,0 +1,178 @@
+// -------------------------------------------------------
+// myFP2ESP8266 TASK SCHEDULER CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// scheduler.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "scheduler.h"
+
+
+// -------------------------------------------------------
+// DEBUGGING
+// WARNING: DO NOT ENABLE DEBUGGING INFORMATION
+// -------------------------------------------------------
+// Remove comment to enable scheduler messages to be
+// written to Serial port
+//#define SCHED_MsgPrint 1
+
+#ifdef SCHED_MsgPrint
+#define SchedMsgPrint(...) Serial.print(__VA_ARGS__)
+#define SchedMsgPrintln(...) Serial.println(__VA_ARGS__)
+#else
+#define SchedMsgPrint(...)
+#define SchedMsgPrintln(...)
+#endif
+
+
+// -------------------------------------------------------
+// CLOCK
+// millis() extended to 64 bits by counting its rollovers.
+// A rollover is seen as long as this is called at least
+// once every 49.7 days, SCHEDULER::run() calls it on
+// every pass of loop()
+// -------------------------------------------------------
+uint64_t millis64(void) {
+  static uint32_t rollovers = 0;
+  static uint32_t last = 0;
+  uint32_t now = millis();
+
+  if (now < last) {
+    rollovers++;
+  }
+  last = now;
+  return ((uint64_t)rollovers << 32) | now;
+}
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+SCHEDULER::SCHEDULER() {
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    _tasks[i].task = nullptr;
+    _tasks[i].due = 0;
+    _tasks[i].period = 0;
+  }
+  _nextdue = UINT64_MAX;
+}
+
+
+// -------------------------------------------------------
+// ADD TASK
+// Run task once after delayms. If the task is already
+// pending its time is restarted, so a task is never
+// queued twice. Returns false if the table is full.
+// -------------------------------------------------------
+bool SCHEDULER::add(void (*task)(void), unsigned long delayms) {
+  return set(task, delayms, 0);
+}
+
+
+// -------------------------------------------------------
+// ADD PERIODIC TASK
+// Run task every periodms, the first run is periodms from
+// now. Adding it again restarts the period. A period
+// missed while loop() was busy is skipped, not run late
+// -------------------------------------------------------
+bool SCHEDULER::every(void (*task)(void), unsigned long periodms) {
+  return set(task, periodms, periodms);
+}
+
+bool SCHEDULER::set(void (*task)(void), unsigned long delayms, unsigned long periodms) {
+  int slot = -1;
+
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    if (_tasks[i].task == task) {
+      slot = i;
+      break;
+    }
+    if ((_tasks[i].task == nullptr) && (slot == -1)) {
+      slot = i;
+    }
+  }
+
+  if (slot == -1) {
+    SchedMsgPrintln("sched: full");
+    return false;
+  }
+
+  _tasks[slot].task = task;
+  _tasks[slot].due = millis64() + delayms;
+  _tasks[slot].period = periodms;
+  if (_tasks[slot].due < _nextdue) {
+    _nextdue = _tasks[slot].due;
+  }
+  return true;
+}
+
+
+// -------------------------------------------------------
+// CANCEL TASK
+// _nextdue is left as is, at worst run() makes one
+// early pass and finds nothing due
+// -------------------------------------------------------
+void SCHEDULER::cancel(void (*task)(void)) {
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    if (_tasks[i].task == task) {
+      _tasks[i].task = nullptr;
+    }
+  }
+}
+
+
+// -------------------------------------------------------
+// IS TASK PENDING
+// -------------------------------------------------------
+bool SCHEDULER::pending(void (*task)(void)) {
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    if (_tasks[i].task == task) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+// -------------------------------------------------------
+// RUN DUE TASKS
+// Called every pass of loop(). Until the earliest task is
+// due this is one compare. A one-shot slot is freed, and
+// a periodic task given its next due time, before the
+// task is called, so a task may add itself again.
+// -------------------------------------------------------
+void SCHEDULER::run(void) {
+  uint64_t now = millis64();
+
+  if (now < _nextdue) {
+    return;
+  }
+
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    if ((_tasks[i].task == nullptr) || (_tasks[i].due > now)) {
+      continue;
+    }
+    void (*task)(void) = _tasks[i].task;
+    if (_tasks[i].period == 0) {
+      _tasks[i].task = nullptr;
+    } else {
+      _tasks[i].due += _tasks[i].period;
+      if (_tasks[i].due <= now) {
+        _tasks[i].due = now + _tasks[i].period;
+      }
+    }
+    task();
+  }
+
+  _nextdue = UINT64_MAX;
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    if ((_tasks[i].task != nullptr) && (_tasks[i].due < _nextdue)) {
+      _nextdue = _tasks[i].due;
+    }
+  }
+}
@@ -0,0 +1,57 @@
+// -------------------------------------------------------
+// myFP2ESP8266 TASK SCHEDULER CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// scheduler.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _scheduler_h_
+#define _scheduler_h_
+
+#include <Arduino.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// maximum number of tasks that can be pending at one time
+#define SCHED_MAXTASKS  12
+
+
+// -------------------------------------------------------
+// CLOCK
+// ms since boot, does not rollover. Call from loop()
+// context only, not from an interrupt
+// -------------------------------------------------------
+uint64_t millis64(void);
+
+
+// -------------------------------------------------------
+// CLASS
+// Cooperative one-shot and periodic callbacks, serviced
+// from loop(). A task runs in loop() context, never in
+// an interrupt, and must not block.
+// -------------------------------------------------------
+class SCHEDULER {
+public:
+  SCHEDULER();
+  bool add(void (*)(void), unsigned long);
+  bool every(void (*)(void), unsigned long);
+  void cancel(void (*)(void));
+  bool pending(void (*)(void));
+  void run(void);
+
+private:
+  bool set(void (*)(void), unsigned long, unsigned long);
+
+  typedef struct {
+    void (*task)(void);     // nullptr when the slot is free
+    uint64_t due;           // millis64() when task runs
+    unsigned long period;   // 0 runs once, else every period ms
+  } sched_task;
+
+  sched_task _tasks[SCHED_MAXTASKS];
+  uint64_t _nextdue;        // earliest due of all tasks
+};
+
+#endif
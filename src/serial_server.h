@@ -25,39 +25,59 @@
 
 #include <Arduino.h>
 #include "config.h"
+#include "cmd_ring.h"
+#include "cmd_dispatch.h"
 
 
 #if (CONTROLLERMODE == LOCALSERIAL)
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// Binary frame, sits alongside the ASCII :xx# protocol
+//   STX(0x02) LEN OPCODE PAYLOAD[LEN] CRC8
+// OPCODE is the command index 0-126 (A0 = 100)
+// Request payload is the ASCII argument, 0-60 chars
+// Reply payload is the reply token + value bytes
+// CRC8 polynomial 0x07, init 0, over LEN OPCODE PAYLOAD
+#define BINMAXREQUEST  (CMDRING_MAXCMD - 3)
+#define BINMAXREPLY    128
+// a frame not complete within this time is dropped
+#define BINFRAMETIME   50
+
+
 // -------------------------------------------------------
 // CLASS
+// Commands are handled by cmd_dispatch(), replies are
+// written by send_reply() or send_binary()
 // -------------------------------------------------------
-class LOCAL_SERIAL {
+class LOCAL_SERIAL : public REPLY_SINK {
 public:
   explicit LOCAL_SERIAL(HardwareSerial &serial);
 
   void start(uint32_t portspeed);
   void process_cmd(bool);
+  bool cmd_available(void);
+  unsigned long get_dropped(void);
   void serialEvent(void);
   void clearSerialPort(void);
+  void send_reply(const char *) override;
+  void send_binary(const uint8_t *, size_t) override;
+  bool set_speed(uint32_t);
+  uint32_t get_speed(void);
 
 private:
-  char *ftoa(char *, double, int);
-  void send_reply(const char *);
-
-  void build_reply(const char, const bool);
-  void build_reply(const char, const char *);
-  void build_reply(const char, unsigned char);
-  void build_reply(const char, float, int);
-  void build_reply(const char, int);
-  void build_reply(const char, long);
-  void build_reply(const char, unsigned long);
-  void build_reply(const char, String);
+  void binary_byte(uint8_t);
 
   HardwareSerial &_dev;
-  String line;
-  const char _SOC = ':';  // start of command
-  const char _EOC = '#';  // end of command
-  const char _RTOKEN = '$';
+  CMD_RING _ring;
+  uint32_t _speed = SERIALPORTSPEED;
+  uint32_t _newspeed = 0;           // applied after the reply
+  uint8_t _frame[BINMAXREQUEST + 3]; // LEN OPCODE PAYLOAD CRC8
+  uint8_t _framelen = 0;            // bytes of frame received
+  bool _inframe = false;            // receiving a binary frame
+  unsigned long _framestart = 0;    // millis() at STX
+  uint8_t _opcode = 0;              // binary request in process
+  unsigned long _frameerrors = 0;   // crc, length or timeout
 };
 
 #endif
@@ -0,0 +1,150 @@
+// -------------------------------------------------------
+// myFP2ESP8266 TEMPERATURE COEFFICIENT FIT CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// tc_fit.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "config.h"
+#include "tc_fit.h"
+
+
+// -------------------------------------------------------
+// DEBUGGING
+// WARNING: DO NOT ENABLE DEBUGGING INFORMATION
+// -------------------------------------------------------
+// Remove comment to enable temp coefficient fit messages
+// to be written to Serial port
+//#define TCFIT_MsgPrint 1
+
+#ifdef TCFIT_MsgPrint
+#define TcFitMsgPrint(...) Serial.print(__VA_ARGS__)
+#define TcFitMsgPrintln(...) Serial.println(__VA_ARGS__)
+#else
+#define TcFitMsgPrint(...)
+#define TcFitMsgPrintln(...)
+#endif
+
+
+// -------------------------------------------------------
+// EXTERNALS
+// -------------------------------------------------------
+#include "controller_data.h"
+extern CONTROLLER_DATA *ControllerData;
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+TC_FIT::TC_FIT() {
+  clear();
+}
+
+
+// -------------------------------------------------------
+// CLEAR FIT
+// -------------------------------------------------------
+void TC_FIT::clear(void) {
+  _n = 0;
+  _meant = 0.0;
+  _meanp = 0.0;
+  _m2t = 0.0;
+  _m2p = 0.0;
+  _ctp = 0.0;
+}
+
+
+// -------------------------------------------------------
+// ADD A TEMPERATURE, POSITION PAIR
+// -------------------------------------------------------
+void TC_FIT::add(float temp, long position) {
+  double t = (double)temp;
+  double p = (double)position;
+
+  _n++;
+  double dt = t - _meant;
+  double dp = p - _meanp;
+  _meant += dt / _n;
+  _meanp += dp / _n;
+  // use the old deviation of one and the new of the other
+  _m2t += dt * (t - _meant);
+  _m2p += dp * (p - _meanp);
+  _ctp += dt * (p - _meanp);
+
+  TcFitMsgPrint("tcfit: ");
+  TcFitMsgPrint(get_slope());
+  TcFitMsgPrint(" r2 ");
+  TcFitMsgPrintln(get_confidence());
+}
+
+
+// -------------------------------------------------------
+// SLOPE
+// steps per degree C, positive when focus moves out as
+// the temperature rises
+// -------------------------------------------------------
+float TC_FIT::get_slope(void) {
+  if ((_n < 2) || (_m2t <= 0.0)) {
+    return 0.0f;
+  }
+  return (float)(_ctp / _m2t);
+}
+
+
+// -------------------------------------------------------
+// CONFIDENCE
+// r squared of the fit, 0-1. 0 until there are enough
+// pairs over a wide enough temperature range
+// -------------------------------------------------------
+float TC_FIT::get_confidence(void) {
+  if ((_n < TCFIT_MINSAMPLES) || ((_m2t / _n) < TCFIT_MINVARIANCE) || (_m2p <= 0.0)) {
+    return 0.0f;
+  }
+  return (float)((_ctp * _ctp) / (_m2t * _m2p));
+}
+
+
+// -------------------------------------------------------
+// NUMBER OF PAIRS
+// -------------------------------------------------------
+unsigned int TC_FIT::get_count(void) {
+  return _n;
+}
+
+
+// -------------------------------------------------------
+// SUMMARY
+// "slope,confidence,count" eg "-12.40,0.912,7"
+// -------------------------------------------------------
+void TC_FIT::get_summary(char *buff, size_t len) {
+  char slope[12];
+  char confidence[8];
+
+  dtostrf(get_slope(), 4, 2, slope);
+  dtostrf(get_confidence(), 5, 3, confidence);
+  snprintf(buff, len, "%s,%s,%u", slope, confidence, get_count());
+}
+
+
+// -------------------------------------------------------
+// APPLY FIT
+// When confident, set the temp coefficient and direction.
+// TC_DIRECTION_IN moves in as the temperature falls, which
+// is a positive slope. Returns true if applied.
+// -------------------------------------------------------
+bool TC_FIT::apply(void) {
+  if (get_confidence() < TCFIT_MINCONFIDENCE) {
+    return false;
+  }
+  float slope = get_slope();
+  long coefficient = lroundf(fabsf(slope));
+  RangeCheck(&coefficient, 0, TCFIT_MAXCOEFFICIENT);
+  ControllerData->set_tempcoefficient((int)coefficient);
+  ControllerData->set_tcdirection((slope >= 0.0f) ? TC_DIRECTION_IN : TC_DIRECTION_OUT);
+  return true;
+}
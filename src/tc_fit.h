@@ -0,0 +1,56 @@
+// -------------------------------------------------------
+// myFP2ESP8266 TEMPERATURE COEFFICIENT FIT CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// tc_fit.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _tc_fit_h_
+#define _tc_fit_h_
+
+#include <Arduino.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// confidence is 0 until there are this many pairs, and
+// the temperatures spread by at least 0.5C (variance)
+#define TCFIT_MINSAMPLES     5
+#define TCFIT_MINVARIANCE    0.25
+// auto apply needs at least this confidence
+#define TCFIT_MINCONFIDENCE  0.8f
+// largest coefficient applied, as :22
+#define TCFIT_MAXCOEFFICIENT 400
+// "slope,confidence,count"
+#define TCFIT_SUMMARYLEN     32
+
+
+// -------------------------------------------------------
+// CLASS
+// Least squares fit of focus position against temperature
+// from (temperature, position) pairs taken at the end of
+// client moves. Running sums are updated per pair
+// (Welford), no pairs are stored.
+// -------------------------------------------------------
+class TC_FIT {
+public:
+  TC_FIT();
+  void add(float, long);
+  void clear(void);
+  bool apply(void);
+  float get_slope(void);
+  float get_confidence(void);
+  unsigned int get_count(void);
+  void get_summary(char *, size_t);
+
+private:
+  unsigned int _n;
+  double _meant;    // mean temperature
+  double _meanp;    // mean position
+  double _m2t;      // sum of squared temperature deviations
+  double _m2p;      // sum of squared position deviations
+  double _ctp;      // sum of co-deviations
+};
+
+#endif
@@ -15,6 +15,7 @@
 
 #include <ESP8266WiFi.h>
 #include "WiFiServer.h"
+#include "cmd_dispatch.h"
 
 
 #define MAXCONNECTIONS 1
@@ -22,8 +23,10 @@
 
 // -------------------------------------------------------
 // CLASS
+// Commands are handled by cmd_dispatch(), replies are
+// written by send_reply()
 // -------------------------------------------------------
-class TCPIP_SERVER {
+class TCPIP_SERVER : public REPLY_SINK {
 public:
   TCPIP_SERVER();
   void begin();
@@ -33,22 +36,7 @@ public:
   bool loop(bool);   // check for new client
                      // and manage existing client
 
-  void not_loaded(void);
-  void send_reply(const char *);
-
-  void build_reply(const char, bool);
-  void build_reply(const char, const char *);
-  void build_reply(const char, unsigned char);
-  void build_reply(const char, float, int);
-  void build_reply(const char, int);
-  void build_reply(const char, long);
-  void build_reply(const char, unsigned long);
-  void build_reply(const char, String);
-  void build_reply_board(const char, const char *);
-  void build_reply_config(const char, const char *);
-  void build_reply_string(const char, const char *);
-
-  char *ftoa(char *, double, int);
+  void send_reply(const char *) override;
 
 private:
   void process_command();
@@ -61,8 +49,6 @@ private:
   bool _loaded = STATE_NOTLOADED;
   bool _status = STATUS_STOPPED;
   bool _pwrdwn_status = STATE_OFF;
-  const char _EOC = '#';      // 0x23   '#'  end of command
-  const char _RTOKEN = '$';   // start of command
 };
 
 
@@ -56,14 +56,34 @@ extern CONTROLLER_DATA *ControllerData;
 // -------------------------------------------------------
 // DEFINES
 // -------------------------------------------------------
-// temperature compensation DO NOT CHANGE
-#define TEMP_FALLING 1
-#define TEMP_RISING 0
 #define DEFAULTEMPPIN 10
 
+// DS18B20 bus commands
+#define DS_MATCHROM     0x55
+#define DS_SKIPROM      0xCC
+#define DS_CONVERT      0x44
+#define DS_WRITESCRATCH 0x4E
+#define DS_READSCRATCH  0xBE
+// scratchpad byte offsets
+#define DS_TH      2
+#define DS_TL      3
+#define DS_CONFIG  4
+
 OneWire tpWire(DEFAULTEMPPIN);  // temp probe pin
 DallasTemperature tpsensor(&tpWire);
-DeviceAddress tprobe;
+
+
+// -------------------------------------------------------
+// ROM ID TO HEX
+// -------------------------------------------------------
+static void rom_to_hex(const uint8_t *rom, char *hex) {
+  static const char digits[] = "0123456789ABCDEF";
+  for (uint8_t i = 0; i < 8; i++) {
+    hex[i * 2] = digits[rom[i] >> 4];
+    hex[(i * 2) + 1] = digits[rom[i] & 0x0F];
+  }
+  hex[16] = '\0';
+}
 
 
 // -------------------------------------------------------
@@ -73,7 +93,10 @@ DeviceAddress tprobe;
 // -------------------------------------------------------
 TEMP_PROBE::TEMP_PROBE(int pin)
   : _pin(pin) {
-
+  for (byte i = 0; i < TEMP_MAXPROBES; i++) {
+    _probes[i].temp = DEFAULTLASTTEMP;
+    _probes[i].present = false;
+  }
 }
 
 
@@ -97,7 +120,6 @@ bool TEMP_PROBE::start() {
   {
     TempMsgPrintln(T_DISABLED);
     _loaded = STATE_NOTLOADED;
-    _lasttemp = DEFAULTLASTTEMP;
     tempcomp_state = STATE_DISABLED;
     return false;
   } 
@@ -105,16 +127,14 @@ bool TEMP_PROBE::start() {
   {
     TempMsgPrintln(T_ENABLED);
       
-    // search for a sensor
-    TempMsgPrintln("Find probe");
+    // search for sensors
+    TempMsgPrintln("Find probes");
     tpsensor.begin();
 
-    TempMsgPrint("Probes found ");
-    TempMsgPrintln(tpsensor.getDeviceCount(), DEC);
-
     // report parasite power requirements
+    _parasite = tpsensor.isParasitePowerMode();
     TempMsgPrint("Parasite power is: ");
-    if (tpsensor.isParasitePowerMode()) 
+    if (_parasite) 
     {
       TempMsgPrintln(T_ON);
     } 
@@ -123,34 +143,39 @@ bool TEMP_PROBE::start() {
       TempMsgPrintln(T_OFF);
     }
 
-    if (!tpsensor.getAddress(tprobe, 0)) 
+    if (find_probes() == 0) 
     {
-      TempMsgPrintln("ERROR: find probe address");
-    
-      TempMsgPrintln("Search for probe");
-      // method 1
-      tpWire.reset_search();
-
-      if (!tpWire.search(tprobe)) 
-      {
-        TempMsgPrintln("ERROR: probe address not found");
-        _loaded = STATE_NOTLOADED;
-        _lasttemp = DEFAULTLASTTEMP;
-        tempcomp_state = STATE_DISABLED;
-        return false;
-      } 
+      TempMsgPrintln("ERROR: probe address not found");
+      _loaded = STATE_NOTLOADED;
+      tempcomp_state = STATE_DISABLED;
+      return false;
     } 
 
-    // show the addresses we found on the bus
-    TempMsgPrint("Probe Address: ");
-    //printAddress(tprobe);
-    TempMsgPrintln();
-
-    // request the sensor to begin a temperature reading
-    // async request - read
-    tpsensor.setWaitForConversion(false);
+    // one blocking bulk conversion at boot so the first
+    // readings are valid, after this run() does conversions
+    tpsensor.setWaitForConversion(true);
     tpsensor.requestTemperatures();
-    //sensors.setWaitForConversion(true);
+    for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+      if (_probes[role].present) {
+        float result = tpsensor.getTempC(_probes[role].rom);
+        if (result > -40.0 && result < 80.0) {
+          _probes[role].temp = result;
+        }
+      }
+    }
+
+    // filter and temp comp start from this reading
+    for (byte i = 0; i < TEMP_MEDIAN; i++) {
+      _history[i] = read();
+    }
+    _hpos = 0;
+    _filtered = read();
+    _tcstate = STATE_DISABLED;
+
+    // resolution is written to all probes on the first run()
+    _resolution = 0;
+    _state = Probe_Idle;
+    _timestamp = millis() - TEMPCONVERTTIME;
 
     _loaded = STATE_LOADED;
     tempcomp_available = AVAILABLE;
@@ -170,128 +195,368 @@ void TEMP_PROBE::stop() {
   tempcomp_state = STATE_OFF;
 }
 
+
+// -------------------------------------------------------
+// FIND PROBES
+// A probe whose rom is saved against a role takes that
+// role. A role with no saved rom takes the next unclaimed
+// probe in bus search order, and its rom is saved. A saved
+// probe that is missing keeps its role, so it is used
+// again when reconnected. Returns the number of probes.
+// -------------------------------------------------------
+byte TEMP_PROBE::find_probes(void) {
+  DeviceAddress found[TEMP_MAXFOUND];
+  bool claimed[TEMP_MAXFOUND];
+  char hex[TEMP_ROMHEXLEN];
+  byte count = 0;
+  byte present = 0;
+
+  tpWire.reset_search();
+  while ((count < TEMP_MAXFOUND) && tpWire.search(found[count])) {
+    if (tpsensor.validAddress(found[count]) && tpsensor.validFamily(found[count])) {
+      claimed[count] = false;
+      count++;
+    }
+  }
+  TempMsgPrint("Probes found ");
+  TempMsgPrintln(count);
+
+  // roles with a saved rom
+  for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+    _probes[role].present = false;
+    _probes[role].temp = DEFAULTLASTTEMP;
+    for (byte i = 0; i < count; i++) {
+      rom_to_hex(found[i], hex);
+      if (!claimed[i] && (strcmp(hex, ControllerData->get_tprobe_rom(role)) == 0)) {
+        claim(role, found[i]);
+        claimed[i] = true;
+        break;
+      }
+    }
+  }
+
+  // roles without a saved rom
+  for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+    if (ControllerData->get_tprobe_rom(role)[0] != '\0') {
+      continue;
+    }
+    for (byte i = 0; i < count; i++) {
+      if (!claimed[i]) {
+        claim(role, found[i]);
+        claimed[i] = true;
+        rom_to_hex(found[i], hex);
+        ControllerData->set_tprobe_rom(role, hex);
+        break;
+      }
+    }
+  }
+
+  for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+    if (_probes[role].present) {
+      present++;
+      TempMsgPrint("Probe ");
+      TempMsgPrint(role);
+      TempMsgPrint(": ");
+      TempMsgPrintln(ControllerData->get_tprobe_rom(role));
+    }
+  }
+  return present;
+}
+
+
+// -------------------------------------------------------
+// CLAIM PROBE FOR A ROLE
 // -------------------------------------------------------
-// START A TEMPERATURE READING
-// Can take up to 700mS, but we do an async read rather
-// than a blocking call
+void TEMP_PROBE::claim(byte role, const uint8_t *rom) {
+  uint8_t scratchpad[TEMP_SCRATCHPAD];
+
+  memcpy(_probes[role].rom, rom, sizeof(DeviceAddress));
+  _probes[role].present = true;
+  _probes[role].th = 0;
+  _probes[role].tl = 0;
+  // keep TH and TL, a resolution change writes them back
+  if (tpsensor.readScratchPad(rom, scratchpad)) {
+    _probes[role].th = scratchpad[DS_TH];
+    _probes[role].tl = scratchpad[DS_TL];
+  }
+}
+
+
 // -------------------------------------------------------
-void TEMP_PROBE::request() {
+// RUN PROBE CONVERSION
+// Called every pass of loop() when idle. Each call does at
+// most one bus step, a reset or one byte, so loop() is
+// never held for more than about 1ms. Every TEMPCONVERTTIME
+// all probes convert together from one broadcast, the wait
+// is timed with millis(), then each probe is read by its
+// rom id in turn.
+// -------------------------------------------------------
+void TEMP_PROBE::run(void) {
   if (_loaded == STATE_NOTLOADED) {
     return;
   }
-  tpsensor.setWaitForConversion(false);
-  tpsensor.requestTemperatures();
+
+  switch (_state) {
+    case Probe_Idle:
+      if ((millis() - _timestamp) < TEMPCONVERTTIME) {
+        break;
+      }
+      _newresolution = ControllerData->get_tempresolution();
+      _newresolution = (_newresolution < 9) ? 9 : ((_newresolution > 12) ? 12 : _newresolution);
+      if (_newresolution != _resolution) {
+        _probe = 0;
+        _state = Probe_Configure;
+      } else {
+        // skip rom, every probe on the bus converts
+        load_cmd(nullptr, DS_CONVERT);
+        _next = Probe_Wait;
+        _state = Probe_Reset;
+      }
+      break;
+
+    case Probe_Configure:
+      // write the config register of each probe, TH and TL
+      // unchanged. not copied to the probe eeprom, the
+      // resolution is kept in the controller config instead
+      while ((_probe < TEMP_MAXPROBES) && !_probes[_probe].present) {
+        _probe++;
+      }
+      if (_probe >= TEMP_MAXPROBES) {
+        _resolution = _newresolution;
+        _state = Probe_Idle;
+        break;
+      }
+      load_cmd(_probes[_probe].rom, DS_WRITESCRATCH);
+      _tx[_txlen++] = _probes[_probe].th;
+      _tx[_txlen++] = _probes[_probe].tl;
+      _tx[_txlen++] = ((_newresolution - 9) << 5) | 0x1F;
+      _probe++;
+      _next = Probe_Configure;
+      _state = Probe_Reset;
+      break;
+
+    case Probe_Reset:
+      if (tpWire.reset() == 0) {
+        // no presence pulse, try again next period
+        TempMsgPrintln("TP no probe");
+        _timestamp = millis();
+        _state = Probe_Idle;
+      } else {
+        _state = Probe_Write;
+      }
+      break;
+
+    case Probe_Write:
+      // in parasite mode the bus is held high after the
+      // convert command, to power the probes
+      if ((_txpos == (_txlen - 1)) && (_next == Probe_Wait) && _parasite) {
+        tpWire.write(_tx[_txpos], 1);
+      } else {
+        tpWire.write(_tx[_txpos], 0);
+      }
+      _txpos++;
+      if (_txpos >= _txlen) {
+        if (_next == Probe_Wait) {
+          _timestamp = millis();
+        }
+        _rxpos = 0;
+        _state = _next;
+      }
+      break;
+
+    case Probe_Wait:
+      if ((millis() - _timestamp) >= conversion_time()) {
+        _probe = 0;
+        _state = Probe_Select;
+      }
+      break;
+
+    case Probe_Select:
+      while ((_probe < TEMP_MAXPROBES) && !_probes[_probe].present) {
+        _probe++;
+      }
+      if (_probe >= TEMP_MAXPROBES) {
+        _state = Probe_Idle;
+        break;
+      }
+      load_cmd(_probes[_probe].rom, DS_READSCRATCH);
+      _next = Probe_Read;
+      _state = Probe_Reset;
+      break;
+
+    case Probe_Read:
+      _scratchpad[_rxpos++] = tpWire.read();
+      if (_rxpos >= TEMP_SCRATCHPAD) {
+        decode(_probe);
+        _probe++;
+        _state = Probe_Select;
+      }
+      break;
+  }
 }
 
 
 // -------------------------------------------------------
-// READ TEMP PROBE VALUE
+// LOAD A BUS COMMAND
+// match rom addresses one probe, nullptr for skip rom
 // -------------------------------------------------------
-float TEMP_PROBE::read(void) {
-  if (_loaded == STATE_NOTLOADED) {
-    return _lasttemp;
+void TEMP_PROBE::load_cmd(const uint8_t *rom, uint8_t cmd) {
+  _txlen = 0;
+  _txpos = 0;
+  if (rom != nullptr) {
+    _tx[_txlen++] = DS_MATCHROM;
+    for (uint8_t i = 0; i < 8; i++) {
+      _tx[_txlen++] = rom[i];
+    }
+  } else {
+    _tx[_txlen++] = DS_SKIPROM;
   }
+  _tx[_txlen++] = cmd;
+}
+
+
+// -------------------------------------------------------
+// CONVERSION TIME
+// 94, 188, 375, 750ms for 9, 10, 11, 12 bits
+// -------------------------------------------------------
+unsigned long TEMP_PROBE::conversion_time(void) {
+  byte shift = 12 - _resolution;
+  return (750UL + (1UL << shift) - 1) >> shift;
+}
+
+
+// -------------------------------------------------------
+// DECODE SCRATCHPAD
+// -------------------------------------------------------
+void TEMP_PROBE::decode(byte role) {
+  if (OneWire::crc8(_scratchpad, TEMP_SCRATCHPAD - 1) != _scratchpad[TEMP_SCRATCHPAD - 1]) {
+    TempMsgPrintln("TP crc error");
+    return;
+  }
+
+  int16_t raw = (int16_t)((_scratchpad[1] << 8) | _scratchpad[0]);
+  // low bits are undefined below 12 bit resolution
+  raw &= ~((1 << (12 - _resolution)) - 1);
+  float result = (float)raw / 16.0f;
 
-  // get temperature, always in celsius
-  float result = tpsensor.getTempCByIndex(0);
   // avoid erronous readings
   if (result > -40.0 && result < 80.0) {
-    // valid, save in _lasttemp
-    _lasttemp = result;
+    _probes[role].temp = result;
+  }
+}
+
+
+// -------------------------------------------------------
+// READ TEMP PROBE VALUE
+// Last valid reading, no bus access. Without a role this
+// is the temp comp probe, or the first probe found if
+// that role has no probe.
+// -------------------------------------------------------
+float TEMP_PROBE::read(void) {
+  byte role = ControllerData->get_tcprobe();
+  if ((role < TEMP_MAXPROBES) && _probes[role].present) {
+    return _probes[role].temp;
+  }
+  for (role = 0; role < TEMP_MAXPROBES; role++) {
+    if (_probes[role].present) {
+      return _probes[role].temp;
+    }
+  }
+  return DEFAULTLASTTEMP;
+}
+
+float TEMP_PROBE::read(byte role) {
+  return (role < TEMP_MAXPROBES) ? _probes[role].temp : DEFAULTLASTTEMP;
+}
+
+
+// -------------------------------------------------------
+// PROBE INFORMATION
+// -------------------------------------------------------
+bool TEMP_PROBE::get_present(byte role) {
+  return (role < TEMP_MAXPROBES) && _probes[role].present;
+}
+
+void TEMP_PROBE::get_rom(byte role, char *hex) {
+  if (get_present(role)) {
+    rom_to_hex(_probes[role].rom, hex);
   } else {
-    // invalid, use the last valid temp reading
-    result = _lasttemp;
+    hex[0] = '\0';
   }
-  return result;
 }
 
+
 // -------------------------------------------------------
 // UPDATE_TEMP PROBE
-// read temperature
-// check for temperature compensation, apply tc rules
+// read temperature, filter it, and apply temp comp
+// A median of the last 3 readings drops single spikes,
+// an ema then smooths the probe noise. Temp comp turns
+// each change of the filtered temperature into steps,
+// tempcoefficient steps per degree, and accumulates them
+// with the fraction kept. A move is made only when the
+// total reaches the deadband and the camera is idle, so
+// focus follows temperature in small corrections made
+// between exposures.
 // -------------------------------------------------------
 float TEMP_PROBE::update(void) {
+  float tempval = read();
   if (_loaded == STATE_NOTLOADED) {
-    return _lasttemp;
+    return tempval;
   }
 
-  // track tempcompenabled changes
-  static bool tcchanged = tempcomp_state;
-  // start with a temp request
-  static byte requesttempflag = 0;
-  static float tempval;
-  // start temperature to use when temperature compensation is enabled
-  static float starttemp;
-
-  if (tcchanged != tempcomp_state) {
-    tcchanged = tempcomp_state;
-    if (tcchanged == 1) {
-      starttemp = read();
-    }
-  }
+  _history[_hpos] = tempval;
+  _hpos = (_hpos + 1) % TEMP_MEDIAN;
+  _filtered += TEMP_EMAALPHA * (median() - _filtered);
 
-  if (requesttempflag) {
-    TempMsgPrintln("TP READ");
-    tempval = read();
-  } else {
-    TempMsgPrintln("TP REQUEST");
-    tpsensor.requestTemperatures();
+  // track tempcomp enabled changes, start from the
+  // filtered temperature with nothing accumulated
+  if (_tcstate != tempcomp_state) {
+    _tcstate = tempcomp_state;
+    _tctemp = _filtered;
+    _tcsteps = 0.0f;
   }
 
-  // toggle flag
-  requesttempflag ^= 1;
-
-  // check for temperature compensation
   if (tempcomp_state) {
-    // calculate if temp has moved by more than 1 degree
-    if ((abs)(starttemp - tempval) >= 1) {
-      long newPos;
-      // temperature falling (1) or rising (0)?
-      byte temperaturedirection;
-      temperaturedirection = (tempval < starttemp) ? TEMP_FALLING : TEMP_RISING;
-
-      // check if tc direction for compensation is inwards
-      if (ControllerData->get_tcdirection() == TC_DIRECTION_IN) {
-        // temperature compensation direction is inwards,
-        // if temperature falling then move in else move out
-        if (temperaturedirection == TEMP_FALLING) {
-          // then move inwards
-          newPos = ftargetPosition - ControllerData->get_tempcoefficient();
-        } else {
-          // else move outwards
-          newPos = ftargetPosition + ControllerData->get_tempcoefficient();
-        }
-      } else {
-        // temperature compensation direction is out,
-        // if a fall then move out else move in
-        if (temperaturedirection == TEMP_FALLING) {
-          newPos = ftargetPosition + ControllerData->get_tempcoefficient();
-        } else {
-          newPos = ftargetPosition - ControllerData->get_tempcoefficient();
-        }  // if ( temperaturedirection == 1 )
-      }    // if (ControllerData->get_tcdirection() == 0)
-
-      RangeCheck(&newPos, 0, ControllerData->get_maxstep());
-      ftargetPosition = newPos;
-
-      // save this current temp point for future reference
-      starttemp = tempval;
-    }  // end of check for tempchange >=1
-  }    // end of check for tempcomp enabled
+    // TC_DIRECTION_IN moves in when the temperature falls
+    float steps = (_filtered - _tctemp) * (float)ControllerData->get_tempcoefficient();
+    if (ControllerData->get_tcdirection() == TC_DIRECTION_OUT) {
+      steps = -steps;
+    }
+    _tcsteps += steps;
+    _tctemp = _filtered;
+
+    if ((fabsf(_tcsteps) >= (float)ControllerData->get_tcdeadband()) && camera_idle) {
+      // whole steps, the fraction is carried forward
+      long move = (long)_tcsteps;
+      if (move != 0) {
+        long newPos = ftargetPosition + move;
+        RangeCheck(&newPos, 0, ControllerData->get_maxstep());
+        ftargetPosition = newPos;
+        tempcomp_target = newPos;
+        _tcsteps -= (float)move;
+        TempMsgPrint("TC move ");
+        TempMsgPrintln(move);
+      }
+    }
+  }
   return tempval;
 }
 
-// function to print a device address
-void TEMP_PROBE::printAddress(DeviceAddress deviceAddress)
-{
-  String addr;
-  for (uint8_t i = 0; i < 8; i++)
-  {
-    if (deviceAddress[i] < 16) {
-      addr += "0";      
-    }
-    addr += String(deviceAddress[i], HEX);
+
+// -------------------------------------------------------
+// MEDIAN OF THE LAST 3 READINGS
+// -------------------------------------------------------
+float TEMP_PROBE::median(void) {
+  float a = _history[0];
+  float b = _history[1];
+  float c = _history[2];
+  if (a > b) {
+    float t = a;
+    a = b;
+    b = t;
   }
+  // a <= b, median is b clamped to [a, c]
+  return (c < a) ? a : ((c > b) ? b : c);
 }
 
 #endif
@@ -23,6 +23,28 @@
 
 
 
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+// longest bus sequence, match rom + write scratchpad
+#define TEMP_TXMAX  13
+#define TEMP_SCRATCHPAD  9
+
+// most devices looked at when searching the bus
+#define TEMP_MAXFOUND  8
+// readings in the temp comp median filter
+#define TEMP_MEDIAN  3
+
+// conversion states, run() does one bus step per call
+enum Probe_States { Probe_Idle,
+                    Probe_Configure,
+                    Probe_Reset,
+                    Probe_Write,
+                    Probe_Wait,
+                    Probe_Select,
+                    Probe_Read };
+
+
 // -------------------------------------------------------
 // TEMPERATURE CLASS
 // -------------------------------------------------------
@@ -32,15 +54,49 @@ public:
   bool start(void);
   void stop(void);
   float update(void);
-
-  void request(void);
+  void run(void);
   float read(void);
+  float read(byte);
+  bool get_present(byte);
+  void get_rom(byte, char *);
 
 private:
-  void printAddress(DeviceAddress);
+  typedef struct {
+    DeviceAddress rom;
+    float temp;       // last valid reading, celsius
+    uint8_t th;       // alarm registers, written back
+    uint8_t tl;       // unchanged on a resolution change
+    bool present;
+  } probe_entry;
+
+  byte find_probes(void);
+  void claim(byte, const uint8_t *);
+  void load_cmd(const uint8_t *, uint8_t);
+  unsigned long conversion_time(void);
+  void decode(byte);
+  float median(void);
   uint8_t _pin; 
   bool _loaded = STATE_NOTLOADED;
-  float _lasttemp = DEFAULTLASTTEMP;
+  bool _parasite = false;
+  probe_entry _probes[TEMP_MAXPROBES];  // indexed by role
+  byte _probe = 0;                  // role being configured or read
+  Probe_States _state = Probe_Idle;
+  Probe_States _next = Probe_Idle;  // state after a write
+  byte _resolution = 0;             // set in probes, 0 = not yet
+  byte _newresolution = 0;
+  unsigned long _timestamp = 0;     // start of last conversion
+  uint8_t _tx[TEMP_TXMAX];
+  uint8_t _txlen = 0;
+  uint8_t _txpos = 0;
+  uint8_t _scratchpad[TEMP_SCRATCHPAD];
+  uint8_t _rxpos = 0;
+  // temp comp
+  float _history[TEMP_MEDIAN];      // last readings, median filter
+  byte _hpos = 0;
+  float _filtered = DEFAULTLASTTEMP;  // ema of the median
+  bool _tcstate = STATE_DISABLED;   // tempcomp_state last update
+  float _tctemp = DEFAULTLASTTEMP;  // filtered temp at last update
+  float _tcsteps = 0.0f;            // steps not yet moved
 };
 
 #endif
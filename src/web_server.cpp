@@ -55,6 +55,10 @@ extern DRIVER_BOARD *driverboard;
 #include "web_server.h"
 extern WEB_SERVER *websrvr;
 
+// Page arena, shared by the servers
+#include "page_arena.h"
+extern PAGE_ARENA pagearena;
+
 
 //---------------------------------------------------
 // EXTERNS
@@ -185,6 +189,12 @@ bool WEB_SERVER::start() {
     wsget_notfound();
   });
 
+  // record time to first request
+  _web_server->addHook([](const String &, const String &, WiFiClient *, ESP8266WebServer::ContentTypeFunction) {
+    mark_firstrequest();
+    return ESP8266WebServer::CLIENT_REQUEST_CAN_CONTINUE;
+  });
+
   _web_server->begin();
   _loaded = STATE_LOADED;
   WebSrvrMsgPrintln(T_RUNNING);
@@ -268,10 +278,27 @@ void WEB_SERVER::send_myheader(void) {
 }
 
 // ----------------------------------------------------------------------
-// sends html page to web client
+// sends html page to web client, with send_myheader(). A page that did
+// not fit in the page arena is cut short, it is not sent
 // ----------------------------------------------------------------------
-void WEB_SERVER::send_mycontent(String str) {
-  _web_server->client().print(str);
+void WEB_SERVER::send_mycontent(PAGE_ARENA &pg) {
+  if (pg.overflow()) {
+    _web_server->send(HTML_SERVERERROR, PLAINTEXTPAGETYPE, T_PAGETOOBIG);
+    return;
+  }
+  send_myheader();
+  _web_server->client().write((const uint8_t *)pg.c_str(), pg.length());
+}
+
+// ----------------------------------------------------------------------
+// sends html page to web client, with send()
+// ----------------------------------------------------------------------
+void WEB_SERVER::send_page(PAGE_ARENA &pg) {
+  if (pg.overflow()) {
+    _web_server->send(HTML_SERVERERROR, PLAINTEXTPAGETYPE, T_PAGETOOBIG);
+    return;
+  }
+  _web_server->send(HTML_WEBPAGE, TEXTPAGETYPE, pg.c_str(), pg.length());
 }
 
 //---------------------------------------------------
@@ -298,8 +325,7 @@ String WEB_SERVER::get_contenttype(String filename) {
 //---------------------------------------------------
 void WEB_SERVER::get_index(void) {
   String tmp;
-  String _WSpg;
-  _WSpg.reserve(4608);  // 4540
+  PAGE_ARENA &_WSpg = pagearena;
 
   WebSrvrMsgPrintln(WST_INDEX);
 
@@ -411,7 +437,7 @@ Get_Handler:
     _WSpg = H_FILENOTFOUNDSTR;
   } else {
     // index page found, send to client
-    _WSpg = file.readString();
+    _WSpg.load(file);
     file.close();
 
     // Web page colors
@@ -531,7 +557,7 @@ Get_Handler:
 
   WebSrvrMsgPrint(WST_INDEX);
   WebSrvrMsgPrintln(_WSpg.length());
-  _web_server->send(HTML_WEBPAGE, TEXTPAGETYPE, _WSpg);
+  send_page(_WSpg);
 }
 
 
@@ -539,8 +565,7 @@ Get_Handler:
 // HANDLER FOR /move
 //---------------------------------------------------
 void WEB_SERVER::get_move(void) {
-  String _WSpg;
-  _WSpg.reserve(4864);  // 4765
+  PAGE_ARENA &_WSpg = pagearena;
 
   WebSrvrMsgPrintln(WST_MOVE);
 
@@ -624,7 +649,7 @@ Get_Handler:
     _WSpg = H_FILENOTFOUNDSTR;
   } else {
     // move page found, send to client
-    _WSpg = file.readString();
+    _WSpg.load(file);
     file.close();
 
     // Web page colors
@@ -662,17 +687,15 @@ Get_Handler:
   }
   WebSrvrMsgPrint(WST_MOVE);
   WebSrvrMsgPrintln(_WSpg.length());
-  send_myheader();
   send_mycontent(_WSpg);
-  //_web_server->send(HTML_WEBPAGE, TEXTPAGETYPE, _WSpg);
+  //_web_server->send(HTML_WEBPAGE, TEXTPAGETYPE, _WSpg.c_str(), _WSpg.length());
 }
 
 //---------------------------------------------------
 // GET NOTFOUND AND SEND TO WEB CLIENT
 //---------------------------------------------------
 void WEB_SERVER::get_notfound(void) {
-  String _WSpg;
-  _WSpg.reserve(3456);  // 3341
+  PAGE_ARENA &_WSpg = pagearena;
 
   // can we get server args to determine the filename?
   String p = _web_server->uri();
@@ -697,7 +720,7 @@ void WEB_SERVER::get_notfound(void) {
   if (!nfile) {
     _WSpg = H_FILENOTFOUNDSTR;
   } else {
-    _WSpg = nfile.readString();
+    _WSpg.load(nfile);
     nfile.close();
     // Web page colors
     _WSpg.replace("%PGT%", DeviceName);
@@ -718,10 +741,10 @@ void WEB_SERVER::get_notfound(void) {
 
     WebSrvrMsgPrint(WST_NOTFOUND);
     WebSrvrMsgPrintln(_WSpg.length());
-    _web_server->send(HTML_WEBPAGE, TEXTPAGETYPE, _WSpg);
+    send_page(_WSpg);
     return;
   }
-  _web_server->send(HTML_WEBPAGE, TEXTPAGETYPE, _WSpg);
+  send_page(_WSpg);
   return;
 }
 
@@ -20,6 +20,7 @@
 #undef DEBUG_ESP_HTTP_SERVER  // prevent messages from WiFiServer
 #include <ESP8266WiFi.h>
 #include <ESP8266WebServer.h>
+#include "page_arena.h"
 
 
 // -------------------------------------------------------
@@ -58,7 +59,8 @@ class WEB_SERVER {
     void send_xhtml(String);
     void send_ACAOheader(void);
     void send_myheader(void);
-    void send_mycontent(String);
+    void send_mycontent(PAGE_ARENA &);
+    void send_page(PAGE_ARENA &);
     String get_contenttype(String filename);
 
     ESP8266WebServer *_web_server;
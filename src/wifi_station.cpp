@@ -0,0 +1,286 @@
+// -------------------------------------------------------
+// myFP2ESP8266 WIFI STATION CLASS
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// wifi_station.cpp
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <Arduino.h>
+#include "config.h"
+
+#if (CONTROLLERMODE == STATION)
+
+#include <ESP8266WiFi.h>
+#include <LittleFS.h>
+#include <coredecls.h>  // crc32()
+#include "wifi_station.h"
+
+
+// -------------------------------------------------------
+// DEBUGGING
+// WARNING: DO NOT ENABLE DEBUGGING INFORMATION
+// -------------------------------------------------------
+// Remove comment to enable wifi station messages to be
+// written to Serial port
+//#define WIFISTATION_MsgPrint 1
+
+#ifdef WIFISTATION_MsgPrint
+#define WiFiStationMsgPrint(...) Serial.print(__VA_ARGS__)
+#define WiFiStationMsgPrintln(...) Serial.println(__VA_ARGS__)
+#else
+#define WiFiStationMsgPrint(...)
+#define WiFiStationMsgPrintln(...)
+#endif
+
+
+// -------------------------------------------------------
+// CLASS CONSTRUCTOR
+// -------------------------------------------------------
+WIFI_STATION::WIFI_STATION() {
+  memset(&_cache, 0, sizeof(_cache));
+}
+
+
+// -------------------------------------------------------
+// START
+// Begin connecting and return, run() completes the
+// connection. staticip is the IPADDRESSMODE setting,
+// reuselease uses the cached DHCP lease as a static
+// address on the fast path.
+// -------------------------------------------------------
+void WIFI_STATION::start(const char *ssid, const char *pass, const char *ssid1, const char *pass1, bool staticip, bool reuselease) {
+  strlcpy(_ssid[0], ssid, WIFICREDLEN);
+  strlcpy(_pass[0], pass, WIFICREDLEN);
+  strlcpy(_ssid[1], ssid1, WIFICREDLEN);
+  strlcpy(_pass[1], pass1, WIFICREDLEN);
+  _staticip = staticip;
+  _reuselease = reuselease;
+  _starttime = millis();
+  _fastconnect = false;
+  _connecttime = 0;
+
+  WiFi.persistent(false);
+  WiFi.mode(WIFI_STA);
+
+  if (load_cache()) {
+    begin_fast();
+  } else {
+    begin_scan(0);
+  }
+}
+
+
+// -------------------------------------------------------
+// RUN
+// Called every pass of loop(). At boot, moves to the next
+// way of connecting when the current one times out:
+// fast (cached AP) -> scan mySSID -> scan mySSID_1 -> failed
+// After the first connect, supervises the link:
+// connected -> lost -> scan mySSID_1 -> lost -> scan mySSID
+// -------------------------------------------------------
+void WIFI_STATION::run(void) {
+  unsigned long now = millis();
+  bool linkup = (WiFi.status() == WL_CONNECTED);
+
+  switch (_state) {
+    case WiFi_Fast:
+      if (linkup) {
+        connected();
+      } else if ((now - _steptime) >= WIFIFASTTIME) {
+        WiFiStationMsgPrintln("wifi:fast:timeout");
+        begin_scan(0);
+      }
+      break;
+
+    case WiFi_Scan:
+      if (linkup) {
+        connected();
+      } else if ((now - _steptime) >= WIFISCANTIME) {
+        WiFiStationMsgPrintln("wifi:scan:timeout");
+        if (_supervise) {
+          // wait, then try the other credentials
+          _retrytime *= 2;
+          if (_retrytime > WIFIMAXRETRYTIME) {
+            _retrytime = WIFIMAXRETRYTIME;
+          }
+          _steptime = now;
+          _state = WiFi_Lost;
+        } else {
+          begin_scan(_cred + 1);
+        }
+      }
+      break;
+
+    case WiFi_Connected:
+      if (!linkup) {
+        lost();
+      }
+      break;
+
+    case WiFi_Lost:
+      if (linkup) {
+        // SDK auto reconnect
+        connected();
+      } else if ((now - _steptime) >= _retrytime) {
+        byte cred = (_cred + 1) % WIFICREDENTIALS;
+        if (_ssid[cred][0] == 0x00) {
+          cred = _cred;
+        }
+        begin_scan(cred);
+      }
+      break;
+
+    case WiFi_Idle:
+    case WiFi_Failed:
+      break;
+  }
+}
+
+
+// -------------------------------------------------------
+// LINK LOST
+// -------------------------------------------------------
+void WIFI_STATION::lost(void) {
+  WiFiStationMsgPrintln("wifi:link lost");
+  _losttime = millis();
+  _steptime = _losttime;
+  _retrytime = WIFIRETRYTIME;
+  _state = WiFi_Lost;
+}
+
+
+// -------------------------------------------------------
+// DOWNTIME
+// total ms without a link since the first connect,
+// including a current outage
+// -------------------------------------------------------
+unsigned long WIFI_STATION::get_downtime(void) {
+  if ((_state == WiFi_Lost) || ((_supervise) && (_state == WiFi_Scan))) {
+    return _downtime + (millis() - _losttime);
+  }
+  return _downtime;
+}
+
+
+// -------------------------------------------------------
+// FAST CONNECT
+// join the cached AP on its channel, no scan
+// -------------------------------------------------------
+void WIFI_STATION::begin_fast(void) {
+  _cred = _cache.cred;
+  if ((_reuselease) && (!_staticip) && (_cache.ip != 0)) {
+    WiFi.config(IPAddress(_cache.ip), IPAddress(_cache.gateway), IPAddress(_cache.subnet), IPAddress(_cache.dns));
+  }
+  WiFiStationMsgPrint("wifi:fast:channel ");
+  WiFiStationMsgPrintln(_cache.channel);
+  WiFi.begin(_ssid[_cred], _pass[_cred], _cache.channel, _cache.bssid);
+  _steptime = millis();
+  _state = WiFi_Fast;
+}
+
+
+// -------------------------------------------------------
+// SCAN CONNECT
+// -------------------------------------------------------
+void WIFI_STATION::begin_scan(byte cred) {
+  if ((cred >= WIFICREDENTIALS) || (_ssid[cred][0] == 0x00)) {
+    WiFiStationMsgPrintln("wifi:failed");
+    _state = WiFi_Failed;
+    return;
+  }
+  _cred = cred;
+  if ((_reuselease) && (!_staticip)) {
+    // back to DHCP in case the cached lease was used
+    WiFi.config(IPAddress(), IPAddress(), IPAddress());
+  }
+  WiFiStationMsgPrint("wifi:scan:");
+  WiFiStationMsgPrintln(_ssid[cred]);
+  WiFi.begin(_ssid[cred], _pass[cred]);
+  _steptime = millis();
+  _state = WiFi_Scan;
+}
+
+
+// -------------------------------------------------------
+// CONNECTED
+// update the cache, only written if it changed
+// -------------------------------------------------------
+void WIFI_STATION::connected(void) {
+  if (_supervise) {
+    // reconnect after a link loss
+    _downtime += millis() - _losttime;
+    _reconnects++;
+    WiFiStationMsgPrint("wifi:reconnected:");
+    WiFiStationMsgPrintln(_reconnects);
+  } else {
+    _fastconnect = (_state == WiFi_Fast);
+    _connecttime = millis() - _starttime;
+    _supervise = true;
+    WiFiStationMsgPrint("wifi:connected ms:");
+    WiFiStationMsgPrintln(_connecttime);
+  }
+  _state = WiFi_Connected;
+
+  wifi_cache cache;
+  memset(&cache, 0, sizeof(cache));
+  cache.ssidcrc = crc32(_ssid[_cred], strlen(_ssid[_cred]));
+  memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+  cache.channel = WiFi.channel();
+  cache.cred = _cred;
+  cache.ip = (uint32_t)WiFi.localIP();
+  cache.gateway = (uint32_t)WiFi.gatewayIP();
+  cache.subnet = (uint32_t)WiFi.subnetMask();
+  cache.dns = (uint32_t)WiFi.dnsIP();
+  cache.crc = cache_crc(cache);
+  if (memcmp(&cache, &_cache, sizeof(cache)) != 0) {
+    _cache = cache;
+    save_cache();
+  }
+}
+
+
+// -------------------------------------------------------
+// CACHE
+// RTC memory survives a reset or reboot, the file also
+// survives a power cycle. A cache is only used if the
+// crc is good and it was made with the same ssid.
+// -------------------------------------------------------
+uint32_t WIFI_STATION::cache_crc(const wifi_cache &cache) {
+  return crc32((const uint8_t *)&cache + sizeof(cache.crc), sizeof(cache) - sizeof(cache.crc));
+}
+
+bool WIFI_STATION::load_cache(void) {
+  bool ok = ESP.rtcUserMemoryRead(WIFICACHE_RTCOFFSET, (uint32_t *)&_cache, sizeof(_cache))
+            && (_cache.crc == cache_crc(_cache));
+  if (!ok) {
+    File file = LittleFS.open(WIFICACHEFILE, "r");
+    if (file) {
+      ok = (file.read((uint8_t *)&_cache, sizeof(_cache)) == sizeof(_cache))
+           && (_cache.crc == cache_crc(_cache));
+      file.close();
+    }
+  }
+  if ((!ok) || (_cache.cred >= WIFICREDENTIALS)
+      || (_cache.ssidcrc != crc32(_ssid[_cache.cred], strlen(_ssid[_cache.cred])))) {
+    WiFiStationMsgPrintln("wifi:cache:none");
+    memset(&_cache, 0, sizeof(_cache));
+    return false;
+  }
+  return true;
+}
+
+void WIFI_STATION::save_cache(void) {
+  WiFiStationMsgPrintln("wifi:cache:save");
+  ESP.rtcUserMemoryWrite(WIFICACHE_RTCOFFSET, (uint32_t *)&_cache, sizeof(_cache));
+  File file = LittleFS.open(WIFICACHEFILE, "w");
+  if (file) {
+    file.write((const uint8_t *)&_cache, sizeof(_cache));
+    file.close();
+  }
+}
+
+#endif  // #if (CONTROLLERMODE == STATION)
@@ -0,0 +1,119 @@
+// -------------------------------------------------------
+// myFP2ESP8266 WIFI STATION CLASS DEFINITION
+// Copyright Robert Brown 2014-2025. All Rights Reserved.
+// wifi_station.h
+// NodeMCU 1.0 (ESP-12E Module)
+// -------------------------------------------------------
+
+#ifndef _wifi_station_h_
+#define _wifi_station_h_
+
+#include <Arduino.h>
+#include "config.h"
+
+#if (CONTROLLERMODE == STATION)
+
+// -------------------------------------------------------
+// INCLUDES
+// -------------------------------------------------------
+#include <ESP8266WiFi.h>
+
+
+// -------------------------------------------------------
+// DEFINES
+// -------------------------------------------------------
+#define WIFICACHEFILE       "/wifi.bin"
+#define WIFICACHE_RTCOFFSET 0       // rtc user memory, 4 byte blocks
+#define WIFIFASTTIME        3000    // ms to wait for a fast connect
+#define WIFISCANTIME        6000    // ms to wait for a scan connect
+#define WIFIRETRYTIME       5000    // ms after link loss before a scan
+#define WIFIMAXRETRYTIME    60000   // retry time doubles up to this
+#define WIFICREDENTIALS     2       // mySSID, mySSID_1
+#define WIFICREDLEN         64
+
+
+// -------------------------------------------------------
+// CLASS
+// Connects to the WiFi network without blocking setup()
+// or loop(). The BSSID and channel (and DHCP lease) of the
+// last connection are kept in RTC memory and a LittleFS
+// file. At boot the station joins that AP directly, which
+// skips the scan. If that fails within WIFIFASTTIME each
+// set of credentials is tried with a full scan.
+// Once connected the link is supervised. When it is lost
+// the SDK auto reconnect is given WIFIRETRYTIME, then each
+// set of credentials is scanned in turn, with the wait
+// between attempts doubling up to WIFIMAXRETRYTIME.
+// -------------------------------------------------------
+class WIFI_STATION {
+public:
+  enum WiFi_States { WiFi_Idle, WiFi_Fast, WiFi_Scan, WiFi_Connected, WiFi_Lost, WiFi_Failed };
+
+  WIFI_STATION();
+  void start(const char *, const char *, const char *, const char *, bool, bool);
+  void run(void);
+  WiFi_States get_state(void) {
+    return _state;
+  }
+  byte get_cred(void) {
+    return _cred;
+  }
+  const char *get_ssid(void) {
+    return _ssid[_cred];
+  }
+  const char *get_password(void) {
+    return _pass[_cred];
+  }
+  bool get_fastconnect(void) {
+    return _fastconnect;
+  }
+  unsigned long get_connecttime(void) {
+    return _connecttime;
+  }
+  unsigned long get_reconnects(void) {
+    return _reconnects;
+  }
+  unsigned long get_downtime(void);
+
+private:
+  typedef struct {
+    uint32_t crc;         // crc of the rest of the struct
+    uint32_t ssidcrc;     // crc of the ssid used
+    uint8_t bssid[6];
+    uint8_t channel;
+    uint8_t cred;         // credentials used, 0 or 1
+    uint32_t ip;          // DHCP lease
+    uint32_t gateway;
+    uint32_t subnet;
+    uint32_t dns;
+  } wifi_cache;
+
+  bool load_cache(void);
+  void save_cache(void);
+  uint32_t cache_crc(const wifi_cache &);
+  void begin_fast(void);
+  void begin_scan(byte);
+  void connected(void);
+  void lost(void);
+
+  char _ssid[WIFICREDENTIALS][WIFICREDLEN];
+  char _pass[WIFICREDENTIALS][WIFICREDLEN];
+  bool _staticip = false;
+  bool _reuselease = false;
+  wifi_cache _cache;
+  WiFi_States _state = WiFi_Idle;
+  byte _cred = 0;
+  bool _fastconnect = false;          // connected via cached BSSID
+  unsigned long _starttime = 0;       // millis() at start()
+  unsigned long _steptime = 0;        // millis() at begin()
+  unsigned long _connecttime = 0;     // ms from start() to connected
+  // supervisor
+  bool _supervise = false;            // true after first connect
+  unsigned long _retrytime = WIFIRETRYTIME;
+  unsigned long _losttime = 0;        // millis() when link was lost
+  unsigned long _downtime = 0;        // ms, total of past outages
+  unsigned long _reconnects = 0;
+};
+
+#endif  // #if (CONTROLLERMODE == STATION)
+#endif
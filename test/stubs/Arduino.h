@@ -0,0 +1,433 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// Arduino.h
+// Host replacement for the parts of the ESP8266 Arduino
+// core used by the modules under test
+// millis() and micros() are driven by the test through
+// stub_millis and stub_micros, delay() advances both
+// -------------------------------------------------------
+
+#ifndef _stub_arduino_h_
+#define _stub_arduino_h_
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH   1
+#define LOW    0
+#define INPUT  0
+#define OUTPUT 1
+
+#define F(s)    (s)
+#define PSTR(s) (s)
+
+using std::min;
+using std::max;
+#define constrain(v, lo, hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
+
+// -------------------------------------------------------
+// TIME
+// -------------------------------------------------------
+inline uint32_t stub_millis = 0;
+inline uint32_t stub_micros = 0;
+
+inline unsigned long millis(void) {
+  return stub_millis;
+}
+inline unsigned long micros(void) {
+  return stub_micros;
+}
+inline void delay(unsigned long ms) {
+  stub_millis += ms;
+  stub_micros += ms * 1000;
+}
+inline void delayMicroseconds(unsigned int us) {
+  stub_micros += us;
+}
+inline void yield(void) {}
+
+
+// -------------------------------------------------------
+// PINS
+// -------------------------------------------------------
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) {
+  return LOW;
+}
+
+
+// -------------------------------------------------------
+// STRINGS
+// -------------------------------------------------------
+#if !defined(__GLIBC__) || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38)
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = (len >= size) ? size - 1 : len;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return len;
+}
+inline size_t strlcat(char *dst, const char *src, size_t size) {
+  size_t len = strnlen(dst, size);
+  if (len == size) {
+    return len + strlen(src);
+  }
+  return len + strlcpy(dst + len, src, size - len);
+}
+#endif
+
+inline char *dtostrf(double val, signed char width, unsigned char prec, char *buff) {
+  sprintf(buff, "%*.*f", width, prec, val);
+  return buff;
+}
+inline char *ltoa(long val, char *buff, int base) {
+  if (base == 16) {
+    sprintf(buff, "%lx", val);
+  } else {
+    sprintf(buff, "%ld", val);
+  }
+  return buff;
+}
+inline char *itoa(int val, char *buff, int base) {
+  return ltoa(val, buff, base);
+}
+inline char *ultoa(unsigned long val, char *buff, int base) {
+  sprintf(buff, (base == 16) ? "%lx" : "%lu", val);
+  return buff;
+}
+
+class String {
+public:
+  String(const char *s = "")
+    : _s(s ? s : "") {}
+  String(const std::string &s)
+    : _s(s) {}
+  explicit String(char c)
+    : _s(1, c) {}
+  String(int v)
+    : _s(std::to_string(v)) {}
+  String(unsigned int v)
+    : _s(std::to_string(v)) {}
+  String(long v)
+    : _s(std::to_string(v)) {}
+  String(unsigned long v)
+    : _s(std::to_string(v)) {}
+  String(double v, unsigned char prec = 2) {
+    char buff[32];
+    snprintf(buff, sizeof(buff), "%.*f", prec, v);
+    _s = buff;
+  }
+
+  const char *c_str(void) const {
+    return _s.c_str();
+  }
+  unsigned int length(void) const {
+    return _s.length();
+  }
+  bool isEmpty(void) const {
+    return _s.empty();
+  }
+  void reserve(unsigned int n) {
+    _s.reserve(n);
+  }
+  long toInt(void) const {
+    return atol(_s.c_str());
+  }
+  float toFloat(void) const {
+    return atof(_s.c_str());
+  }
+  void toCharArray(char *buff, unsigned int size) const {
+    strlcpy(buff, _s.c_str(), size);
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t i = _s.find(c, from);
+    return (i == std::string::npos) ? -1 : (int)i;
+  }
+  int indexOf(const char *s, unsigned int from = 0) const {
+    size_t i = _s.find(s, from);
+    return (i == std::string::npos) ? -1 : (int)i;
+  }
+  String substring(unsigned int from) const {
+    return (from < _s.length()) ? String(_s.substr(from)) : String();
+  }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) {
+      std::swap(from, to);
+    }
+    return (from < _s.length()) ? String(_s.substr(from, to - from)) : String();
+  }
+  bool startsWith(const String &s) const {
+    return _s.compare(0, s._s.length(), s._s) == 0;
+  }
+  bool endsWith(const String &s) const {
+    return (_s.length() >= s._s.length())
+           && (_s.compare(_s.length() - s._s.length(), s._s.length(), s._s) == 0);
+  }
+  bool equals(const char *s) const {
+    return _s == s;
+  }
+  void trim(void) {
+    size_t b = _s.find_first_not_of(" \t\r\n");
+    size_t e = _s.find_last_not_of(" \t\r\n");
+    _s = (b == std::string::npos) ? "" : _s.substr(b, e - b + 1);
+  }
+  void replace(const String &from, const String &to) {
+    if (from._s.empty()) {
+      return;
+    }
+    for (size_t i = _s.find(from._s); i != std::string::npos; i = _s.find(from._s, i + to._s.length())) {
+      _s.replace(i, from._s.length(), to._s);
+    }
+  }
+  bool concat(const char *s) {
+    _s += s;
+    return true;
+  }
+  bool concat(const char *s, unsigned int n) {
+    _s.append(s, n);
+    return true;
+  }
+  bool concat(char c) {
+    _s += c;
+    return true;
+  }
+
+  char operator[](unsigned int i) const {
+    return (i < _s.length()) ? _s[i] : 0;
+  }
+  char &operator[](unsigned int i) {
+    return _s[i];
+  }
+  String &operator+=(const String &s) {
+    _s += s._s;
+    return *this;
+  }
+  String &operator+=(const char *s) {
+    _s += s;
+    return *this;
+  }
+  String &operator+=(char c) {
+    _s += c;
+    return *this;
+  }
+  bool operator==(const String &s) const {
+    return _s == s._s;
+  }
+  bool operator==(const char *s) const {
+    return _s == s;
+  }
+  bool operator!=(const String &s) const {
+    return _s != s._s;
+  }
+  bool operator!=(const char *s) const {
+    return _s != s;
+  }
+  friend String operator+(const String &a, const String &b) {
+    return String(a._s + b._s);
+  }
+  friend String operator+(const String &a, const char *b) {
+    return String(a._s + b);
+  }
+  friend String operator+(const char *a, const String &b) {
+    return String(a + b._s);
+  }
+
+private:
+  std::string _s;
+};
+
+
+// -------------------------------------------------------
+// PRINT AND STREAM
+// -------------------------------------------------------
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t) {
+    return 1;
+  }
+  virtual size_t write(const uint8_t *buff, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+      write(buff[i]);
+    }
+    return len;
+  }
+  size_t write(const char *s) {
+    return write((const uint8_t *)s, strlen(s));
+  }
+  size_t print(const char *s) {
+    return write(s);
+  }
+  size_t print(const String &s) {
+    return write(s.c_str());
+  }
+  size_t print(char c) {
+    return write((uint8_t)c);
+  }
+  size_t print(long v) {
+    return print(String(v));
+  }
+  size_t print(int v) {
+    return print(String(v));
+  }
+  size_t print(unsigned long v) {
+    return print(String(v));
+  }
+  size_t print(unsigned int v) {
+    return print(String(v));
+  }
+  size_t print(double v, int prec = 2) {
+    return print(String(v, prec));
+  }
+  template<typename T>
+  size_t println(const T &v) {
+    return print(v) + println();
+  }
+  size_t println(void) {
+    return write("\r\n");
+  }
+  void flush(void) {}
+};
+
+class Stream : public Print {
+public:
+  virtual int available(void) {
+    return 0;
+  }
+  virtual int read(void) {
+    return -1;
+  }
+  virtual int peek(void) {
+    return -1;
+  }
+  void setTimeout(unsigned long) {}
+  size_t readBytes(char *buff, size_t len) {
+    size_t n = 0;
+    while ((n < len) && available()) {
+      buff[n++] = (char)read();
+    }
+    return n;
+  }
+  size_t readBytesUntil(char term, char *buff, size_t len) {
+    size_t n = 0;
+    while ((n < len) && available()) {
+      int c = read();
+      if (c == term) {
+        break;
+      }
+      buff[n++] = (char)c;
+    }
+    return n;
+  }
+  String readString(void) {
+    std::string s;
+    while (available()) {
+      s += (char)read();
+    }
+    return String(s);
+  }
+  bool find(char term) {
+    while (available()) {
+      if (read() == term) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+
+// -------------------------------------------------------
+// SERIAL
+// Bytes pushed into rx are read by the firmware, bytes
+// written by the firmware are appended to tx
+// -------------------------------------------------------
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long speed) {
+    baud = speed;
+  }
+  void end(void) {}
+  void updateBaudRate(unsigned long speed) {
+    baud = speed;
+  }
+  int available(void) override {
+    return rx.length() - rxpos;
+  }
+  int read(void) override {
+    return (rxpos < rx.length()) ? (uint8_t)rx[rxpos++] : -1;
+  }
+  int peek(void) override {
+    return (rxpos < rx.length()) ? (uint8_t)rx[rxpos] : -1;
+  }
+  using Print::write;
+  size_t write(uint8_t c) override {
+    tx += (char)c;
+    return 1;
+  }
+  size_t write(const uint8_t *buff, size_t len) override {
+    tx.append((const char *)buff, len);
+    return len;
+  }
+  void clear(void) {
+    rx.clear();
+    tx.clear();
+    rxpos = 0;
+  }
+
+  std::string rx;
+  size_t rxpos = 0;
+  std::string tx;
+  unsigned long baud = 0;
+};
+
+inline HardwareSerial Serial;
+
+
+// -------------------------------------------------------
+// ESP
+// The heap values are set by the tests
+// -------------------------------------------------------
+class EspClass {
+public:
+  uint32_t getFreeHeap(void) {
+    return freeheap;
+  }
+  uint32_t getMaxFreeBlockSize(void) {
+    return maxblock;
+  }
+  uint8_t getHeapFragmentation(void) {
+    return frag;
+  }
+  void getHeapStats(uint32_t *hfree, uint32_t *hmax, uint8_t *hfrag) {
+    *hfree = freeheap;
+    *hmax = maxblock;
+    *hfrag = frag;
+  }
+  uint32_t getFreeContStack(void) {
+    return stackfree;
+  }
+  void restart(void) {}
+
+  uint32_t freeheap = 40000;
+  uint32_t maxblock = 32000;
+  uint8_t frag = 0;
+  uint32_t stackfree = 4000;
+};
+
+inline EspClass ESP;
+
+#endif
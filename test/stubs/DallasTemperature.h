@@ -0,0 +1,54 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// DallasTemperature.h
+// The calls temp_probe.cpp makes at start(), answered
+// from the stub_onewire bus
+// -------------------------------------------------------
+
+#ifndef _stub_dallastemperature_h_
+#define _stub_dallastemperature_h_
+
+#include <OneWire.h>
+
+typedef uint8_t DeviceAddress[8];
+
+#define DEVICE_DISCONNECTED_C -127
+
+class DallasTemperature {
+public:
+  DallasTemperature(OneWire *) {}
+  void begin(void) {}
+  bool isParasitePowerMode(void) {
+    return false;
+  }
+  bool validAddress(const uint8_t *deviceAddress) {
+    return OneWire::crc8(deviceAddress, 7) == deviceAddress[7];
+  }
+  bool validFamily(const uint8_t *deviceAddress) {
+    return deviceAddress[0] == 0x28;
+  }
+  bool readScratchPad(const uint8_t *deviceAddress, uint8_t *scratchPad) {
+    int n = OneWire::find_rom(deviceAddress);
+    if (n < 0) {
+      return false;
+    }
+    OneWire::load_scratchpad(n, scratchPad);
+    return true;
+  }
+  void setWaitForConversion(bool flag) {
+    _wait = flag;
+  }
+  void requestTemperatures(void) {
+    OneWire::convert_all(_wait);
+  }
+  float getTempC(const uint8_t *deviceAddress, byte retryCount = 0) {
+    (void)retryCount;
+    int n = OneWire::find_rom(deviceAddress);
+    return (n < 0) ? DEVICE_DISCONNECTED_C : stub_onewire.dev[n].sample;
+  }
+
+private:
+  bool _wait = true;
+};
+
+#endif
@@ -0,0 +1,15 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// ESP8266WebServer.h
+// Servers are not run on the host, only the type is needed
+// -------------------------------------------------------
+
+#ifndef _stub_esp8266webserver_h_
+#define _stub_esp8266webserver_h_
+
+#include <ESP8266WiFi.h>
+#include <FS.h>
+
+class ESP8266WebServer;
+
+#endif
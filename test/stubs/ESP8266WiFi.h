@@ -0,0 +1,160 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// ESP8266WiFi.h
+// WiFiClient talks to a stand in server in stub_server.
+// The test scripts a reply per connection and how fast
+// it arrives, and reads back the request the client sent
+// -------------------------------------------------------
+
+#ifndef _stub_esp8266wifi_h_
+#define _stub_esp8266wifi_h_
+
+#include <Arduino.h>
+#include <lwip/dns.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+class IPAddress {
+public:
+  IPAddress() {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    : _ip{ a, b, c, d } {}
+  IPAddress(const ip_addr_t *addr) {
+    memcpy(_ip, &addr->addr, 4);
+  }
+  uint8_t operator[](int i) const {
+    return _ip[i];
+  }
+  bool operator==(const IPAddress &other) const {
+    return memcmp(_ip, other._ip, 4) == 0;
+  }
+  bool isSet(void) const {
+    return (_ip[0] | _ip[1] | _ip[2] | _ip[3]) != 0;
+  }
+  // a.b.c.d, each 0-255
+  bool fromString(const char *str) {
+    uint8_t ip[4];
+    for (int i = 0; i < 4; i++) {
+      int val = 0;
+      int digits = 0;
+      while (isdigit(*str) && (digits < 3)) {
+        val = (val * 10) + (*str++ - '0');
+        digits++;
+      }
+      if ((digits == 0) || (val > 255) || (*str != ((i < 3) ? '.' : '\0'))) {
+        return false;
+      }
+      ip[i] = val;
+      str++;
+    }
+    memcpy(_ip, ip, 4);
+    return true;
+  }
+
+private:
+  uint8_t _ip[4] = { 0, 0, 0, 0 };
+};
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_CONNECTED = 3,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+class ESP8266WiFiClass {
+public:
+  wl_status_t status(void) {
+    return _status;
+  }
+  wl_status_t _status = WL_CONNECTED;
+};
+
+inline ESP8266WiFiClass WiFi;
+
+struct STUB_SERVER {
+  bool accept = true;             // connect() succeeds
+  unsigned long connect_ms = 0;   // time connect() takes
+  std::vector<std::string> replies;  // one per connection
+  size_t bytes_per_ms = 0;        // reply arrival rate, 0 all at once
+  size_t stall_at = SIZE_MAX;     // no more arrives, left open
+  std::string request;            // bytes the client wrote
+  IPAddress ip;                   // last connected to
+  uint16_t port = 0;
+  unsigned long timeout = 0;      // client setTimeout() at connect
+  std::vector<unsigned long> connect_times;  // millis() of each connect()
+};
+
+inline STUB_SERVER stub_server;
+
+class WiFiClient : public Stream {
+public:
+  void setTimeout(unsigned long ms) {
+    _timeout = ms;
+  }
+  // blocks for connect_ms, or until the timeout
+  int connect(IPAddress ip, uint16_t port) {
+    STUB_SERVER &srv = stub_server;
+    size_t n = srv.connect_times.size();
+    srv.connect_times.push_back(millis());
+    srv.ip = ip;
+    srv.port = port;
+    srv.timeout = _timeout;
+    srv.request.clear();
+    if (!srv.accept || (srv.connect_ms > _timeout)) {
+      delay(_timeout);
+      return 0;
+    }
+    delay(srv.connect_ms);
+    _reply = (n < srv.replies.size()) ? srv.replies[n] : "";
+    _start = millis();
+    _pos = 0;
+    _open = true;
+    return 1;
+  }
+  int available(void) override {
+    return _open ? (int)(arrived() - _pos) : 0;
+  }
+  int read(void) override {
+    return (available() > 0) ? (uint8_t)_reply[_pos++] : -1;
+  }
+  int peek(void) override {
+    return (available() > 0) ? (uint8_t)_reply[_pos] : -1;
+  }
+  using Print::write;
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buff, size_t len) override {
+    if (!_open) {
+      return 0;
+    }
+    stub_server.request.append((const char *)buff, len);
+    return len;
+  }
+  // open until the whole reply has arrived and been read,
+  // the server then closes
+  uint8_t connected(void) {
+    return (_open && ((arrived() < _reply.length()) || (available() > 0))) ? 1 : 0;
+  }
+  void stop(void) {
+    _open = false;
+  }
+
+private:
+  size_t arrived(void) {
+    size_t len = _reply.length();
+    if (stub_server.bytes_per_ms != 0) {
+      len = std::min(len, (size_t)(millis() - _start) * stub_server.bytes_per_ms);
+    }
+    return std::min(len, stub_server.stall_at);
+  }
+
+  unsigned long _timeout = 1000;
+  std::string _reply;
+  unsigned long _start = 0;
+  size_t _pos = 0;
+  bool _open = false;
+};
+
+#endif
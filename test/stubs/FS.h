@@ -0,0 +1,142 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// FS.h
+// An in memory file system, files are held by path
+// -------------------------------------------------------
+
+#ifndef _stub_fs_h_
+#define _stub_fs_h_
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+
+class File : public Stream {
+public:
+  File() {}
+  File(std::shared_ptr<std::string> data, const char *name, bool append)
+    : _data(data), _name(name), _pos(append ? data->length() : 0) {}
+
+  operator bool() const {
+    return _data != nullptr;
+  }
+  int available(void) override {
+    return _data ? (int)(_data->length() - _pos) : 0;
+  }
+  int read(void) override {
+    return (available() > 0) ? (uint8_t)(*_data)[_pos++] : -1;
+  }
+  int peek(void) override {
+    return (available() > 0) ? (uint8_t)(*_data)[_pos] : -1;
+  }
+  size_t read(uint8_t *buff, size_t len) {
+    size_t n = std::min(len, (size_t)available());
+    if (n) {
+      memcpy(buff, _data->data() + _pos, n);
+      _pos += n;
+    }
+    return n;
+  }
+  using Print::write;
+  size_t write(uint8_t c) override {
+    return write(&c, 1);
+  }
+  size_t write(const uint8_t *buff, size_t len) override {
+    if (!_data) {
+      return 0;
+    }
+    if (_pos + len > _data->length()) {
+      _data->resize(_pos + len);
+    }
+    memcpy(&(*_data)[_pos], buff, len);
+    _pos += len;
+    return len;
+  }
+  bool seek(uint32_t pos) {
+    if (!_data || (pos > _data->length())) {
+      return false;
+    }
+    _pos = pos;
+    return true;
+  }
+  size_t position(void) const {
+    return _pos;
+  }
+  size_t size(void) const {
+    return _data ? _data->length() : 0;
+  }
+  const char *name(void) const {
+    return _name.c_str();
+  }
+  void flush(void) {}
+  void close(void) {
+    _data = nullptr;
+  }
+
+private:
+  std::shared_ptr<std::string> _data;
+  std::string _name;
+  size_t _pos = 0;
+};
+
+class FS {
+public:
+  bool begin(void) {
+    return true;
+  }
+  void end(void) {}
+  bool format(void) {
+    _files.clear();
+    return true;
+  }
+  File open(const char *path, const char *mode) {
+    auto it = _files.find(path);
+    if (mode[0] == 'r') {
+      return (it == _files.end()) ? File() : File(it->second, path, false);
+    }
+    if ((it == _files.end()) || (mode[0] == 'w')) {
+      _files[path] = std::make_shared<std::string>();
+    }
+    return File(_files[path], path, mode[0] == 'a');
+  }
+  File open(const String &path, const char *mode) {
+    return open(path.c_str(), mode);
+  }
+  bool exists(const char *path) {
+    return _files.count(path) != 0;
+  }
+  bool exists(const String &path) {
+    return exists(path.c_str());
+  }
+  bool remove(const char *path) {
+    return _files.erase(path) != 0;
+  }
+  bool remove(const String &path) {
+    return remove(path.c_str());
+  }
+  bool rename(const char *from, const char *to) {
+    auto it = _files.find(from);
+    if (it == _files.end()) {
+      return false;
+    }
+    _files[to] = it->second;
+    _files.erase(from);
+    return true;
+  }
+  bool rename(const String &from, const String &to) {
+    return rename(from.c_str(), to.c_str());
+  }
+
+  // test access, the content of a file
+  std::string &content(const char *path) {
+    if (!exists(path)) {
+      _files[path] = std::make_shared<std::string>();
+    }
+    return *_files[path];
+  }
+
+private:
+  std::map<std::string, std::shared_ptr<std::string>> _files;
+};
+
+#endif
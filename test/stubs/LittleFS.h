@@ -0,0 +1,13 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// LittleFS.h
+// -------------------------------------------------------
+
+#ifndef _stub_littlefs_h_
+#define _stub_littlefs_h_
+
+#include <FS.h>
+
+inline FS LittleFS;
+
+#endif
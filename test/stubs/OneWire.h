@@ -0,0 +1,214 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// OneWire.h
+// A bus of up to STUB_DS_MAX DS18B20s. The test sets the
+// rom and temperature of each in stub_onewire.dev[]. A
+// skip rom convert starts every probe, and a read
+// scratchpad by match rom returns the last finished
+// conversion at the resolution in that probe's config
+// register, 85C if there has been none. A search returns
+// the present probes in dev[] order. Each reset and each
+// byte written or read is counted as one bus step
+// -------------------------------------------------------
+
+#ifndef _stub_onewire_h_
+#define _stub_onewire_h_
+
+#include <Arduino.h>
+
+#define STUB_DS_MATCHROM     0x55
+#define STUB_DS_SKIPROM      0xCC
+#define STUB_DS_CONVERT      0x44
+#define STUB_DS_READSCRATCH  0xBE
+#define STUB_DS_WRITESCRATCH 0x4E
+#define STUB_DS_MAX          4
+#define STUB_DS_POWERON      85.0f
+
+class OneWire;
+
+struct STUB_DS18B20 {
+  uint8_t rom[8] = { 0x28, 0x61, 0x64, 0x12, 0x3c, 0x7c, 0x2f, 0x27 };
+  bool present = true;
+  float temp = 20.0f;              // celsius
+  float sample = STUB_DS_POWERON;  // last finished conversion
+  float pending = 0.0f;            // temp when converting started
+  bool converting = false;
+  uint32_t converted = 0;          // millis() at the convert
+  uint8_t th = 0x4b;
+  uint8_t tl = 0x46;
+  uint8_t config = 0x7f;           // 12 bit
+  int reads = 0;                   // scratchpads read in full
+};
+
+struct STUB_ONEWIRE_BUS {
+  STUB_DS18B20 dev[STUB_DS_MAX];
+  uint8_t count = 1;      // probes on the bus
+  std::string cmd;        // bytes written since the last reset
+  int selected = -1;      // probe addressed by match rom
+  uint8_t scratchpad[9];
+  uint8_t rxpos = 0;
+  uint8_t searchpos = 0;
+  bool corrupt = false;   // the next scratchpad has a bad crc
+  int resets = 0;
+  int converts = 0;
+  int reads = 0;          // scratchpads read in full, all probes
+  int steps = 0;
+};
+
+inline STUB_ONEWIRE_BUS stub_onewire;
+
+class OneWire {
+public:
+  OneWire(uint8_t pin) {
+    begin(pin);
+  }
+  void begin(uint8_t) {}
+  uint8_t reset(void) {
+    stub_onewire.cmd.clear();
+    stub_onewire.rxpos = 0;
+    stub_onewire.selected = -1;
+    stub_onewire.resets++;
+    stub_onewire.steps++;
+    for (uint8_t i = 0; i < stub_onewire.count; i++) {
+      if (stub_onewire.dev[i].present) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+  void write(uint8_t v, uint8_t power = 0) {
+    (void)power;
+    std::string &cmd = stub_onewire.cmd;
+    cmd += (char)v;
+    stub_onewire.steps++;
+    if ((uint8_t)cmd[0] == STUB_DS_SKIPROM) {
+      if ((cmd.length() == 2) && (v == STUB_DS_CONVERT)) {
+        convert_all(false);
+        stub_onewire.converts++;
+      }
+      return;
+    }
+    if ((uint8_t)cmd[0] != STUB_DS_MATCHROM) {
+      return;
+    }
+    // match rom, 8 rom bytes, then the function
+    if (cmd.length() == 9) {
+      stub_onewire.selected = find_rom((const uint8_t *)cmd.data() + 1);
+    }
+    int sel = stub_onewire.selected;
+    if ((cmd.length() == 10) && ((uint8_t)cmd[9] == STUB_DS_READSCRATCH)) {
+      if (sel >= 0) {
+        load_scratchpad(sel, stub_onewire.scratchpad);
+      } else {
+        memset(stub_onewire.scratchpad, 0xff, sizeof(stub_onewire.scratchpad));
+      }
+    }
+    if ((cmd.length() == 13) && ((uint8_t)cmd[9] == STUB_DS_WRITESCRATCH) && (sel >= 0)) {
+      stub_onewire.dev[sel].th = (uint8_t)cmd[10];
+      stub_onewire.dev[sel].tl = (uint8_t)cmd[11];
+      stub_onewire.dev[sel].config = (uint8_t)cmd[12];
+    }
+  }
+  uint8_t read(void) {
+    stub_onewire.steps++;
+    if (stub_onewire.rxpos >= sizeof(stub_onewire.scratchpad)) {
+      return 0xff;
+    }
+    uint8_t b = stub_onewire.scratchpad[stub_onewire.rxpos++];
+    if ((stub_onewire.rxpos == sizeof(stub_onewire.scratchpad)) && (stub_onewire.selected >= 0)) {
+      stub_onewire.dev[stub_onewire.selected].reads++;
+      stub_onewire.reads++;
+    }
+    return b;
+  }
+  void reset_search(void) {
+    stub_onewire.searchpos = 0;
+  }
+  bool search(uint8_t *newAddr, bool search_mode = true) {
+    (void)search_mode;
+    while (stub_onewire.searchpos < stub_onewire.count) {
+      STUB_DS18B20 &dev = stub_onewire.dev[stub_onewire.searchpos++];
+      if (dev.present) {
+        memcpy(newAddr, dev.rom, 8);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Dallas/Maxim CRC-8, polynomial 0x31 reflected
+  static uint8_t crc8(const uint8_t *addr, uint8_t len) {
+    uint8_t crc = 0;
+    while (len--) {
+      uint8_t inbyte = *addr++;
+      for (uint8_t i = 8; i; i--) {
+        uint8_t mix = (crc ^ inbyte) & 0x01;
+        crc >>= 1;
+        if (mix) {
+          crc ^= 0x8C;
+        }
+        inbyte >>= 1;
+      }
+    }
+    return crc;
+  }
+
+  // the present probe with this rom, or -1
+  static int find_rom(const uint8_t *rom) {
+    for (uint8_t i = 0; i < stub_onewire.count; i++) {
+      if (stub_onewire.dev[i].present && (memcmp(stub_onewire.dev[i].rom, rom, 8) == 0)) {
+        return i;
+      }
+    }
+    return -1;
+  }
+
+  // 93, 187, 375, 750ms for 9, 10, 11, 12 bits
+  static uint32_t conversion_time(const STUB_DS18B20 &dev) {
+    return 750UL >> (3 - ((dev.config >> 5) & 0x03));
+  }
+
+  // start a conversion on every present probe, at once
+  // when the caller waits for it
+  static void convert_all(bool wait) {
+    for (uint8_t i = 0; i < stub_onewire.count; i++) {
+      STUB_DS18B20 &dev = stub_onewire.dev[i];
+      if (dev.present) {
+        dev.pending = dev.temp;
+        dev.converting = !wait;
+        dev.converted = stub_millis;
+        if (wait) {
+          dev.sample = dev.temp;
+        }
+      }
+    }
+  }
+
+  // the last finished conversion rounded to the resolution
+  // in config, the undefined low bits are left set
+  static void load_scratchpad(int n, uint8_t *sp) {
+    STUB_DS18B20 &dev = stub_onewire.dev[n];
+    if (dev.converting && ((stub_millis - dev.converted) >= conversion_time(dev))) {
+      dev.sample = dev.pending;
+      dev.converting = false;
+    }
+    int bits = 9 + ((dev.config >> 5) & 0x03);
+    int16_t raw = (int16_t)lroundf(dev.sample * 16.0f);
+    raw |= (1 << (12 - bits)) - 1;
+    sp[0] = (uint8_t)(raw & 0xff);
+    sp[1] = (uint8_t)((raw >> 8) & 0xff);
+    sp[2] = dev.th;
+    sp[3] = dev.tl;
+    sp[4] = dev.config;
+    sp[5] = 0xff;
+    sp[6] = 0x0c;
+    sp[7] = 0x10;
+    sp[8] = crc8(sp, 8);
+    if (stub_onewire.corrupt) {
+      sp[0] ^= 0x10;
+      stub_onewire.corrupt = false;
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,50 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// Wire.h
+// Counts the I2C traffic, a transmission is the address
+// byte and the bytes written. A device at an address not
+// in stub_wire_present does not ack
+// -------------------------------------------------------
+
+#ifndef _stub_wire_h_
+#define _stub_wire_h_
+
+#include <Arduino.h>
+
+inline uint8_t stub_wire_present = 0x3C;
+
+class TwoWire {
+public:
+  void begin(void) {}
+  void begin(int sda, int scl) {
+    (void)sda;
+    (void)scl;
+  }
+  void setClock(uint32_t) {}
+  void beginTransmission(uint8_t address) {
+    _address = address;
+    transmissions++;
+    bytes++;
+  }
+  uint8_t endTransmission(void) {
+    return (_address == stub_wire_present) ? 0 : 2;
+  }
+  size_t write(uint8_t) {
+    bytes++;
+    return 1;
+  }
+  // traffic since the last reset
+  void reset_count(void) {
+    transmissions = 0;
+    bytes = 0;
+  }
+  unsigned long transmissions = 0;
+  unsigned long bytes = 0;
+
+private:
+  uint8_t _address = 0;
+};
+
+inline TwoWire Wire;
+
+#endif
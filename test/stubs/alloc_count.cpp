@@ -0,0 +1,30 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// alloc_count.cpp
+// Replaces the global operator new and delete to count
+// allocations, the array and nothrow forms call these
+// Built by a suite from its fakes.cpp
+// -------------------------------------------------------
+#include <new>
+#include <stdlib.h>
+#include "alloc_count.h"
+
+unsigned long alloc_count;
+
+void *operator new(size_t size) {
+  alloc_count++;
+  void *ptr = malloc((size == 0) ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete(void *ptr, size_t size) noexcept {
+  (void)size;
+  free(ptr);
+}
@@ -0,0 +1,13 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// alloc_count.h
+// Heap allocations made through operator new, which the
+// String stub and std::string use. A test reads the count
+// before and after the code under test
+// -------------------------------------------------------
+#ifndef _alloc_count_h_
+#define _alloc_count_h_
+
+extern unsigned long alloc_count;
+
+#endif
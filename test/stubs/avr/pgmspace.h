@@ -0,0 +1,21 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// avr/pgmspace.h
+// Flash and RAM are the same on the host
+// -------------------------------------------------------
+
+#ifndef _stub_pgmspace_h_
+#define _stub_pgmspace_h_
+
+#include <cstring>
+
+#define PROGMEM
+#define memcpy_P  memcpy
+#define strcpy_P  strcpy
+#define strncpy_P strncpy
+#define strlen_P  strlen
+#define strcmp_P  strcmp
+#define pgm_read_byte(a) (*(const uint8_t *)(a))
+#define pgm_read_word(a) (*(const uint16_t *)(a))
+
+#endif
@@ -0,0 +1,15 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// bearssl/bearssl_hash.h
+// -------------------------------------------------------
+
+#ifndef _stub_bearssl_hash_h_
+#define _stub_bearssl_hash_h_
+
+#include <cstdint>
+
+typedef struct {
+  uint8_t state[112];
+} br_sha256_context;
+
+#endif
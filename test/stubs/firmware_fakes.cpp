@@ -0,0 +1,183 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// firmware_fakes.cpp
+// Globals from myfp2esp8266_330_36.ino and fakes for the
+// classes cmd_dispatch.cpp calls that are not under test
+// Built by a suite from its fakes.cpp, with the
+// allocation counter
+// -------------------------------------------------------
+#include "alloc_count.cpp"
+#include <Arduino.h>
+#include "config.h"
+#include "controller_data.h"
+#include "driver_board.h"
+#include "management_server.h"
+#include "heap_stats.h"
+#include "tc_fit.h"
+#include "firmware_fakes.h"
+
+
+// -------------------------------------------------------
+// GLOBALS
+// -------------------------------------------------------
+CONTROLLER_DATA *ControllerData;
+DRIVER_BOARD *driverboard;
+MANAGEMENT_SERVER *mngsrvr;
+TC_FIT *tcfit;
+HEAP_STATS *heapstats;
+
+int _display_type = DISPLAY_NONE;
+long ftargetPosition;
+bool isMoving;
+float temp;
+bool tempcomp_available;
+bool tempcomp_state;
+bool camera_idle = true;
+long tempcomp_target = -1;
+bool alpacasrvr_status;
+bool display_found;
+bool display_status;
+bool mngsrvr_status;
+bool websrvr_status;
+bool tempprobe_found;
+volatile bool halt_alert;
+bool filesystemloaded;
+char ipStr[BUFFER16LEN] = "192.168.2.21";
+char mySSID[BUFFER64LEN] = "myssid";
+char myAPSSID[BUFFER64LEN] = "myfp2eap";
+char project_author[BUFFER32LEN];
+char project_name[BUFFER32LEN];
+char major_version[BUFFER8LEN] = "330";
+char minor_version[BUFFER8LEN] = "36";
+char DeviceName[BUFFER12LEN];
+char MDNSName[BUFFER12LEN];
+char systemuptime[BUFFER12LEN] = "001:02:03";
+int mycontrollermode = CONTROLLERMODE;
+
+FAKE_CALLS fake;
+
+
+// -------------------------------------------------------
+// METHODS
+// -------------------------------------------------------
+void RangeCheck(int *val, int low, int high) {
+  if (*val < low) *val = low;
+  if (*val > high) *val = high;
+}
+
+void RangeCheck(long *val, long low, long high) {
+  if (*val < low) *val = low;
+  if (*val > high) *val = high;
+}
+
+void RangeCheck(unsigned long *val, unsigned long low, unsigned long high) {
+  if (*val < low) *val = low;
+  if (*val > high) *val = high;
+}
+
+void RangeCheck(float *val, float low, float high) {
+  if (*val < low) *val = low;
+  if (*val > high) *val = high;
+}
+
+void software_Reboot(int delay) {
+  fake.reboot = delay;
+}
+
+void get_systemuptime(void) {}
+
+long getrssi(void) {
+  return -60;
+}
+
+unsigned long serialserver_speed(unsigned long speed) {
+  if (speed != 0) {
+    fake.serialspeed = speed;
+  }
+  return fake.serialspeed;
+}
+
+void display_off(void) {
+  fake.display = false;
+}
+
+void display_on(void) {
+  fake.display = true;
+}
+
+bool start_alpacaserver(void) {
+  return STATUS_RUNNING;
+}
+
+void stop_alpacaserver(void) {}
+
+bool start_webserver(void) {
+  return STATUS_RUNNING;
+}
+
+void stop_webserver(void) {}
+
+
+// -------------------------------------------------------
+// DRIVER_BOARD
+// -------------------------------------------------------
+DRIVER_BOARD::DRIVER_BOARD() {
+  _focuserposition = 0;
+}
+
+DRIVER_BOARD::~DRIVER_BOARD(void) {}
+
+long DRIVER_BOARD::getposition(void) {
+  return _focuserposition;
+}
+
+bool DRIVER_BOARD::getdirection(void) {
+  return moving_in;
+}
+
+void DRIVER_BOARD::enablemotor(void) {
+  _enabled = true;
+  fake.motor = true;
+}
+
+void DRIVER_BOARD::releasemotor(void) {
+  _enabled = false;
+  fake.motor = false;
+}
+
+void DRIVER_BOARD::setposition(long pos) {
+  _focuserposition = pos;
+}
+
+void DRIVER_BOARD::setstepmode(int smode) {
+  fake.stepmode = smode;
+}
+
+
+// -------------------------------------------------------
+// MANAGEMENT_SERVER
+// -------------------------------------------------------
+MANAGEMENT_SERVER::MANAGEMENT_SERVER() {}
+
+bool MANAGEMENT_SERVER::start(void) {
+  fake.mngsrvr_starts++;
+  return STATUS_RUNNING;
+}
+
+void MANAGEMENT_SERVER::stop(void) {
+  fake.mngsrvr_stops++;
+}
+
+
+// -------------------------------------------------------
+// HEAP_STATS
+// -------------------------------------------------------
+HEAP_STATS::HEAP_STATS() {}
+
+void HEAP_STATS::reset(void) {
+  fake.heap_resets++;
+}
+
+void HEAP_STATS::get_summary(char *buff, size_t len) {
+  snprintf(buff, len, "40000,32000,0,38000,4000");
+}
@@ -0,0 +1,22 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// firmware_fakes.h
+// Calls made by the dispatcher into the fakes
+// -------------------------------------------------------
+#ifndef _firmware_fakes_h_
+#define _firmware_fakes_h_
+
+typedef struct {
+  int reboot;                 // software_Reboot() delay
+  unsigned long serialspeed;  // serialserver_speed()
+  bool display;               // display_on(), display_off()
+  bool motor;                 // enablemotor(), releasemotor()
+  int stepmode;               // setstepmode()
+  int mngsrvr_starts;
+  int mngsrvr_stops;
+  int heap_resets;
+} FAKE_CALLS;
+
+extern FAKE_CALLS fake;
+
+#endif
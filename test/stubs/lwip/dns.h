@@ -0,0 +1,55 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// lwip/dns.h
+// Host name lookups answered from stub_dns. A lookup is
+// cached, in progress until the test answers it, or fails
+// -------------------------------------------------------
+
+#ifndef _stub_lwip_dns_h_
+#define _stub_lwip_dns_h_
+
+#include <Arduino.h>
+
+typedef int8_t err_t;
+#define ERR_OK          0
+#define ERR_INPROGRESS  -5
+#define ERR_ARG         -16
+
+typedef struct {
+  uint32_t addr;
+} ip_addr_t;
+
+typedef void (*dns_found_callback)(const char *, const ip_addr_t *, void *);
+
+struct STUB_DNS {
+  err_t result = ERR_OK;     // ERR_OK cached, ERR_INPROGRESS, or error
+  uint32_t addr = 0x0100007f;  // 127.0.0.1
+  std::string name;            // last host looked up
+  int lookups = 0;
+  dns_found_callback found = nullptr;
+  void *arg = nullptr;
+};
+
+inline STUB_DNS stub_dns;
+
+inline err_t dns_gethostbyname(const char *name, ip_addr_t *addr, dns_found_callback found, void *arg) {
+  stub_dns.name = name;
+  stub_dns.lookups++;
+  if (stub_dns.result == ERR_OK) {
+    addr->addr = stub_dns.addr;
+  } else if (stub_dns.result == ERR_INPROGRESS) {
+    stub_dns.found = found;
+    stub_dns.arg = arg;
+  }
+  return stub_dns.result;
+}
+
+// the answer to a lookup in progress, nullptr if not found
+inline void stub_dns_answer(const ip_addr_t *addr) {
+  if (stub_dns.found != nullptr) {
+    stub_dns.found(stub_dns.name.c_str(), addr, stub_dns.arg);
+    stub_dns.found = nullptr;
+  }
+}
+
+#endif
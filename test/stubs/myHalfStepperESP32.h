@@ -0,0 +1,11 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// myHalfStepperESP32.h
+// -------------------------------------------------------
+
+#ifndef _stub_myhalfstepper_h_
+#define _stub_myhalfstepper_h_
+
+class HalfStepper;
+
+#endif
@@ -0,0 +1,222 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// mySSD1306Ascii.h
+// A recording SSD1306Ascii for a 128x64 display and the
+// Adafruit5x7 font. Each pixel column of each display
+// page records the character drawn there, so the test
+// can read back the text of a row and see torn or stray
+// characters. The commands and display RAM bytes are sent
+// to writeDisplay() as the library sends them, so the I2C
+// traffic counted by the Wire stub is the real traffic
+// -------------------------------------------------------
+
+#ifndef _stub_myssd1306ascii_h_
+#define _stub_myssd1306ascii_h_
+
+#include <Arduino.h>
+#include <string>
+
+#define SSD1306_MODE_CMD     0
+#define SSD1306_MODE_RAM     1
+#define SSD1306_MODE_RAM_BUF 2
+
+#define SSD1306_SETCONTRAST   0x81
+#define SSD1306_SETLOWCOLUMN  0x00
+#define SSD1306_SETHIGHCOLUMN 0x10
+#define SSD1306_SETSTARTLINE  0x40
+#define SSD1306_SETSTARTPAGE  0xB0
+
+#define STUB_OLED_WIDTH  128
+#define STUB_OLED_PAGES  8
+// 5 font columns and 1 space, times the scale
+#define STUB_OLED_CHARWIDTH 6
+
+typedef struct {
+  uint8_t lcdWidth;
+  uint8_t lcdHeight;
+} DevType;
+
+inline const DevType Adafruit128x64 = { STUB_OLED_WIDTH, 64 };
+inline const uint8_t Adafruit5x7[] = { 0, 0, 5, 7, 32, 96 };
+
+class SSD1306Ascii;
+inline SSD1306Ascii *stub_oled = nullptr;  // the last display begun
+
+class SSD1306Ascii : public Print {
+public:
+  SSD1306Ascii() {
+    clear_cells();
+  }
+  virtual ~SSD1306Ascii() {}
+
+  void clear(void) {
+    clear(0, STUB_OLED_WIDTH - 1, 0, STUB_OLED_PAGES - 1);
+    ssd1306WriteCmd(SSD1306_SETSTARTLINE | 0);
+  }
+  void clear(uint8_t c0, uint8_t c1, uint8_t r0, uint8_t r1) {
+    if (r1 >= STUB_OLED_PAGES) {
+      r1 = STUB_OLED_PAGES - 1;
+    }
+    for (uint8_t r = r0; r <= r1; r++) {
+      setCursor(c0, r);
+      for (uint8_t c = c0; c <= c1; c++) {
+        ram(0);
+      }
+    }
+    setCursor(c0, r0);
+  }
+  void clearToEOL(void) {
+    clear(_col, STUB_OLED_WIDTH - 1, _row, _row + _mag - 1);
+  }
+  void set1X(void) {
+    _mag = 1;
+  }
+  void set2X(void) {
+    _mag = 2;
+  }
+  void setFont(const uint8_t *) {}
+  void set400kHz(void) {}
+  void setCursor(uint8_t col, uint8_t row) {
+    setCol(col);
+    setRow(row);
+  }
+  void setContrast(uint8_t value) {
+    ssd1306WriteCmd(SSD1306_SETCONTRAST);
+    ssd1306WriteCmd(value);
+    contrast = value;
+  }
+  void Display_Normal(void) {
+    ssd1306WriteCmd(0xA6);
+  }
+  void Display_On(void) {
+    ssd1306WriteCmd(0xAF);
+    on = true;
+  }
+  void Display_Off(void) {
+    ssd1306WriteCmd(0xAE);
+    on = false;
+  }
+  void Display_Bright(void) {
+    setContrast(0xFF);
+  }
+  void Display_Rotate(int) {
+    ssd1306WriteCmd(0xA1);
+    ssd1306WriteCmd(0xC8);
+  }
+
+  // a character cell, font columns then space columns,
+  // each page of a 2X character written in turn
+  using Print::write;
+  size_t write(uint8_t ch) override {
+    if (ch == '\r') {
+      setCol(0);
+      return 1;
+    }
+    if (ch == '\n') {
+      setCursor(0, _row + _mag);
+      return 1;
+    }
+    if ((ch < ' ') || (ch >= 0x80)) {
+      return 0;
+    }
+    uint8_t scol = _col;
+    uint8_t srow = _row;
+    for (uint8_t half = 0; half < _mag; half++) {
+      if (half) {
+        setCursor(scol, srow + 1);
+      }
+      for (uint8_t c = 0; c < (STUB_OLED_CHARWIDTH * _mag); c++) {
+        ram((ch == ' ') ? 0 : cell(ch, _mag, c, half));
+      }
+    }
+    setRow(srow);
+    return 1;
+  }
+
+  // the text of a row of pages, the row starts at page
+  // and is scale pages high. Blank cells are spaces and
+  // trailing spaces are dropped. A character that is
+  // torn, misplaced or at another scale is shown as '?'
+  std::string text(uint8_t page, uint8_t scale) {
+    std::string s;
+    uint8_t w = STUB_OLED_CHARWIDTH * scale;
+    for (uint8_t x = 0; x < STUB_OLED_WIDTH; x += w) {
+      uint32_t first = _cells[page][x];
+      char ch = (char)(first & 0xFF);
+      bool ok = true;
+      for (uint8_t half = 0; half < scale; half++) {
+        for (uint8_t c = 0; c < w; c++) {
+          uint32_t want = (first == 0) ? 0 : cell(ch, scale, c, half);
+          if (((x + c) >= STUB_OLED_WIDTH) ? (want != 0) : (_cells[page + half][x + c] != want)) {
+            ok = false;
+          }
+        }
+      }
+      s += ok ? ((first == 0) ? ' ' : ch) : '?';
+    }
+    while (!s.empty() && (s.back() == ' ')) {
+      s.pop_back();
+    }
+    return s;
+  }
+  // true if nothing is drawn on the page
+  bool blank(uint8_t page) {
+    for (uint8_t c = 0; c < STUB_OLED_WIDTH; c++) {
+      if (_cells[page][c] != 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  unsigned long ram_bytes = 0;  // display RAM bytes written
+  uint8_t contrast = 0;
+  bool on = false;
+
+protected:
+  void init(const DevType *) {
+    stub_oled = this;
+    clear();
+  }
+  virtual void writeDisplay(uint8_t b, uint8_t mode) = 0;
+
+private:
+  static uint32_t cell(char ch, uint8_t scale, uint8_t col, uint8_t half) {
+    return (uint8_t)ch | (scale << 8) | (col << 16) | (half << 24);
+  }
+  void clear_cells(void) {
+    memset(_cells, 0, sizeof(_cells));
+  }
+  void setCol(uint8_t col) {
+    if (col < STUB_OLED_WIDTH) {
+      _col = col;
+      ssd1306WriteCmd(SSD1306_SETLOWCOLUMN | (col & 0x0F));
+      ssd1306WriteCmd(SSD1306_SETHIGHCOLUMN | (col >> 4));
+    }
+  }
+  void setRow(uint8_t row) {
+    if (row < STUB_OLED_PAGES) {
+      _row = row;
+      ssd1306WriteCmd(SSD1306_SETSTARTPAGE | row);
+    }
+  }
+  void ssd1306WriteCmd(uint8_t c) {
+    writeDisplay(c, SSD1306_MODE_CMD);
+  }
+  void ram(uint32_t c) {
+    if (_col >= STUB_OLED_WIDTH) {
+      return;
+    }
+    _cells[_row][_col] = c;
+    writeDisplay((c == 0) ? 0x00 : 0x5A, SSD1306_MODE_RAM_BUF);
+    ram_bytes++;
+    _col++;
+  }
+
+  uint8_t _mag = 1;
+  uint8_t _col = 0;
+  uint8_t _row = 0;
+  uint32_t _cells[STUB_OLED_PAGES][STUB_OLED_WIDTH];
+};
+
+#endif
@@ -0,0 +1,47 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// mySSD1306AsciiWire.h
+// Sends to the Wire stub as the library does with
+// OPTIMIZE_I2C, up to 17 display RAM bytes are buffered
+// in one transmission, each command is its own
+// -------------------------------------------------------
+
+#ifndef _stub_myssd1306asciiwire_h_
+#define _stub_myssd1306asciiwire_h_
+
+#include <Wire.h>
+#include "mySSD1306Ascii.h"
+
+class SSD1306AsciiWire : public SSD1306Ascii {
+public:
+  void begin(const DevType *dev, uint8_t i2cAddr) {
+    _nData = 0;
+    _i2cAddr = i2cAddr;
+    init(dev);
+  }
+
+protected:
+  void writeDisplay(uint8_t b, uint8_t mode) override {
+    if ((_nData > 16) || (_nData && (mode == SSD1306_MODE_CMD))) {
+      Wire.endTransmission();
+      _nData = 0;
+    }
+    if (_nData == 0) {
+      Wire.beginTransmission(_i2cAddr);
+      Wire.write((mode == SSD1306_MODE_CMD) ? 0x00 : 0x40);
+    }
+    Wire.write(b);
+    if (mode == SSD1306_MODE_RAM_BUF) {
+      _nData++;
+    } else {
+      Wire.endTransmission();
+      _nData = 0;
+    }
+  }
+
+private:
+  uint8_t _i2cAddr = 0;
+  uint8_t _nData = 0;
+};
+
+#endif
@@ -0,0 +1,11 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST STUBS
+// myStepperESP32.h
+// -------------------------------------------------------
+
+#ifndef _stub_mystepper_h_
+#define _stub_mystepper_h_
+
+class Stepper;
+
+#endif
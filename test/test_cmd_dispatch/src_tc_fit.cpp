@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_tc_fit.cpp
+// Builds src/tc_fit.cpp as its own translation unit
+// -------------------------------------------------------
+#include "tc_fit.cpp"
@@ -0,0 +1,486 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_cmd_dispatch/test_main.cpp
+// Table driven tests of cmd_dispatch(), the real
+// CONTROLLER_DATA and TC_FIT run over the in memory
+// LittleFS, the driver board and servers are fakes
+// A polling cycle of get commands does not allocate
+// pio test -e native -f test_cmd_dispatch
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <string>
+#include <unity.h>
+#include "config.h"
+#include "cmd_dispatch.h"
+#include "controller_data.h"
+#include "driver_board.h"
+#include "management_server.h"
+#include "heap_stats.h"
+#include "tc_fit.h"
+#include "firmware_fakes.h"
+#include "alloc_count.h"
+
+extern CONTROLLER_DATA *ControllerData;
+extern DRIVER_BOARD *driverboard;
+extern MANAGEMENT_SERVER *mngsrvr;
+extern TC_FIT *tcfit;
+extern HEAP_STATS *heapstats;
+
+
+// -------------------------------------------------------
+// STUB REPLY SINK
+// Collects the replies to a command
+// -------------------------------------------------------
+class STUB_SINK : public REPLY_SINK {
+public:
+  void send_reply(const char *str) override {
+    reply += str;
+  }
+  std::string reply;
+};
+
+static const byte transports[] = { CMD_TCPIP, CMD_SERIAL };
+
+// send a command, return the reply
+static std::string dispatch(byte transport, const char *cmd) {
+  STUB_SINK sink;
+  cmd_dispatch(sink, transport, false, cmd);
+  return sink.reply;
+}
+
+// state a command may change, used to tell if it ran
+static std::string snapshot(void) {
+  char buff[256];
+  snprintf(buff, sizeof(buff), "%ld %ld %d %ld %d %d %d %d %d %d %d %d %lu %d %d %d",
+           ftargetPosition, driverboard->getposition(), isMoving,
+           ControllerData->get_fposition(), ControllerData->get_reverse_enable(),
+           ControllerData->get_alpacasrvr_enable(), alpacasrvr_status,
+           ControllerData->get_websrvr_enable(), websrvr_status,
+           ControllerData->get_mngsrvr_enable(), mngsrvr_status,
+           fake.mngsrvr_starts, fake.serialspeed, fake.stepmode, fake.reboot, fake.motor);
+  return std::string(buff);
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// Each test starts with the default configuration
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  delete driverboard;
+  driverboard = new DRIVER_BOARD();
+  delete tcfit;
+  tcfit = new TC_FIT();
+  if (mngsrvr == nullptr) {
+    mngsrvr = new MANAGEMENT_SERVER();
+    heapstats = new HEAP_STATS();
+  }
+  fake = FAKE_CALLS();
+  fake.serialspeed = 57600;
+  isMoving = false;
+  ftargetPosition = 0;
+  camera_idle = true;
+  alpacasrvr_status = STATUS_STOPPED;
+  websrvr_status = STATUS_STOPPED;
+  mngsrvr_status = STATUS_STOPPED;
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// EVERY OPCODE
+// The reply to each opcode without an argument, from the
+// default configuration, for each transport
+// "" is no reply, @path is the file sent as is after $
+// -------------------------------------------------------
+typedef struct {
+  const char *cmd;
+  const char *tcpip;
+  const char *serial;
+} opcode_reply;
+
+static const opcode_reply opcode_replies[] = {
+  { "00", "P0#", "P0#" },
+  { "01", "I0#", "I0#" },
+  { "02", "EOK#", "EOK#" },
+  { "03", "F330#", "F330#" },
+  { "04", "FUnknown\r\n330#", "FUnknown\r\n330#" },
+  { "05", "", "" },
+  { "06", "Z0.000#", "Z0.000#" },
+  { "07", "", "" },
+  { "08", "M80000#", "M80000#" },
+  { "09", "$0#", "$0#" },
+  { "10", "Y80000#", "Y80000#" },
+  { "11", "O0#", "O0#" },
+  { "12", "", "" },
+  { "13", "R0#", "R0#" },
+  { "14", "", "" },
+  { "15", "", "" },
+  { "16", "", "" },
+  { "17", "", "" },
+  { "18", "", "" },
+  { "19", "", "" },
+  { "20", "", "" },
+  { "21", "Q10#", "Q10#" },
+  { "22", "", "" },
+  { "23", "", "" },
+  { "24", "10#", "10#" },
+  { "25", "A0#", "A0#" },
+  { "26", "B0#", "B0#" },
+  { "27", "", "" },
+  { "28", "", "" },
+  { "29", "S1#", "S1#" },
+  { "30", "", "" },
+  { "31", "", "" },
+  { "32", "U1#", "U1#" },
+  { "33", "T50.00#", "T50.00#" },
+  { "34", "X4#", "X4000#" },
+  { "35", "", "" },
+  { "36", "", "" },
+  { "37", "D0#", "D0#" },
+  { "38", "b1#", "b1#" },
+  { "39", "N0#", "N0#" },
+  { "40", "", "" },
+  { "41", "", "" },
+  { "42", "", "" },
+  { "43", "C2#", "C2#" },
+  { "44", "$0#", "$0#" },
+  { "45", "", "" },
+  { "46", "$0#", "$0#" },
+  { "47", "", "" },
+  { "48", "", "" },
+  { "49", "ab552efd#", "ab552efd#" },
+  { "50", "l0#", "l0#" },
+  { "51", "$192.168.2.21#", "$192.168.2.21#" },
+  { "52", "$0#", "$0#" },
+  { "53", "$0#", "$0#" },
+  { "54", "$myssid#", "gSERIAL#" },
+  { "55", "04000#", "04000#" },
+  { "56", "", "" },
+  { "57", "$0#", "$0#" },
+  { "58", "", "" },
+  { "59", "$60#", "$60#" },
+  { "60", "", "" },
+  { "61", "", "" },
+  { "62", "L1#", "L1#" },
+  { "63", "H0#", "H0#" },
+  { "64", "", "" },
+  { "65", "", "" },
+  { "66", "K0#", "K0#" },
+  { "67", "", "" },
+  { "68", "V0#", "V0#" },
+  { "69", "?1#", "?1#" },
+  { "70", "", "" },
+  { "71", "", "" },
+  { "72", "325#", "325#" },
+  { "73", "", "" },
+  { "74", "40#", "40#" },
+  { "75", "", "" },
+  { "76", "40#", "40#" },
+  { "77", "", "" },
+  { "78", "60#", "60#" },
+  { "79", "", "" },
+  { "80", "70#", "70#" },
+  { "81", "80#", "80#" },
+  { "82", "", "" },
+  { "83", "c0#", "c0#" },
+  { "84", "", "" },
+  { "85", "$1#", "$1#" },
+  { "86", "", "" },
+  { "87", "k0#", "c0#" },
+  { "88", "", "" },
+  { "89", "91#", "91#" },
+  { "90", "", "" },
+  { "91", "$0#", "$0#" },
+  { "92", "", "" },
+  { "93", "l111111#", "l111111#" },
+  { "94", "n0#", "" },
+  { "95", "", "n0#" },
+  { "96", "F330,36#", "F330,36#" },
+  { "97", "n0#", "n0#" },
+  { "98", "$-60#", "$-60#" },
+  { "99", "", "" },
+  { "A0", "$0#", "$0#" },
+  { "A1", "", "" },
+  { "A2", "$0#", "$0#" },
+  { "A3", "", "" },
+  { "A4", "$0#", "$0#" },
+  { "A5", "", "" },
+  { "A6", "$0#", "$0#" },
+  { "A7", "", "" },
+  { "A8", "$0#", "$0#" },
+  { "A9", "", "" },
+  { "B0", "$0#", "$0#" },
+  { "B1", "", "" },
+  { "B2", "$0#", "$0#" },
+  { "B3", "", "" },
+  { "B4", "$1#", "$1#" },
+  { "B5", "", "" },
+  { "B6", "$0#", "$0#" },
+  { "B7", "", "" },
+  { "B8", "@/cntlr_config.jsn", "@/cntlr_config.jsn" },
+  { "B9", "@/board_config.jsn", "@/board_config.jsn" },
+  { "C0", "$0#", "" },
+  { "C1", "", "" },
+  { "C2", "$0#", "" },
+  { "C3", "", "" },
+  { "C4", "$255#", "" },
+  { "C5", "", "" },
+  { "C6", "", "$57600#" },
+  { "C7", "$1#", "$1#" },
+  { "C8", "$0.00,0.000,0#", "$0.00,0.000,0#" },
+  { "C9", "$0#", "$0#" },
+  { "D0", "$40000,32000,0,38000,4000#", "$40000,32000,0,38000,4000#" },
+};
+static_assert(sizeof(opcode_replies) / sizeof(opcode_replies[0]) == CMD_COUNT, "opcode_replies must cover every opcode");
+
+void test_every_opcode(void) {
+  for (int i = 0; i < CMD_COUNT; i++) {
+    const opcode_reply &row = opcode_replies[i];
+    TEST_ASSERT_EQUAL_INT_MESSAGE(i, cmd_opcode(row.cmd), row.cmd);
+    for (byte transport : transports) {
+      setUp();
+      const char *expect = (transport == CMD_TCPIP) ? row.tcpip : row.serial;
+      std::string want = expect;
+      if (expect[0] == '@') {
+        want = "$" + LittleFS.content(&expect[1]);
+        TEST_ASSERT_GREATER_THAN(1, want.length());
+      }
+      std::string msg = std::string(":") + row.cmd + ((transport == CMD_TCPIP) ? " tcpip" : " serial");
+      TEST_ASSERT_EQUAL_STRING_MESSAGE(want.c_str(), dispatch(transport, row.cmd).c_str(), msg.c_str());
+    }
+  }
+}
+
+
+// -------------------------------------------------------
+// OPCODES
+// -------------------------------------------------------
+void test_opcode_parse(void) {
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode(""));
+  TEST_ASSERT_EQUAL_INT(0, cmd_opcode("00"));
+  TEST_ASSERT_EQUAL_INT(5, cmd_opcode("051234"));
+  TEST_ASSERT_EQUAL_INT(99, cmd_opcode("99"));
+  TEST_ASSERT_EQUAL_INT(100, cmd_opcode("A0"));
+  TEST_ASSERT_EQUAL_INT(119, cmd_opcode("B9"));
+  TEST_ASSERT_EQUAL_INT(129, cmd_opcode("C9"));
+  TEST_ASSERT_EQUAL_INT(130, cmd_opcode("D0"));
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("D1"));
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("D9"));
+
+  // a letter must be followed by a digit
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("A"));
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("BZ"));
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("C:"));
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("D/"));
+  TEST_ASSERT_EQUAL_INT(-1, cmd_opcode("A 1"));
+
+  // out of range opcodes are dropped without a reply
+  for (byte transport : transports) {
+    TEST_ASSERT_EQUAL_STRING("", dispatch(transport, "").c_str());
+    TEST_ASSERT_EQUAL_STRING("", dispatch(transport, "A").c_str());
+    TEST_ASSERT_EQUAL_STRING("", dispatch(transport, "BZ").c_str());
+    TEST_ASSERT_EQUAL_STRING("", dispatch(transport, "C:").c_str());
+    TEST_ASSERT_EQUAL_STRING("", dispatch(transport, "D1").c_str());
+    TEST_ASSERT_EQUAL_STRING("", dispatch(transport, "D9").c_str());
+  }
+}
+
+
+// -------------------------------------------------------
+// FLAGS
+// A command runs if it replies or changes the snapshot
+// NOTMOVING commands do not run while moving, NETWORK
+// commands do not run on serial, LOCAL commands do not
+// run on the network
+// -------------------------------------------------------
+typedef struct {
+  const char *cmd;
+  byte flags;
+} flag_row;
+
+static const flag_row flag_rows[] = {
+  { "05100", CMD_NOTMOVING },
+  { "141", CMD_NOTMOVING },
+  { "28", CMD_NOTMOVING },
+  { "31500", CMD_NOTMOVING },
+  { "42", CMD_NOTMOVING },
+  { "48", CMD_NOTMOVING },
+  { "6450", CMD_NOTMOVING },
+  { "A70", CMD_NETWORK },
+  { "A91", CMD_NETWORK },
+  { "B10", CMD_NETWORK },
+  { "B31", CMD_NETWORK },
+  { "B50", CMD_NETWORK },
+  { "B71", CMD_NETWORK },
+  { "C0", CMD_NETWORK },
+  { "C2", CMD_NETWORK },
+  { "C4", CMD_NETWORK },
+  { "C6115200", CMD_LOCAL },
+  { "00", 0 },
+  { "1210", 0 },
+  { "C70", 0 },
+};
+
+static bool runs(const char *cmd, byte transport, bool moving) {
+  setUp();
+  // a state where each command in flag_rows has an effect
+  driverboard->setposition(1000);
+  ftargetPosition = 1000;
+  ControllerData->set_alpacasrvr_enable(STATE_ENABLED);
+  ControllerData->set_websrvr_enable(STATE_ENABLED);
+  isMoving = moving;
+
+  std::string before = snapshot();
+  std::string reply = dispatch(transport, cmd);
+  return (reply.length() != 0) || (snapshot() != before);
+}
+
+void test_flags(void) {
+  for (const flag_row &row : flag_rows) {
+    for (byte transport : transports) {
+      for (int moving = 0; moving < 2; moving++) {
+        bool expect = true;
+        if (((row.flags & CMD_NOTMOVING) != 0) && moving) {
+          expect = false;
+        }
+        if (((row.flags & CMD_NETWORK) != 0) && (transport == CMD_SERIAL)) {
+          expect = false;
+        }
+        if (((row.flags & CMD_LOCAL) != 0) && (transport != CMD_SERIAL)) {
+          expect = false;
+        }
+        char msg[48];
+        snprintf(msg, sizeof(msg), ":%s %s %s", row.cmd, (transport == CMD_TCPIP) ? "tcpip" : "serial",
+                 moving ? "moving" : "stopped");
+        TEST_ASSERT_EQUAL_MESSAGE(expect, runs(row.cmd, transport, moving), msg);
+      }
+    }
+  }
+}
+
+
+// -------------------------------------------------------
+// ARG_RANGE
+// Set, then read back with the get command
+// -------------------------------------------------------
+typedef struct {
+  const char *set;
+  const char *get;
+  const char *reply;
+} range_row;
+
+static const range_row range_rows[] = {
+  { "159", "43", "C2#" },
+  { "15-1", "43", "C0#" },
+  { "151", "43", "C1#" },
+  { "2099", "21", "Q12#" },
+  { "203", "21", "Q9#" },
+  { "2011", "21", "Q11#" },
+  { "22500", "26", "B400#" },
+  { "22-5", "26", "B0#" },
+  { "22120", "26", "B120#" },
+  { "5699999", "55", "014000#" },
+  { "5610", "55", "0500#" },
+  { "562500", "55", "02500#" },
+  { "6010", "59", "$30#" },
+  { "60999", "59", "$120#" },
+  { "6045", "59", "$45#" },
+  { "71300", "72", "3255#" },
+  { "71-1", "72", "30#" },
+  { "77300", "78", "6255#" },
+  { "77-1", "78", "60#" },
+  { "79300", "80", "7255#" },
+  { "79-1", "80", "70#" },
+};
+
+void test_arg_range(void) {
+  for (const range_row &row : range_rows) {
+    for (byte transport : transports) {
+      setUp();
+      TEST_ASSERT_EQUAL_STRING_MESSAGE("", dispatch(transport, row.set).c_str(), row.set);
+      TEST_ASSERT_EQUAL_STRING_MESSAGE(row.reply, dispatch(transport, row.get).c_str(), row.set);
+    }
+  }
+}
+
+
+// -------------------------------------------------------
+// ARGUMENTS
+// -------------------------------------------------------
+void test_arguments(void) {
+  for (byte transport : transports) {
+    setUp();
+    // ARG_LONG, the handler checks the limits
+    dispatch(transport, "05123456");
+    TEST_ASSERT_EQUAL_INT32(80000, ftargetPosition);
+    TEST_ASSERT_TRUE(isMoving);
+    isMoving = false;
+    dispatch(transport, "31-5");
+    TEST_ASSERT_EQUAL_STRING("P0#", dispatch(transport, "00").c_str());
+
+    // ARG_FLOAT
+    dispatch(transport, "192.5");
+    TEST_ASSERT_EQUAL_STRING("T2.50#", dispatch(transport, "33").c_str());
+
+    // ARG_STR, the page option is padded to 6 digits
+    dispatch(transport, "92101");
+    TEST_ASSERT_EQUAL_STRING("l000101#", dispatch(transport, "93").c_str());
+
+    // a get with an argument sets, without only gets
+    TEST_ASSERT_EQUAL_STRING("$0#", dispatch(transport, "C70").c_str());
+    TEST_ASSERT_EQUAL_STRING("$0#", dispatch(transport, "C7").c_str());
+    TEST_ASSERT_FALSE(camera_idle);
+  }
+}
+
+
+// -------------------------------------------------------
+// ALLOCATIONS
+// The get commands a client polls with, the replies are
+// kept in a fixed buffer so only the firmware can count
+// -------------------------------------------------------
+class FIXED_SINK : public REPLY_SINK {
+public:
+  void send_reply(const char *str) override {
+    strncat(reply, str, sizeof(reply) - strlen(reply) - 1);
+  }
+  char reply[BUFFER64LEN] = "";
+};
+
+static const char *const poll_cmds[] = { "00", "01", "04", "06", "08", "93" };
+
+void test_no_alloc(void) {
+  ControllerData->set_brdname("PRO2ESP8266DRV8825");
+  for (byte transport : transports) {
+    unsigned long count = alloc_count;
+    for (int i = 0; i < 1000; i++) {
+      for (const char *cmd : poll_cmds) {
+        FIXED_SINK sink;
+        cmd_dispatch(sink, transport, false, cmd);
+        TEST_ASSERT_TRUE_MESSAGE(sink.reply[0] != 0x00, cmd);
+      }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, alloc_count - count);
+  }
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_every_opcode);
+  RUN_TEST(test_opcode_parse);
+  RUN_TEST(test_flags);
+  RUN_TEST(test_arg_range);
+  RUN_TEST(test_arguments);
+  RUN_TEST(test_no_alloc);
+  return UNITY_END();
+}
@@ -0,0 +1,226 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_cmd_ring/test_main.cpp
+// Tests of CMD_RING, framing, wrap at the end of the
+// buffer, and dropping commands when the ring is full
+// pio test -e native -f test_cmd_ring
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <string>
+#include <unity.h>
+#include "cmd_ring.h"
+
+static CMD_RING ring;
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+static void put(const std::string &bytes) {
+  for (char c : bytes) {
+    ring.put(c);
+  }
+}
+
+// send a command, as :cmd#
+static void put_cmd(const std::string &cmd) {
+  put(":" + cmd + "#");
+}
+
+// the oldest command, then release it
+static std::string pop(void) {
+  const char *cmd = ring.peek();
+  TEST_ASSERT_NOT_NULL(cmd);
+  std::string s(cmd);
+  ring.pop();
+  return s;
+}
+
+// a command of len chars, different for each n
+static std::string make_cmd(int n, int len) {
+  static const char chars[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+  std::string s;
+  for (int i = 0; i < len; i++) {
+    s += chars[(n + i) % (sizeof(chars) - 1)];
+  }
+  return s;
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// -------------------------------------------------------
+void setUp(void) {
+  ring = CMD_RING();
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// FRAMING
+// -------------------------------------------------------
+void test_framing(void) {
+  TEST_ASSERT_FALSE(ring.available());
+  TEST_ASSERT_NULL(ring.peek());
+
+  put_cmd("00");
+  TEST_ASSERT_TRUE(ring.available());
+  TEST_ASSERT_EQUAL_STRING("00", ring.peek());
+  // peek does not release the command
+  TEST_ASSERT_EQUAL_STRING("00", ring.peek());
+  ring.pop();
+  TEST_ASSERT_FALSE(ring.available());
+  ring.pop();
+  TEST_ASSERT_FALSE(ring.available());
+
+  // bytes outside : and # are ignored
+  put("xx\r\n#05100#yy");
+  TEST_ASSERT_FALSE(ring.available());
+  put(":05100#\r\n");
+  TEST_ASSERT_EQUAL_STRING("05100", pop().c_str());
+
+  // : restarts a partial command
+  put(":0512:06#");
+  TEST_ASSERT_EQUAL_STRING("06", pop().c_str());
+  TEST_ASSERT_FALSE(ring.available());
+
+  // the wrap marker is never stored
+  put(":1\xff" "2#");
+  TEST_ASSERT_EQUAL_STRING("12", pop().c_str());
+
+  // an empty command
+  put_cmd("");
+  TEST_ASSERT_EQUAL_STRING("", pop().c_str());
+  TEST_ASSERT_EQUAL_UINT32(0, ring.get_dropped());
+
+  // the longest command is kept, one more char is dropped
+  put_cmd(make_cmd(0, CMDRING_MAXCMD));
+  TEST_ASSERT_EQUAL_STRING(make_cmd(0, CMDRING_MAXCMD).c_str(), pop().c_str());
+  put_cmd(make_cmd(0, CMDRING_MAXCMD + 1));
+  TEST_ASSERT_FALSE(ring.available());
+  TEST_ASSERT_EQUAL_UINT32(1, ring.get_dropped());
+
+  // clear discards commands and a command in progress
+  put_cmd("01");
+  put(":02");
+  ring.clear();
+  TEST_ASSERT_FALSE(ring.available());
+  put("#");
+  TEST_ASSERT_FALSE(ring.available());
+}
+
+
+// -------------------------------------------------------
+// WRAP
+// The consumer keeps up, commands of every length wrap
+// around the buffer many times and come out in order
+// -------------------------------------------------------
+void test_wrap(void) {
+  int sent = 0;
+  int received = 0;
+  for (int pass = 0; pass < 2000; pass++) {
+    // 1 to 3 commands, then read them
+    int count = 1 + (pass % 3);
+    for (int i = 0; i < count; i++) {
+      put_cmd(make_cmd(sent, sent % (CMDRING_MAXCMD + 1)));
+      sent++;
+    }
+    while (ring.available()) {
+      std::string want = make_cmd(received, received % (CMDRING_MAXCMD + 1));
+      TEST_ASSERT_EQUAL_STRING(want.c_str(), pop().c_str());
+      received++;
+    }
+    TEST_ASSERT_EQUAL_INT(sent, received);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, ring.get_dropped());
+}
+
+
+// -------------------------------------------------------
+// FULL RING
+// A :xxxxxxxxxx# command uses 11 bytes. 18 commands use
+// bytes 0-197, the 19th must start at 0 as 63 chars do
+// not fit before the end, 0 is the oldest command so it
+// and every later command are dropped and counted
+// -------------------------------------------------------
+void test_full_drop(void) {
+  for (int i = 0; i < 30; i++) {
+    put_cmd(make_cmd(i, 10));
+  }
+  TEST_ASSERT_EQUAL_UINT32(12, ring.get_dropped());
+
+  // the oldest 18 are kept, in order
+  for (int i = 0; i < 18; i++) {
+    TEST_ASSERT_EQUAL_STRING(make_cmd(i, 10).c_str(), pop().c_str());
+  }
+  TEST_ASSERT_FALSE(ring.available());
+
+  // after reading, commands are accepted again
+  put_cmd("00");
+  TEST_ASSERT_EQUAL_STRING("00", pop().c_str());
+  TEST_ASSERT_EQUAL_UINT32(12, ring.get_dropped());
+}
+
+
+// -------------------------------------------------------
+// WRAP MARKER
+// A command that starts at 0 leaves the 0xFF marker at
+// the end of the previous command, the consumer reads
+// the commands before the marker, then skips to 0
+// -------------------------------------------------------
+void test_wrap_marker(void) {
+  // head at 198, 58 bytes to the end of the buffer
+  for (int i = 0; i < 18; i++) {
+    put_cmd(make_cmd(i, 10));
+  }
+  // read all but the last, the oldest is now at 187
+  for (int i = 0; i < 17; i++) {
+    TEST_ASSERT_EQUAL_STRING(make_cmd(i, 10).c_str(), pop().c_str());
+  }
+
+  // these start at 0, the marker is written at 198
+  put_cmd("WXYZ");
+  put_cmd("0612");
+  TEST_ASSERT_EQUAL_UINT32(0, ring.get_dropped());
+
+  // the command before the marker, then across it
+  TEST_ASSERT_EQUAL_STRING(make_cmd(17, 10).c_str(), pop().c_str());
+  TEST_ASSERT_TRUE(ring.available());
+  TEST_ASSERT_EQUAL_STRING("WXYZ", pop().c_str());
+  TEST_ASSERT_EQUAL_STRING("0612", pop().c_str());
+  TEST_ASSERT_FALSE(ring.available());
+
+  // a command starting at 0 may not run into the oldest
+  // command, still before the marker, it is dropped and
+  // not truncated
+  ring = CMD_RING();
+  for (int i = 0; i < 18; i++) {
+    put_cmd(make_cmd(i, 10));
+  }
+  TEST_ASSERT_EQUAL_STRING(make_cmd(0, 10).c_str(), pop().c_str());
+  // bytes 0-10 are free, 10 chars and the '\0' do not fit
+  put_cmd(make_cmd(99, 10));
+  TEST_ASSERT_EQUAL_UINT32(1, ring.get_dropped());
+  // 9 chars and the '\0' do
+  put_cmd(make_cmd(98, 9));
+  TEST_ASSERT_EQUAL_UINT32(1, ring.get_dropped());
+  for (int i = 1; i < 18; i++) {
+    TEST_ASSERT_EQUAL_STRING(make_cmd(i, 10).c_str(), pop().c_str());
+  }
+  TEST_ASSERT_EQUAL_STRING(make_cmd(98, 9).c_str(), pop().c_str());
+  TEST_ASSERT_FALSE(ring.available());
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_framing);
+  RUN_TEST(test_wrap);
+  RUN_TEST(test_full_drop);
+  RUN_TEST(test_wrap_marker);
+  return UNITY_END();
+}
@@ -0,0 +1,36 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// fakes.cpp
+// Globals and methods from myfp2esp8266_330_36.ino used by
+// controller_data.cpp, and the allocation counter
+// -------------------------------------------------------
+#include "alloc_count.cpp"
+#include <Arduino.h>
+#include "config.h"
+
+
+// -------------------------------------------------------
+// GLOBALS
+// -------------------------------------------------------
+int _display_type = DISPLAY_NONE;
+bool isMoving;
+bool filesystemloaded;
+char project_author[BUFFER32LEN];
+char project_name[BUFFER32LEN];
+char major_version[BUFFER8LEN];
+char minor_version[BUFFER8LEN];
+char DeviceName[BUFFER12LEN];
+char MDNSName[BUFFER12LEN];
+
+
+// -------------------------------------------------------
+// METHODS
+// -------------------------------------------------------
+void RangeCheck(int *val, int low, int high) {
+  if (*val < low) *val = low;
+  if (*val > high) *val = high;
+}
+
+void software_Reboot(int delay) {
+  (void)delay;
+}
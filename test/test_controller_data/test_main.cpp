@@ -0,0 +1,280 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_controller_data/test_main.cpp
+// Tests of CONTROLLER_DATA over the in memory LittleFS
+// String settings are truncated to fit, and only a
+// change of the stored value requests a save
+// Display page options are padded to 6 chars
+// The getters used every polling cycle do not allocate
+// pio test -e native -f test_controller_data
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <string>
+#include <unity.h>
+#include "config.h"
+#include "controller_data.h"
+#include "alloc_count.h"
+
+CONTROLLER_DATA *ControllerData;
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// true if a setting was waiting to be saved, waits out
+// the save delay then saves
+static bool saved(void) {
+  delay(DEFAULTSAVETIME + 1);
+  return ControllerData->SaveConfiguration(ControllerData->get_fposition(), ControllerData->get_focuserdirection());
+}
+
+// load the configuration from the files again
+static void reload(void) {
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// Each test starts with the default configuration
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  reload();
+  saved();
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// STRING SETTINGS
+// StartDelayedUpdate(char *, const char *, size_t)
+// -------------------------------------------------------
+static void set_devicename(const char *s) {
+  ControllerData->set_devicename(s);
+}
+static const char *get_devicename(void) {
+  return ControllerData->get_devicename();
+}
+static void set_mdnsname(const char *s) {
+  ControllerData->set_mdnsname(s);
+}
+static const char *get_mdnsname(void) {
+  return ControllerData->get_mdnsname();
+}
+static void set_duckdns_domain(const char *s) {
+  ControllerData->set_duckdns_domain(s);
+}
+static const char *get_duckdns_domain(void) {
+  return ControllerData->get_duckdns_domain();
+}
+static void set_duckdns_token(const char *s) {
+  ControllerData->set_duckdns_token(s);
+}
+static const char *get_duckdns_token(void) {
+  return ControllerData->get_duckdns_token();
+}
+static void set_tprobe_rom(const char *s) {
+  ControllerData->set_tprobe_rom(Probe_Mirror, s);
+}
+static const char *get_tprobe_rom(void) {
+  return ControllerData->get_tprobe_rom(Probe_Mirror);
+}
+
+typedef struct {
+  const char *name;
+  void (*set)(const char *);
+  const char *(*get)(void);
+  size_t len;  // size of the setting, with the 0x00
+} string_setting;
+
+static const string_setting string_settings[] = {
+  { "devicename", set_devicename, get_devicename, BUFFER12LEN },
+  { "mdnsname", set_mdnsname, get_mdnsname, BUFFER12LEN },
+  { "duckdns_domain", set_duckdns_domain, get_duckdns_domain, BUFFER48LEN },
+  { "duckdns_token", set_duckdns_token, get_duckdns_token, BUFFER48LEN },
+  { "tprobe_rom", set_tprobe_rom, get_tprobe_rom, TEMP_ROMHEXLEN },
+};
+
+void test_string_truncate(void) {
+  for (const string_setting &s : string_settings) {
+    setUp();
+    std::string fits(s.len - 1, 'a');
+    std::string longer = fits + "bcdef";
+
+    // too long, truncated to len - 1 chars
+    s.set(longer.c_str());
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(fits.c_str(), s.get(), s.name);
+    TEST_ASSERT_TRUE_MESSAGE(saved(), s.name);
+
+    // the same value again is not a change
+    s.set(longer.c_str());
+    TEST_ASSERT_FALSE_MESSAGE(saved(), s.name);
+    s.set(fits.c_str());
+    TEST_ASSERT_FALSE_MESSAGE(saved(), s.name);
+
+    // a difference after the last char kept is not a change
+    s.set((fits + "x").c_str());
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(fits.c_str(), s.get(), s.name);
+    TEST_ASSERT_FALSE_MESSAGE(saved(), s.name);
+
+    // the truncated value is saved and loaded
+    reload();
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(fits.c_str(), s.get(), s.name);
+
+    // a shorter value, and a difference in the last char
+    s.set("abc");
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("abc", s.get(), s.name);
+    TEST_ASSERT_TRUE_MESSAGE(saved(), s.name);
+    std::string last = fits.substr(0, s.len - 2) + "z";
+    s.set(fits.c_str());
+    s.set(last.c_str());
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(last.c_str(), s.get(), s.name);
+    TEST_ASSERT_TRUE_MESSAGE(saved(), s.name);
+
+    // empty
+    s.set("");
+    TEST_ASSERT_EQUAL_STRING_MESSAGE("", s.get(), s.name);
+    TEST_ASSERT_TRUE_MESSAGE(saved(), s.name);
+  }
+}
+
+// the cached names follow the setting
+void test_string_cache(void) {
+  ControllerData->set_devicename("FocuserNumberOne");
+  TEST_ASSERT_EQUAL_STRING("FocuserNumb", DeviceName);
+  ControllerData->set_mdnsname("myfocuser.local");
+  TEST_ASSERT_EQUAL_STRING("myfocuser.l", MDNSName);
+}
+
+
+// -------------------------------------------------------
+// DISPLAY PAGE OPTION
+// pad_pageoption(), from set_display_pageoption() and
+// when cntlr_config.jsn is loaded
+// -------------------------------------------------------
+typedef struct {
+  const char *in;
+  const char *out;
+} pageoption_row;
+
+static const pageoption_row pageoption_rows[] = {
+  { "111111", "111111" },
+  { "101010", "101010" },
+  { "1", "100000" },
+  { "011", "011000" },
+  { "", "000000" },
+  { "1111111", "111111" },
+  { "0101010101", "010101" },
+};
+
+void test_pageoption_set(void) {
+  for (const pageoption_row &row : pageoption_rows) {
+    setUp();
+    ControllerData->set_display_pageoption(row.in);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(row.out, ControllerData->get_display_pageoption(), row.in);
+    TEST_ASSERT_EQUAL_MESSAGE(strcmp(row.out, "111111") != 0, saved(), row.in);
+  }
+}
+
+void test_pageoption_load(void) {
+  for (const pageoption_row &row : pageoption_rows) {
+    setUp();
+    std::string &cfg = LittleFS.content("/cntlr_config.jsn");
+    size_t pos = cfg.find("\"d_pgopt\":\"111111\"");
+    TEST_ASSERT_TRUE(pos != std::string::npos);
+    cfg.replace(pos, 18, std::string("\"d_pgopt\":\"") + row.in + "\"");
+    reload();
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(row.out, ControllerData->get_display_pageoption(), row.in);
+  }
+
+  // no page option in the file
+  setUp();
+  std::string &cfg = LittleFS.content("/cntlr_config.jsn");
+  cfg.replace(cfg.find("\"d_pgopt\":\"111111\","), 19, "");
+  reload();
+  TEST_ASSERT_EQUAL_STRING("000000", ControllerData->get_display_pageoption());
+}
+
+
+// -------------------------------------------------------
+// ALLOCATIONS
+// One polling cycle reads the settings the way the
+// firmware does: process_command() builds the :04 reply
+// from the board name, each page footer fills %NAM%, and
+// each page flip reads the page option. The network names
+// are read for the web and DuckDNS pages
+// -------------------------------------------------------
+#define POLL_CYCLES 1000
+
+static size_t poll_cycle(void) {
+  char buff[BUFFER64LEN];
+  size_t len = 0;
+
+  snprintf(buff, sizeof(buff), "%.19s%c%c%s", ControllerData->get_brdname(), '\r', '\n', major_version);
+  len += strlen(buff);
+  len += strlen(ControllerData->get_brdname());
+  const char *pageoption = ControllerData->get_display_pageoption();
+  for (int i = 0; i < 6; i++) {
+    len += (pageoption[i] == '1');
+  }
+  len += strlen(ControllerData->get_devicename());
+  len += strlen(ControllerData->get_mdnsname());
+  len += strlen(ControllerData->get_duckdns_domain());
+  len += strlen(ControllerData->get_duckdns_token());
+  return len;
+}
+
+void test_no_alloc(void) {
+  // values too long for a small string buffer
+  ControllerData->set_brdname("PRO2ESP8266DRV8825");
+  ControllerData->set_devicename("FocuserNumberOne");
+  ControllerData->set_mdnsname("myfocuser.local");
+  ControllerData->set_duckdns_domain("my-observatory-focuser-number-one.duckdns.org");
+  ControllerData->set_duckdns_token("a7c4d2e8-0b1f-4c3a-9e6d-5f2b8a1c7d40");
+  ControllerData->set_display_pageoption("101101");
+  saved();
+
+  // the counter sees a String copy of a setting
+  unsigned long count = alloc_count;
+  String copy(ControllerData->get_duckdns_domain());
+  TEST_ASSERT_GREATER_THAN(count, alloc_count);
+
+  size_t len = 0;
+  count = alloc_count;
+  for (int i = 0; i < POLL_CYCLES; i++) {
+    len += poll_cycle();
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, alloc_count - count);
+  TEST_ASSERT_GREATER_THAN(0, len);
+}
+
+
+// -------------------------------------------------------
+// FILESYSTEM STATE
+// load_vars() no longer clears filesystemloaded, so the
+// constructor must set it when the first mount succeeds
+// -------------------------------------------------------
+void test_filesystemloaded(void) {
+  filesystemloaded = STATE_NOTLOADED;
+  reload();
+  TEST_ASSERT_TRUE(filesystemloaded == STATE_LOADED);
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_string_truncate);
+  RUN_TEST(test_string_cache);
+  RUN_TEST(test_pageoption_set);
+  RUN_TEST(test_pageoption_load);
+  RUN_TEST(test_no_alloc);
+  RUN_TEST(test_filesystemloaded);
+  return UNITY_END();
+}
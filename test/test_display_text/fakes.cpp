@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// fakes.cpp
+// Builds test/stubs/firmware_fakes.cpp for this suite
+// -------------------------------------------------------
+#include "firmware_fakes.cpp"
@@ -0,0 +1,7 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_display_text.cpp
+// Builds src/display_text.cpp as its own translation unit
+// -------------------------------------------------------
+#include "suite_config.h"
+#include "display_text.cpp"
@@ -0,0 +1,14 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// suite_config.h
+// config.h built with the text OLED, included before any
+// other header by the files that need it
+// -------------------------------------------------------
+#ifndef _suite_config_h_
+#define _suite_config_h_
+
+#include "config.h"
+#undef DISPLAYTYPE
+#define DISPLAYTYPE TEXT_OLED12864
+
+#endif
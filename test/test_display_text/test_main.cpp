@@ -0,0 +1,301 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_display_text/test_main.cpp
+// Tests of TEXT_DISPLAY::flush() through update_page()
+// and update_position(), on the recording SSD1306 stub.
+// The text on screen is read back from the stub, and the
+// display RAM and I2C bytes each update costs are counted
+// Page flips do not allocate
+// pio test -e native -f test_display_text
+// -------------------------------------------------------
+#include "suite_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <Wire.h>
+#include <string>
+#include <unity.h>
+#include "controller_data.h"
+#include "display_text.h"
+#include "firmware_fakes.h"
+#include "alloc_count.h"
+
+extern CONTROLLER_DATA *ControllerData;
+static TEXT_DISPLAY *display;
+static SSD1306Ascii *oled;      // the screen of display
+static TEXT_DISPLAY *scratch;   // draws the pages skipped
+static int next_page = 1;
+
+// a 2X row cleared, both pages to the end
+#define ROW_CLEAR   (2 * 128)
+// a 2X character, 12 columns on both pages
+#define CHAR_2X     (2 * 12)
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// update_page() shows the enabled pages in turn, with all
+// enabled 1 to 6. The pages before pg are drawn on the
+// scratch display, the counts are then zeroed
+static void draw_page(int pg, long position) {
+  while (next_page != pg) {
+    scratch->update_page(0);
+    next_page = (next_page % 6) + 1;
+  }
+  Wire.reset_count();
+  oled->ram_bytes = 0;
+  display->update_page(position);
+  next_page = (next_page % 6) + 1;
+}
+
+static void draw_position(long position) {
+  Wire.reset_count();
+  oled->ram_bytes = 0;
+  display->update_position(position);
+}
+
+// the text of row r, a 1X row keeps its second page blank
+static std::string row(uint8_t r, uint8_t scale) {
+  if (scale == 1) {
+    TEST_ASSERT_TRUE(oled->blank((r * 2) + 1));
+  }
+  return oled->text(r * 2, scale);
+}
+
+static void check_page1(long position) {
+  char want[TEXT_ROWLEN];
+  snprintf(want, sizeof(want), "P  %ld", position);
+  want[TEXT_COLS2X] = 0x00;
+  TEST_ASSERT_EQUAL_STRING(want, row(0, 2).c_str());
+  snprintf(want, sizeof(want), "T  %ld", ftargetPosition);
+  TEST_ASSERT_EQUAL_STRING(want, row(1, 2).c_str());
+  TEST_ASSERT_EQUAL_STRING("M  80000", row(2, 2).c_str());
+  TEST_ASSERT_EQUAL_STRING("Stopped", row(3, 2).c_str());
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// A new display each test, the screen shows the boot text
+// and its contents are TEXT_UNKNOWN to flush()
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  ControllerData->set_display_enable(STATE_ENABLED);
+  ftargetPosition = 5000;
+  isMoving = false;
+
+  if (scratch == nullptr) {
+    scratch = new TEXT_DISPLAY(OLED_ADDR);
+    scratch->start();
+  }
+  delete display;
+  display = new TEXT_DISPLAY(OLED_ADDR);
+  TEST_ASSERT_TRUE(display->start());
+  oled = stub_oled;
+  TEST_ASSERT_TRUE(oled->on);
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// TEXT_UNKNOWN
+// The first flush of a row clears both its pages, then
+// writes the text
+// -------------------------------------------------------
+void test_unknown(void) {
+  TEST_ASSERT_EQUAL_STRING("330", oled->text(1, 1).c_str());
+  TEST_ASSERT_EQUAL_STRING("BOOTING", oled->text(2, 1).c_str());
+
+  draw_position(1234);
+  TEST_ASSERT_EQUAL_STRING("P  1234", row(0, 2).c_str());
+  TEST_ASSERT_EQUAL_STRING("T  5000", row(1, 2).c_str());
+  TEST_ASSERT_EQUAL_UINT32(2 * (ROW_CLEAR + (7 * CHAR_2X)), oled->ram_bytes);
+
+  // an empty row of unknown contents is cleared
+  oled->setCursor(0, 5);
+  oled->print("junk");
+  oled->setCursor(0, 7);
+  oled->print("junk");
+  draw_page(4, 1234);
+  TEST_ASSERT_TRUE(row(0, 2).rfind("BIN#  ", 0) == 0);
+  TEST_ASSERT_TRUE(row(1, 2).rfind("BOU#  ", 0) == 0);
+  for (uint8_t page = 4; page < 8; page++) {
+    TEST_ASSERT_TRUE(oled->blank(page));
+  }
+}
+
+
+// -------------------------------------------------------
+// TEXT_BLANK
+// A row that is clear is written without clearing it,
+// an empty row is cleared once
+// -------------------------------------------------------
+void test_blank(void) {
+  display->clear();
+  for (uint8_t page = 0; page < 8; page++) {
+    TEST_ASSERT_TRUE(oled->blank(page));
+  }
+  draw_position(1234);
+  TEST_ASSERT_EQUAL_STRING("P  1234", row(0, 2).c_str());
+  TEST_ASSERT_EQUAL_UINT32(2 * 7 * CHAR_2X, oled->ram_bytes);
+
+  // page 4 leaves rows 2 and 3 empty, then page 5 fills
+  // them with no clear
+  draw_page(1, 1234);
+  draw_page(4, 1234);
+  for (uint8_t page = 4; page < 8; page++) {
+    TEST_ASSERT_TRUE(oled->blank(page));
+  }
+  draw_page(4, 1234);
+  TEST_ASSERT_EQUAL_UINT32(0, Wire.bytes);
+
+  DeviceName[0] = 0x00;
+  strlcpy(MDNSName, "fp2", sizeof(MDNSName));
+  draw_page(5, 1234);
+  TEST_ASSERT_EQUAL_STRING("STATION", row(0, 2).c_str());
+  TEST_ASSERT_EQUAL_STRING("SSID myssi", row(1, 2).c_str());
+  TEST_ASSERT_TRUE(oled->blank(4) && oled->blank(5));
+  TEST_ASSERT_EQUAL_STRING("fp2", row(3, 2).c_str());
+}
+
+
+// -------------------------------------------------------
+// DIFF
+// Only the cells from the first to the last difference
+// are written
+// -------------------------------------------------------
+void test_diff(void) {
+  draw_page(1, 1234);
+  check_page1(1234);
+
+  // nothing changed, nothing sent
+  draw_page(1, 1234);
+  draw_position(1234);
+  TEST_ASSERT_EQUAL_UINT32(0, Wire.bytes);
+
+  // one digit, one character cell. The cursor is 3
+  // commands, the top page 12 bytes in one transmission,
+  // the cursor for the bottom page, its 12 bytes, and the
+  // row set back. 3 bytes per command, 14 per page
+  draw_position(1235);
+  check_page1(1235);
+  TEST_ASSERT_EQUAL_UINT32(CHAR_2X, oled->ram_bytes);
+  TEST_ASSERT_EQUAL_UINT32(9 + 14 + 9 + 14 + 3, Wire.bytes);
+
+  // first and last digit, the cells between are written
+  draw_position(2236);
+  check_page1(2236);
+  TEST_ASSERT_EQUAL_UINT32(4 * CHAR_2X, oled->ram_bytes);
+
+  ftargetPosition = 5100;
+  draw_position(2236);
+  check_page1(2236);
+  TEST_ASSERT_EQUAL_UINT32(CHAR_2X, oled->ram_bytes);
+
+  // against drawing the whole page for each digit
+  draw_page(2, 2236);
+  draw_page(1, 2236);
+  unsigned long page_bytes = Wire.bytes;
+  draw_position(2237);
+  char msg[80];
+  snprintf(msg, sizeof(msg), "page 1 drawn %lu I2C bytes, one digit %lu", page_bytes, Wire.bytes);
+  TEST_MESSAGE(msg);
+  TEST_ASSERT_LESS_THAN(page_bytes / 10, Wire.bytes);
+}
+
+
+// -------------------------------------------------------
+// CLEAR TAIL
+// Shorter text writes the changed cells, then clears the
+// rest of the row once
+// -------------------------------------------------------
+void test_clear_tail(void) {
+  draw_page(1, 12345);
+  check_page1(12345);
+
+  draw_position(99);
+  check_page1(99);
+  TEST_ASSERT_EQUAL_UINT32((2 * CHAR_2X) + (2 * (128 - (5 * 12))), oled->ram_bytes);
+
+  // longer again, no clear
+  draw_position(123456);
+  check_page1(123456);
+  TEST_ASSERT_EQUAL_UINT32(6 * CHAR_2X, oled->ram_bytes);
+
+  // only the tail changed
+  draw_position(12);
+  check_page1(12);
+  TEST_ASSERT_EQUAL_UINT32(2 * (128 - (5 * 12)), oled->ram_bytes);
+
+  // clipped to 10 columns at 2X
+  draw_position(1234567890);
+  check_page1(1234567890);
+  TEST_ASSERT_EQUAL_STRING("P  1234567", row(0, 2).c_str());
+  draw_position(-5);
+  check_page1(-5);
+}
+
+
+// -------------------------------------------------------
+// SCALE
+// Page 6 shows the IP address at 1X in row 0, a change of
+// scale clears both pages of the row before writing
+// -------------------------------------------------------
+void test_scale(void) {
+  draw_page(1, 1234);
+  check_page1(1234);
+
+  draw_page(6, 1234);
+  TEST_ASSERT_EQUAL_STRING("192.168.2.21", row(0, 1).c_str());
+  TEST_ASSERT_EQUAL_STRING("40000", row(1, 2).c_str());
+  TEST_ASSERT_EQUAL_STRING("001:02:03", row(2, 2).c_str());
+  TEST_ASSERT_TRUE(oled->blank(6) && oled->blank(7));
+
+  // the same text at 1X again sends nothing
+  strlcpy(ipStr, "192.168.2.210", sizeof(ipStr));
+  draw_page(6, 1234);
+  TEST_ASSERT_EQUAL_STRING("192.168.2.210", row(0, 1).c_str());
+  TEST_ASSERT_EQUAL_UINT32(6, oled->ram_bytes);
+  strlcpy(ipStr, "192.168.2.21", sizeof(ipStr));
+
+  // 1X to 2X
+  draw_page(1, 1234);
+  check_page1(1234);
+  draw_position(1234);
+  TEST_ASSERT_EQUAL_UINT32(0, Wire.bytes);
+}
+
+
+// -------------------------------------------------------
+// ALLOCATIONS
+// Each page flip reads the page option and draws from
+// the settings, none of it allocates
+// -------------------------------------------------------
+void test_no_alloc(void) {
+  ControllerData->set_brdname("PRO2ESP8266DRV8825");
+  unsigned long count = alloc_count;
+  for (int i = 0; i < 600; i++) {
+    display->update_page(i);
+    display->update_position(i);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, alloc_count - count);
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_unknown);
+  RUN_TEST(test_blank);
+  RUN_TEST(test_diff);
+  RUN_TEST(test_clear_tail);
+  RUN_TEST(test_scale);
+  RUN_TEST(test_no_alloc);
+  return UNITY_END();
+}
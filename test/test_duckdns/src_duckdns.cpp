@@ -0,0 +1,7 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_duckdns.cpp
+// Builds src/duckdns.cpp as its own translation unit
+// -------------------------------------------------------
+#include "suite_config.h"
+#include "duckdns.cpp"
@@ -0,0 +1,13 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// suite_config.h
+// config.h built with DuckDNS, included before any other
+// header by the files that need it
+// -------------------------------------------------------
+#ifndef _suite_config_h_
+#define _suite_config_h_
+
+#include "config.h"
+#define ENABLE_DUCKDNS
+
+#endif
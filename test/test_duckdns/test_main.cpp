@@ -0,0 +1,328 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_duckdns/test_main.cpp
+// Tests of DUCK_DNS::run() against the stand in server of
+// the WiFiClient stub. The public ip is read, duckdns is
+// sent only a changed ip, replies may arrive slowly or in
+// part, OK and KO are told apart, and a failed step is
+// retried after a time that doubles up to the maximum
+// pio test -e native -f test_duckdns
+// -------------------------------------------------------
+#include "suite_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <ESP8266WiFi.h>
+#include <lwip/dns.h>
+#include <string>
+#include <unity.h>
+#include "controller_data.h"
+#include "duckdns.h"
+#include "firmware_fakes.h"
+
+extern CONTROLLER_DATA *ControllerData;
+bool duckdns_status;
+static DUCK_DNS *ddns;
+
+#define DOMAIN  "myfocuser"
+#define TOKEN   "a7c4d2e8-0b1f-4c3a-9e6d-5f2b8a1c7d40"
+#define REFRESH (DUCKDNS_REFRESHRATE * 1000UL)
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// a 200 reply with headers and the body
+static std::string http(const char *body, int code = 200) {
+  char status[40];
+  snprintf(status, sizeof(status), "HTTP/1.1 %d X\r\n", code);
+  return std::string(status) + "Content-Type: text/plain\r\nContent-Length: " + std::to_string(strlen(body)) +
+         "\r\nConnection: close\r\n\r\n" + body;
+}
+
+// loop() passes, 1 ms apart
+static void run_for(unsigned long ms) {
+  for (unsigned long i = 0; i < ms; i++) {
+    delay(1);
+    ddns->run();
+  }
+}
+
+static size_t connects(void) {
+  return stub_server.connect_times.size();
+}
+
+// the time from connect n - 1 to connect n, a try is
+// begun one pass before its connect
+static unsigned long gap(size_t n) {
+  return stub_server.connect_times[n] - stub_server.connect_times[n - 1];
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// DuckDNS is started with no ip sent, so the first check
+// is made on the next run()
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  ControllerData->set_duckdns_enable(STATE_ENABLED);
+  ControllerData->set_duckdns_domain(DOMAIN);
+  ControllerData->set_duckdns_token(TOKEN);
+
+  stub_server = STUB_SERVER();
+  stub_dns = STUB_DNS();
+  WiFi._status = WL_CONNECTED;
+  delete ddns;
+  ddns = new DUCK_DNS();
+  TEST_ASSERT_TRUE(ddns->start());
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// UPDATE
+// The public ip is read, then sent to duckdns. The next
+// check after the refresh time finds it unchanged and
+// sends nothing
+// -------------------------------------------------------
+void test_update(void) {
+  stub_server.replies = { http("203.0.113.7\n"), http("OK"), http("203.0.113.7\n"),
+                          http("198.51.100.2\n"), http("OK") };
+  run_for(10);
+  TEST_ASSERT_EQUAL_UINT(2, connects());
+  TEST_ASSERT_EQUAL_STRING("www.duckdns.org", stub_dns.name.c_str());
+  TEST_ASSERT_TRUE(stub_server.ip == IPAddress(127, 0, 0, 1));
+  TEST_ASSERT_EQUAL_UINT(80, stub_server.port);
+  TEST_ASSERT_EQUAL_STRING("GET /update?domains=" DOMAIN "&token=" TOKEN "&ip=203.0.113.7 HTTP/1.0\r\n"
+                           "Host: www.duckdns.org\r\n\r\n",
+                           stub_server.request.c_str());
+  TEST_ASSERT_EQUAL_STRING("203.0.113.7", ddns->get_ddns_ip().c_str());
+
+  // unchanged, only the ip is read
+  run_for(REFRESH + 10);
+  TEST_ASSERT_EQUAL_UINT(3, connects());
+  TEST_ASSERT_EQUAL_STRING("ifconfig.me", stub_dns.name.c_str());
+  TEST_ASSERT_EQUAL_STRING("GET /ip HTTP/1.0\r\nHost: ifconfig.me\r\nUser-Agent: curl\r\n\r\n",
+                           stub_server.request.c_str());
+
+  // changed, sent again
+  run_for(REFRESH + 10);
+  TEST_ASSERT_EQUAL_UINT(5, connects());
+  TEST_ASSERT_EQUAL_STRING("198.51.100.2", ddns->get_ddns_ip().c_str());
+}
+
+
+// -------------------------------------------------------
+// REPLIES
+// The status code, and the first body line, decide if a
+// step worked. A body line without a newline is taken
+// when the server closes
+// -------------------------------------------------------
+typedef struct {
+  const char *name;
+  std::string ip;      // reply to the ip request
+  std::string update;  // reply to the update
+  bool sent;           // the ip was accepted by duckdns
+} reply_row;
+
+void test_replies(void) {
+  const reply_row rows[] = {
+    { "ok", http("203.0.113.7\n"), http("OK"), true },
+    { "ok crlf", http("203.0.113.7\r\n"), http("OK\r\n"), true },
+    { "ko", http("203.0.113.7\n"), http("KO"), false },
+    { "ok 500", http("203.0.113.7\n"), http("OK", 500), false },
+    { "okay", http("203.0.113.7\n"), http("OKAY"), false },
+    { "no body", http("203.0.113.7\n"), http(""), false },
+    { "ip 404", http("203.0.113.7\n", 404), http("OK"), false },
+    { "ip html", http("<html>203.0.113.7</html>\n"), http("OK"), false },
+    { "ip range", http("203.0.113.256\n"), http("OK"), false },
+    { "ip cut", http("203.0.113"), http("OK"), false },
+    { "no status", "203.0.113.7\n", http("OK"), false },
+    { "empty", "", http("OK"), false },
+  };
+
+  for (const reply_row &row : rows) {
+    setUp();
+    stub_server.replies = { row.ip, row.update };
+    run_for(10);
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(row.sent ? "203.0.113.7" : "", ddns->get_ddns_ip().c_str(), row.name);
+    if (!row.sent) {
+      // the next check waits for the retry time
+      size_t n = connects();
+      run_for(DUCKDNS_RETRYTIME - 20);
+      TEST_ASSERT_EQUAL_UINT_MESSAGE(n, connects(), row.name);
+    }
+  }
+}
+
+
+// -------------------------------------------------------
+// SLOW AND PARTIAL REPLIES
+// run() reads only what has arrived and never waits, a
+// reply that stops arriving times out
+// -------------------------------------------------------
+void test_slow(void) {
+  // 1 byte per ms, each run() takes what has arrived
+  stub_server.replies = { http("203.0.113.7\n"), http("OK") };
+  stub_server.bytes_per_ms = 1;
+  size_t len = stub_server.replies[0].length() + stub_server.replies[1].length();
+  unsigned long start = millis();
+  run_for(len + 10);
+  TEST_ASSERT_EQUAL_STRING("203.0.113.7", ddns->get_ddns_ip().c_str());
+  TEST_ASSERT_EQUAL_UINT(2, connects());
+  TEST_ASSERT_EQUAL_UINT32(len + 10, millis() - start);
+}
+
+void test_stall(void) {
+  stub_server.replies = { http("203.0.113.7\n") };
+  stub_server.stall_at = stub_server.replies[0].length() - 6;
+  run_for(DUCKDNS_READTIMEOUT - 10);
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+  run_for(20);
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+  TEST_ASSERT_EQUAL_STRING("", ddns->get_ddns_ip().c_str());
+
+  // timed out after the last byte was read, one pass after
+  // connect, then retried with the whole reply
+  stub_server.stall_at = SIZE_MAX;
+  stub_server.replies.push_back(http("203.0.113.7\n"));
+  stub_server.replies.push_back(http("OK"));
+  run_for(DUCKDNS_RETRYTIME + 100);
+  TEST_ASSERT_EQUAL_UINT(3, connects());
+  TEST_ASSERT_EQUAL_UINT32(1 + DUCKDNS_READTIMEOUT + DUCKDNS_RETRYTIME + 1, gap(1));
+  TEST_ASSERT_EQUAL_STRING("203.0.113.7", ddns->get_ddns_ip().c_str());
+}
+
+
+// -------------------------------------------------------
+// CONNECT
+// A connect that is not accepted in time gives up after
+// DUCKDNS_CONNECTTIMEOUT, the only step that waits
+// -------------------------------------------------------
+void test_connect_timeout(void) {
+  stub_server.connect_ms = 5000;
+  run_for(1);
+  unsigned long start = millis();
+  ddns->run();
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+  TEST_ASSERT_EQUAL_UINT32(DUCKDNS_CONNECTTIMEOUT, stub_server.timeout);
+  TEST_ASSERT_EQUAL_UINT32(DUCKDNS_CONNECTTIMEOUT, millis() - start);
+
+  // a slow connect in time works
+  stub_server.connect_ms = DUCKDNS_CONNECTTIMEOUT / 2;
+  stub_server.replies = { "", http("203.0.113.7\n"), http("OK") };
+  run_for(DUCKDNS_RETRYTIME + DUCKDNS_CONNECTTIMEOUT + 10);
+  TEST_ASSERT_EQUAL_UINT(3, connects());
+  TEST_ASSERT_EQUAL_STRING("203.0.113.7", ddns->get_ddns_ip().c_str());
+}
+
+
+// -------------------------------------------------------
+// RETRY
+// Each failure doubles the time to the next try, up to
+// DUCKDNS_MAXRETRYTIME, a success starts it again
+// -------------------------------------------------------
+void test_backoff(void) {
+  stub_server.accept = false;
+  unsigned long limit = 0;
+  unsigned long wait = DUCKDNS_RETRYTIME;
+  for (int i = 0; i < 12; i++) {
+    limit += wait + 10;
+    wait = std::min(wait * 2, (unsigned long)DUCKDNS_MAXRETRYTIME);
+  }
+  for (unsigned long i = 0; (i < limit) && (connects() < 13); i++) {
+    run_for(1);
+  }
+  TEST_ASSERT_EQUAL_UINT(13, connects());
+
+  // each connect blocks, then the retry wait
+  wait = DUCKDNS_RETRYTIME;
+  for (size_t n = 1; n < connects(); n++) {
+    TEST_ASSERT_EQUAL_UINT32(DUCKDNS_CONNECTTIMEOUT + wait + 1, gap(n));
+    wait = std::min(wait * 2, (unsigned long)DUCKDNS_MAXRETRYTIME);
+  }
+  TEST_ASSERT_EQUAL_UINT32(DUCKDNS_CONNECTTIMEOUT + DUCKDNS_MAXRETRYTIME + 1, gap(12));
+
+  // a success, then a failed check waits the first retry
+  // time again, the reply is empty
+  stub_server.accept = true;
+  stub_server.replies.resize(connects());
+  stub_server.replies.push_back(http("203.0.113.7\n"));
+  stub_server.replies.push_back(http("OK"));
+  for (unsigned long i = 0; (i < DUCKDNS_MAXRETRYTIME + 10) && (connects() < 15); i++) {
+    run_for(1);
+  }
+  run_for(10);
+  TEST_ASSERT_EQUAL_STRING("203.0.113.7", ddns->get_ddns_ip().c_str());
+  run_for(REFRESH + DUCKDNS_RETRYTIME + 10);
+  TEST_ASSERT_EQUAL_UINT(17, connects());
+  TEST_ASSERT_EQUAL_UINT32(1 + DUCKDNS_RETRYTIME + 1, gap(16));
+}
+
+
+// -------------------------------------------------------
+// HOST LOOKUP AND WIFI
+// A lookup in progress is waited for without blocking,
+// one not answered times out, one not found fails. No
+// lookup is made while WiFi is down
+// -------------------------------------------------------
+void test_lookup(void) {
+  stub_dns.result = ERR_INPROGRESS;
+  stub_server.replies = { http("203.0.113.7\n"), http("OK") };
+  run_for(100);
+  TEST_ASSERT_EQUAL_INT(1, stub_dns.lookups);
+  TEST_ASSERT_EQUAL_UINT(0, connects());
+  ip_addr_t addr = { 0x0a00000a };  // 10.0.0.10
+  stub_dns_answer(&addr);
+  run_for(5);
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+  TEST_ASSERT_TRUE(stub_server.ip == IPAddress(10, 0, 0, 10));
+
+  // the update host is not found
+  stub_dns_answer(nullptr);
+  run_for(5);
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+  TEST_ASSERT_EQUAL_STRING("", ddns->get_ddns_ip().c_str());
+
+  // no answer
+  run_for(DUCKDNS_RETRYTIME);
+  TEST_ASSERT_EQUAL_INT(3, stub_dns.lookups);
+  run_for(DUCKDNS_DNSTIMEOUT);
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+
+  // a late answer is ignored
+  stub_dns_answer(&addr);
+  run_for(5);
+  TEST_ASSERT_EQUAL_UINT(1, connects());
+}
+
+void test_wifi_down(void) {
+  WiFi._status = WL_DISCONNECTED;
+  run_for(DUCKDNS_RETRYTIME + DUCKDNS_RETRYTIME * 2);
+  TEST_ASSERT_EQUAL_INT(0, stub_dns.lookups);
+
+  WiFi._status = WL_CONNECTED;
+  stub_server.replies = { http("203.0.113.7\n"), http("OK") };
+  run_for(DUCKDNS_RETRYTIME * 4 + 10);
+  TEST_ASSERT_EQUAL_STRING("203.0.113.7", ddns->get_ddns_ip().c_str());
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_update);
+  RUN_TEST(test_replies);
+  RUN_TEST(test_slow);
+  RUN_TEST(test_stall);
+  RUN_TEST(test_connect_timeout);
+  RUN_TEST(test_backoff);
+  RUN_TEST(test_lookup);
+  RUN_TEST(test_wifi_down);
+  return UNITY_END();
+}
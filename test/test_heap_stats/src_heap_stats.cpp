@@ -0,0 +1,7 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_heap_stats.cpp
+// Builds src/heap_stats.cpp with the allocation counters
+// -------------------------------------------------------
+#define ENABLE_HEAPCOUNTERS
+#include "heap_stats.cpp"
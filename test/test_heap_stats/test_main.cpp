@@ -0,0 +1,172 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_heap_stats/test_main.cpp
+// Tests of HEAP_STATS with the allocation counters
+// The lowest free heap follows the ESP stub through a
+// soak run, reset() restarts it and the counts, and the
+// report stays inside its buffer
+// pio test -e native -f test_heap_stats
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <string.h>
+#include <string>
+#include <unity.h>
+#define ENABLE_HEAPCOUNTERS
+#include "heap_stats.h"
+
+extern "C" {
+void *__wrap_malloc(size_t);
+void *__wrap_realloc(void *, size_t);
+}
+
+static HEAP_STATS *stats;
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+static std::string report(void) {
+  char buff[HEAP_REPORTLEN];
+  stats->get_report(buff, sizeof(buff));
+  return buff;
+}
+
+// the "tag allocs bytes" line from the report
+static std::string tag_line(const char *tag) {
+  std::string r = report();
+  size_t pos = r.find(std::string("\n") + tag + " ");
+  TEST_ASSERT_TRUE_MESSAGE(pos != std::string::npos, tag);
+  pos++;
+  return r.substr(pos, r.find('\n', pos) - pos);
+}
+
+// one allocation of size bytes charged to tag
+static void alloc(byte tag, size_t size) {
+  HeapTag(tag);
+  free(__wrap_malloc(size));
+  HeapTag(Heap_Loop);
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// -------------------------------------------------------
+void setUp(void) {
+  ESP.freeheap = 40000;
+  ESP.maxblock = 32000;
+  ESP.frag = 0;
+  ESP.stackfree = 4000;
+  delete stats;
+  stats = new HEAP_STATS();
+  stats->reset();
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// LOWEST FREE HEAP
+// run() keeps the lowest free heap seen, reset() starts
+// again from the free heap now
+// -------------------------------------------------------
+void test_minfree(void) {
+  TEST_ASSERT_EQUAL_UINT32(40000, stats->get_minfree());
+  ESP.freeheap = 30000;
+  stats->run();
+  ESP.freeheap = 35000;
+  stats->run();
+  TEST_ASSERT_EQUAL_UINT32(30000, stats->get_minfree());
+  TEST_ASSERT_EQUAL_UINT32(35000, stats->get_free());
+
+  // get_minfree() also samples the heap
+  ESP.freeheap = 20000;
+  TEST_ASSERT_EQUAL_UINT32(20000, stats->get_minfree());
+
+  ESP.freeheap = 38000;
+  stats->reset();
+  TEST_ASSERT_EQUAL_UINT32(38000, stats->get_minfree());
+}
+
+// a long run, the heap dips once in the middle
+void test_soak(void) {
+  for (uint32_t i = 0; i < 100000; i++) {
+    ESP.freeheap = 36000 + (i % 1000);
+    if (i == 54321) {
+      ESP.freeheap = 12345;
+    }
+    stats->run();
+    alloc(Heap_Web, 64);
+  }
+  TEST_ASSERT_EQUAL_UINT32(12345, stats->get_minfree());
+  TEST_ASSERT_EQUAL_STRING("web 100000 6400000", tag_line("web").c_str());
+  TEST_ASSERT_EQUAL_STRING("loop 0 0", tag_line("loop").c_str());
+}
+
+
+// -------------------------------------------------------
+// ALLOCATION COUNTS
+// Each malloc and realloc counts against the current tag
+// -------------------------------------------------------
+void test_counts(void) {
+  HeapTag(Heap_Serial);
+  void *p = __wrap_malloc(100);
+  p = __wrap_realloc(p, 200);
+  free(p);
+  HeapTag(Heap_Loop);
+  alloc(Heap_Display, 10);
+  alloc(Heap_Display, 20);
+
+  TEST_ASSERT_EQUAL_STRING("serial 2 300", tag_line("serial").c_str());
+  TEST_ASSERT_EQUAL_STRING("display 2 30", tag_line("display").c_str());
+  TEST_ASSERT_EQUAL_STRING("alpaca 0 0", tag_line("alpaca").c_str());
+
+  stats->reset();
+  TEST_ASSERT_EQUAL_STRING("serial 0 0", tag_line("serial").c_str());
+  TEST_ASSERT_EQUAL_STRING("display 0 0", tag_line("display").c_str());
+}
+
+
+// -------------------------------------------------------
+// SUMMARY AND REPORT
+// -------------------------------------------------------
+void test_summary(void) {
+  char buff[HEAP_SUMMARYLEN];
+
+  ESP.freeheap = 30000;
+  ESP.maxblock = 25000;
+  ESP.frag = 12;
+  ESP.stackfree = 3000;
+  stats->get_summary(buff, sizeof(buff));
+  TEST_ASSERT_EQUAL_STRING("30000,25000,12,30000,3000", buff);
+}
+
+void test_report(void) {
+  ESP.frag = 7;
+  std::string r = report();
+  TEST_ASSERT_EQUAL_STRING("free 40000\nmaxblock 32000\nfrag 7%\nminfree 40000\nstack 4000\n",
+                           r.substr(0, r.find("loop")).c_str());
+  TEST_ASSERT_EQUAL_STRING("display 0 0\n", r.substr(r.find("display")).c_str());
+
+  // a short buffer is cut, nothing is written past it
+  char buff[64];
+  memset(buff, '*', sizeof(buff));
+  stats->get_report(buff, 40);
+  TEST_ASSERT_EQUAL_UINT(39, strlen(buff));
+  for (size_t i = 40; i < sizeof(buff); i++) {
+    TEST_ASSERT_EQUAL_HEX8('*', buff[i]);
+  }
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_minfree);
+  RUN_TEST(test_soak);
+  RUN_TEST(test_counts);
+  RUN_TEST(test_summary);
+  RUN_TEST(test_report);
+  return UNITY_END();
+}
@@ -0,0 +1,18 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// wrap_malloc.cpp
+// The native build is not linked with --wrap, so the
+// tests call __wrap_malloc and __wrap_realloc as the
+// wrapped firmware would, and __real_ is the C library
+// -------------------------------------------------------
+#include <stdlib.h>
+
+extern "C" {
+void *__real_malloc(size_t size) {
+  return malloc(size);
+}
+
+void *__real_realloc(void *ptr, size_t size) {
+  return realloc(ptr, size);
+}
+}
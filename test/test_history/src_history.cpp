@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_history.cpp
+// Builds src/history.cpp as its own translation unit
+// -------------------------------------------------------
+#include "history.cpp"
@@ -0,0 +1,161 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_history/test_main.cpp
+// Tests of HISTORY, the tiered temperature and position
+// history. Each sample's position is its index, a coarse
+// sample keeps the position of its last sample, so the
+// test knows which samples each period holds. The merged
+// export must give periods that never overlap, with a gap
+// at a tier boundary only where the finer tier has
+// already dropped the samples
+// pio test -e native -f test_history
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include "config.h"
+#include "controller_data.h"
+#include "history.h"
+
+extern CONTROLLER_DATA *ControllerData;
+static HISTORY *history;
+static long samples;
+
+// tier 0 samples in one sample of each tier
+static const long span[HISTORY_TIERS] = { 1, HISTORY_TIER1RATIO, HISTORY_TIER1RATIO * HISTORY_TIER2RATIO };
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// the next sample, taken ms after the last
+static void sample(uint32_t ms, float temp, bool moving) {
+  stub_millis += ms;
+  history->sample(temp, samples, samples, moving);
+  samples++;
+}
+
+// the merged export, oldest first, as /history sends it
+// with no tier
+static void check_merged(void) {
+  HIST_SAMPLE s;
+  long end = -1;  // index of the last sample exported
+  long last = 0;  // span of the last period exported
+  int lasttier = -1;
+
+  for (int t = HISTORY_TIERS - 1; t >= 0; t--) {
+    uint16_t n = history->merged_count(t);
+    TEST_ASSERT_LESS_OR_EQUAL(history->count(t), n);
+    for (uint16_t i = 0; i < n; i++) {
+      TEST_ASSERT_TRUE(history->get(t, i, s));
+      long start = s.position - span[t];  // index before the period
+      if (end >= 0) {
+        // no period is sent twice
+        TEST_ASSERT_GREATER_OR_EQUAL(end, start);
+        if (t == lasttier) {
+          TEST_ASSERT_EQUAL_INT32(end, start);
+        } else {
+          // short of the next coarse period, which
+          // overlaps the finer tier
+          TEST_ASSERT_LESS_THAN(end + last, start);
+        }
+      }
+      end = s.position;
+      last = span[t];
+      lasttier = t;
+    }
+  }
+  // up to the newest sample
+  TEST_ASSERT_EQUAL_INT32(samples - 1, end);
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  delete history;
+  history = new HISTORY();
+  samples = 0;
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// TIERS
+// A tier 1 sample is the rounded mean temperature of 60
+// samples, the last position, and moving if any moved
+// -------------------------------------------------------
+void test_fold(void) {
+  HIST_SAMPLE s;
+  for (int i = 0; i < HISTORY_TIER1RATIO; i++) {
+    sample(HISTORYSAMPLETIME, (i < 30) ? -1.0f : -1.01f, i == 10);
+  }
+  TEST_ASSERT_EQUAL_UINT(HISTORY_TIER1RATIO, history->count(0));
+  TEST_ASSERT_EQUAL_UINT(1, history->count(1));
+  TEST_ASSERT_TRUE(history->get(1, 0, s));
+  TEST_ASSERT_EQUAL_INT32(-101, s.temp);
+  TEST_ASSERT_EQUAL_INT32(HISTORY_TIER1RATIO - 1, s.position);
+  TEST_ASSERT_EQUAL_UINT(1, s.moving);
+
+  for (int i = 0; i < HISTORY_TIER1RATIO; i++) {
+    sample(HISTORYSAMPLETIME, 20.0f, false);
+  }
+  TEST_ASSERT_TRUE(history->get(1, 1, s));
+  TEST_ASSERT_EQUAL_INT32(2000, s.temp);
+  TEST_ASSERT_EQUAL_UINT(0, s.moving);
+
+  // nothing merged from a coarse tier while the finer
+  // tier still holds every sample
+  TEST_ASSERT_EQUAL_UINT(0, history->merged_count(1));
+  TEST_ASSERT_EQUAL_UINT(2 * HISTORY_TIER1RATIO, history->merged_count(0));
+  check_merged();
+}
+
+
+// -------------------------------------------------------
+// MERGED EXPORT
+// Checked after each sample, from before tier 0 is full
+// to after tier 2 wraps
+// -------------------------------------------------------
+void test_merged(void) {
+  long wrap = (HISTORY_TIER2LEN + 2) * span[2];
+  while (samples < wrap) {
+    sample(HISTORYSAMPLETIME, 20.0f, false);
+    if ((samples < (3 * span[2])) || ((samples % 7) == 0)) {
+      check_merged();
+    }
+  }
+  TEST_ASSERT_EQUAL_UINT(HISTORY_TIER2LEN, history->count(2));
+  TEST_ASSERT_GREATER_THAN(0, history->merged_count(2));
+  TEST_ASSERT_GREATER_THAN(0, history->merged_count(1));
+}
+
+// late samples, the whole second times repeat. The tiers
+// are merged by sample, so a period ending at the same
+// second as the oldest finer sample is still sent
+void test_late(void) {
+  // 0.05s, 2s, 2.05s, 4s... each odd and the next even
+  // sample have the same time
+  stub_millis += 1000 - (stub_millis % 1000);
+  while (samples < (3 * span[2])) {
+    sample((samples & 1) ? 1950 : 50, 20.0f, false);
+    check_merged();
+  }
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_fold);
+  RUN_TEST(test_merged);
+  RUN_TEST(test_late);
+  return UNITY_END();
+}
@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// fakes.cpp
+// Builds test/stubs/alloc_count.cpp for this suite
+// -------------------------------------------------------
+#include "alloc_count.cpp"
@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_page_arena.cpp
+// Builds src/page_arena.cpp as its own translation unit
+// -------------------------------------------------------
+#include "page_arena.cpp"
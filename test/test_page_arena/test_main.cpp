@@ -0,0 +1,251 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_page_arena/test_main.cpp
+// Tests of PAGE_ARENA over the in memory LittleFS
+// Replacements grow and shrink the page in place, a page
+// that does not fit is cut at PAGEARENALEN and flagged,
+// and repeated renders neither grow the page nor touch
+// the heap
+// pio test -e native -f test_page_arena
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <string>
+#include <unity.h>
+#include "page_arena.h"
+#include "alloc_count.h"
+
+static PAGE_ARENA arena;
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// std::string reference for PAGE_ARENA::replace()
+static std::string replace_ref(std::string page, const std::string &find, const std::string &with) {
+  size_t pos = 0;
+  while ((pos = page.find(find, pos)) != std::string::npos) {
+    page.replace(pos, find.length(), with);
+    pos += with.length();
+  }
+  return page;
+}
+
+static File write_file(const char *path, const std::string &content) {
+  LittleFS.content(path) = content;
+  return LittleFS.open(path, "r");
+}
+
+// the arena holds exactly want, and ends with a terminator
+static void check_page(const std::string &want) {
+  TEST_ASSERT_EQUAL_UINT(want.length(), arena.length());
+  TEST_ASSERT_EQUAL_UINT(want.length(), strlen(arena.c_str()));
+  TEST_ASSERT_TRUE(want == arena.c_str());
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  arena.clear();
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// ASSIGN AND APPEND
+// -------------------------------------------------------
+void test_append(void) {
+  arena = "<html>";
+  arena += "<body>";
+  arena += String("</body>");
+  check_page("<html><body></body>");
+  TEST_ASSERT_FALSE(arena.overflow());
+
+  arena = "new";
+  check_page("new");
+  arena.clear();
+  check_page("");
+}
+
+
+// -------------------------------------------------------
+// REPLACE
+// Every match is replaced, the rest of the page moves up
+// or down to fit, as String::replace()
+// -------------------------------------------------------
+typedef struct {
+  const char *page;
+  const char *find;
+  const char *with;
+} replace_row;
+
+static const replace_row replace_rows[] = {
+  { "a%NAM%b%NAM%c", "%NAM%", "PRO2ESP8266" },  // grow
+  { "a%NAM%b%NAM%c", "%NAM%", "X" },            // shrink
+  { "a%NAM%b%NAM%c", "%NAM%", "" },             // remove
+  { "a%NAM%b%NAM%c", "%NAM%", "12345" },        // same length
+  { "%NAM%%NAM%", "%NAM%", "%NAM%%NAM%" },      // with holds find
+  { "abc", "%NAM%", "xyz" },                    // no match
+  { "%NAM", "%NAM%", "xyz" },                   // cut short match
+};
+
+void test_replace(void) {
+  for (const replace_row &row : replace_rows) {
+    arena = row.page;
+    arena.replace(row.find, row.with);
+    check_page(replace_ref(row.page, row.find, row.with));
+    TEST_ASSERT_FALSE(arena.overflow());
+  }
+
+  // the String overloads
+  arena = "%POS% %POS%";
+  arena.replace(String("%POS%"), String(123456));
+  arena.replace("123456", String("7"));
+  arena.replace(String("7 "), "8:");
+  check_page("8:7");
+
+  // an empty find does nothing
+  arena = "abc";
+  arena.replace("", "x");
+  check_page("abc");
+}
+
+
+// -------------------------------------------------------
+// OVERFLOW
+// A page is cut at PAGEARENALEN, a replacement that does
+// not fit is left undone with those after it
+// -------------------------------------------------------
+void test_append_overflow(void) {
+  std::string full(PAGEARENALEN, 'x');
+
+  // exactly full fits
+  arena = full.c_str();
+  check_page(full);
+  TEST_ASSERT_FALSE(arena.overflow());
+
+  arena = full.substr(0, PAGEARENALEN - 2).c_str();
+  arena += "abcde";
+  check_page(full.substr(0, PAGEARENALEN - 2) + "ab");
+  TEST_ASSERT_TRUE(arena.overflow());
+
+  // a full arena takes nothing more
+  arena += "more";
+  check_page(full.substr(0, PAGEARENALEN - 2) + "ab");
+  TEST_ASSERT_TRUE(arena.overflow());
+
+  arena.clear();
+  TEST_ASSERT_FALSE(arena.overflow());
+}
+
+void test_replace_overflow(void) {
+  // room to grow by 4
+  std::string page = std::string(PAGEARENALEN - 16, 'x') + "%AB%%AB%%AB%";
+  arena = page.c_str();
+
+  // each grows by 4, the first fills the arena exactly,
+  // the others do not fit
+  arena.replace("%AB%", "12345678");
+  check_page(std::string(PAGEARENALEN - 16, 'x') + "12345678%AB%%AB%");
+  TEST_ASSERT_TRUE(arena.overflow());
+
+  // shrinking still works at the limit
+  arena.replace("%AB%", "1");
+  check_page(std::string(PAGEARENALEN - 16, 'x') + "1234567811");
+}
+
+void test_load(void) {
+  File file = write_file("/small.html", "<p>%NAM%</p>");
+  TEST_ASSERT_TRUE(arena.load(file));
+  check_page("<p>%NAM%</p>");
+
+  std::string full(PAGEARENALEN, 'y');
+  file = write_file("/full.html", full);
+  TEST_ASSERT_TRUE(arena.load(file));
+  check_page(full);
+  TEST_ASSERT_FALSE(arena.overflow());
+
+  file = write_file("/big.html", full + "z");
+  TEST_ASSERT_FALSE(arena.load(file));
+  check_page(full);
+  TEST_ASSERT_TRUE(arena.overflow());
+
+  // load starts a new page
+  file = write_file("/small.html", "<p>%NAM%</p>");
+  TEST_ASSERT_TRUE(arena.load(file));
+  TEST_ASSERT_FALSE(arena.overflow());
+}
+
+
+// -------------------------------------------------------
+// RENDERS
+// A page is loaded and filled as a page handler does, with
+// values whose lengths change from view to view. The page
+// never grows past its largest view and no view
+// allocates, so the largest free heap block is unchanged
+// -------------------------------------------------------
+#define RENDER_COUNT  10000
+
+static const char *const render_names[] = { "A", "PRO2ESP8266DRV8825", "WEMOSDRV8825H", "" };
+
+void test_renders(void) {
+  std::string page = "<html><head><title>%NAM%</title></head><body>";
+  while (page.length() < 5000) {
+    page += "<tr><td>Position</td><td>%POS%</td><td>Heap</td><td>%HEA%</td></tr>\n";
+  }
+  page += "<p>%NAM%</p></body></html>";
+
+  // the views, and the reference pages, before counting
+  std::string want[4 * 7];
+  size_t highwater = 0;
+  for (int i = 0; i < 4 * 7; i++) {
+    char pos[16];
+    snprintf(pos, sizeof(pos), "%ld", 1L << ((i % 7) * 4));
+    want[i] = replace_ref(replace_ref(replace_ref(page, "%NAM%", render_names[i % 4]), "%POS%", pos), "%HEA%", "40000");
+    highwater = std::max(highwater, want[i].length());
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(PAGEARENALEN, highwater);
+
+  File file = write_file("/page.html", page);
+  size_t maxlen = 0;
+  unsigned long count = alloc_count;
+  for (int i = 0; i < RENDER_COUNT; i++) {
+    char pos[16];
+    snprintf(pos, sizeof(pos), "%ld", 1L << ((i % 7) * 4));
+    file.seek(0);
+    arena.load(file);
+    arena.replace("%NAM%", render_names[i % 4]);
+    arena.replace("%POS%", pos);
+    arena.replace("%HEA%", "40000");
+    TEST_ASSERT_FALSE(arena.overflow());
+    if (want[i % (4 * 7)] != arena.c_str()) {
+      TEST_ASSERT_EQUAL_STRING(want[i % (4 * 7)].c_str(), arena.c_str());
+    }
+    maxlen = std::max(maxlen, arena.length());
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, alloc_count - count);
+  TEST_ASSERT_EQUAL_UINT(highwater, maxlen);
+
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%d renders, largest page %u of %u", RENDER_COUNT, (unsigned)maxlen, PAGEARENALEN);
+  TEST_MESSAGE(msg);
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_append);
+  RUN_TEST(test_replace);
+  RUN_TEST(test_append_overflow);
+  RUN_TEST(test_replace_overflow);
+  RUN_TEST(test_load);
+  RUN_TEST(test_renders);
+  return UNITY_END();
+}
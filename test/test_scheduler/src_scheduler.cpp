@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_scheduler.cpp
+// Builds src/scheduler.cpp as its own translation unit
+// -------------------------------------------------------
+#include "scheduler.cpp"
@@ -0,0 +1,243 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_scheduler/test_main.cpp
+// Tests of millis64() and SCHEDULER on a simulated clock.
+// stub_millis is the 32 bit millis() and wraps as it does
+// on the ESP8266, the test keeps the elapsed time in 64
+// bits to check millis64() against
+// pio test -e native -f test_scheduler
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <unity.h>
+#include "scheduler.h"
+
+static SCHEDULER sched;
+static uint64_t elapsed = 0;  // ms since the start of the test run
+
+#define SECOND_MS  1000UL
+#define MINUTE_MS  60000UL
+#define HOUR_MS    3600000UL
+#define DAY_MS     86400000ULL
+
+
+// -------------------------------------------------------
+// TASKS
+// -------------------------------------------------------
+static unsigned long calls[SCHED_MAXTASKS + 1];
+
+template<int N>
+static void task(void) {
+  calls[N]++;
+}
+
+// re-adds itself from inside run(), a one-shot timer
+// restarted by its own callback
+static void hourly(void) {
+  calls[0]++;
+  sched.add(hourly, HOUR_MS);
+}
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// advance the clock by ms, under 49.7 days
+static void tick(uint32_t ms) {
+  stub_millis += ms;
+  elapsed += ms;
+}
+
+// one pass of loop() after ms
+static void pass(uint32_t ms) {
+  tick(ms);
+  sched.run();
+}
+
+// run the clock on to ms before millis() wraps
+static void to_wrap(uint32_t ms) {
+  uint32_t left = (uint32_t)(0 - ms - stub_millis);
+  while (left > 0) {
+    uint32_t step = (left > 0x40000000UL) ? 0x40000000UL : left;
+    pass(step);
+    left -= step;
+  }
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// The clock carries on from the last test, it is never
+// set back
+// -------------------------------------------------------
+void setUp(void) {
+  sched = SCHEDULER();
+  memset(calls, 0, sizeof(calls));
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// 150 DAYS
+// From boot, passes of loop() 1 to 997ms apart, so every
+// period is seen. Three millis() rollovers
+// -------------------------------------------------------
+void test_150_days(void) {
+  TEST_ASSERT_EQUAL_UINT64(0, millis64());
+  sched.every(task<1>, SECOND_MS);
+  sched.every(task<2>, MINUTE_MS);
+  sched.add(task<3>, 5 * SECOND_MS);
+  sched.add(hourly, HOUR_MS);
+
+  unsigned long passes = 0;
+  uint64_t minutes = 0;
+  while (elapsed < (150 * DAY_MS)) {
+    pass(1 + ((passes * 7919UL) % 997));
+    passes++;
+    if (calls[2] != minutes) {
+      // the minute task ran in this pass, on time
+      minutes = calls[2];
+      TEST_ASSERT_EQUAL_UINT64(elapsed, millis64());
+      TEST_ASSERT_EQUAL_UINT64(minutes, elapsed / MINUTE_MS);
+    }
+  }
+
+  TEST_ASSERT_EQUAL_UINT64(elapsed, millis64());
+  TEST_ASSERT_EQUAL_UINT32(3, (uint32_t)(millis64() >> 32));
+  TEST_ASSERT_EQUAL_UINT64(elapsed / SECOND_MS, calls[1]);
+  TEST_ASSERT_EQUAL_UINT64(elapsed / MINUTE_MS, calls[2]);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[3]);
+  TEST_ASSERT_FALSE(sched.pending(task<3>));
+
+  // each restart is from the pass it ran in, up to 997ms
+  // late, so the hourly task falls behind by at most that
+  TEST_ASSERT_LESS_OR_EQUAL(elapsed / HOUR_MS, calls[0]);
+  TEST_ASSERT_GREATER_OR_EQUAL(elapsed / (HOUR_MS + 997), calls[0]);
+  TEST_ASSERT_TRUE(sched.pending(hourly));
+}
+
+
+// -------------------------------------------------------
+// ROLLOVER
+// millis64() does not go back when millis() wraps, and
+// tasks due across the wrap run on time
+// -------------------------------------------------------
+void test_rollover(void) {
+  to_wrap(300);
+  uint64_t start = millis64();
+  TEST_ASSERT_EQUAL_UINT64(elapsed, start);
+  sched.every(task<1>, 100);
+  sched.add(task<2>, 500);
+
+  uint64_t last = start;
+  for (int i = 1; i <= 100; i++) {
+    pass(10);
+    uint64_t now = millis64();
+    TEST_ASSERT_TRUE(now > last);
+    TEST_ASSERT_EQUAL_UINT64(elapsed, now);
+    TEST_ASSERT_EQUAL_UINT32((i * 10) / 100, calls[1]);
+    TEST_ASSERT_EQUAL_UINT32((i >= 50) ? 1 : 0, calls[2]);
+    last = now;
+  }
+  TEST_ASSERT_TRUE(stub_millis < 1000);
+
+  // a pass that lands on 0
+  to_wrap(1);
+  pass(1);
+  TEST_ASSERT_EQUAL_UINT32(0, stub_millis);
+  TEST_ASSERT_EQUAL_UINT64(elapsed, millis64());
+}
+
+
+// -------------------------------------------------------
+// MISSED PERIOD
+// loop() held up for 10 periods, the task runs once and
+// is then due one period after that pass
+// -------------------------------------------------------
+void test_missed(void) {
+  sched.every(task<1>, SECOND_MS);
+  pass(10 * SECOND_MS);
+  sched.run();
+  TEST_ASSERT_EQUAL_UINT32(1, calls[1]);
+  pass(SECOND_MS - 1);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[1]);
+  pass(1);
+  TEST_ASSERT_EQUAL_UINT32(2, calls[1]);
+}
+
+
+// -------------------------------------------------------
+// ONE-SHOT, RESTART AND CANCEL
+// -------------------------------------------------------
+void test_one_shot(void) {
+  sched.add(task<1>, 5000);
+  pass(4999);
+  TEST_ASSERT_EQUAL_UINT32(0, calls[1]);
+  TEST_ASSERT_TRUE(sched.pending(task<1>));
+  pass(1);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[1]);
+  TEST_ASSERT_FALSE(sched.pending(task<1>));
+  pass(60000);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[1]);
+
+  // adding again restarts the time, never queued twice
+  sched.add(task<2>, 5000);
+  pass(3000);
+  sched.add(task<2>, 5000);
+  pass(3000);
+  TEST_ASSERT_EQUAL_UINT32(0, calls[2]);
+  pass(2000);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[2]);
+  pass(10000);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[2]);
+
+  // cancelled before it is due, and a periodic task
+  sched.add(task<3>, 1000);
+  sched.every(task<4>, 1000);
+  pass(500);
+  sched.cancel(task<3>);
+  pass(500);
+  TEST_ASSERT_EQUAL_UINT32(0, calls[3]);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[4]);
+  sched.cancel(task<4>);
+  TEST_ASSERT_FALSE(sched.pending(task<4>));
+  pass(5000);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[4]);
+}
+
+// SCHED_MAXTASKS tasks, one more is refused
+void test_full(void) {
+  void (*tasks[])(void) = { task<1>, task<2>, task<3>, task<4>, task<5>, task<6>,
+                            task<7>, task<8>, task<9>, task<10>, task<11>, task<12> };
+  TEST_ASSERT_EQUAL_INT(SCHED_MAXTASKS, sizeof(tasks) / sizeof(tasks[0]));
+  for (int i = 0; i < SCHED_MAXTASKS; i++) {
+    TEST_ASSERT_TRUE(sched.add(tasks[i], 100 + i));
+  }
+  TEST_ASSERT_FALSE(sched.add(hourly, 100));
+  // a pending task may still be restarted
+  TEST_ASSERT_TRUE(sched.add(task<1>, 200));
+
+  pass(150);
+  for (int i = 2; i <= SCHED_MAXTASKS; i++) {
+    TEST_ASSERT_EQUAL_UINT32(1, calls[i]);
+  }
+  TEST_ASSERT_EQUAL_UINT32(0, calls[1]);
+  TEST_ASSERT_TRUE(sched.add(hourly, 100));
+  pass(100);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[1]);
+  TEST_ASSERT_EQUAL_UINT32(1, calls[0]);
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_150_days);
+  RUN_TEST(test_rollover);
+  RUN_TEST(test_missed);
+  RUN_TEST(test_one_shot);
+  RUN_TEST(test_full);
+  return UNITY_END();
+}
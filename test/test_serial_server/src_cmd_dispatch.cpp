@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_cmd_dispatch.cpp
+// Builds src/cmd_dispatch.cpp as its own translation unit
+// -------------------------------------------------------
+#include "cmd_dispatch.cpp"
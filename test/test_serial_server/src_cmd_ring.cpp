@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_cmd_ring.cpp
+// Builds src/cmd_ring.cpp as its own translation unit
+// -------------------------------------------------------
+#include "cmd_ring.cpp"
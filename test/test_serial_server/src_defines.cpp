@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_defines.cpp
+// Builds src/defines.cpp as its own translation unit
+// -------------------------------------------------------
+#include "defines.cpp"
@@ -0,0 +1,7 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_serial_server.cpp
+// Builds src/serial_server.cpp as its own translation unit
+// -------------------------------------------------------
+#include "suite_config.h"
+#include "serial_server.cpp"
@@ -0,0 +1,14 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// suite_config.h
+// config.h built as a LOCALSERIAL controller, included
+// before any other header by the files that need it
+// -------------------------------------------------------
+#ifndef _suite_config_h_
+#define _suite_config_h_
+
+#include "config.h"
+#undef CONTROLLERMODE
+#define CONTROLLERMODE LOCALSERIAL
+
+#endif
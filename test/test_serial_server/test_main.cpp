@@ -0,0 +1,415 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_serial_server/test_main.cpp
+// Tests of the LOCAL_SERIAL binary frames, binary_byte()
+// and crc8(), fed from the stub Serial. Requests are
+// handled by the real cmd_dispatch(). A client paced at
+// the baud rate is answered without drops or allocations
+// pio test -e native -f test_serial_server
+// -------------------------------------------------------
+#include "suite_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <unity.h>
+#include "serial_server.h"
+#include "controller_data.h"
+#include "driver_board.h"
+#include "management_server.h"
+#include "heap_stats.h"
+#include "tc_fit.h"
+#include "firmware_fakes.h"
+#include "alloc_count.h"
+
+extern CONTROLLER_DATA *ControllerData;
+extern DRIVER_BOARD *driverboard;
+extern MANAGEMENT_SERVER *mngsrvr;
+extern TC_FIT *tcfit;
+extern HEAP_STATS *heapstats;
+LOCAL_SERIAL *serialsrvr;
+static std::optional<LOCAL_SERIAL> serial_port;
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// CRC-8/SMBUS, polynomial 0x07, init 0, computed here
+// one bit at a time as a reference for the firmware
+static uint8_t crc8_ref(const std::string &data) {
+  uint8_t crc = 0;
+  for (unsigned char ch : data) {
+    for (int bit = 7; bit >= 0; bit--) {
+      bool msb = ((crc >> 7) ^ (ch >> bit)) & 1;
+      crc = (uint8_t)(crc << 1);
+      if (msb) {
+        crc ^= 0x07;
+      }
+    }
+  }
+  return crc;
+}
+
+// STX LEN OPCODE ARG CRC8
+static std::string frame(uint8_t opcode, const std::string &arg) {
+  std::string body;
+  body += (char)arg.length();
+  body += (char)opcode;
+  body += arg;
+  return std::string(1, CMD_STX) + body + (char)crc8_ref(body);
+}
+
+// the bytes arrive, then the loop() runs
+static void receive(const std::string &bytes) {
+  Serial.rx += bytes;
+  serialsrvr->serialEvent();
+  while (serialsrvr->cmd_available()) {
+    serialsrvr->process_cmd(false);
+  }
+}
+
+// all bytes sent since the last call
+static std::string sent(void) {
+  std::string tx = Serial.tx;
+  Serial.tx.clear();
+  return tx;
+}
+
+// the payload of one reply frame taken from tx, the
+// frame must have the opcode and a good CRC
+static std::string reply_frame(std::string &tx, uint8_t opcode) {
+  TEST_ASSERT_GREATER_OR_EQUAL(4, tx.length());
+  TEST_ASSERT_EQUAL_HEX8(CMD_STX, (uint8_t)tx[0]);
+  size_t len = (uint8_t)tx[1];
+  TEST_ASSERT_GREATER_OR_EQUAL(len + 4, tx.length());
+  TEST_ASSERT_EQUAL_HEX8(opcode, (uint8_t)tx[2]);
+  TEST_ASSERT_EQUAL_HEX8(crc8_ref(tx.substr(1, len + 2)), (uint8_t)tx[len + 3]);
+  std::string payload = tx.substr(3, len);
+  tx.erase(0, len + 4);
+  return payload;
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  delete driverboard;
+  driverboard = new DRIVER_BOARD();
+  if (mngsrvr == nullptr) {
+    mngsrvr = new MANAGEMENT_SERVER();
+    heapstats = new HEAP_STATS();
+    tcfit = new TC_FIT();
+  }
+  fake = FAKE_CALLS();
+  isMoving = false;
+  Serial.clear();
+  serial_port.emplace(Serial);
+  serialsrvr = &*serial_port;
+  serialsrvr->start(SERIALPORTSPEED);
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// CRC8
+// The firmware accepts frames with the reference CRC and
+// sends replies with it, a change to any bit of a frame
+// is rejected
+// -------------------------------------------------------
+void test_crc8(void) {
+  // CRC-8/SMBUS check value
+  TEST_ASSERT_EQUAL_HEX8(0xf4, crc8_ref("123456789"));
+
+  receive(frame(2, ""));
+  std::string tx = sent();
+  TEST_ASSERT_EQUAL_STRING("EOK", reply_frame(tx, 2).c_str());
+  TEST_ASSERT_EQUAL_UINT(0, tx.length());
+
+  // a bool is one byte
+  receive(frame(1, ""));
+  tx = sent();
+  TEST_ASSERT_TRUE(reply_frame(tx, 1) == std::string("I\x00", 2));
+
+  // every single bit error after STX
+  std::string good = frame(1, "0");
+  unsigned long errors = 0;
+  for (size_t i = 1; i < good.length(); i++) {
+    for (int bit = 0; bit < 8; bit++) {
+      std::string bad = good;
+      bad[i] ^= (char)(1 << bit);
+      receive(bad);
+      // a LEN error leaves the rest of the frame as text,
+      // a LEN longer than the frame waits for more bytes
+      stub_millis += BINFRAMETIME + 1;
+      receive("");
+      errors++;
+      char msg[32];
+      snprintf(msg, sizeof(msg), "byte %u bit %d", (unsigned)i, bit);
+      TEST_ASSERT_EQUAL_STRING_MESSAGE("", sent().c_str(), msg);
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(errors, serialsrvr->get_dropped(), msg);
+    }
+  }
+}
+
+
+// -------------------------------------------------------
+// BAD CRC
+// The frame is dropped and counted, the next is handled
+// -------------------------------------------------------
+void test_bad_crc(void) {
+  std::string bad = frame(2, "");
+  bad.back() ^= 0x5a;
+  receive(bad);
+  TEST_ASSERT_EQUAL_STRING("", sent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, serialsrvr->get_dropped());
+
+  receive(frame(2, ""));
+  std::string tx = sent();
+  TEST_ASSERT_EQUAL_STRING("EOK", reply_frame(tx, 2).c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, serialsrvr->get_dropped());
+}
+
+
+// -------------------------------------------------------
+// LENGTH
+// LEN > BINMAXREQUEST is dropped at the LEN byte, the
+// bytes after it are read as text
+// -------------------------------------------------------
+void test_length(void) {
+  // the longest argument fits the command ring
+  std::string arg = "1" + std::string(BINMAXREQUEST - 1, ' ');
+  receive(frame(1, arg));
+  std::string tx = sent();
+  TEST_ASSERT_TRUE(reply_frame(tx, 1) == std::string("I\x00", 2));
+  TEST_ASSERT_EQUAL_UINT32(0, serialsrvr->get_dropped());
+
+  std::string toolong = frame(1, arg + " ");
+  TEST_ASSERT_EQUAL_HEX8(BINMAXREQUEST + 1, (uint8_t)toolong[1]);
+  receive(toolong);
+  TEST_ASSERT_EQUAL_STRING("", sent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(1, serialsrvr->get_dropped());
+
+  std::string lenff = std::string(1, CMD_STX) + "\xff";
+  receive(lenff + ":02#");
+  TEST_ASSERT_EQUAL_STRING("EOK#", sent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(2, serialsrvr->get_dropped());
+}
+
+
+// -------------------------------------------------------
+// INTER-BYTE TIMEOUT
+// A frame not complete within BINFRAMETIME is dropped
+// -------------------------------------------------------
+void test_timeout(void) {
+  std::string req = frame(2, "");
+
+  // complete within the time, over two reads
+  receive(req.substr(0, 3));
+  stub_millis += BINFRAMETIME - 1;
+  receive(req.substr(3));
+  std::string tx = sent();
+  TEST_ASSERT_EQUAL_STRING("EOK", reply_frame(tx, 2).c_str());
+
+  // not complete
+  receive(req.substr(0, 3));
+  stub_millis += BINFRAMETIME + 1;
+  receive("");
+  TEST_ASSERT_EQUAL_UINT32(1, serialsrvr->get_dropped());
+  // the rest of the frame is read as text, no reply
+  receive(req.substr(3));
+  TEST_ASSERT_EQUAL_STRING("", sent().c_str());
+
+  // a text command straight after the timeout
+  receive(req.substr(0, 2));
+  stub_millis += BINFRAMETIME + 1;
+  receive(":01#");
+  TEST_ASSERT_EQUAL_STRING("I0#", sent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(2, serialsrvr->get_dropped());
+}
+
+
+// -------------------------------------------------------
+// OPCODE
+// Opcodes >= CMD_COUNT are dropped, CMD_COUNT - 1 is the
+// last in the table
+// -------------------------------------------------------
+void test_opcode(void) {
+  receive(frame(CMD_COUNT, ""));
+  receive(frame(0xff, ""));
+  TEST_ASSERT_EQUAL_STRING("", sent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(2, serialsrvr->get_dropped());
+
+  receive(frame(CMD_COUNT - 1, ""));
+  std::string tx = sent();
+  TEST_ASSERT_GREATER_THAN(1, reply_frame(tx, CMD_COUNT - 1).length());
+  TEST_ASSERT_EQUAL_UINT(0, tx.length());
+  TEST_ASSERT_EQUAL_UINT32(2, serialsrvr->get_dropped());
+
+  // the argument is printable, and not : or #
+  const char *bad_args[] = { "1:", "#", "\x01", "\x7f" };
+  for (const char *arg : bad_args) {
+    receive(frame(1, arg));
+  }
+  TEST_ASSERT_EQUAL_STRING("", sent().c_str());
+  TEST_ASSERT_EQUAL_UINT32(6, serialsrvr->get_dropped());
+}
+
+
+// -------------------------------------------------------
+// ORDER
+// Text and binary requests are answered in the order
+// received
+// -------------------------------------------------------
+void test_order(void) {
+  receive(":00#" + frame(2, "") + ":01#" + frame(1, ""));
+  std::string tx = sent();
+  TEST_ASSERT_EQUAL_STRING("P0#", tx.substr(0, 3).c_str());
+  tx.erase(0, 3);
+  TEST_ASSERT_EQUAL_STRING("EOK", reply_frame(tx, 2).c_str());
+  TEST_ASSERT_EQUAL_STRING("I0#", tx.substr(0, 3).c_str());
+  tx.erase(0, 3);
+  TEST_ASSERT_TRUE(reply_frame(tx, 1) == std::string("I\x00", 2));
+  TEST_ASSERT_EQUAL_UINT(0, tx.length());
+}
+
+
+// -------------------------------------------------------
+// LOOPBACK
+// Request, dispatch and reply, one at a time, reported
+// in messages per second on this host
+// -------------------------------------------------------
+#define LOOPBACK_COUNT 20000
+
+static void loopback(const char *name, const std::string &req, const std::string &reply) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < LOOPBACK_COUNT; i++) {
+    receive(req);
+    if (Serial.tx != reply) {
+      TEST_ASSERT_EQUAL_STRING(reply.c_str(), Serial.tx.c_str());
+    }
+    Serial.tx.clear();
+    Serial.rx.clear();
+    Serial.rxpos = 0;
+  }
+  std::chrono::duration<double> secs = std::chrono::steady_clock::now() - start;
+
+  char msg[64];
+  snprintf(msg, sizeof(msg), "%s loopback %.0f msgs/sec", name, LOOPBACK_COUNT / secs.count());
+  TEST_MESSAGE(msg);
+}
+
+void test_loopback(void) {
+  receive(frame(2, ""));
+  std::string reply = sent();
+  loopback("binary", frame(2, ""), reply);
+  loopback("text", ":02#", "EOK#");
+  TEST_ASSERT_EQUAL_UINT32(0, serialsrvr->get_dropped());
+}
+
+
+// -------------------------------------------------------
+// PACED LOOPBACK
+// A client at the baud rate, each byte arrives 10 bits
+// after the last. loop() runs every LOOP_PASS_US and
+// handles at most one command, as check_serialserver()
+// does. The client sends a burst of text and binary
+// requests, then waits for all the replies before the
+// next burst. Only allocations made by serialEvent() and
+// process_cmd() are counted
+// -------------------------------------------------------
+#define LOOP_PASS_US  200
+#define PACED_BURSTS  500
+
+static const uint32_t paced_speeds[] = { 115200, 230400, 460800, 921600 };
+
+static double paced_now;  // microseconds
+
+static void paced_advance(double us) {
+  paced_now += us;
+  stub_micros = (uint32_t)paced_now;
+  stub_millis = (uint32_t)(paced_now / 1000);
+}
+
+void test_paced(void) {
+  // the burst, and the replies taken one request at a time
+  std::string burst;
+  std::string replies;
+  for (int i = 0; i < 4; i++) {
+    std::string reqs[] = { ":00#", frame(1, ""), ":01#", frame(2, ""), ":04#", frame(8, "") };
+    for (const std::string &req : reqs) {
+      receive(req);
+      burst += req;
+      replies += sent();
+    }
+  }
+  Serial.clear();
+
+  Serial.rx.reserve(burst.length());
+  Serial.tx.reserve(replies.length());
+  std::string received;
+  received.reserve(replies.length());
+
+  for (uint32_t speed : paced_speeds) {
+    double byte_us = 10.0 * 1000000.0 / speed;
+    unsigned long allocs = 0;
+    paced_now = 0;
+    paced_advance(0);
+    serialsrvr->start(speed);
+
+    for (int i = 0; i < PACED_BURSTS; i++) {
+      double start = paced_now;
+      Serial.rx.clear();
+      Serial.rxpos = 0;
+      received.clear();
+      // a dropped request never gets its reply
+      for (int pass = 0; (pass < 1000) && (received.length() < replies.length()); pass++) {
+        size_t due = std::min(burst.length(), (size_t)((paced_now - start) / byte_us));
+        Serial.rx.append(burst, Serial.rx.length(), due - Serial.rx.length());
+
+        unsigned long count = alloc_count;
+        serialsrvr->serialEvent();
+        if (serialsrvr->cmd_available()) {
+          serialsrvr->process_cmd(false);
+        }
+        allocs += alloc_count - count;
+
+        received += Serial.tx;
+        Serial.tx.clear();
+        paced_advance(LOOP_PASS_US);
+      }
+      TEST_ASSERT_TRUE(received == replies);
+      // the last reply reaches the client
+      paced_advance(replies.length() * byte_us);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, serialsrvr->get_dropped());
+    TEST_ASSERT_EQUAL_UINT32(0, allocs);
+
+    char msg[80];
+    snprintf(msg, sizeof(msg), "%lu baud, %.0f cmds/sec paced", (unsigned long)speed,
+             (PACED_BURSTS * 24) / (paced_now / 1000000.0));
+    TEST_MESSAGE(msg);
+  }
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_crc8);
+  RUN_TEST(test_bad_crc);
+  RUN_TEST(test_length);
+  RUN_TEST(test_timeout);
+  RUN_TEST(test_opcode);
+  RUN_TEST(test_order);
+  RUN_TEST(test_loopback);
+  RUN_TEST(test_paced);
+  return UNITY_END();
+}
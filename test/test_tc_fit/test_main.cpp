@@ -0,0 +1,287 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_tc_fit/test_main.cpp
+// Tests of TC_FIT, the running least squares fit of focus
+// position against temperature. The slope and confidence
+// are checked against a two pass fit of the same pairs,
+// and apply() against the steps temp comp would move
+// pio test -e native -f test_tc_fit
+// -------------------------------------------------------
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <vector>
+#include <unity.h>
+#include "config.h"
+#include "controller_data.h"
+#include "tc_fit.h"
+
+extern CONTROLLER_DATA *ControllerData;
+static TC_FIT fit;
+
+typedef struct {
+  float temp;
+  long position;
+} tc_pair;
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// slope and r squared from the stored pairs, two passes
+static void reference(const std::vector<tc_pair> &pairs, double *slope, double *r2) {
+  double meant = 0.0;
+  double meanp = 0.0;
+  for (const tc_pair &p : pairs) {
+    meant += p.temp;
+    meanp += p.position;
+  }
+  meant /= pairs.size();
+  meanp /= pairs.size();
+
+  double stt = 0.0;
+  double spp = 0.0;
+  double stp = 0.0;
+  for (const tc_pair &p : pairs) {
+    stt += (p.temp - meant) * (p.temp - meant);
+    spp += (p.position - meanp) * (p.position - meanp);
+    stp += (p.temp - meant) * (p.position - meanp);
+  }
+  *slope = stp / stt;
+  *r2 = (stp * stp) / (stt * spp);
+}
+
+// pairs on a line, temperatures from t0 down in steps of
+// dt, each position offset by up to +-noise steps
+static std::vector<tc_pair> line(int n, float t0, float dt, long p0, float slope, int noise) {
+  std::vector<tc_pair> pairs;
+  uint32_t seed = 12345;
+  for (int i = 0; i < n; i++) {
+    float t = t0 - (i * dt);
+    long offset = 0;
+    if (noise > 0) {
+      seed = (seed * 1103515245UL) + 12345UL;
+      offset = (long)((seed >> 16) % (2 * noise + 1)) - noise;
+    }
+    pairs.push_back({ t, p0 + lroundf(slope * (t - t0)) + offset });
+  }
+  return pairs;
+}
+
+static void add(const std::vector<tc_pair> &pairs) {
+  for (const tc_pair &p : pairs) {
+    fit.add(p.temp, p.position);
+  }
+}
+
+// steps temp comp moves for a change of temperature, as
+// TEMP_PROBE::update() turns the coefficient and direction
+// into a move
+static float tc_steps(float change) {
+  float steps = change * (float)ControllerData->get_tempcoefficient();
+  if (ControllerData->get_tcdirection() == TC_DIRECTION_OUT) {
+    steps = -steps;
+  }
+  return steps;
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  fit.clear();
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// SLOPE
+// Known slopes of both signs, exact and with noise
+// -------------------------------------------------------
+typedef struct {
+  float slope;  // steps per degree
+  int noise;    // +- steps
+} slope_row;
+
+static const slope_row slope_rows[] = {
+  { -12.4f, 0 },
+  { 12.4f, 0 },
+  { -55.0f, 3 },
+  { 30.0f, 5 },
+  { -250.0f, 20 },
+  { 1.5f, 0 },
+};
+
+void test_slope(void) {
+  for (const slope_row &row : slope_rows) {
+    char msg[32];
+    snprintf(msg, sizeof(msg), "slope %.1f noise %d", row.slope, row.noise);
+    fit.clear();
+    std::vector<tc_pair> pairs = line(12, 15.0f, 0.75f, 20000L, row.slope, row.noise);
+    add(pairs);
+
+    double slope;
+    double r2;
+    reference(pairs, &slope, &r2);
+    TEST_ASSERT_EQUAL_UINT_MESSAGE(12, fit.get_count(), msg);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.001 * fabs(slope), slope, fit.get_slope(), msg);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1e-4, r2, fit.get_confidence(), msg);
+    // the sign is the sign of the line, the noise small
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(0.1 * fabsf(row.slope) + 0.05, row.slope, fit.get_slope(), msg);
+    TEST_ASSERT_TRUE_MESSAGE((fit.get_slope() > 0) == (row.slope > 0), msg);
+  }
+}
+
+// positions far from 0 and a narrow temperature range,
+// the running sums keep the precision of a two pass fit
+void test_precision(void) {
+  std::vector<tc_pair> pairs = line(400, 10.0f, 0.01f, 2000000000L, -40.0f, 1);
+  add(pairs);
+  double slope;
+  double r2;
+  reference(pairs, &slope, &r2);
+  TEST_ASSERT_FLOAT_WITHIN(0.001 * fabs(slope), slope, fit.get_slope());
+  TEST_ASSERT_FLOAT_WITHIN(1e-4, r2, fit.get_confidence());
+}
+
+
+// -------------------------------------------------------
+// CONFIDENCE
+// 0 until there are TCFIT_MINSAMPLES pairs with a
+// temperature variance of TCFIT_MINVARIANCE, and the
+// position changes
+// -------------------------------------------------------
+void test_confidence(void) {
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_slope());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_confidence());
+
+  // an exact line, confidence 1 from the 5th pair
+  std::vector<tc_pair> pairs = line(TCFIT_MINSAMPLES, 15.0f, 1.0f, 20000L, 20.0f, 0);
+  for (int i = 0; i < TCFIT_MINSAMPLES; i++) {
+    fit.add(pairs[i].temp, pairs[i].position);
+    if (i < TCFIT_MINSAMPLES - 1) {
+      TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_confidence());
+    }
+    if (i > 0) {
+      TEST_ASSERT_FLOAT_WITHIN(1e-3, 20.0f, fit.get_slope());
+    }
+  }
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0f, fit.get_confidence());
+
+  // 5 temperatures 0.3C apart, variance 0.18, are too
+  // narrow, 0.4C apart, variance 0.32, are not
+  fit.clear();
+  add(line(TCFIT_MINSAMPLES, 10.0f, 0.3f, 20000L, 20.0f, 0));
+  TEST_ASSERT_FLOAT_WITHIN(1e-2, 20.0f, fit.get_slope());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_confidence());
+  fit.clear();
+  add(line(TCFIT_MINSAMPLES, 10.0f, 0.4f, 20000L, 20.0f, 0));
+  TEST_ASSERT_FLOAT_WITHIN(1e-6, 1.0f, fit.get_confidence());
+
+  // focus did not change
+  fit.clear();
+  add(line(10, 15.0f, 1.0f, 20000L, 0.0f, 0));
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_slope());
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_confidence());
+
+  // one temperature, no slope
+  fit.clear();
+  add({ { 12.0f, 100L }, { 12.0f, 200L }, { 12.0f, 300L } });
+  TEST_ASSERT_EQUAL_FLOAT(0.0f, fit.get_slope());
+
+  // noise lowers the confidence
+  fit.clear();
+  add(line(12, 15.0f, 0.75f, 20000L, 10.0f, 40));
+  TEST_ASSERT_GREATER_THAN(0.0f, fit.get_confidence());
+  TEST_ASSERT_LESS_THAN(TCFIT_MINCONFIDENCE, fit.get_confidence());
+}
+
+
+// -------------------------------------------------------
+// APPLY
+// Below TCFIT_MINCONFIDENCE nothing is set. When set, a
+// change of temperature moves temp comp by the fitted
+// slope, so a positive slope is TC_DIRECTION_IN
+// -------------------------------------------------------
+void test_apply_gate(void) {
+  ControllerData->set_tempcoefficient(7);
+  ControllerData->set_tcdirection(TC_DIRECTION_OUT);
+
+  // no pairs, too few, and too noisy
+  TEST_ASSERT_FALSE(fit.apply());
+  add(line(TCFIT_MINSAMPLES - 1, 15.0f, 1.0f, 20000L, 20.0f, 0));
+  TEST_ASSERT_FALSE(fit.apply());
+  fit.clear();
+  add(line(12, 15.0f, 0.75f, 20000L, 10.0f, 40));
+  TEST_ASSERT_FALSE(fit.apply());
+  TEST_ASSERT_EQUAL_INT(7, ControllerData->get_tempcoefficient());
+  TEST_ASSERT_EQUAL(TC_DIRECTION_OUT, ControllerData->get_tcdirection());
+}
+
+void test_apply_direction(void) {
+  for (const slope_row &row : slope_rows) {
+    char msg[32];
+    snprintf(msg, sizeof(msg), "slope %.1f noise %d", row.slope, row.noise);
+    setUp();
+    ControllerData->set_tempcoefficient(7);
+    ControllerData->set_tcdirection((row.slope > 0) ? TC_DIRECTION_OUT : TC_DIRECTION_IN);
+    add(line(12, 15.0f, 0.75f, 20000L, row.slope, row.noise));
+    TEST_ASSERT_TRUE_MESSAGE(fit.apply(), msg);
+
+    TEST_ASSERT_EQUAL_INT_MESSAGE(lroundf(fabsf(fit.get_slope())), ControllerData->get_tempcoefficient(), msg);
+    TEST_ASSERT_EQUAL_MESSAGE((row.slope > 0) ? TC_DIRECTION_IN : TC_DIRECTION_OUT, ControllerData->get_tcdirection(), msg);
+
+    // 2C warmer, temp comp moves where the fit says
+    // focus goes, within the rounding of the coefficient
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1.0f, 2.0f * fit.get_slope(), tc_steps(2.0f), msg);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(1.0f, -2.0f * fit.get_slope(), tc_steps(-2.0f), msg);
+  }
+}
+
+// the coefficient is limited to TCFIT_MAXCOEFFICIENT
+void test_apply_limit(void) {
+  add(line(12, 15.0f, 0.75f, 20000L, -900.0f, 0));
+  TEST_ASSERT_TRUE(fit.apply());
+  TEST_ASSERT_EQUAL_INT(TCFIT_MAXCOEFFICIENT, ControllerData->get_tempcoefficient());
+  TEST_ASSERT_EQUAL(TC_DIRECTION_OUT, ControllerData->get_tcdirection());
+}
+
+
+// -------------------------------------------------------
+// SUMMARY
+// "slope,confidence,count", as sent to clients
+// -------------------------------------------------------
+void test_summary(void) {
+  char buff[TCFIT_SUMMARYLEN];
+  fit.get_summary(buff, sizeof(buff));
+  TEST_ASSERT_EQUAL_STRING("0.00,0.000,0", buff);
+
+  add(line(TCFIT_MINSAMPLES, 15.0f, 5.0f, 20000L, -12.4f, 0));
+  fit.get_summary(buff, sizeof(buff));
+  TEST_ASSERT_EQUAL_STRING("-12.40,1.000,5", buff);
+
+  fit.clear();
+  TEST_ASSERT_EQUAL_UINT(0, fit.get_count());
+  fit.get_summary(buff, sizeof(buff));
+  TEST_ASSERT_EQUAL_STRING("0.00,0.000,0", buff);
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_slope);
+  RUN_TEST(test_precision);
+  RUN_TEST(test_confidence);
+  RUN_TEST(test_apply_gate);
+  RUN_TEST(test_apply_direction);
+  RUN_TEST(test_apply_limit);
+  RUN_TEST(test_summary);
+  return UNITY_END();
+}
@@ -0,0 +1,6 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_controller_data.cpp
+// Builds src/controller_data.cpp as its own translation unit
+// -------------------------------------------------------
+#include "controller_data.cpp"
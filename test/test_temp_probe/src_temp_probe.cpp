@@ -0,0 +1,7 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// src_temp_probe.cpp
+// Builds src/temp_probe.cpp as its own translation unit
+// -------------------------------------------------------
+#include "suite_config.h"
+#include "temp_probe.cpp"
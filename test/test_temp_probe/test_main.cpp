@@ -0,0 +1,571 @@
+// -------------------------------------------------------
+// myFP2ESP8266 NATIVE TEST
+// test_temp_probe/test_main.cpp
+// The TEMP_PROBE conversion state machine and probe roles
+// on the stub OneWire bus, and a trace replay of update(). Each
+// reading is converted and read by run(), then update()
+// filters it, a median of 3 then an ema,
+// and temp comp accumulates steps with the fraction kept
+// and moves when the deadband is reached and the camera
+// is idle
+// pio test -e native -f test_temp_probe
+// -------------------------------------------------------
+#include "suite_config.h"
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <vector>
+#include <unity.h>
+#include "controller_data.h"
+#include "temp_probe.h"
+#include "firmware_fakes.h"
+
+extern CONTROLLER_DATA *ControllerData;
+static TEMP_PROBE *tempprobe;
+
+#define TC_START    5000L
+#define TC_COEFF    40     // steps per degree
+#define TC_DEADBAND 2
+
+
+// -------------------------------------------------------
+// HELPERS
+// -------------------------------------------------------
+// run() until the probe has been converted and read once
+static void convert(float t) {
+  stub_onewire.dev[0].temp = t;
+  int reads = stub_onewire.reads;
+  for (int i = 0; (i < 5000) && (stub_onewire.reads == reads); i++) {
+    stub_millis++;
+    tempprobe->run();
+  }
+  TEST_ASSERT_EQUAL_INT(reads + 1, stub_onewire.reads);
+}
+
+// one reading through the bus then update(), returns
+// the target position after the update, a move made by
+// temp comp is kept in tempcomp_target
+static long replay(float t) {
+  long last = ftargetPosition;
+  convert(t);
+  TEST_ASSERT_EQUAL_FLOAT(t, tempprobe->update());
+  if (ftargetPosition != last) {
+    TEST_ASSERT_EQUAL_INT32(ftargetPosition, tempcomp_target);
+  }
+  return ftargetPosition;
+}
+
+// run() once a millisecond, each call makes at most one
+// bus step
+static void run_for(uint32_t ms) {
+  for (uint32_t i = 0; i < ms; i++) {
+    int steps = stub_onewire.steps;
+    stub_millis++;
+    tempprobe->run();
+    TEST_ASSERT_LESS_OR_EQUAL(steps + 1, stub_onewire.steps);
+  }
+}
+
+// the target after each reading of a trace
+static std::vector<long> replay(const std::vector<float> &trace) {
+  std::vector<long> targets;
+  for (float t : trace) {
+    targets.push_back(replay(t));
+  }
+  return targets;
+}
+
+// each change of target is at least the deadband, in
+// the direction given
+static void check_moves(const std::vector<long> &targets, long start, int sign) {
+  long last = start;
+  for (long target : targets) {
+    long move = target - last;
+    if (move != 0) {
+      TEST_ASSERT_GREATER_OR_EQUAL(TC_DEADBAND, move * sign);
+    }
+    last = target;
+  }
+}
+
+
+// probe n on the bus, a DS18B20 rom with serial number n
+static void add_probe(int n, float temp) {
+  uint8_t rom[8] = { 0x28, (uint8_t)(0x10 + n), 0x20, 0x30, 0x40, 0x50, 0x60, 0x00 };
+  rom[7] = OneWire::crc8(rom, 7);
+  memcpy(stub_onewire.dev[n].rom, rom, sizeof(rom));
+  stub_onewire.dev[n].temp = temp;
+  if (stub_onewire.count <= n) {
+    stub_onewire.count = n + 1;
+  }
+}
+
+// the rom of probe n as saved in the config
+static std::string rom_hex(int n) {
+  char hex[TEMP_ROMHEXLEN];
+  for (int i = 0; i < 8; i++) {
+    snprintf(&hex[i * 2], 3, "%02X", stub_onewire.dev[n].rom[i]);
+  }
+  return hex;
+}
+
+// the rom the probe has for a role
+static std::string role_rom(byte role) {
+  char hex[TEMP_ROMHEXLEN];
+  tempprobe->get_rom(role, hex);
+  return hex;
+}
+
+// tube 22C, ambient 15C and mirror 10C, no roles saved
+static void three_probes(void) {
+  for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+    ControllerData->set_tprobe_rom(role, "");
+  }
+  add_probe(0, 22.0f);
+  add_probe(1, 15.0f);
+  add_probe(2, 10.0f);
+}
+
+// a new probe started on the bus as it is now
+static void restart(void) {
+  delete tempprobe;
+  tempprobe = new TEMP_PROBE(10);
+  TEST_ASSERT_TRUE(tempprobe->start());
+  tempcomp_state = STATE_ENABLED;
+}
+
+
+// -------------------------------------------------------
+// SETUP
+// The probe starts at 20C, 12 bit, temp comp enabled,
+// 40 steps per degree, deadband 2 steps
+// -------------------------------------------------------
+void setUp(void) {
+  LittleFS.format();
+  delete ControllerData;
+  ControllerData = new CONTROLLER_DATA();
+  ControllerData->set_brdtemppin(10);
+  ControllerData->set_tempprobe_enable(STATE_ENABLED);
+  ControllerData->set_tempresolution(12);
+  ControllerData->set_tempcoefficient(TC_COEFF);
+  ControllerData->set_tcdirection(TC_DIRECTION_IN);
+  ControllerData->set_tcdeadband(TC_DEADBAND);
+
+  stub_onewire = STUB_ONEWIRE_BUS();
+  ftargetPosition = TC_START;
+  tempcomp_target = -1;
+  camera_idle = true;
+  restart();
+}
+
+void tearDown(void) {}
+
+
+// -------------------------------------------------------
+// BUS
+// The resolution is written, then readings come back at
+// 1/16 degree
+// -------------------------------------------------------
+void test_bus(void) {
+  TEST_ASSERT_TRUE(tempprobe->get_present(Probe_Tube));
+  TEST_ASSERT_EQUAL_FLOAT(20.0f, tempprobe->read());
+  convert(21.0625f);
+  TEST_ASSERT_EQUAL_HEX8(0x7f, stub_onewire.dev[0].config);
+  TEST_ASSERT_EQUAL_FLOAT(21.0625f, tempprobe->read());
+  convert(-5.5f);
+  TEST_ASSERT_EQUAL_FLOAT(-5.5f, tempprobe->read());
+
+  // out of range readings are ignored
+  convert(85.0f);
+  TEST_ASSERT_EQUAL_FLOAT(-5.5f, tempprobe->read());
+}
+
+
+// -------------------------------------------------------
+// CONVERSION
+// One convert is broadcast each TEMPCONVERTTIME. The probe
+// is read once the conversion time for the resolution has
+// passed, the stub returns the previous conversion to a
+// read made any sooner
+// -------------------------------------------------------
+void test_period(void) {
+  int converts = stub_onewire.converts;
+  int reads = stub_onewire.reads;
+  run_for(10 * TEMPCONVERTTIME);
+  TEST_ASSERT_INT32_WITHIN(1, 10, stub_onewire.converts - converts);
+  TEST_ASSERT_INT32_WITHIN(1, 10, stub_onewire.reads - reads);
+}
+
+// each resolution is written with TH and TL kept, then
+// the wait and the reading follow it
+void test_resolution(void) {
+  static const uint32_t wait[] = { 94, 188, 375, 750 };
+  static const float expect[] = { 21.0f, 21.25f, 21.25f, 21.3125f };
+  stub_onewire.dev[0].th = 0x12;
+  stub_onewire.dev[0].tl = 0x34;
+  restart();
+
+  for (byte bits = 9; bits <= 12; bits++) {
+    ControllerData->set_tempresolution(bits);
+    stub_onewire.dev[0].temp = 21.3125f;
+    int reads = stub_onewire.reads;
+    int converts = stub_onewire.converts;
+    uint32_t converted = 0;
+    for (int i = 0; (i < 5000) && (stub_onewire.reads == reads); i++) {
+      stub_millis++;
+      tempprobe->run();
+      if (stub_onewire.converts != converts) {
+        converts = stub_onewire.converts;
+        converted = stub_millis;
+      }
+    }
+    TEST_ASSERT_EQUAL_INT(reads + 1, stub_onewire.reads);
+    TEST_ASSERT_EQUAL_HEX8(((bits - 9) << 5) | 0x1F, stub_onewire.dev[0].config);
+    TEST_ASSERT_EQUAL_HEX8(0x12, stub_onewire.dev[0].th);
+    TEST_ASSERT_EQUAL_HEX8(0x34, stub_onewire.dev[0].tl);
+
+    // the convert, the wait, then a reset, match rom and
+    // 9 scratchpad bytes a millisecond apart
+    TEST_ASSERT_TRUE(converted != 0);
+    TEST_ASSERT_GREATER_OR_EQUAL(wait[bits - 9], stub_millis - converted);
+    TEST_ASSERT_LESS_OR_EQUAL(wait[bits - 9] + 25, stub_millis - converted);
+    TEST_ASSERT_EQUAL_FLOAT(expect[bits - 9], tempprobe->read());
+  }
+}
+
+// no presence pulse, the last reading is kept and the bus
+// is tried again each period
+void test_missing(void) {
+  convert(21.0f);
+  stub_onewire.dev[0].present = false;
+  stub_onewire.dev[0].temp = 22.0f;
+  int reads = stub_onewire.reads;
+  int resets = stub_onewire.resets;
+  run_for(3 * TEMPCONVERTTIME);
+  TEST_ASSERT_EQUAL_INT(reads, stub_onewire.reads);
+  TEST_ASSERT_INT32_WITHIN(1, 3, stub_onewire.resets - resets);
+  TEST_ASSERT_EQUAL_FLOAT(21.0f, tempprobe->read());
+
+  stub_onewire.dev[0].present = true;
+  convert(22.0f);
+  TEST_ASSERT_EQUAL_FLOAT(22.0f, tempprobe->read());
+}
+
+// a scratchpad with a bad crc is dropped
+void test_crc(void) {
+  convert(21.0f);
+  stub_onewire.corrupt = true;
+  convert(22.0f);
+  TEST_ASSERT_EQUAL_FLOAT(21.0f, tempprobe->read());
+  convert(22.0f);
+  TEST_ASSERT_EQUAL_FLOAT(22.0f, tempprobe->read());
+}
+
+
+// -------------------------------------------------------
+// PROBES
+// Each role keeps the probe whose rom is saved for it, a
+// role with none saved takes the next probe found. One
+// broadcast converts every probe, then each is read by
+// its rom in the same conversion window
+// -------------------------------------------------------
+void test_roles_found(void) {
+  three_probes();
+  add_probe(3, 5.0f);
+  restart();
+  for (byte role = 0; role < TEMP_MAXPROBES; role++) {
+    TEST_ASSERT_TRUE(tempprobe->get_present(role));
+    TEST_ASSERT_EQUAL_STRING(rom_hex(role).c_str(), role_rom(role).c_str());
+    TEST_ASSERT_EQUAL_STRING(rom_hex(role).c_str(), ControllerData->get_tprobe_rom(role));
+  }
+  TEST_ASSERT_EQUAL_FLOAT(22.0f, tempprobe->read(Probe_Tube));
+  TEST_ASSERT_EQUAL_FLOAT(15.0f, tempprobe->read(Probe_Ambient));
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, tempprobe->read(Probe_Mirror));
+}
+
+// saved roles win over the bus search order
+void test_roles_saved(void) {
+  three_probes();
+  ControllerData->set_tprobe_rom(Probe_Tube, rom_hex(2).c_str());
+  ControllerData->set_tprobe_rom(Probe_Ambient, rom_hex(0).c_str());
+  ControllerData->set_tprobe_rom(Probe_Mirror, rom_hex(1).c_str());
+  restart();
+  TEST_ASSERT_EQUAL_STRING(rom_hex(2).c_str(), role_rom(Probe_Tube).c_str());
+  TEST_ASSERT_EQUAL_STRING(rom_hex(0).c_str(), role_rom(Probe_Ambient).c_str());
+  TEST_ASSERT_EQUAL_STRING(rom_hex(1).c_str(), role_rom(Probe_Mirror).c_str());
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, tempprobe->read(Probe_Tube));
+  TEST_ASSERT_EQUAL_FLOAT(22.0f, tempprobe->read(Probe_Ambient));
+  TEST_ASSERT_EQUAL_FLOAT(15.0f, tempprobe->read(Probe_Mirror));
+}
+
+// a missing probe keeps its saved role, a new probe only
+// takes a role with no rom saved
+void test_role_missing(void) {
+  three_probes();
+  restart();
+  stub_onewire.dev[1].present = false;
+  add_probe(3, 5.0f);
+  restart();
+  TEST_ASSERT_FALSE(tempprobe->get_present(Probe_Ambient));
+  TEST_ASSERT_EQUAL_STRING("", role_rom(Probe_Ambient).c_str());
+  TEST_ASSERT_EQUAL_STRING(rom_hex(1).c_str(), ControllerData->get_tprobe_rom(Probe_Ambient));
+  TEST_ASSERT_EQUAL_FLOAT(DEFAULTLASTTEMP, tempprobe->read(Probe_Ambient));
+  TEST_ASSERT_EQUAL_STRING(rom_hex(0).c_str(), role_rom(Probe_Tube).c_str());
+  TEST_ASSERT_EQUAL_STRING(rom_hex(2).c_str(), role_rom(Probe_Mirror).c_str());
+
+  // reconnected, the probe is back in its role
+  stub_onewire.dev[1].present = true;
+  restart();
+  TEST_ASSERT_EQUAL_STRING(rom_hex(1).c_str(), role_rom(Probe_Ambient).c_str());
+  TEST_ASSERT_EQUAL_FLOAT(15.0f, tempprobe->read(Probe_Ambient));
+
+  // the mirror probe replaced, its role cleared
+  stub_onewire.dev[2].present = false;
+  ControllerData->set_tprobe_rom(Probe_Mirror, "");
+  restart();
+  TEST_ASSERT_EQUAL_STRING(rom_hex(3).c_str(), role_rom(Probe_Mirror).c_str());
+  TEST_ASSERT_EQUAL_STRING(rom_hex(3).c_str(), ControllerData->get_tprobe_rom(Probe_Mirror));
+  TEST_ASSERT_EQUAL_FLOAT(5.0f, tempprobe->read(Probe_Mirror));
+}
+
+// one convert, then all three read in one window
+void test_bulk(void) {
+  three_probes();
+  restart();
+  run_for(2 * TEMPCONVERTTIME);
+  stub_onewire.dev[0].temp = 21.0f;
+  stub_onewire.dev[1].temp = 16.0f;
+  stub_onewire.dev[2].temp = 11.0f;
+
+  int reads[3] = { stub_onewire.dev[0].reads, stub_onewire.dev[1].reads, stub_onewire.dev[2].reads };
+  int converts = stub_onewire.converts;
+  uint32_t converted = 0;
+  for (int i = 0; (i < 5000) && (stub_onewire.dev[2].reads == reads[2]); i++) {
+    stub_millis++;
+    tempprobe->run();
+    if ((converted == 0) && (stub_onewire.converts != converts)) {
+      converted = stub_millis;
+    }
+  }
+  TEST_ASSERT_EQUAL_INT(converts + 1, stub_onewire.converts);
+  for (int n = 0; n < 3; n++) {
+    TEST_ASSERT_EQUAL_INT(reads[n] + 1, stub_onewire.dev[n].reads);
+  }
+  // 750ms, then 21 bus steps a probe
+  TEST_ASSERT_TRUE(converted != 0);
+  TEST_ASSERT_LESS_OR_EQUAL(750 + (3 * 25), stub_millis - converted);
+  TEST_ASSERT_EQUAL_FLOAT(21.0f, tempprobe->read(Probe_Tube));
+  TEST_ASSERT_EQUAL_FLOAT(16.0f, tempprobe->read(Probe_Ambient));
+  TEST_ASSERT_EQUAL_FLOAT(11.0f, tempprobe->read(Probe_Mirror));
+}
+
+// temp comp reads its own role, or the first probe found
+// when that role has none
+void test_tcprobe(void) {
+  three_probes();
+  ControllerData->set_tcprobe(Probe_Mirror);
+  restart();
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, tempprobe->read());
+  TEST_ASSERT_EQUAL_FLOAT(10.0f, tempprobe->update());
+
+  stub_onewire.dev[2].present = false;
+  restart();
+  TEST_ASSERT_EQUAL_FLOAT(22.0f, tempprobe->read());
+}
+
+// a resolution change is written to every probe, each
+// keeping its own TH and TL
+void test_resolution_each(void) {
+  three_probes();
+  for (int n = 0; n < 3; n++) {
+    stub_onewire.dev[n].th = 0x10 + n;
+    stub_onewire.dev[n].tl = 0x20 + n;
+  }
+  restart();
+  ControllerData->set_tempresolution(10);
+  run_for(2 * TEMPCONVERTTIME);
+  for (int n = 0; n < 3; n++) {
+    TEST_ASSERT_EQUAL_HEX8(0x3F, stub_onewire.dev[n].config);
+    TEST_ASSERT_EQUAL_HEX8(0x10 + n, stub_onewire.dev[n].th);
+    TEST_ASSERT_EQUAL_HEX8(0x20 + n, stub_onewire.dev[n].tl);
+  }
+}
+
+
+// -------------------------------------------------------
+// TRAJECTORY
+// A step from 20C to 18C. The median holds the first
+// reading, then the ema closes 20% of the gap each
+// update, the target moves in towards 80 steps less
+// -------------------------------------------------------
+void test_trajectory(void) {
+  std::vector<long> targets = replay(std::vector<float>(40, 18.0f));
+
+  // one reading at 18C is not the median
+  TEST_ASSERT_EQUAL_INT32(TC_START, targets[0]);
+  // 20 + 0.2 * (18 - 20) = 19.6C, 16 steps
+  TEST_ASSERT_INT32_WITHIN(1, TC_START - 16, targets[1]);
+  // 19.6 + 0.2 * (18 - 19.6) = 19.28C, 28.8 steps
+  TEST_ASSERT_INT32_WITHIN(1, TC_START - 28, targets[2]);
+
+  // moves in only, never more than the gap left
+  check_moves(targets, TC_START, -1);
+  for (size_t i = 1; i < targets.size(); i++) {
+    TEST_ASSERT_LESS_OR_EQUAL(targets[i - 1], targets[i]);
+    TEST_ASSERT_GREATER_OR_EQUAL(TC_START - 80, targets[i]);
+  }
+  // settled, less than the deadband short of 80 steps
+  TEST_ASSERT_LESS_THAN(TC_START - 80 + TC_DEADBAND, targets.back());
+  TEST_ASSERT_EQUAL_INT32(targets.back(), replay(18.0f));
+
+  // back to 20C, the target returns to the start
+  targets = replay(std::vector<float>(40, 20.0f));
+  check_moves(targets, targets.front(), 1);
+  TEST_ASSERT_INT32_WITHIN(TC_DEADBAND, TC_START, targets.back());
+}
+
+// TC_DIRECTION_OUT moves out when the temperature falls
+void test_direction_out(void) {
+  ControllerData->set_tcdirection(TC_DIRECTION_OUT);
+  std::vector<long> targets = replay(std::vector<float>(40, 18.0f));
+  check_moves(targets, TC_START, 1);
+  TEST_ASSERT_INT32_WITHIN(TC_DEADBAND, TC_START + 80, targets.back());
+}
+
+
+// -------------------------------------------------------
+// MEDIAN
+// A single spike is dropped, update() still returns it
+// -------------------------------------------------------
+void test_spike(void) {
+  std::vector<long> targets = replay({ 20.0f, 20.0f, 30.0f, 20.0f, 20.0f, 10.0f, 20.0f });
+  for (long target : targets) {
+    TEST_ASSERT_EQUAL_INT32(TC_START, target);
+  }
+  TEST_ASSERT_EQUAL_INT32(-1, tempcomp_target);
+}
+
+
+// -------------------------------------------------------
+// DEADBAND
+// A slow rise of 1/16C per reading is 2.5 steps per
+// reading, with a deadband of 20 each move is 20 to 22
+// steps and nothing is lost to the fraction
+// -------------------------------------------------------
+void test_deadband(void) {
+  ControllerData->set_tcdeadband(20);
+  std::vector<float> trace;
+  for (int i = 1; i <= 100; i++) {
+    trace.push_back(20.0f + (i * 0.0625f));
+  }
+  std::vector<long> targets = replay(trace);
+
+  int moves = 0;
+  long last = TC_START;
+  for (long target : targets) {
+    long move = target - last;
+    if (move != 0) {
+      TEST_ASSERT_GREATER_OR_EQUAL(20, move);
+      TEST_ASSERT_LESS_OR_EQUAL(22, move);
+      moves++;
+    }
+    last = target;
+  }
+  TEST_ASSERT_GREATER_OR_EQUAL(10, moves);
+
+  // 250 steps, less the lag of the filter and what is
+  // waiting for the deadband
+  long moved = targets.back() - TC_START;
+  TEST_ASSERT_LESS_OR_EQUAL(250, moved);
+  TEST_ASSERT_GREATER_OR_EQUAL(250 - 15 - 20, moved);
+
+  // below the deadband nothing moves
+  setUp();
+  ControllerData->set_tcdeadband(20);
+  targets = replay({ 20.0f, 20.25f, 20.25f, 20.25f });
+  TEST_ASSERT_EQUAL_INT32(TC_START, targets.back());
+  // 0.75C is 30 steps, one move when 20 are reached
+  targets = replay(std::vector<float>(40, 20.75f));
+  long move = targets.back() - TC_START;
+  TEST_ASSERT_GREATER_OR_EQUAL(20, move);
+  TEST_ASSERT_LESS_OR_EQUAL(22, move);
+  for (long target : targets) {
+    TEST_ASSERT_TRUE((target == TC_START) || (target == targets.back()));
+  }
+}
+
+
+// -------------------------------------------------------
+// CAMERA IDLE
+// No move while the camera is busy, the steps are kept
+// and moved at once when it is idle again
+// -------------------------------------------------------
+void test_camera_idle(void) {
+  camera_idle = false;
+  std::vector<long> targets = replay(std::vector<float>(40, 18.0f));
+  for (long target : targets) {
+    TEST_ASSERT_EQUAL_INT32(TC_START, target);
+  }
+  TEST_ASSERT_EQUAL_INT32(-1, tempcomp_target);
+
+  camera_idle = true;
+  long target = replay(18.0f);
+  TEST_ASSERT_INT32_WITHIN(1, TC_START - 80, target);
+  TEST_ASSERT_EQUAL_INT32(target, tempcomp_target);
+}
+
+
+// -------------------------------------------------------
+// TEMP COMP STATE
+// A change while disabled is not applied, enabling starts
+// from the filtered temperature
+// -------------------------------------------------------
+void test_state(void) {
+  tempcomp_state = STATE_DISABLED;
+  replay(std::vector<float>(40, 18.0f));
+  TEST_ASSERT_EQUAL_INT32(TC_START, ftargetPosition);
+
+  tempcomp_state = STATE_ENABLED;
+  std::vector<long> targets = replay(std::vector<float>(10, 18.0f));
+  TEST_ASSERT_EQUAL_INT32(TC_START, targets.back());
+  targets = replay(std::vector<float>(40, 20.0f));
+  check_moves(targets, TC_START, 1);
+  TEST_ASSERT_INT32_WITHIN(TC_DEADBAND, TC_START + 80, targets.back());
+}
+
+// the target is kept within 0 and maxstep
+void test_range(void) {
+  ftargetPosition = 30;
+  replay(std::vector<float>(40, 18.0f));
+  TEST_ASSERT_EQUAL_INT32(0, ftargetPosition);
+
+  ftargetPosition = ControllerData->get_maxstep() - 30;
+  replay(std::vector<float>(40, 20.0f));
+  TEST_ASSERT_EQUAL_INT32(ControllerData->get_maxstep(), ftargetPosition);
+}
+
+
+// -------------------------------------------------------
+// MAIN
+// -------------------------------------------------------
+int main(void) {
+  UNITY_BEGIN();
+  RUN_TEST(test_bus);
+  RUN_TEST(test_period);
+  RUN_TEST(test_resolution);
+  RUN_TEST(test_missing);
+  RUN_TEST(test_crc);
+  RUN_TEST(test_roles_found);
+  RUN_TEST(test_roles_saved);
+  RUN_TEST(test_role_missing);
+  RUN_TEST(test_bulk);
+  RUN_TEST(test_tcprobe);
+  RUN_TEST(test_resolution_each);
+  RUN_TEST(test_trajectory);
+  RUN_TEST(test_direction_out);
+  RUN_TEST(test_spike);
+  RUN_TEST(test_deadband);
+  RUN_TEST(test_camera_idle);
+  RUN_TEST(test_state);
+  RUN_TEST(test_range);
+  return UNITY_END();
+}
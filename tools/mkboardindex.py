@@ -0,0 +1,84 @@
+# -------------------------------------------------------
+# myFP2ESP8266 BOARD PROFILE INDEX GENERATOR
+# Copyright Robert Brown 2014-2025. All Rights Reserved.
+# mkboardindex.py
+# -------------------------------------------------------
+# Builds data/boards/boards.idx from data/boards/*.jsn so
+# the controller can load a board profile without parsing
+# JSON. Run by PlatformIO before build/buildfs (see
+# extra_scripts in platformio.ini), or by hand when using
+# the Arduino IDE:
+#     python tools/mkboardindex.py
+#
+# File layout, all values little endian
+#   header   char magic[4] "BIDX"
+#            uint16 record length
+#            uint16 record count
+#   slots    uint8 slot[256], indexed by board number
+#            (the <n> of /boards/<n>.jsn, which is how the
+#            firmware looks a profile up), 0 = no profile,
+#            else record number + 1
+#   records  record[count], see BOARD_RECORD in
+#            src/controller_data.h
+# -------------------------------------------------------
+
+import glob
+import json
+import os
+import struct
+
+MAGIC = b"BIDX"
+NUMSLOTS = 256
+NAMELEN = 24
+# name, brdnum, maxstepmode, stepmode, enpin, steppin,
+# dirpin, temppin, stepsrev, fixedsmode, brdpins[4], msdelay
+RECORD = struct.Struct("<%ds13hH" % NAMELEN)
+
+
+def build_index(boarddir):
+    records = []
+    slots = bytearray(NUMSLOTS)
+
+    for fname in sorted(glob.glob(os.path.join(boarddir, "*.jsn")),
+                        key=lambda f: int(os.path.splitext(os.path.basename(f))[0])):
+        with open(fname, "r") as f:
+            brd = json.load(f)
+        num = int(os.path.splitext(os.path.basename(fname))[0])
+        if num < 0 or num >= NUMSLOTS:
+            raise ValueError("%s: brdnum %d out of range" % (fname, num))
+        if slots[num] != 0:
+            raise ValueError("%s: duplicate brdnum %d" % (fname, num))
+        name = brd["board"].encode("ascii")
+        if len(name) >= NAMELEN:
+            raise ValueError("%s: board name too long" % fname)
+        pins = list(brd["brdpins"]) + [-1] * 4
+        records.append(RECORD.pack(name, brd["brdnum"], brd["maxstepmode"], brd["stepmode"],
+                                   brd["enpin"], brd["steppin"], brd["dirpin"],
+                                   brd["temppin"], brd["stepsrev"], brd["fixedsmode"],
+                                   pins[0], pins[1], pins[2], pins[3], brd["msdelay"]))
+        slots[num] = len(records)
+
+    header = MAGIC + struct.pack("<HH", RECORD.size, len(records))
+    return header + bytes(slots) + b"".join(records)
+
+
+def write_index(projectdir):
+    boarddir = os.path.join(projectdir, "data", "boards")
+    outname = os.path.join(boarddir, "boards.idx")
+    data = build_index(boarddir)
+    # only rewrite when changed, keeps the data folder timestamp stable
+    if os.path.exists(outname):
+        with open(outname, "rb") as f:
+            if f.read() == data:
+                return
+    with open(outname, "wb") as f:
+        f.write(data)
+    print("mkboardindex: wrote %s" % outname)
+
+
+if __name__ == "__main__":
+    write_index(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+else:
+    # PlatformIO extra_script
+    Import("env")  # noqa: F821
+    write_index(env["PROJECT_DIR"])  # noqa: F821
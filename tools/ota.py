@@ -0,0 +1,98 @@
+# -------------------------------------------------------
+# myFP2ESP8266 OTA UPDATER
+# Copyright Robert Brown 2014-2025. All Rights Reserved.
+# ota.py
+# -------------------------------------------------------
+# Sends a firmware or LittleFS image to one or more
+# controllers over WiFi, for example:
+#     python tools/ota.py --firmware firmware.bin 192.168.2.128
+#     python tools/ota.py --fs littlefs.bin 192.168.2.128 192.168.2.129
+# PlatformIO builds the images with
+#     pio run                (.pio/build/<env>/firmware.bin)
+#     pio run -t buildfs     (.pio/build/<env>/littlefs.bin)
+#
+# The image is posted to the management server as
+#     /update?md5=<hex>[&type=fs]
+# The controller refuses it while the focuser is moving,
+# checks the MD5 and reboots into the new image. The reply
+# is: bytes KB/s ok|error
+# A LittleFS image replaces all the data/ files, the
+# focuser settings are saved again after it is written.
+# Controllers are updated one at a time, and a failed
+# one does not stop the rest.
+# -------------------------------------------------------
+
+import argparse
+import base64
+import hashlib
+import sys
+import time
+import urllib.error
+import urllib.parse
+import urllib.request
+
+BOUNDARY = "myfp2esp8266update"
+
+
+def build_body(filename, image):
+    body = bytearray()
+    body += ("--%s\r\n" % BOUNDARY).encode()
+    body += ('Content-Disposition: form-data; name="image"; filename="%s"\r\n' % filename).encode()
+    body += b"Content-Type: application/octet-stream\r\n\r\n"
+    body += image
+    body += ("\r\n--%s--\r\n" % BOUNDARY).encode()
+    return bytes(body)
+
+
+def update(host, args, query, body):
+    url = "http://%s:%d/update?%s" % (host, args.port, query)
+    auth = base64.b64encode(("%s:%s" % (args.user, args.password)).encode()).decode()
+    req = urllib.request.Request(url, data=body, method="POST")
+    req.add_header("Content-Type", "multipart/form-data; boundary=%s" % BOUNDARY)
+    req.add_header("Authorization", "Basic %s" % auth)
+
+    start = time.time()
+    try:
+        with urllib.request.urlopen(req, timeout=300) as resp:
+            reply = resp.read().decode().strip()
+            ok = True
+    except urllib.error.HTTPError as e:
+        reply = e.read().decode().strip()
+        ok = False
+    except (urllib.error.URLError, OSError) as e:
+        reply = str(e)
+        ok = False
+    print("%s: %s (%.1fs)" % (host, reply, time.time() - start))
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description="OTA update controllers")
+    image = parser.add_mutually_exclusive_group(required=True)
+    image.add_argument("--firmware")
+    image.add_argument("--fs")
+    parser.add_argument("hosts", nargs="+")
+    parser.add_argument("--port", type=int, default=6060)
+    parser.add_argument("--user", default="admin")
+    parser.add_argument("--password", default="admin")
+    args = parser.parse_args()
+
+    filename = args.firmware or args.fs
+    with open(filename, "rb") as f:
+        data = f.read()
+    query = [("md5", hashlib.md5(data).hexdigest())]
+    if args.fs:
+        query.append(("type", "fs"))
+    query = urllib.parse.urlencode(query)
+    body = build_body(filename, data)
+
+    print("%s, %d bytes, md5 %s" % (filename, len(data), hashlib.md5(data).hexdigest()))
+    failed = [host for host in args.hosts if not update(host, args, query, body)]
+    if failed:
+        print("failed: %s" % " ".join(failed))
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
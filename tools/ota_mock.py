@@ -0,0 +1,651 @@
+# -------------------------------------------------------
+# myFP2ESP8266 OTA MOCK CONTROLLER
+# Copyright Robert Brown 2014-2025. All Rights Reserved.
+# ota_mock.py
+# -------------------------------------------------------
+# A local stand in for the management server /update and
+# /upload endpoints, to test ota.py and uploaddata.py,
+# throughput and rollback without a controller, for
+# example:
+#     python tools/ota_mock.py --port 6060 --kbps 40
+#     python tools/ota.py --firmware firmware.bin 127.0.0.1
+#     python tools/uploaddata.py 127.0.0.1
+#     python tools/ota_mock.py --selftest
+#
+# It follows handler_postupdatefile() and
+# handler_postupdate(): the multipart image is streamed
+# into a mock Updater in HTTP upload sized chunks, the
+# MD5 is checked in end(), and the reply is
+#     bytes KB/s ok|error
+# Firmware is staged in the free flash and only replaces
+# the running image on the reboot after a good update,
+# so a failed or aborted one leaves it as it was. A
+# filesystem image is written in place, a failed one
+# leaves a formatted filesystem with the settings saved.
+#
+# /upload follows handler_postuploadfile(): each file is
+# staged in /upload.tmp in UPLOADBUFLEN blocks, checked
+# against its SHA-256 and renamed over the old file, so a
+# failed or aborted file leaves the old one as it was.
+# The reply has a line per file, path bytes KB/s result.
+# GET /mock/state returns the state as JSON.
+# --selftest runs ota.py, uploaddata.py and raw uploads
+# against a mock on a free port and checks each result.
+# -------------------------------------------------------
+
+import argparse
+import base64
+import hashlib
+import http.server
+import json
+import os
+import re
+import socket
+import sys
+import threading
+import time
+import urllib.error
+import urllib.parse
+import urllib.request
+
+# HTTP_UPLOAD_BUFLEN of the ESP8266 core
+CHUNKLEN = 2048
+# management_server.h
+UPLOADBUFLEN = 4096
+
+
+class MockUpdater:
+    """Updater: begin(), write(), end() as the core's"""
+
+    def __init__(self):
+        self.running = False
+
+    def begin(self, size):
+        if size <= 0:
+            return False
+        self.size = size
+        self.data = bytearray()
+        self.md5 = None
+        self.running = True
+        return True
+
+    def set_md5(self, md5):
+        self.md5 = md5.lower()
+
+    def write(self, chunk):
+        # past the space given to begin(), nothing written
+        if len(self.data) + len(chunk) > self.size:
+            return 0
+        self.data += chunk
+        return len(chunk)
+
+    # the image if commit and the MD5 matches, else None
+    def end(self, commit):
+        self.running = False
+        if not commit or hashlib.md5(self.data).hexdigest() != self.md5:
+            return None
+        return bytes(self.data)
+
+
+class Controller:
+    """The flash and settings of one controller"""
+
+    def __init__(self, args):
+        self.lock = threading.Lock()
+        self.user = args.user
+        self.password = args.password
+        self.flash = args.flash
+        self.fssize = args.fssize
+        self.kbps = args.kbps
+        self.moving = args.moving
+        self.firmware = b"running firmware"
+        self.staged = None
+        self.fs = b"littlefs image"
+        self.fsfree = args.fsfree
+        self.files = {}       # LittleFS path: data
+        self.tmpfile = None   # /upload.tmp while a file is staged
+        self.block_writes = 0
+        self.settings_saved = 0
+        self.reboots = 0
+        self.results = []
+
+    def state(self):
+        return {
+            "firmware_md5": hashlib.md5(self.firmware).hexdigest(),
+            "fs_md5": hashlib.md5(self.fs).hexdigest(),
+            "staged": self.staged is not None,
+            "files": {name: hashlib.sha256(data).hexdigest() for name, data in self.files.items()},
+            "tmpfile": self.tmpfile is not None,
+            "block_writes": self.block_writes,
+            "settings_saved": self.settings_saved,
+            "reboots": self.reboots,
+            "moving": self.moving,
+            "results": self.results,
+        }
+
+    # software_Reboot() saves the settings, a staged
+    # firmware is then copied over the running one
+    def reboot(self):
+        self.settings_saved += 1
+        if self.staged is not None:
+            self.firmware = self.staged
+            self.staged = None
+        self.reboots += 1
+
+
+def read_parts(rfile, length, boundary):
+    """Yields (filename, None) at the start of each part,
+    (filename, chunk) for its data in CHUNKLEN chunks, then
+    (filename, b"") at its end. Raises EOFError if the body
+    ends early"""
+    delim = b"\r\n--" + boundary
+    # the first boundary has no CRLF before it
+    buf = b"\r\n"
+    left = length
+
+    def more():
+        nonlocal buf, left
+        if left <= 0:
+            raise EOFError()
+        data = rfile.read(min(CHUNKLEN, left))
+        if not data:
+            raise EOFError()
+        left -= len(data)
+        buf += data
+
+    while True:
+        # a boundary, then "--" after the last part
+        while len(buf) < len(delim) + 2:
+            more()
+        if not buf.startswith(delim) or buf[len(delim):len(delim) + 2] == b"--":
+            while left > 0:
+                more()
+            return
+
+        # the part headers
+        while b"\r\n\r\n" not in buf:
+            more()
+        end = buf.index(b"\r\n\r\n")
+        found = re.search(r'filename="([^"]*)"', buf[:end].decode("utf-8", "replace"))
+        name = found.group(1) if found else ""
+        buf = buf[end + 4:]
+        yield name, None
+
+        while True:
+            pos = buf.find(delim)
+            if pos >= 0:
+                if pos:
+                    yield name, buf[:pos]
+                buf = buf[pos:]
+                break
+            # keep what may be the start of the delimiter
+            while len(buf) - len(delim) >= CHUNKLEN:
+                yield name, buf[:CHUNKLEN]
+                buf = buf[CHUNKLEN:]
+            more()
+        yield name, b""
+
+
+def read_multipart(rfile, length, boundary):
+    """Yields the file data of the first part in CHUNKLEN
+    chunks, the rest of the body is read and dropped.
+    Raises EOFError if the body ends early"""
+    parts = 0
+    for name, chunk in read_parts(rfile, length, boundary):
+        if chunk is None:
+            parts += 1
+        elif chunk and parts == 1:
+            yield chunk
+
+
+class Handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = "HTTP/1.1"
+
+    def log_message(self, fmt, *args):
+        if self.server.verbose:
+            sys.stderr.write("mock: " + (fmt % args) + "\n")
+
+    def reply(self, code, text, headers=()):
+        body = text.encode()
+        self.send_response(code)
+        self.send_header("Content-Type", "text/plain")
+        self.send_header("Content-Length", str(len(body)))
+        for name, value in headers:
+            self.send_header(name, value)
+        self.end_headers()
+        self.wfile.write(body)
+
+    def authenticated(self):
+        ctl = self.server.controller
+        want = base64.b64encode(("%s:%s" % (ctl.user, ctl.password)).encode()).decode()
+        return self.headers.get("Authorization", "") == "Basic " + want
+
+    def do_GET(self):
+        if self.path == "/mock/state":
+            with self.server.controller.lock:
+                self.reply(200, json.dumps(self.server.controller.state()))
+        else:
+            self.reply(404, "not found")
+
+    def boundary(self):
+        ctype = self.headers.get("Content-Type", "")
+        if ctype.startswith("multipart/form-data") and "boundary=" in ctype:
+            return ctype.split("boundary=", 1)[1].strip().encode()
+        return None
+
+    def do_POST(self):
+        url = urllib.parse.urlparse(self.path)
+        if url.path not in ("/update", "/upload"):
+            self.reply(404, "not found")
+            return
+        args = dict(urllib.parse.parse_qsl(url.query))
+        ctl = self.server.controller
+        with ctl.lock:
+            if url.path == "/update":
+                self.update(ctl, args)
+            else:
+                self.upload(ctl, args)
+
+    def update(self, ctl, args):
+        length = int(self.headers.get("Content-Length", "0"))
+        boundary = self.boundary()
+
+        # UPLOAD_FILE_START
+        err = None
+        isfs = args.get("type") == "fs"
+        started = False
+        size = 0
+        start = time.time()
+        updater = MockUpdater()
+        if boundary is None:
+            err = "nofile"
+        elif not self.authenticated():
+            err = "access"
+        elif ctl.moving:
+            err = "moving"
+        elif len(args.get("md5", "")) != 32:
+            err = "md5"
+        else:
+            # a filesystem image from here on remounts LittleFS
+            started = True
+            if not updater.begin(ctl.fssize if isfs else ctl.flash):
+                err = "begin"
+        if err is None:
+            updater.set_md5(args["md5"])
+            if isfs:
+                # written in place, the old image is gone
+                ctl.fs = b""
+
+        # UPLOAD_FILE_WRITE
+        aborted = False
+        if boundary is not None:
+            try:
+                for chunk in read_multipart(self.rfile, length, boundary):
+                    if err is None:
+                        if updater.write(chunk) != len(chunk):
+                            err = "write"
+                        size += len(chunk)
+                        if ctl.kbps:
+                            time.sleep(len(chunk) / (ctl.kbps * 1024.0))
+            except EOFError:
+                aborted = True
+                if err is None:
+                    err = "aborted"
+        else:
+            self.rfile.read(length)
+
+        # UPLOAD_FILE_END or UPLOAD_FILE_ABORTED
+        if updater.running:
+            image = updater.end(err is None)
+            if image is None and err is None:
+                err = "verify"
+            if image is not None:
+                if isfs:
+                    ctl.fs = image
+                else:
+                    ctl.staged = image
+        if isfs and started and err is not None:
+            # remounted, formatted if the image was partly
+            # written, and the settings saved again
+            if err != "begin":
+                ctl.fs = b""
+            ctl.settings_saved += 1
+        ctl.results.append(err or "ok")
+
+        if aborted:
+            # the client has gone, there is no one to reply to
+            self.close_connection = True
+            return
+
+        # handler_postupdate()
+        ms = max(1, int((time.time() - start) * 1000))
+        text = "%u %uKB/s %s\n" % (size, (size * 1000) // (ms * 1024), err or "ok")
+        if not self.authenticated():
+            self.reply(401, "", [("WWW-Authenticate", 'Basic realm="Login Required"')])
+        elif err is not None:
+            self.reply(500, text)
+        else:
+            # rebooted before the reply is sent, so the state
+            # has settled when the client has it
+            ctl.reboot()
+            self.reply(200, text)
+
+    # handler_postuploadfile() for each file, then
+    # handler_postuploadstart()
+    def upload(self, ctl, args):
+        length = int(self.headers.get("Content-Length", "0"))
+        boundary = self.boundary()
+        authed = self.authenticated()
+        report = []
+        ok = True
+        part = None
+
+        # upload_close(), the temp file is gone either way
+        def close(err):
+            nonlocal ok
+            part["open"] = False
+            ctl.tmpfile = None
+            if err is not None:
+                ok = False
+            ms = max(1, int((time.time() - part["start"]) * 1000))
+            report.append("%s %u %uKB/s %s\n" % (part["name"], part["size"], (part["size"] * 1000) // (ms * 1024), err or "ok"))
+            ctl.results.append(err or "ok")
+
+        # upload_flush(), one LittleFS write of n bytes
+        def flush(n):
+            block = part["buf"][:n]
+            del part["buf"][:n]
+            if len(ctl.tmpfile) + len(block) > ctl.fsfree:
+                close("write")
+                return
+            ctl.tmpfile += block
+            ctl.block_writes += 1
+
+        aborted = False
+        try:
+            if boundary is None:
+                self.rfile.read(length)
+                events = []
+            else:
+                events = read_parts(self.rfile, length, boundary)
+            for name, chunk in events:
+                if chunk is None:
+                    # UPLOAD_FILE_START
+                    part = None
+                    if authed:
+                        part = {"name": name if name.startswith("/") else "/" + name,
+                                "buf": bytearray(), "sha": hashlib.sha256(), "size": 0,
+                                "start": time.time(), "open": True}
+                        ctl.tmpfile = bytearray()
+                elif chunk:
+                    # UPLOAD_FILE_WRITE
+                    if part is not None and part["open"]:
+                        part["sha"].update(chunk)
+                        part["size"] += len(chunk)
+                        part["buf"] += chunk
+                        while part["open"] and len(part["buf"]) >= UPLOADBUFLEN:
+                            flush(UPLOADBUFLEN)
+                    if ctl.kbps:
+                        time.sleep(len(chunk) / (ctl.kbps * 1024.0))
+                elif part is not None and part["open"]:
+                    # UPLOAD_FILE_END
+                    if part["buf"]:
+                        flush(len(part["buf"]))
+                    if part["open"]:
+                        expect = args.get(part["name"], "")
+                        if expect and expect.lower() != part["sha"].hexdigest():
+                            close("checksum")
+                        else:
+                            ctl.files[part["name"]] = bytes(ctl.tmpfile)
+                            close(None)
+        except EOFError:
+            # UPLOAD_FILE_ABORTED
+            aborted = True
+            if part is not None and part["open"]:
+                close("aborted")
+
+        if aborted:
+            # no reply is sent for an aborted request
+            self.close_connection = True
+            return
+        if not authed:
+            self.reply(401, "", [("WWW-Authenticate", 'Basic realm="Login Required"')])
+            return
+        text = "".join(report)
+        if not text:
+            ok = False
+            text = "Err: no file"
+        if args.get("fmt") == "text":
+            self.reply(200 if ok else 500, text)
+        elif ok:
+            # handler_success(), the success page
+            self.reply(200, "success")
+        else:
+            self.reply(500, text)
+
+
+def make_server(args):
+    server = http.server.HTTPServer(("127.0.0.1", args.port), Handler)
+    server.controller = Controller(args)
+    server.verbose = not args.selftest
+    return server
+
+
+# -------------------------------------------------------
+# SELF TEST
+# -------------------------------------------------------
+def selftest(args):
+    sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+    import ota
+    import uploaddata
+
+    args.port = 0
+    server = make_server(args)
+    port = server.server_address[1]
+    ctl = server.controller
+    threading.Thread(target=server.serve_forever, daemon=True).start()
+
+    ota_args = argparse.Namespace(port=port, user=args.user, password=args.password)
+    failures = []
+
+    def check(name, cond):
+        print("%-44s %s" % (name, "PASS" if cond else "FAIL"))
+        if not cond:
+            failures.append(name)
+
+    def post(image, md5=None, fs=False, password=None):
+        query = [("md5", md5 or hashlib.md5(image).hexdigest())]
+        if fs:
+            query.append(("type", "fs"))
+        saved = ota_args.password
+        if password is not None:
+            ota_args.password = password
+        ok = ota.update("127.0.0.1", ota_args, urllib.parse.urlencode(query), ota.build_body("image.bin", image))
+        ota_args.password = saved
+        return ok
+
+    def md5(data):
+        return hashlib.md5(data).hexdigest()
+
+    # a body cut short, the client goes away part way
+    def send_cut(path, boundary, body):
+        count = len(ctl.results)
+        auth = base64.b64encode(("%s:%s" % (args.user, args.password)).encode()).decode()
+        head = ("POST %s HTTP/1.1\r\nHost: 127.0.0.1\r\n"
+                "Authorization: Basic %s\r\n"
+                "Content-Type: multipart/form-data; boundary=%s\r\n"
+                "Content-Length: %d\r\n\r\n" % (path, auth, boundary, len(body)))
+        with socket.create_connection(("127.0.0.1", port)) as sock:
+            sock.sendall(head.encode() + body[:len(body) // 2])
+        # wait for the mock to see the end of the body
+        for _ in range(100):
+            if len(ctl.results) == count + 1:
+                break
+            time.sleep(0.01)
+
+    def post_aborted(image):
+        send_cut("/update?md5=%s" % md5(image), ota.BOUNDARY, ota.build_body("image.bin", image))
+
+    # files posted as uploaddata.py does, hashes is the
+    # query to send instead of one with every file's hash.
+    # Returns the status and the reply
+    def upload(files, hashes=None, password=None):
+        query, body = uploaddata.build_request(files)
+        if hashes is not None:
+            query = urllib.parse.urlencode([("fmt", "text")] + hashes)
+        auth = base64.b64encode(("%s:%s" % (args.user, password or args.password)).encode()).decode()
+        req = urllib.request.Request("http://127.0.0.1:%d/upload?%s" % (port, query), data=body, method="POST")
+        req.add_header("Content-Type", "multipart/form-data; boundary=%s" % uploaddata.BOUNDARY)
+        req.add_header("Authorization", "Basic %s" % auth)
+        try:
+            with urllib.request.urlopen(req, timeout=60) as resp:
+                return resp.status, resp.read().decode()
+        except urllib.error.HTTPError as e:
+            return e.code, e.read().decode()
+
+    def sha256(data):
+        return hashlib.sha256(data).hexdigest()
+
+    good = os.urandom(300 * 1024)
+    old = ctl.firmware
+
+    # a good firmware image, staged then run after the reboot
+    check("firmware ok", post(good))
+    check("firmware running after reboot", ctl.firmware == good and ctl.reboots == 1)
+
+    # MD5 mismatch, the running image is kept
+    old = ctl.firmware
+    other = os.urandom(64 * 1024)
+    check("md5 mismatch refused", not post(other, md5=md5(good)))
+    check("md5 mismatch result verify", ctl.results[-1] == "verify")
+    check("md5 mismatch firmware kept", ctl.firmware == old and ctl.staged is None and ctl.reboots == 1)
+
+    # bigger than the free flash, the write fails
+    big = os.urandom(args.flash + 1)
+    check("oversize image refused", not post(big))
+    check("oversize result write", ctl.results[-1] == "write")
+    check("oversize firmware kept", ctl.firmware == old and ctl.staged is None)
+
+    # a bad md5 argument, nothing is written
+    check("bad md5 argument refused", not post(good, md5="1234"))
+    check("bad md5 argument result md5", ctl.results[-1] == "md5")
+
+    # aborted part way, the running image is kept
+    post_aborted(os.urandom(128 * 1024))
+    check("aborted upload result aborted", ctl.results[-1:] == ["aborted"])
+    check("aborted upload firmware kept", ctl.firmware == old and ctl.staged is None and ctl.reboots == 1)
+
+    # refused while moving
+    ctl.moving = True
+    check("moving refused", not post(good))
+    check("moving result moving", ctl.results[-1] == "moving")
+    ctl.moving = False
+
+    # wrong password
+    check("wrong password refused", not post(good, password="nope"))
+    check("wrong password result access", ctl.results[-1] == "access")
+    check("wrong password firmware kept", ctl.firmware == old)
+
+    # filesystem image, then one that fails verify and
+    # leaves a formatted filesystem with the settings saved
+    fs = os.urandom(200 * 1024)
+    check("fs image ok", post(fs, fs=True))
+    check("fs image in place", ctl.fs == fs and ctl.reboots == 2)
+    saved = ctl.settings_saved
+    check("fs md5 mismatch refused", not post(os.urandom(1024), md5=md5(fs), fs=True))
+    check("fs md5 mismatch formatted, settings saved", ctl.fs == b"" and ctl.settings_saved == saved + 1)
+
+    # the whole data/ folder in one request, each file
+    # written in UPLOADBUFLEN blocks
+    datadir = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "data")
+    files = uploaddata.collect_files(datadir)
+    writes = ctl.block_writes
+    status, text = upload(files)
+    lines = text.splitlines()
+    check("data/ upload ok", status == 200 and len(lines) == len(files))
+    check("data/ upload a line per file ok", all(line.endswith(" ok") for line in lines))
+    check("data/ upload files saved", all(ctl.files.get("/" + rel) == data for rel, data in files))
+    check("data/ upload in UPLOADBUFLEN blocks",
+          ctl.block_writes - writes == sum((len(data) + UPLOADBUFLEN - 1) // UPLOADBUFLEN for rel, data in files))
+    check("data/ upload temp file removed", ctl.tmpfile is None)
+
+    # a checksum mismatch keeps the old file, the other
+    # files in the request are still saved
+    ctl.files["/a.txt"] = b"old a"
+    new_a, new_b = os.urandom(10000), os.urandom(5000)
+    status, text = upload([("a.txt", new_a), ("b.txt", new_b)],
+                          [("/a.txt", sha256(b"other")), ("/b.txt", sha256(new_b))])
+    lines = text.splitlines()
+    check("checksum mismatch refused", status == 500 and len(lines) == 2)
+    check("checksum mismatch result checksum", lines[0].startswith("/a.txt 10000 ") and lines[0].endswith(" checksum"))
+    check("checksum mismatch old file kept", ctl.files["/a.txt"] == b"old a" and ctl.tmpfile is None)
+    check("checksum mismatch next file saved", lines[1].endswith(" ok") and ctl.files["/b.txt"] == new_b)
+
+    # without a hash the file is saved as sent
+    status, text = upload([("c.txt", b"c")], [])
+    check("no hash saved", status == 200 and ctl.files["/c.txt"] == b"c")
+
+    # aborted part way, the old file is kept
+    query, body = uploaddata.build_request([("a.txt", os.urandom(64 * 1024))])
+    send_cut("/upload?" + query, uploaddata.BOUNDARY, body)
+    check("aborted file result aborted", ctl.results[-1:] == ["aborted"])
+    check("aborted file old file kept", ctl.files["/a.txt"] == b"old a" and ctl.tmpfile is None)
+
+    # the filesystem fills while staging
+    ctl.fsfree = 10000
+    status, text = upload([("a.txt", os.urandom(20000))])
+    check("filesystem full refused", status == 500 and text.strip().endswith(" write"))
+    check("filesystem full old file kept", ctl.files["/a.txt"] == b"old a" and ctl.tmpfile is None)
+    ctl.fsfree = args.fsfree
+
+    # wrong password, nothing is written
+    status, text = upload([("a.txt", b"new a")], password="nope")
+    check("upload wrong password refused", status == 401 and ctl.files["/a.txt"] == b"old a")
+
+    # a request without a file
+    status, text = upload([])
+    check("upload without a file refused", status == 500 and text == "Err: no file")
+
+    # throughput, at the rate set
+    ctl.kbps = 200
+    start = time.time()
+    check("throughput upload ok", post(os.urandom(100 * 1024)))
+    secs = time.time() - start
+    print("throughput: 100 KB in %.2fs, %.0f KB/s at a %d KB/s link" % (secs, 100 / secs, ctl.kbps))
+    check("throughput within the link rate", 100 / secs <= ctl.kbps * 1.05)
+
+    server.shutdown()
+    if failures:
+        print("%d failed" % len(failures))
+        return 1
+    print("all passed")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="mock controller for ota.py and uploaddata.py")
+    parser.add_argument("--port", type=int, default=6060)
+    parser.add_argument("--user", default="admin")
+    parser.add_argument("--password", default="admin")
+    parser.add_argument("--flash", type=int, default=1024 * 1024, help="free flash for firmware, bytes")
+    parser.add_argument("--fssize", type=int, default=1024 * 1024, help="LittleFS size, bytes")
+    parser.add_argument("--fsfree", type=int, default=1024 * 1024, help="LittleFS free for an upload, bytes")
+    parser.add_argument("--kbps", type=float, default=0, help="link rate, KB/s, 0 no limit")
+    parser.add_argument("--moving", action="store_true", help="the focuser is moving")
+    parser.add_argument("--selftest", action="store_true")
+    args = parser.parse_args()
+
+    if args.selftest:
+        return selftest(args)
+
+    server = make_server(args)
+    print("mock controller on 127.0.0.1:%d" % server.server_address[1])
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
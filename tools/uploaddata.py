@@ -0,0 +1,86 @@
+# -------------------------------------------------------
+# myFP2ESP8266 DATA FOLDER UPLOADER
+# Copyright Robert Brown 2014-2025. All Rights Reserved.
+# uploaddata.py
+# -------------------------------------------------------
+# Uploads every file in data/ to the controller's
+# management server in one request, for example:
+#     python tools/uploaddata.py 192.168.2.128
+#     python tools/uploaddata.py 192.168.2.128 --user admin
+#         --password admin --port 6060 --data data
+#
+# Each file is a part of one multipart POST to
+#     /upload?fmt=text&/<path>=<sha256 hex>...
+# The controller stages each file in /upload.tmp, checks
+# it against its SHA-256 and only then renames it over
+# the old file. The reply has a line per file:
+#     /<path> bytes KB/s ok|error
+# -------------------------------------------------------
+
+import argparse
+import base64
+import hashlib
+import os
+import sys
+import urllib.error
+import urllib.parse
+import urllib.request
+
+BOUNDARY = "myfp2esp8266upload"
+
+
+def collect_files(datadir):
+    files = []
+    for root, dirs, names in os.walk(datadir):
+        dirs.sort()
+        for name in sorted(names):
+            path = os.path.join(root, name)
+            rel = os.path.relpath(path, datadir).replace(os.sep, "/")
+            with open(path, "rb") as f:
+                files.append((rel, f.read()))
+    return files
+
+
+def build_request(files):
+    body = bytearray()
+    query = [("fmt", "text")]
+    for rel, data in files:
+        query.append(("/" + rel, hashlib.sha256(data).hexdigest()))
+        body += ("--%s\r\n" % BOUNDARY).encode()
+        body += ('Content-Disposition: form-data; name="name"; filename="%s"\r\n' % rel).encode()
+        body += b"Content-Type: application/octet-stream\r\n\r\n"
+        body += data
+        body += b"\r\n"
+    body += ("--%s--\r\n" % BOUNDARY).encode()
+    return urllib.parse.urlencode(query), bytes(body)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="upload data/ to the controller")
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=6060)
+    parser.add_argument("--user", default="admin")
+    parser.add_argument("--password", default="admin")
+    parser.add_argument("--data", default=os.path.join(os.path.dirname(__file__), "..", "data"))
+    args = parser.parse_args()
+
+    files = collect_files(args.data)
+    query, body = build_request(files)
+    url = "http://%s:%d/upload?%s" % (args.host, args.port, query)
+    auth = base64.b64encode(("%s:%s" % (args.user, args.password)).encode()).decode()
+    req = urllib.request.Request(url, data=body, method="POST")
+    req.add_header("Content-Type", "multipart/form-data; boundary=%s" % BOUNDARY)
+    req.add_header("Authorization", "Basic %s" % auth)
+
+    print("%d files, %d bytes" % (len(files), len(body)))
+    try:
+        with urllib.request.urlopen(req, timeout=300) as resp:
+            print(resp.read().decode(), end="")
+    except urllib.error.HTTPError as e:
+        print(e.read().decode(), end="")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())